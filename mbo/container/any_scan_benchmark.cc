@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares iterating a `ConstScan` (range-for and `ForEach`) against iterating
+// the underlying container directly.
+// Run with: bazel run -c opt //mbo/container:any_scan_benchmark
+
+#include <cstdint>
+#include <list>
+#include <set>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mbo/container/any_scan.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+template<typename Container>
+Container MakeContainer(std::size_t size) {
+  Container container;
+  for (std::size_t idx = 0; idx < size; ++idx) {
+    container.insert(container.end(), static_cast<int>(idx));
+  }
+  return container;
+}
+
+template<typename Container>
+void BmDirect(benchmark::State& state) {
+  const auto container = MakeContainer<Container>(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::int64_t sum = 0;
+    for (const int value : container) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename Container>
+void BmScanRangeFor(benchmark::State& state) {
+  const auto container = MakeContainer<Container>(static_cast<std::size_t>(state.range(0)));
+  ConstScan<int> scan = MakeConstScan(container);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scan);  // Prevent the compiler from seeing through the type erasure.
+    std::int64_t sum = 0;
+    for (const int value : scan) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename Container>
+void BmScanForEach(benchmark::State& state) {
+  const auto container = MakeContainer<Container>(static_cast<std::size_t>(state.range(0)));
+  ConstScan<int> scan = MakeConstScan(container);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scan);  // Prevent the compiler from seeing through the type erasure.
+    std::int64_t sum = 0;
+    scan.ForEach([&sum](const int value) { sum += value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+BENCHMARK(BmDirect<std::vector<int>>)->Range(16, 65'536);
+BENCHMARK(BmScanRangeFor<std::vector<int>>)->Range(16, 65'536);
+BENCHMARK(BmScanForEach<std::vector<int>>)->Range(16, 65'536);
+BENCHMARK(BmDirect<std::list<int>>)->Range(16, 65'536);
+BENCHMARK(BmScanRangeFor<std::list<int>>)->Range(16, 65'536);
+BENCHMARK(BmScanForEach<std::list<int>>)->Range(16, 65'536);
+BENCHMARK(BmDirect<std::set<int>>)->Range(16, 65'536);
+BENCHMARK(BmScanRangeFor<std::set<int>>)->Range(16, 65'536);
+BENCHMARK(BmScanForEach<std::set<int>>)->Range(16, 65'536);
+
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
+
+BENCHMARK_MAIN();
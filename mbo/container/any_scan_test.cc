@@ -24,6 +24,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -54,8 +55,10 @@ namespace mbo::container {
 namespace {
 
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::IsEmpty;
 using ::testing::Not;
+using ::testing::Optional;
 using ::testing::Pair;
 using ::testing::Pointee;
 using ::testing::SizeIs;
@@ -365,5 +368,159 @@ TEST_F(ConvertingScanTest, StringPairs) {
   }
 }
 
+struct AnyScanAccessTest : public AnyScanTest {};
+
+TEST_F(AnyScanAccessTest, AsSpanForContiguousContainers) {
+  std::vector<int> vector{1, 2, 3};
+  const auto vector_span = AnyScan<int>(MakeAnyScan(vector)).AsSpan();
+  ASSERT_TRUE(vector_span.has_value());
+  EXPECT_THAT(vector_span->data(), vector.data());  // Lvalues are referenced, not copied.
+  EXPECT_THAT(*vector_span, ElementsAre(1, 2, 3));
+  const std::array<std::string, 2> array{"a", "b"};
+  EXPECT_THAT(ConstScan<std::string>(MakeConstScan(array)).AsSpan(), Optional(ElementsAre("a", "b")));
+  EXPECT_THAT(ConstScan<int>({4, 5}).AsSpan(), Optional(ElementsAre(4, 5)));
+  EXPECT_THAT(AnyScan<int>(MakeAnyScan(std::vector<int>{})).AsSpan(), Optional(IsEmpty()));
+  // Node based containers have no span.
+  EXPECT_FALSE(AnyScan<int>(MakeAnyScan(std::list<int>{1, 2})).AsSpan().has_value());
+  EXPECT_FALSE(ConstScan<int>(MakeConstScan(std::set<int>{1, 2})).AsSpan().has_value());
+}
+
+TEST_F(AnyScanAccessTest, ForEachChunk) {
+  constexpr std::size_t kNumValues = 2 * AnyScan<int>::kChunkSize + 5;
+  std::list<int> list;
+  std::vector<int> vector;
+  for (std::size_t idx = 0; idx < kNumValues; ++idx) {
+    list.push_back(static_cast<int>(idx));
+    vector.push_back(static_cast<int>(idx));
+  }
+  const auto chunks = [](const ConstScan<int>& scan) {
+    std::vector<std::size_t> sizes;
+    std::vector<int> values;
+    scan.ForEachChunk([&](std::span<const int* const> chunk) {
+      sizes.push_back(chunk.size());
+      for (const int* value : chunk) {
+        values.push_back(*value);
+      }
+    });
+    return std::make_pair(sizes, values);
+  };
+  const auto [list_sizes, list_values] = chunks(MakeConstScan(list));
+  EXPECT_THAT(list_sizes, ElementsAre(AnyScan<int>::kChunkSize, AnyScan<int>::kChunkSize, 5));
+  EXPECT_THAT(list_values, ElementsAreArray(vector));
+  const auto [vector_sizes, vector_values] = chunks(MakeConstScan(vector));
+  EXPECT_THAT(vector_sizes, ElementsAre(AnyScan<int>::kChunkSize, AnyScan<int>::kChunkSize, 5));
+  EXPECT_THAT(vector_values, ElementsAreArray(vector));
+  EXPECT_THAT(chunks(MakeConstScan(std::set<int>{})).first, IsEmpty());
+}
+
+TEST_F(AnyScanAccessTest, ForEach) {
+  const auto collect = [](const ConstScan<std::string>& scan) {
+    std::vector<std::string> result;
+    scan.ForEach([&result](const std::string& value) { result.push_back(value); });
+    return result;
+  };
+  EXPECT_THAT(collect(MakeConstScan(std::vector<std::string>{"a", "b"})), ElementsAre("a", "b"));
+  EXPECT_THAT(collect(MakeConstScan(std::list<std::string>{"a", "b"})), ElementsAre("a", "b"));
+  EXPECT_THAT(collect(MakeConstScan(std::set<std::string>{"a", "b"})), ElementsAre("a", "b"));
+  EXPECT_THAT(collect({"a", "b"}), ElementsAre("a", "b"));
+  const std::list<std::string> list{"a", "b"};
+  std::vector<std::string_view> converted;
+  ConvertingScan<std::string_view>(MakeConvertingScan(list))
+      .ForEach([&converted](std::string_view value) { converted.push_back(value); });
+  EXPECT_THAT(converted, ElementsAre("a", "b"));
+}
+
+TEST_F(AnyScanAccessTest, ForEachModifiesElements) {
+  std::list<int> list{1, 2, 3};
+  AnyScan<int>(MakeAnyScan(list)).ForEach([](int& value) { value *= 2; });
+  EXPECT_THAT(list, ElementsAre(2, 4, 6));
+}
+
+TEST_F(AnyScanAccessTest, IteratorsCompareByPosition) {
+  const std::list<int> list{1, 2};
+  const ConstScan<int> scan = MakeConstScan(list);
+  auto lhs = scan.begin();
+  auto rhs = scan.begin();
+  EXPECT_TRUE(lhs == rhs);
+  ++rhs;
+  EXPECT_FALSE(lhs == rhs);
+  ++lhs;
+  EXPECT_TRUE(lhs == rhs);
+  auto copy = lhs;
+  ++lhs;
+  EXPECT_TRUE(lhs == scan.end());
+  EXPECT_THAT(*copy, 2);
+  copy = lhs;
+  EXPECT_TRUE(copy == scan.end());
+}
+
+// A container whose iterator is too large to be stored inline.
+class LargeIteratorContainer {
+ public:
+  using value_type = int;
+  using difference_type = std::ptrdiff_t;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = int;
+    using pointer = const int*;
+    using reference = const int&;
+
+    const_iterator() = default;
+
+    explicit const_iterator(std::vector<int>::const_iterator pos) : pos_(pos) {}
+
+    const int& operator*() const { return *pos_; }
+
+    const_iterator& operator++() {
+      ++pos_;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator result = *this;
+      ++pos_;
+      return result;
+    }
+
+    bool operator==(const const_iterator& other) const { return pos_ == other.pos_; }
+
+   private:
+    std::vector<int>::const_iterator pos_;
+    std::array<char, 128> padding_{};
+  };
+
+  using iterator = const_iterator;
+
+  explicit LargeIteratorContainer(std::vector<int> values) : values_(std::move(values)) {}
+
+  const_iterator begin() const { return const_iterator(values_.begin()); }
+
+  const_iterator end() const { return const_iterator(values_.end()); }
+
+  bool empty() const { return values_.empty(); }
+
+  std::size_t size() const { return values_.size(); }
+
+ private:
+  std::vector<int> values_;
+};
+
+TEST_F(AnyScanAccessTest, LargeIterators) {
+  const LargeIteratorContainer data({1, 2, 3});
+  EXPECT_THAT(ConstTester<int>(MakeConstScan(data)), ElementsAre(1, 2, 3));
+  const ConstScan<int> scan = MakeConstScan(data);
+  auto iter = scan.begin();
+  auto copy = iter;
+  ++iter;
+  EXPECT_THAT(*copy, 1);
+  EXPECT_THAT(*iter, 2);
+  std::vector<int> values;
+  scan.ForEach([&values](int value) { values.push_back(value); });
+  EXPECT_THAT(values, ElementsAre(1, 2, 3));
+}
+
 }  // namespace
 }  // namespace mbo::container
@@ -0,0 +1,527 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_CONTAINER_BLOOM_FILTER_H_
+#define MBO_CONTAINER_BLOOM_FILTER_H_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mbo/config/require.h"
+#include "mbo/container/internal/little_endian.h"
+#include "mbo/hash/hash.h"
+#include "mbo/hash/hash_internal_util.h"
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+#endif
+
+namespace mbo::container {
+namespace container_internal {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+// Maps a uniform 64 bit value onto `[0, range)` without a division (Lemire's fast range reduction).
+inline uint64_t BloomFastRange(uint64_t value, uint64_t range) noexcept {
+  return hash::hash_internal::Mult128(value, range).h2;
+}
+
+// The most hashes `BloomOptimalGeometry` picks and that a serialized Bloom filter may have.
+inline constexpr std::size_t kBloomMaxHashes = 32;
+
+// Bits per key and number of hashes of an optimal Bloom filter for `expected_items` at `false_positive_rate`.
+struct BloomGeometry {
+  std::size_t num_bits = 0;
+  std::size_t num_hashes = 0;
+};
+
+inline BloomGeometry BloomOptimalGeometry(std::size_t expected_items, double false_positive_rate) {
+  MBO_CONFIG_REQUIRE(false_positive_rate > 0.0 && false_positive_rate < 1.0, "False positive rate must be in (0, 1).");
+  const double items = static_cast<double>(std::max<std::size_t>(expected_items, 1));
+  const double ln2 = std::log(2.0);
+  const double bits = std::ceil(-items * std::log(false_positive_rate) / (ln2 * ln2));
+  const double hashes = std::round(bits / items * ln2);
+  return {
+      .num_bits = static_cast<std::size_t>(bits),
+      .num_hashes = static_cast<std::size_t>(std::clamp(hashes, 1.0, static_cast<double>(kBloomMaxHashes))),
+  };
+}
+
+// Header: magic, then `size` (bits or blocks), `num_hashes` and `seed`.
+inline constexpr std::size_t kBloomHeaderSize = 32;
+
+struct BloomHeader {
+  uint64_t size = 0;
+  uint64_t num_hashes = 0;
+  uint64_t seed = 0;
+};
+
+inline std::string BloomSerializeHeader(std::string_view magic, const BloomHeader& header, std::size_t num_words) {
+  std::string out;
+  out.reserve(kBloomHeaderSize + (8 * num_words));
+  out.append(magic);
+  AppendLittleEndian<uint64_t>(out, header.size);
+  AppendLittleEndian<uint64_t>(out, header.num_hashes);
+  AppendLittleEndian<uint64_t>(out, header.seed);
+  return out;
+}
+
+inline absl::StatusOr<BloomHeader> BloomParseHeader(std::string_view magic, std::string_view data) {
+  if (data.size() < kBloomHeaderSize || data.substr(0, magic.size()) != magic) {
+    return absl::InvalidArgumentError("Not a serialized Bloom filter of this type.");
+  }
+  const BloomHeader header{
+      .size = ReadLittleEndian<uint64_t>(data, 8),
+      .num_hashes = ReadLittleEndian<uint64_t>(data, 16),
+      .seed = ReadLittleEndian<uint64_t>(data, 24),
+  };
+  if (header.size == 0 || header.num_hashes == 0) {
+    return absl::InvalidArgumentError("Serialized Bloom filter has no bits or hashes.");
+  }
+  if (header.num_hashes > kBloomMaxHashes) {
+    return absl::InvalidArgumentError("Serialized Bloom filter has too many hashes.");
+  }
+  return header;
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace container_internal
+
+// NOLINTBEGIN(*-magic-numbers)
+
+// A classic Bloom filter: a membership test without false negatives and with a false positive rate determined by
+// bits per key and number of hashes (`ForCapacity` picks both for a target rate).
+//
+// The `k` bit positions of a key come from one `GetHash128` of the key using Kirsch-Mitzenmacher double hashing:
+// `bit[i] = h1 + i * h2`, reduced to the filter size without a division. The default algorithm (`jumbo`) produces two
+// independent 64 bit lanes, which is what double hashing needs.
+//
+// Every probe of a key may touch a different cache line. For large filters `BlockedBloomFilter` is much faster.
+//
+// The bulk operations `InsertMany` and `MayContainMany` hash a batch of keys first and prefetch the first cache line
+// of every key, so the memory accesses of different keys overlap.
+//
+// Filters with the same size, number of hashes and seed can be merged (`Merge`), and `Serialize` / `Deserialize`
+// store them as bytes. The hash algorithm is not part of the serialized form: both sides must use the same `Algo`.
+template<typename Algo = hash::Default128HashAlgorithm>
+requires(hash::IsHashAlgorithm<Algo>)
+class BloomFilter final {
+ public:
+  static constexpr std::string_view kMagic = "MBOBLOOM";
+
+  // A filter for `expected_items` with about `false_positive_rate` once they are all inserted.
+  static BloomFilter ForCapacity(
+      std::size_t expected_items,
+      double false_positive_rate,
+      uint64_t seed = hash::kDefaultSeed) {
+    const container_internal::BloomGeometry geometry =
+        container_internal::BloomOptimalGeometry(expected_items, false_positive_rate);
+    return BloomFilter(geometry.num_bits, geometry.num_hashes, seed);
+  }
+
+  // A filter with at least `num_bits` (rounded up to a multiple of 64) and `num_hashes` bits per key.
+  BloomFilter(std::size_t num_bits, std::size_t num_hashes, uint64_t seed = hash::kDefaultSeed)
+      : num_bits_(((std::max<std::size_t>(num_bits, 1) + 63) / 64) * 64),
+        num_hashes_(num_hashes),
+        seed_(seed),
+        words_(num_bits_ / 64) {
+    MBO_CONFIG_REQUIRE(num_hashes > 0, "Need at least one hash.");
+  }
+
+  std::size_t num_bits() const noexcept { return num_bits_; }
+
+  std::size_t num_hashes() const noexcept { return num_hashes_; }
+
+  uint64_t seed() const noexcept { return seed_; }
+
+  // Number of bytes used by the bits.
+  std::size_t byte_size() const noexcept { return words_.size() * sizeof(uint64_t); }
+
+  void Insert(std::string_view key) noexcept { InsertHash(HashOf(key)); }
+
+  bool MayContain(std::string_view key) const noexcept { return MayContainHash(HashOf(key)); }
+
+  void InsertMany(std::span<const std::string_view> keys) noexcept {
+    ForEachBatch(keys, [this](const hash::Hash128& hash, std::size_t /*index*/) { InsertHash(hash); });
+  }
+
+  // Stores `MayContain` of each key in `results` (which must be at least as large) and returns the positive count.
+  std::size_t MayContainMany(std::span<const std::string_view> keys, std::span<bool> results) const {
+    MBO_CONFIG_REQUIRE(results.size() >= keys.size(), "Results must be as large as the keys.");
+    std::size_t positives = 0;
+    ForEachBatch(keys, [&](const hash::Hash128& hash, std::size_t index) {
+      results[index] = MayContainHash(hash);
+      positives += results[index] ? 1 : 0;
+    });
+    return positives;
+  }
+
+  // Bitwise OR of `other` into this filter, afterwards this contains all keys of both.
+  absl::Status Merge(const BloomFilter& other) noexcept {
+    if (num_bits_ != other.num_bits_ || num_hashes_ != other.num_hashes_ || seed_ != other.seed_) {
+      return absl::InvalidArgumentError("Bloom filters differ in size, number of hashes or seed.");
+    }
+    for (std::size_t word = 0; word < words_.size(); ++word) {
+      words_[word] |= other.words_[word];
+    }
+    return absl::OkStatus();
+  }
+
+  void Clear() noexcept { std::fill(words_.begin(), words_.end(), 0); }
+
+  // Estimated number of inserted keys from the number of set bits (Swamidass and Baldi).
+  double EstimateCount() const noexcept {
+    std::size_t set_bits = 0;
+    for (const uint64_t word : words_) {
+      set_bits += static_cast<std::size_t>(std::popcount(word));
+    }
+    const double bits = static_cast<double>(num_bits_);
+    return -bits / static_cast<double>(num_hashes_) * std::log1p(-static_cast<double>(set_bits) / bits);
+  }
+
+  std::string Serialize() const {
+    std::string out = container_internal::BloomSerializeHeader(
+        kMagic, {.size = num_bits_, .num_hashes = num_hashes_, .seed = seed_}, words_.size());
+    for (const uint64_t word : words_) {
+      container_internal::AppendLittleEndian<uint64_t>(out, word);
+    }
+    return out;
+  }
+
+  static absl::StatusOr<BloomFilter> Deserialize(std::string_view data) {
+    const absl::StatusOr<container_internal::BloomHeader> header =
+        container_internal::BloomParseHeader(kMagic, data);
+    if (!header.ok()) {
+      return header.status();
+    }
+    if (header->size % 64 != 0 || data.size() != container_internal::kBloomHeaderSize + (header->size / 8)) {
+      return absl::InvalidArgumentError("Serialized Bloom filter has the wrong size.");
+    }
+    BloomFilter filter(header->size, header->num_hashes, header->seed);
+    for (std::size_t word = 0; word < filter.words_.size(); ++word) {
+      filter.words_[word] =
+          container_internal::ReadLittleEndian<uint64_t>(data, container_internal::kBloomHeaderSize + (8 * word));
+    }
+    return filter;
+  }
+
+  friend bool operator==(const BloomFilter& lhs, const BloomFilter& rhs) noexcept = default;
+
+ private:
+  static constexpr std::size_t kBatchSize = 16;
+
+  hash::Hash128 HashOf(std::string_view key) const noexcept { return hash::Hasher<Algo>::GetHash128(key, seed_); }
+
+  // The position of the first bit, whose word is prefetched by the bulk operations.
+  std::size_t FirstBit(const hash::Hash128& hash) const noexcept {
+    return static_cast<std::size_t>(container_internal::BloomFastRange(hash.h1, num_bits_));
+  }
+
+  void InsertHash(const hash::Hash128& hash) noexcept {
+    uint64_t combined = hash.h1;
+    for (std::size_t idx = 0; idx < num_hashes_; ++idx) {
+      const std::size_t bit = static_cast<std::size_t>(container_internal::BloomFastRange(combined, num_bits_));
+      words_[bit / 64] |= uint64_t{1} << (bit % 64);
+      combined += hash.h2;
+    }
+  }
+
+  bool MayContainHash(const hash::Hash128& hash) const noexcept {
+    uint64_t combined = hash.h1;
+    for (std::size_t idx = 0; idx < num_hashes_; ++idx) {
+      const std::size_t bit = static_cast<std::size_t>(container_internal::BloomFastRange(combined, num_bits_));
+      if ((words_[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+        return false;
+      }
+      combined += hash.h2;
+    }
+    return true;
+  }
+
+  template<typename Func>
+  void ForEachBatch(std::span<const std::string_view> keys, Func func) const noexcept {
+    std::array<hash::Hash128, kBatchSize> hashes{};
+    for (std::size_t start = 0; start < keys.size(); start += kBatchSize) {
+      const std::size_t count = std::min(kBatchSize, keys.size() - start);
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        hashes[idx] = HashOf(keys[start + idx]);
+        __builtin_prefetch(&words_[FirstBit(hashes[idx]) / 64]);
+      }
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        func(hashes[idx], start + idx);
+      }
+    }
+  }
+
+  std::size_t num_bits_;
+  std::size_t num_hashes_;
+  uint64_t seed_;
+  std::vector<uint64_t> words_;
+};
+
+// A cache line blocked Bloom filter: a key selects one 64 byte block (with `h1`) and all of its `k` bits are in that
+// block (double hashing on `h2`, one bit per 64 bit word and round of 8). So every lookup and insert touches a single
+// cache line, and with AVX2 the bits of a key are computed, set and tested as one 512 bit mask in two registers.
+//
+// The price is a somewhat higher false positive rate than a classic filter of the same size, as keys do not spread
+// evenly over the blocks. `ForCapacity` compensates with 5% to 15% more bits.
+//
+// The interface is that of `BloomFilter`.
+template<typename Algo = hash::Default128HashAlgorithm>
+requires(hash::IsHashAlgorithm<Algo>)
+class BlockedBloomFilter final {
+ public:
+  static constexpr std::string_view kMagic = "MBOBLOCK";
+  static constexpr std::size_t kBlockBits = 512;
+
+  static BlockedBloomFilter ForCapacity(
+      std::size_t expected_items,
+      double false_positive_rate,
+      uint64_t seed = hash::kDefaultSeed) {
+    // Blocking needs more bits to reach the rate of a classic filter, the more the lower the rate. This adds 5% at
+    // 10%, 10% at 1% and 15% at 0.1%, which keeps the actual rate below the requested one.
+    const container_internal::BloomGeometry geometry =
+        container_internal::BloomOptimalGeometry(expected_items, false_positive_rate);
+    const double extra = std::max(0.0, -std::log10(false_positive_rate) / 20.0);
+    const auto num_bits = static_cast<std::size_t>(static_cast<double>(geometry.num_bits) * (1.0 + extra));
+    return BlockedBloomFilter(num_bits, geometry.num_hashes, seed);
+  }
+
+  // A filter with at least `num_bits` (rounded up to a multiple of `kBlockBits`) and `num_hashes` bits per key.
+  BlockedBloomFilter(std::size_t num_bits, std::size_t num_hashes, uint64_t seed = hash::kDefaultSeed)
+      : num_hashes_(num_hashes),
+        seed_(seed),
+        blocks_((std::max<std::size_t>(num_bits, 1) + kBlockBits - 1) / kBlockBits) {
+    MBO_CONFIG_REQUIRE(num_hashes > 0, "Need at least one hash.");
+  }
+
+  std::size_t num_bits() const noexcept { return blocks_.size() * kBlockBits; }
+
+  std::size_t num_blocks() const noexcept { return blocks_.size(); }
+
+  std::size_t num_hashes() const noexcept { return num_hashes_; }
+
+  uint64_t seed() const noexcept { return seed_; }
+
+  std::size_t byte_size() const noexcept { return blocks_.size() * sizeof(Block); }
+
+  void Insert(std::string_view key) noexcept { InsertHash(HashOf(key)); }
+
+  bool MayContain(std::string_view key) const noexcept { return MayContainHash(HashOf(key)); }
+
+  void InsertMany(std::span<const std::string_view> keys) noexcept {
+    ForEachBatch(keys, [this](const hash::Hash128& hash, std::size_t /*index*/) { InsertHash(hash); });
+  }
+
+  std::size_t MayContainMany(std::span<const std::string_view> keys, std::span<bool> results) const {
+    MBO_CONFIG_REQUIRE(results.size() >= keys.size(), "Results must be as large as the keys.");
+    std::size_t positives = 0;
+    ForEachBatch(keys, [&](const hash::Hash128& hash, std::size_t index) {
+      results[index] = MayContainHash(hash);
+      positives += results[index] ? 1 : 0;
+    });
+    return positives;
+  }
+
+  absl::Status Merge(const BlockedBloomFilter& other) noexcept {
+    if (blocks_.size() != other.blocks_.size() || num_hashes_ != other.num_hashes_ || seed_ != other.seed_) {
+      return absl::InvalidArgumentError("Bloom filters differ in size, number of hashes or seed.");
+    }
+    for (std::size_t block = 0; block < blocks_.size(); ++block) {
+      for (std::size_t word = 0; word < kWords; ++word) {
+        blocks_[block].words[word] |= other.blocks_[block].words[word];
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  void Clear() noexcept { std::fill(blocks_.begin(), blocks_.end(), Block{}); }
+
+  std::string Serialize() const {
+    std::string out = container_internal::BloomSerializeHeader(
+        kMagic, {.size = blocks_.size(), .num_hashes = num_hashes_, .seed = seed_}, blocks_.size() * kWords);
+    for (const Block& block : blocks_) {
+      for (const uint64_t word : block.words) {
+        container_internal::AppendLittleEndian<uint64_t>(out, word);
+      }
+    }
+    return out;
+  }
+
+  static absl::StatusOr<BlockedBloomFilter> Deserialize(std::string_view data) {
+    const absl::StatusOr<container_internal::BloomHeader> header =
+        container_internal::BloomParseHeader(kMagic, data);
+    if (!header.ok()) {
+      return header.status();
+    }
+    if ((data.size() - container_internal::kBloomHeaderSize) / sizeof(Block) != header->size
+        || (data.size() - container_internal::kBloomHeaderSize) % sizeof(Block) != 0) {
+      return absl::InvalidArgumentError("Serialized Bloom filter has the wrong size.");
+    }
+    BlockedBloomFilter filter(header->size * kBlockBits, header->num_hashes, header->seed);
+    std::size_t pos = container_internal::kBloomHeaderSize;
+    for (Block& block : filter.blocks_) {
+      for (uint64_t& word : block.words) {
+        word = container_internal::ReadLittleEndian<uint64_t>(data, pos);
+        pos += 8;
+      }
+    }
+    return filter;
+  }
+
+  friend bool operator==(const BlockedBloomFilter& lhs, const BlockedBloomFilter& rhs) noexcept {
+    return lhs.num_hashes_ == rhs.num_hashes_ && lhs.seed_ == rhs.seed_
+           && std::equal(
+               lhs.blocks_.begin(), lhs.blocks_.end(), rhs.blocks_.begin(), rhs.blocks_.end(),
+               [](const Block& lhs_block, const Block& rhs_block) { return lhs_block.words == rhs_block.words; });
+  }
+
+ private:
+  static constexpr std::size_t kWords = kBlockBits / 64;
+  static constexpr std::size_t kBatchSize = 16;
+
+  hash::Hash128 HashOf(std::string_view key) const noexcept { return hash::Hasher<Algo>::GetHash128(key, seed_); }
+
+  struct alignas(64) Block {
+    std::array<uint64_t, kWords> words{};
+  };
+
+  std::size_t BlockIndex(const hash::Hash128& hash) const noexcept {
+    return static_cast<std::size_t>(container_internal::BloomFastRange(hash.h1, blocks_.size()));
+  }
+
+  // The `k` bits of a key in its block use double hashing on the two 32 bit halves of `h2`: bit `i` goes into word
+  // `(start + i) % 8` at the position given by the top 6 bits of `lo + i * hi` (a split block filter). The `start` word
+  // comes from the low bits of `h1` (the block index uses its high bits), so that small `k` still use all words.
+  //
+  // With AVX2 the mask is computed, set and tested in two 256 bit registers, 8 bits at a time. Otherwise each bit is
+  // handled in its 64 bit word, and queries stop at the first missing bit.
+
+  static std::size_t StartWord(const hash::Hash128& hash) noexcept {
+    return static_cast<std::size_t>(hash.h1 % kWords);
+  }
+
+  // NOLINTBEGIN(*-reinterpret-cast)
+
+#if defined(__AVX2__)
+  struct Mask {
+    __m256i lo;  // Words 0 to 3.
+    __m256i hi;  // Words 4 to 7.
+  };
+
+  Mask MaskOf(const hash::Hash128& hash) const noexcept {
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i base = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(hash.h2)));
+    const __m256i step = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(hash.h2 >> 32U) | 1U));
+    const __m256i num_hashes = _mm256_set1_epi32(static_cast<int>(num_hashes_));
+    const __m256i one = _mm256_set1_epi64x(1);
+    // Lane (word) `l` takes hash `(l - start) % 8` of each round.
+    const __m256i order = _mm256_and_si256(
+        _mm256_sub_epi32(lanes, _mm256_set1_epi32(static_cast<int>(StartWord(hash)))), _mm256_set1_epi32(7));
+    Mask mask{.lo = _mm256_setzero_si256(), .hi = _mm256_setzero_si256()};
+    for (std::size_t round = 0; round < num_hashes_; round += 8) {
+      const __m256i index = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(round)), order);
+      const __m256i active = _mm256_cmpgt_epi32(num_hashes, index);
+      const __m256i pos = _mm256_srli_epi32(_mm256_add_epi32(base, _mm256_mullo_epi32(index, step)), 26);
+      const __m256i bits_lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(pos)));
+      const __m256i bits_hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(pos, 1)));
+      const __m256i active_lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(active));
+      const __m256i active_hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(active, 1));
+      mask.lo = _mm256_or_si256(mask.lo, _mm256_and_si256(bits_lo, active_lo));
+      mask.hi = _mm256_or_si256(mask.hi, _mm256_and_si256(bits_hi, active_hi));
+    }
+    return mask;
+  }
+
+  void InsertHash(const hash::Hash128& hash) noexcept {
+    const Mask mask = MaskOf(hash);
+    auto* const words = reinterpret_cast<__m256i*>(blocks_[BlockIndex(hash)].words.data());
+    _mm256_store_si256(&words[0], _mm256_or_si256(_mm256_load_si256(&words[0]), mask.lo));
+    _mm256_store_si256(&words[1], _mm256_or_si256(_mm256_load_si256(&words[1]), mask.hi));
+  }
+
+  bool MayContainHash(const hash::Hash128& hash) const noexcept {
+    const Mask mask = MaskOf(hash);
+    const auto* const words = reinterpret_cast<const __m256i*>(blocks_[BlockIndex(hash)].words.data());
+    const __m256i missing = _mm256_or_si256(
+        _mm256_andnot_si256(_mm256_load_si256(&words[0]), mask.lo),
+        _mm256_andnot_si256(_mm256_load_si256(&words[1]), mask.hi));
+    return _mm256_testz_si256(missing, missing) != 0;
+  }
+#else   // defined(__AVX2__)
+  void InsertHash(const hash::Hash128& hash) noexcept {
+    Block& block = blocks_[BlockIndex(hash)];
+    const std::size_t start = StartWord(hash);
+    uint32_t combined = static_cast<uint32_t>(hash.h2);
+    const uint32_t step = static_cast<uint32_t>(hash.h2 >> 32U) | 1U;
+    for (std::size_t idx = 0; idx < num_hashes_; ++idx) {
+      block.words[(start + idx) % kWords] |= uint64_t{1} << (combined >> 26U);
+      combined += step;
+    }
+  }
+
+  bool MayContainHash(const hash::Hash128& hash) const noexcept {
+    const Block& block = blocks_[BlockIndex(hash)];
+    const std::size_t start = StartWord(hash);
+    uint32_t combined = static_cast<uint32_t>(hash.h2);
+    const uint32_t step = static_cast<uint32_t>(hash.h2 >> 32U) | 1U;
+    for (std::size_t idx = 0; idx < num_hashes_; ++idx) {
+      if ((block.words[(start + idx) % kWords] & (uint64_t{1} << (combined >> 26U))) == 0) {
+        return false;
+      }
+      combined += step;
+    }
+    return true;
+  }
+#endif  // defined(__AVX2__)
+
+  // NOLINTEND(*-reinterpret-cast)
+
+  template<typename Func>
+  void ForEachBatch(std::span<const std::string_view> keys, Func func) const noexcept {
+    std::array<hash::Hash128, kBatchSize> hashes{};
+    for (std::size_t start = 0; start < keys.size(); start += kBatchSize) {
+      const std::size_t count = std::min(kBatchSize, keys.size() - start);
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        hashes[idx] = HashOf(keys[start + idx]);
+        __builtin_prefetch(&blocks_[BlockIndex(hashes[idx])]);
+      }
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        func(hashes[idx], start + idx);
+      }
+    }
+  }
+
+  std::size_t num_hashes_;
+  uint64_t seed_;
+  std::vector<Block> blocks_;
+};
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace mbo::container
+
+#endif  // MBO_CONTAINER_BLOOM_FILTER_H_
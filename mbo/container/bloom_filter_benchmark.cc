@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput of `BloomFilter` and `BlockedBloomFilter` for single and bulk inserts and queries. The argument is the
+// number of keys the filter is sized for (at 1% false positives) and filled with.
+// Run with: bazel run -c opt //mbo/container:bloom_filter_benchmark
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mbo/container/bloom_filter.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+constexpr std::size_t kNumQueries = 1 << 16;
+
+// Keys of 8 to 40 characters, the first `size` are inserted, the rest are queries that half hit and half miss.
+struct Keys {
+  explicit Keys(std::size_t size) {
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+    std::mt19937_64 rng(42);
+    for (std::size_t idx = 0; idx < size + (kNumQueries / 2); ++idx) {
+      std::string key(8 + (rng() % 33), ' ');
+      for (char& chr : key) {
+        chr = static_cast<char>('a' + (rng() % 26));
+      }
+      storage.push_back(std::move(key));
+    }
+    inserted.assign(storage.begin(), storage.begin() + static_cast<std::ptrdiff_t>(size));
+    for (std::size_t idx = 0; idx < kNumQueries; ++idx) {
+      queries.push_back(idx % 2 == 0 ? inserted[rng() % size] : storage[size + (idx / 2)]);
+    }
+  }
+
+  std::vector<std::string> storage;
+  std::vector<std::string_view> inserted;
+  std::vector<std::string_view> queries;
+};
+
+template<typename Filter>
+Filter MakeFilter(const Keys& keys) {
+  auto filter = Filter::ForCapacity(keys.inserted.size(), 0.01);
+  filter.InsertMany(keys.inserted);
+  return filter;
+}
+
+template<typename Filter>
+void BmInsert(benchmark::State& state) {
+  const Keys keys(static_cast<std::size_t>(state.range(0)));
+  auto filter = Filter::ForCapacity(keys.inserted.size(), 0.01);
+  std::size_t item = 0;
+  for (auto _ : state) {
+    filter.Insert(keys.queries[item]);
+    item = (item + 1) % kNumQueries;
+  }
+  benchmark::DoNotOptimize(filter);
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Filter>
+void BmInsertMany(benchmark::State& state) {
+  const Keys keys(static_cast<std::size_t>(state.range(0)));
+  auto filter = Filter::ForCapacity(keys.inserted.size(), 0.01);
+  for (auto _ : state) {
+    filter.InsertMany(keys.queries);
+  }
+  benchmark::DoNotOptimize(filter);
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kNumQueries));
+}
+
+template<typename Filter>
+void BmMayContain(benchmark::State& state) {
+  const Keys keys(static_cast<std::size_t>(state.range(0)));
+  const Filter filter = MakeFilter<Filter>(keys);
+  std::size_t item = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter.MayContain(keys.queries[item]));
+    item = (item + 1) % kNumQueries;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Filter>
+void BmMayContainMany(benchmark::State& state) {
+  const Keys keys(static_cast<std::size_t>(state.range(0)));
+  const Filter filter = MakeFilter<Filter>(keys);
+  const auto results = std::make_unique<bool[]>(kNumQueries);  // NOLINT(*-avoid-c-arrays)
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter.MayContainMany(keys.queries, {results.get(), kNumQueries}));
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kNumQueries));
+}
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+
+#define MBO_REGISTER_BENCHMARKS(Filter)                                        \
+  BENCHMARK(BmInsert<Filter>)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 22);     \
+  BENCHMARK(BmInsertMany<Filter>)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 22); \
+  BENCHMARK(BmMayContain<Filter>)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 22); \
+  BENCHMARK(BmMayContainMany<Filter>)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 22)
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+MBO_REGISTER_BENCHMARKS(BloomFilter<>);
+MBO_REGISTER_BENCHMARKS(BlockedBloomFilter<>);
+
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+#undef MBO_REGISTER_BENCHMARKS
+
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
+
+BENCHMARK_MAIN();  // NOLINT
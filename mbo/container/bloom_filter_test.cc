@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/container/bloom_filter.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/hash/hash.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::testing::DoubleNear;
+using ::testing::Ge;
+using ::testing::Gt;
+using ::testing::Lt;
+
+template<typename Filter>
+class BloomFilterTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  static std::vector<std::string> MakeKeys(std::string_view prefix, std::size_t count) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      keys.push_back(std::string(prefix) + std::to_string(idx));
+    }
+    return keys;
+  }
+
+  static std::vector<std::string_view> Views(const std::vector<std::string>& keys) {
+    return {keys.begin(), keys.end()};
+  }
+};
+
+using BloomFilterTypes = ::testing::Types<BloomFilter<>, BlockedBloomFilter<>, BloomFilter<hash::mumbo::Algorithm>>;
+TYPED_TEST_SUITE(BloomFilterTest, BloomFilterTypes);
+
+TYPED_TEST(BloomFilterTest, Empty) {
+  const auto filter = TypeParam::ForCapacity(100, 0.01);
+  EXPECT_THAT(filter.num_bits(), Ge(100));
+  EXPECT_THAT(filter.num_hashes(), Gt(0));
+  EXPECT_FALSE(filter.MayContain(""));
+  EXPECT_FALSE(filter.MayContain("key"));
+}
+
+TYPED_TEST(BloomFilterTest, NoFalseNegatives) {
+  const std::vector<std::string> keys = TestFixture::MakeKeys("key_", 10'000);
+  auto filter = TypeParam::ForCapacity(keys.size(), 0.01);
+  for (const std::string& key : keys) {
+    filter.Insert(key);
+  }
+  for (const std::string& key : keys) {
+    ASSERT_TRUE(filter.MayContain(key)) << key;
+  }
+}
+
+// Inserts the expected number of keys and checks the rate of positives for keys that were never inserted.
+TYPED_TEST(BloomFilterTest, FalsePositiveRate) {
+  for (const double rate : {0.1, 0.01, 0.001}) {
+    const std::vector<std::string> keys = TestFixture::MakeKeys("key_", 20'000);
+    const std::vector<std::string> others = TestFixture::MakeKeys("other_", 200'000);
+    auto filter = TypeParam::ForCapacity(keys.size(), rate);
+    filter.InsertMany(TestFixture::Views(keys));
+    std::size_t positives = 0;
+    for (const std::string& key : others) {
+      positives += filter.MayContain(key) ? 1 : 0;
+    }
+    const double actual = static_cast<double>(positives) / static_cast<double>(others.size());
+    EXPECT_THAT(actual, Lt(rate * 1.3)) << "Target rate: " << rate;
+    EXPECT_THAT(actual, Gt(rate / 3)) << "Target rate: " << rate;
+  }
+}
+
+TYPED_TEST(BloomFilterTest, BulkMatchesSingle) {
+  const std::vector<std::string> keys = TestFixture::MakeKeys("key_", 1'000);
+  const std::vector<std::string> queries = TestFixture::MakeKeys("key_", 3'000);
+  auto single = TypeParam::ForCapacity(keys.size(), 0.05);
+  auto bulk = TypeParam::ForCapacity(keys.size(), 0.05);
+  for (const std::string& key : keys) {
+    single.Insert(key);
+  }
+  bulk.InsertMany(TestFixture::Views(keys));
+  EXPECT_TRUE(single == bulk);
+  const std::vector<std::string_view> views = TestFixture::Views(queries);
+  const auto results = std::make_unique<bool[]>(views.size());  // NOLINT(*-avoid-c-arrays)
+  const std::size_t positives = bulk.MayContainMany(views, {results.get(), views.size()});
+  std::size_t expected = 0;
+  for (std::size_t idx = 0; idx < views.size(); ++idx) {
+    ASSERT_EQ(results[idx], single.MayContain(views[idx])) << views[idx];
+    expected += results[idx] ? 1 : 0;
+  }
+  EXPECT_EQ(positives, expected);
+  EXPECT_THAT(positives, Ge(keys.size()));
+}
+
+TYPED_TEST(BloomFilterTest, SerializeRoundTrip) {
+  const std::vector<std::string> keys = TestFixture::MakeKeys("key_", 500);
+  auto filter = TypeParam::ForCapacity(keys.size(), 0.01, 42);
+  filter.InsertMany(TestFixture::Views(keys));
+  const std::string bytes = filter.Serialize();
+  EXPECT_EQ(bytes.size(), 32 + filter.byte_size());
+  const auto restored = TypeParam::Deserialize(bytes);
+  ASSERT_TRUE(restored.ok()) << restored.status();
+  EXPECT_TRUE(*restored == filter);
+  EXPECT_EQ(restored->seed(), 42);
+  for (const std::string& key : keys) {
+    ASSERT_TRUE(restored->MayContain(key)) << key;
+  }
+}
+
+TYPED_TEST(BloomFilterTest, DeserializeErrors) {
+  const auto filter = TypeParam::ForCapacity(100, 0.01);
+  const std::string bytes = filter.Serialize();
+  EXPECT_EQ(TypeParam::Deserialize("").status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(
+      TypeParam::Deserialize(bytes.substr(0, bytes.size() - 1)).status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(TypeParam::Deserialize(absl::StrCat(bytes, "x")).status().code(), absl::StatusCode::kInvalidArgument);
+  std::string bad_magic = bytes;
+  bad_magic[0] = 'X';
+  EXPECT_EQ(TypeParam::Deserialize(bad_magic).status().code(), absl::StatusCode::kInvalidArgument);
+  // The number of hashes is a little endian `uint64_t` at offset 16.
+  std::string max_hashes = bytes;
+  max_hashes[16] = 32;
+  const auto restored = TypeParam::Deserialize(max_hashes);
+  ASSERT_TRUE(restored.ok()) << restored.status();
+  EXPECT_EQ(restored->num_hashes(), 32);
+  std::string too_many_hashes = bytes;
+  too_many_hashes[16] = 33;
+  EXPECT_EQ(TypeParam::Deserialize(too_many_hashes).status().code(), absl::StatusCode::kInvalidArgument);
+  std::string huge_hashes = bytes;
+  huge_hashes[23] = '\x80';
+  EXPECT_EQ(TypeParam::Deserialize(huge_hashes).status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+TYPED_TEST(BloomFilterTest, Merge) {
+  const std::vector<std::string> lhs_keys = TestFixture::MakeKeys("lhs_", 1'000);
+  const std::vector<std::string> rhs_keys = TestFixture::MakeKeys("rhs_", 1'000);
+  auto lhs = TypeParam::ForCapacity(2'000, 0.01);
+  auto rhs = TypeParam::ForCapacity(2'000, 0.01);
+  lhs.InsertMany(TestFixture::Views(lhs_keys));
+  rhs.InsertMany(TestFixture::Views(rhs_keys));
+  auto both = TypeParam::ForCapacity(2'000, 0.01);
+  both.InsertMany(TestFixture::Views(lhs_keys));
+  both.InsertMany(TestFixture::Views(rhs_keys));
+  ASSERT_TRUE(lhs.Merge(rhs).ok());
+  EXPECT_TRUE(lhs == both);
+  for (const std::string& key : rhs_keys) {
+    ASSERT_TRUE(lhs.MayContain(key)) << key;
+  }
+  lhs.Clear();
+  EXPECT_FALSE(lhs.MayContain(rhs_keys[0]));
+}
+
+TYPED_TEST(BloomFilterTest, MergeMismatch) {
+  auto filter = TypeParam::ForCapacity(1'000, 0.01);
+  EXPECT_EQ(filter.Merge(TypeParam::ForCapacity(10'000, 0.01)).code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(filter.Merge(TypeParam::ForCapacity(1'000, 0.01, 1)).code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(
+      filter.Merge(TypeParam(filter.num_bits(), filter.num_hashes() + 1)).code(), absl::StatusCode::kInvalidArgument);
+}
+
+struct BloomFilterOtherTest : ::testing::Test {
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+};
+
+TEST_F(BloomFilterOtherTest, EstimateCount) {
+  auto filter = BloomFilter<>::ForCapacity(10'000, 0.01);
+  for (std::size_t idx = 0; idx < 5'000; ++idx) {
+    filter.Insert(absl::StrCat(idx));
+  }
+  EXPECT_THAT(filter.EstimateCount(), DoubleNear(5'000, 150));
+}
+
+TEST_F(BloomFilterOtherTest, BlockedGeometry) {
+  const BlockedBloomFilter<> filter(1'000, 7);
+  EXPECT_EQ(filter.num_blocks(), 2);
+  EXPECT_EQ(filter.num_bits(), 1'024);
+  EXPECT_EQ(filter.byte_size(), 128);
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_CONTAINER_COUNT_MIN_SKETCH_H_
+#define MBO_CONTAINER_COUNT_MIN_SKETCH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>  // IWYU pragma: keep
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mbo/config/require.h"
+#include "mbo/container/internal/little_endian.h"
+#include "mbo/hash/hash.h"
+#include "mbo/hash/hash_internal_util.h"
+
+namespace mbo::container {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+// A Count-Min sketch: approximate frequencies of keys in a stream. `Estimate` never under-counts, and with probability
+// `1 - delta` over-counts by at most `epsilon * total()` for `ForError(epsilon, delta)`.
+//
+// The sketch has `depth` rows of `width` counters. Each key picks one counter per row using double hashing of a single
+// `GetHash128` call. `Add` uses conservative update: it only raises the counters of the key that are below the new
+// minimum estimate, which keeps the estimates of all other keys (that share some of the counters) lower than the
+// classic update with the same guarantees. Counters saturate rather than wrap.
+//
+// Sketches with the same geometry and seed can be merged by adding their counters, the result is still an upper
+// bound for every key (though not as tight as conservative updates over the combined stream). `Serialize` /
+// `Deserialize` store a sketch as bytes for map-reduce style aggregation. The hasher is not part of the serialized
+// form, both sides must use the same `Hasher`.
+//
+// `Hasher` is an `mbo::hash::Hasher<Algo>`, e.g. `Hasher<siphash::Algorithm>` if keys may be adversarial.
+template<typename Hasher = hash::DefaultHasher, std::unsigned_integral Counter = uint32_t>
+class CountMinSketch final {
+ public:
+  static constexpr std::string_view kMagic = "MBOCMSK1";
+
+  CountMinSketch(std::size_t width, std::size_t depth, uint64_t seed = hash::kDefaultSeed)
+      : width_(width), depth_(depth), seed_(seed), counters_(width * depth) {
+    MBO_CONFIG_REQUIRE(width > 0 && depth > 0, "Width and depth must be positive.");
+  }
+
+  // A sketch whose estimates exceed the true count by at most `epsilon * total()` with probability `1 - delta`.
+  static CountMinSketch ForError(double epsilon, double delta, uint64_t seed = hash::kDefaultSeed) {
+    MBO_CONFIG_REQUIRE(epsilon > 0.0 && epsilon < 1.0, "Epsilon must be in (0, 1).");
+    MBO_CONFIG_REQUIRE(delta > 0.0 && delta < 1.0, "Delta must be in (0, 1).");
+    return CountMinSketch(
+        static_cast<std::size_t>(std::ceil(std::exp(1.0) / epsilon)),
+        static_cast<std::size_t>(std::ceil(std::log(1.0 / delta))), seed);
+  }
+
+  std::size_t width() const noexcept { return width_; }
+
+  std::size_t depth() const noexcept { return depth_; }
+
+  uint64_t seed() const noexcept { return seed_; }
+
+  // The sum of all counts added (saturating).
+  Counter total() const noexcept { return total_; }
+
+  std::size_t byte_size() const noexcept { return counters_.size() * sizeof(Counter); }
+
+  void Add(std::string_view key, Counter count = 1) {
+    const hash::Hash128 hash = Hasher::GetHash128(key, seed_);
+    std::size_t* const index = Indices(hash);
+    Counter min_count = std::numeric_limits<Counter>::max();
+    for (std::size_t row = 0; row < depth_; ++row) {
+      min_count = std::min(min_count, counters_[index[row]]);
+    }
+    const Counter target = SaturatingAdd(min_count, count);
+    for (std::size_t row = 0; row < depth_; ++row) {
+      counters_[index[row]] = std::max(counters_[index[row]], target);
+    }
+    total_ = SaturatingAdd(total_, count);
+  }
+
+  // The estimated count of `key`: never below the true count.
+  Counter Estimate(std::string_view key) const noexcept {
+    const hash::Hash128 hash = Hasher::GetHash128(key, seed_);
+    Counter min_count = std::numeric_limits<Counter>::max();
+    for (std::size_t row = 0; row < depth_; ++row) {
+      min_count = std::min(min_count, counters_[Index(hash, row)]);
+    }
+    return min_count;
+  }
+
+  // Adds all counts of `other` to this sketch.
+  absl::Status Merge(const CountMinSketch& other) {
+    if (width_ != other.width_ || depth_ != other.depth_ || seed_ != other.seed_) {
+      return absl::InvalidArgumentError("CountMinSketch sketches differ in width, depth or seed.");
+    }
+    for (std::size_t pos = 0; pos < counters_.size(); ++pos) {
+      counters_[pos] = SaturatingAdd(counters_[pos], other.counters_[pos]);
+    }
+    total_ = SaturatingAdd(total_, other.total_);
+    return absl::OkStatus();
+  }
+
+  void Clear() noexcept {
+    std::fill(counters_.begin(), counters_.end(), Counter{0});
+    total_ = 0;
+  }
+
+  // Format: magic, counter size, width, depth, seed, total (u64 each), then the counters row by row (each
+  // `sizeof(Counter)` bytes).
+  std::string Serialize() const {
+    std::string out;
+    out.reserve(kHeaderSize + byte_size());
+    out.append(kMagic);
+    container_internal::AppendLittleEndian<uint64_t>(out, sizeof(Counter));
+    container_internal::AppendLittleEndian<uint64_t>(out, width_);
+    container_internal::AppendLittleEndian<uint64_t>(out, depth_);
+    container_internal::AppendLittleEndian<uint64_t>(out, seed_);
+    container_internal::AppendLittleEndian<uint64_t>(out, total_);
+    for (const Counter counter : counters_) {
+      container_internal::AppendLittleEndian<Counter>(out, counter);
+    }
+    return out;
+  }
+
+  static absl::StatusOr<CountMinSketch> Deserialize(std::string_view data) {
+    if (data.size() < kHeaderSize || data.substr(0, kMagic.size()) != kMagic) {
+      return absl::InvalidArgumentError("Not a serialized CountMinSketch.");
+    }
+    if (container_internal::ReadLittleEndian<uint64_t>(data, 8) != sizeof(Counter)) {
+      return absl::InvalidArgumentError("Serialized CountMinSketch has a different counter type.");
+    }
+    const uint64_t width = container_internal::ReadLittleEndian<uint64_t>(data, 16);
+    const uint64_t depth = container_internal::ReadLittleEndian<uint64_t>(data, 24);
+    if (width == 0 || depth == 0 || width > (data.size() / sizeof(Counter)) / depth
+        || data.size() - kHeaderSize != width * depth * sizeof(Counter)) {
+      return absl::InvalidArgumentError("Serialized CountMinSketch has the wrong size.");
+    }
+    CountMinSketch sketch(width, depth, container_internal::ReadLittleEndian<uint64_t>(data, 32));
+    sketch.total_ = static_cast<Counter>(container_internal::ReadLittleEndian<uint64_t>(data, 40));
+    for (std::size_t pos = 0; pos < sketch.counters_.size(); ++pos) {
+      sketch.counters_[pos] =
+          container_internal::ReadLittleEndian<Counter>(data, kHeaderSize + (pos * sizeof(Counter)));
+    }
+    return sketch;
+  }
+
+  friend bool operator==(const CountMinSketch& lhs, const CountMinSketch& rhs) noexcept {
+    return lhs.width_ == rhs.width_ && lhs.depth_ == rhs.depth_ && lhs.seed_ == rhs.seed_ && lhs.total_ == rhs.total_
+           && lhs.counters_ == rhs.counters_;
+  }
+
+ private:
+  static constexpr std::size_t kHeaderSize = 48;
+
+  static Counter SaturatingAdd(Counter lhs, Counter rhs) noexcept {
+    const Counter sum = lhs + rhs;
+    return sum < lhs ? std::numeric_limits<Counter>::max() : sum;
+  }
+
+  // The counter of `row`, rows are stored one after another.
+  std::size_t Index(const hash::Hash128& hash, std::size_t row) const noexcept {
+    const uint64_t combined = hash.h1 + (row * (hash.h2 | 1));
+    const auto column = static_cast<std::size_t>(hash::hash_internal::Mult128(combined, width_).h2);
+    return (row * width_) + column;
+  }
+
+  // Computes the counter of every row into `scratch_`, so `Add` reads and updates the same counters.
+  std::size_t* Indices(const hash::Hash128& hash) {
+    if (scratch_.size() < depth_) {
+      scratch_.resize(depth_);
+    }
+    for (std::size_t row = 0; row < depth_; ++row) {
+      scratch_[row] = Index(hash, row);
+    }
+    return scratch_.data();
+  }
+
+  std::size_t width_;
+  std::size_t depth_;
+  uint64_t seed_;
+  Counter total_ = 0;
+  std::vector<Counter> counters_;
+  std::vector<std::size_t> scratch_;
+};
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace mbo::container
+
+#endif  // MBO_CONTAINER_COUNT_MIN_SKETCH_H_
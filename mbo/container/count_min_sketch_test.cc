@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/container/count_min_sketch.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "absl/log/initialize.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/hash/hash.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::testing::Ge;
+using ::testing::Le;
+
+template<typename Sketch>
+class CountMinSketchTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  // Adds a Zipf like stream: key `idx` is added `1000 / (idx + 1)` times.
+  static uint64_t AddZipf(Sketch& sketch, std::size_t num_keys) {
+    uint64_t total = 0;
+    for (std::size_t idx = 0; idx < num_keys; ++idx) {
+      const auto count = static_cast<uint32_t>(1'000 / (idx + 1));
+      sketch.Add(Key(idx), count);
+      total += count;
+    }
+    return total;
+  }
+
+  static std::string Key(std::size_t idx) { return "key_" + std::to_string(idx); }
+};
+
+using CountMinSketchTypes = ::testing::Types<
+    CountMinSketch<>,
+    CountMinSketch<hash::Hasher<hash::siphash::Algorithm>>,
+    CountMinSketch<hash::DefaultHasher, uint64_t>>;
+TYPED_TEST_SUITE(CountMinSketchTest, CountMinSketchTypes);
+
+TYPED_TEST(CountMinSketchTest, Empty) {
+  const auto sketch = TypeParam::ForError(0.01, 0.01);
+  EXPECT_EQ(sketch.width(), 272);
+  EXPECT_EQ(sketch.depth(), 5);
+  EXPECT_EQ(sketch.total(), 0);
+  EXPECT_EQ(sketch.Estimate("key"), 0);
+}
+
+TYPED_TEST(CountMinSketchTest, ErrorBound) {
+  constexpr double kEpsilon = 0.001;
+  auto sketch = TypeParam::ForError(kEpsilon, 0.01);
+  const uint64_t total = TestFixture::AddZipf(sketch, 20'000);
+  EXPECT_EQ(sketch.total(), total);
+  std::size_t exact = 0;
+  for (std::size_t idx = 0; idx < 20'000; ++idx) {
+    const auto count = static_cast<uint32_t>(1'000 / (idx + 1));
+    const auto estimate = sketch.Estimate(TestFixture::Key(idx));
+    ASSERT_THAT(estimate, Ge(count)) << idx;
+    EXPECT_THAT(estimate, Le(count + static_cast<uint32_t>(kEpsilon * static_cast<double>(total)))) << idx;
+    exact += estimate == count ? 1 : 0;
+  }
+  // Conservative update keeps most estimates exact at this width.
+  EXPECT_THAT(exact, Ge(15'000));
+}
+
+// Conservative update never estimates above the classic update of the same stream.
+TYPED_TEST(CountMinSketchTest, ConservativeUpdate) {
+  TypeParam sketch(64, 3);
+  sketch.Add("a", 10);
+  sketch.Add("a", 5);
+  EXPECT_EQ(sketch.Estimate("a"), 15);
+  for (std::size_t idx = 0; idx < 200; ++idx) {
+    sketch.Add(TestFixture::Key(idx));
+  }
+  EXPECT_THAT(sketch.Estimate("a"), Ge(15));
+  EXPECT_THAT(sketch.Estimate("a"), Le(15 + 200));
+}
+
+TYPED_TEST(CountMinSketchTest, Saturates) {
+  using Counter = decltype(std::declval<TypeParam>().total());
+  TypeParam sketch(16, 2);
+  sketch.Add("a", std::numeric_limits<Counter>::max() - 1);
+  sketch.Add("a", 5);
+  EXPECT_EQ(sketch.Estimate("a"), std::numeric_limits<Counter>::max());
+  EXPECT_EQ(sketch.total(), std::numeric_limits<Counter>::max());
+}
+
+TYPED_TEST(CountMinSketchTest, Merge) {
+  auto lhs = TypeParam::ForError(0.001, 0.01);
+  auto rhs = TypeParam::ForError(0.001, 0.01);
+  lhs.Add("a", 3);
+  lhs.Add("b", 4);
+  rhs.Add("a", 7);
+  rhs.Add("c", 1);
+  ASSERT_TRUE(lhs.Merge(rhs).ok());
+  EXPECT_EQ(lhs.total(), 15);
+  EXPECT_EQ(lhs.Estimate("a"), 10);
+  EXPECT_EQ(lhs.Estimate("b"), 4);
+  EXPECT_EQ(lhs.Estimate("c"), 1);
+  lhs.Clear();
+  EXPECT_EQ(lhs.total(), 0);
+  EXPECT_EQ(lhs.Estimate("a"), 0);
+}
+
+TYPED_TEST(CountMinSketchTest, MergeMismatch) {
+  TypeParam sketch(100, 4);
+  EXPECT_EQ(sketch.Merge(TypeParam(101, 4)).code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(sketch.Merge(TypeParam(100, 5)).code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(sketch.Merge(TypeParam(100, 4, 1)).code(), absl::StatusCode::kInvalidArgument);
+}
+
+TYPED_TEST(CountMinSketchTest, SerializeRoundTrip) {
+  TypeParam sketch(100, 4, 42);
+  TestFixture::AddZipf(sketch, 1'000);
+  const std::string bytes = sketch.Serialize();
+  EXPECT_EQ(bytes.size(), 48 + sketch.byte_size());
+  const auto restored = TypeParam::Deserialize(bytes);
+  ASSERT_TRUE(restored.ok()) << restored.status();
+  EXPECT_TRUE(*restored == sketch);
+  EXPECT_EQ(restored->seed(), 42);
+  EXPECT_EQ(restored->Estimate("key_0"), sketch.Estimate("key_0"));
+}
+
+TYPED_TEST(CountMinSketchTest, DeserializeErrors) {
+  const TypeParam sketch(100, 4);
+  const std::string bytes = sketch.Serialize();
+  EXPECT_EQ(TypeParam::Deserialize("").status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(
+      TypeParam::Deserialize(bytes.substr(0, bytes.size() - 1)).status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(TypeParam::Deserialize(absl::StrCat(bytes, "x")).status().code(), absl::StatusCode::kInvalidArgument);
+  std::string bad_magic = bytes;
+  bad_magic[0] = 'X';
+  EXPECT_EQ(TypeParam::Deserialize(bad_magic).status().code(), absl::StatusCode::kInvalidArgument);
+  std::string bad_counter = bytes;
+  bad_counter[8] = 2;
+  EXPECT_EQ(TypeParam::Deserialize(bad_counter).status().code(), absl::StatusCode::kInvalidArgument);
+  std::string bad_depth = bytes;
+  bad_depth[31] = 1;
+  EXPECT_EQ(TypeParam::Deserialize(bad_depth).status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
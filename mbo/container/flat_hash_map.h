@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_CONTAINER_FLAT_HASH_MAP_H_
+#define MBO_CONTAINER_FLAT_HASH_MAP_H_
+
+#include <concepts>  // IWYU pragma: keep
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+#include "mbo/config/require.h"
+#include "mbo/container/internal/flat_hash_table.h"
+
+namespace mbo::container {
+namespace container_internal {
+
+template<typename Key, typename Value>
+struct FlatHashMapPolicy {
+  using key_type = Key;
+  using value_type = std::pair<const Key, Value>;
+
+  static const Key& GetKey(const value_type& value) noexcept { return value.first; }
+};
+
+}  // namespace container_internal
+
+// NOLINTBEGIN(readability-identifier-naming)
+
+// An unordered map in the style of `absl::flat_hash_map`: elements live in a single open addressing slot array and
+// lookups compare 16 control bytes at once using SSE2 (8 in a portable fallback).
+//
+// Unlike `absl::flat_hash_map`, the hash is not re-mixed: its low 7 bits go into the control bytes and the rest
+// selects the probe start. That is why the default hash for string like keys is `mbo::hash::DefaultHasher`, whose low
+// bits are strong. Such keys also support transparent lookup, e.g. `std::string` keys can be found with a
+// `std::string_view` without creating a temporary string. Other keys default to `absl::Hash`.
+//
+// If `StoreHash` is set, then each slot also stores the full 64 bit hash. That costs 8 bytes per slot, but growing
+// never hashes keys again and lookups skip key comparisons unless the full hash matches. That pays off for long keys.
+//
+// Element addresses are not stable: growing the table moves all elements.
+//
+// Example:
+//
+// ```c++
+// mbo::container::FlatHashMap<std::string, int> map{{"one", 1}, {"two", 2}};
+// map["three"] = 3;
+// if (map.contains(std::string_view("two"))) { ... }
+// ```
+template<
+    typename Key,
+    typename Value,
+    typename Hash = container_internal::FlatHashDefaultHash<Key>,
+    typename Eq = std::equal_to<>,
+    bool StoreHash = false>
+class FlatHashMap final
+    : public container_internal::
+          FlatHashTable<container_internal::FlatHashMapPolicy<Key, Value>, Hash, Eq, StoreHash> {
+  using Base =
+      container_internal::FlatHashTable<container_internal::FlatHashMapPolicy<Key, Value>, Hash, Eq, StoreHash>;
+
+ public:
+  using mapped_type = Value;
+  using typename Base::const_iterator;
+  using typename Base::iterator;
+  using typename Base::value_type;
+
+  using Base::Base;
+
+  FlatHashMap() noexcept = default;
+
+  FlatHashMap(std::initializer_list<value_type> list) { Base::insert(list); }
+
+  template<std::input_iterator It>
+  FlatHashMap(It first, It last) {
+    Base::insert(first, last);
+  }
+
+  // Find and search: at, []
+
+  Value& at(const Key& key) {
+    auto it = Base::find(key);
+    MBO_CONFIG_REQUIRE(it != Base::end(), "Out of range");
+    return it->second;
+  }
+
+  const Value& at(const Key& key) const {
+    auto it = Base::find(key);
+    MBO_CONFIG_REQUIRE(it != Base::end(), "Out of range");
+    return it->second;
+  }
+
+  // Like `LimitedMap` only lookups take a foreign key. `operator[]`, `try_emplace` and `insert_or_assign` need a
+  // `Key` as they may insert.
+
+  template<typename K>
+  requires(Base::template kIsForeignKey<K>)
+  Value& at(const K& key) {
+    auto it = Base::find(key);
+    MBO_CONFIG_REQUIRE(it != Base::end(), "Out of range");
+    return it->second;
+  }
+
+  template<typename K>
+  requires(Base::template kIsForeignKey<K>)
+  const Value& at(const K& key) const {
+    auto it = Base::find(key);
+    MBO_CONFIG_REQUIRE(it != Base::end(), "Out of range");
+    return it->second;
+  }
+
+  Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+  Value& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+  // Map-types only: try_emplace, insert_or_assign
+
+  // Only constructs the value (and copies the key) if `key` is not present.
+  template<typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return Base::EmplaceWithKey(
+        key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template<typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return Base::EmplaceWithKey(
+        key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template<typename V>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) {
+    auto result = try_emplace(key, std::forward<V>(value));
+    if (!result.second) {
+      result.first->second = std::forward<V>(value);
+    }
+    return result;
+  }
+
+  template<typename V>
+  std::pair<iterator, bool> insert_or_assign(Key&& key, V&& value) {
+    auto result = try_emplace(std::move(key), std::forward<V>(value));
+    if (!result.second) {
+      result.first->second = std::forward<V>(value);
+    }
+    return result;
+  }
+};
+
+// Same as `FlatHashMap` but with `StoreHash` set.
+template<
+    typename Key,
+    typename Value,
+    typename Hash = container_internal::FlatHashDefaultHash<Key>,
+    typename Eq = std::equal_to<>>
+using FlatHashMapWithHash = FlatHashMap<Key, Value, Hash, Eq, true>;
+
+// NOLINTEND(readability-identifier-naming)
+
+}  // namespace mbo::container
+
+#endif  // MBO_CONTAINER_FLAT_HASH_MAP_H_
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares string keyed `FlatHashMap` (with and without stored hashes) against `absl::flat_hash_map` and
+// `std::unordered_map`. The keys follow the length distributions of //mbo/hash:hash_benchmark: `dist` selects
+// Short (0) or Web (1) and `bound` the inverse-CDF point whose length caps the keys.
+// Run with: bazel run -c opt //mbo/container:flat_hash_map_benchmark
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "benchmark/benchmark.h"
+#include "mbo/container/flat_hash_map.h"
+#include "mbo/hash/hash_benchmark_lengths.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+// The first half of the distribution's keys go into the map, the second half provides the misses.
+struct Keys {
+  std::vector<std::string> inserted;
+  std::vector<std::string> other;
+};
+
+Keys GetKeys(const benchmark::State& state) {
+  const std::vector<std::string>& all =
+      hash::bench::ThroughputKeys(static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)));
+  Keys keys;
+  keys.inserted.assign(all.begin(), all.begin() + static_cast<std::ptrdiff_t>(all.size() / 2));
+  keys.other.assign(all.begin() + static_cast<std::ptrdiff_t>(all.size() / 2), all.end());
+  return keys;
+}
+
+template<typename Map>
+void BmFind(benchmark::State& state) {
+  const bool hit = state.range(2) != 0;
+  const Keys keys = GetKeys(state);
+  Map map;
+  for (const std::string& key : keys.inserted) {
+    map.try_emplace(key, 0);
+  }
+  std::vector<std::string> input;
+  for (const std::string& key : hit ? keys.inserted : keys.other) {
+    if (map.contains(key) == hit) {
+      input.push_back(key);
+    }
+  }
+  if (input.empty()) {
+    state.SkipWithError("No keys");
+    return;
+  }
+  std::size_t item = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(input[item]));
+    item = (item + 1) % input.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Builds a map without reserving, so growth (and with it re-hashing) is part of the measurement.
+template<typename Map>
+void BmInsert(benchmark::State& state) {
+  const Keys keys = GetKeys(state);
+  for (auto _ : state) {
+    Map map;
+    for (const std::string& key : keys.inserted) {
+      map.try_emplace(key, 0);
+    }
+    benchmark::DoNotOptimize(map);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(keys.inserted.size()));
+}
+
+void FindArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"dist", "bound", "hit"});
+  for (const int dist : {0, 1}) {
+    for (const int bound : {2, 5, 8}) {
+      bench->Args({dist, bound, 1});
+      bench->Args({dist, bound, 0});
+    }
+  }
+}
+
+void InsertArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"dist", "bound"});
+  for (const int dist : {0, 1}) {
+    for (const int bound : {2, 5, 8}) {
+      bench->Args({dist, bound});
+    }
+  }
+}
+
+using MboMap = FlatHashMap<std::string, int>;
+using MboMapWithHash = FlatHashMapWithHash<std::string, int>;
+using AbslMap = absl::flat_hash_map<std::string, int>;
+using StdMap = std::unordered_map<std::string, int>;
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+
+#define MBO_REGISTER_BENCHMARKS(Map)      \
+  BENCHMARK(BmFind<Map>)->Apply(FindArgs); \
+  BENCHMARK(BmInsert<Map>)->Apply(InsertArgs)
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+MBO_REGISTER_BENCHMARKS(MboMap);
+MBO_REGISTER_BENCHMARKS(MboMapWithHash);
+MBO_REGISTER_BENCHMARKS(AbslMap);
+MBO_REGISTER_BENCHMARKS(StdMap);
+
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+#undef MBO_REGISTER_BENCHMARKS
+
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
+
+BENCHMARK_MAIN();  // NOLINT
@@ -0,0 +1,269 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/container/flat_hash_map.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <ranges>     // IWYU pragma: keep
+#include <stdexcept>  // IWYU pragma: keep
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/config/config.h"
+
+// Clang has issues with exception tracing in ASAN, so corresponding tests must
+// be disabled. But we do so for all known ASAN identification methods.
+#ifndef HAS_ADDRESS_SANITIZER
+# if defined(__has_feature)
+#  if __has_feature(address_sanitizer)
+#   define HAS_ADDRESS_SANITIZER 1
+#  endif
+# elif defined(__SANITIZE_ADDRESS__)
+#  define HAS_ADDRESS_SANITIZER 1
+# endif
+#endif
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+using ::testing::SizeIs;
+using ::testing::UnorderedElementsAre;
+
+static_assert(std::ranges::forward_range<FlatHashMap<std::string, int>>);
+static_assert(std::forward_iterator<FlatHashMap<std::string, int>::iterator>);
+static_assert(std::forward_iterator<FlatHashMap<std::string, int>::const_iterator>);
+
+template<typename Map>
+class FlatHashMapTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+};
+
+using FlatHashMapTypes = ::testing::Types<FlatHashMap<std::string, int>, FlatHashMapWithHash<std::string, int>>;
+TYPED_TEST_SUITE(FlatHashMapTest, FlatHashMapTypes);
+
+TYPED_TEST(FlatHashMapTest, Empty) {
+  const TypeParam map;
+  EXPECT_THAT(map, IsEmpty());
+  EXPECT_THAT(map, SizeIs(0));
+  EXPECT_THAT(map.capacity(), 0);
+  EXPECT_THAT(map.begin(), map.end());
+  EXPECT_FALSE(map.contains("any"));
+  EXPECT_THAT(map.find("any"), map.end());
+}
+
+TYPED_TEST(FlatHashMapTest, InsertAndFind) {
+  TypeParam map{{"one", 1}, {"two", 2}};
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("one", 1), Pair("two", 2)));
+  EXPECT_TRUE(map.insert({"three", 3}).second);
+  EXPECT_FALSE(map.insert({"three", 33}).second);
+  EXPECT_TRUE(map.emplace("four", 4).second);
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("one", 1), Pair("two", 2), Pair("three", 3), Pair("four", 4)));
+  EXPECT_THAT(map.at("three"), 3);
+  EXPECT_THAT(map.count("four"), 1);
+  EXPECT_THAT(map.count("five"), 0);
+  ASSERT_NE(map.find("two"), map.end());
+  EXPECT_THAT(*map.find("two"), Pair("two", 2));
+}
+
+TYPED_TEST(FlatHashMapTest, TransparentLookup) {
+  TypeParam map{{"one", 1}, {"two", 2}};
+  const std::string_view key = "two";
+  EXPECT_TRUE(map.contains(key));
+  EXPECT_THAT(map.find(key)->second, 2);
+  EXPECT_THAT(map.at(key), 2);
+  EXPECT_THAT(map.count(std::string_view("three")), 0);
+  EXPECT_THAT(map.erase(std::string_view("one")), 1);
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("two", 2)));
+}
+
+TYPED_TEST(FlatHashMapTest, SubscriptTryEmplaceInsertOrAssign) {
+  TypeParam map;
+  map["one"] = 1;
+  map["two"];
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("one", 1), Pair("two", 0)));
+  EXPECT_FALSE(map.try_emplace("one", 11).second);
+  EXPECT_TRUE(map.try_emplace("three", 3).second);
+  EXPECT_FALSE(map.insert_or_assign("two", 2).second);
+  EXPECT_TRUE(map.insert_or_assign("four", 4).second);
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("one", 1), Pair("two", 2), Pair("three", 3), Pair("four", 4)));
+}
+
+TYPED_TEST(FlatHashMapTest, Erase) {
+  TypeParam map{{"one", 1}, {"two", 2}, {"three", 3}};
+  EXPECT_THAT(map.erase("two"), 1);
+  EXPECT_THAT(map.erase("two"), 0);
+  map.erase(map.find("one"));
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("three", 3)));
+  map.erase(map.begin(), map.end());
+  EXPECT_THAT(map, IsEmpty());
+  EXPECT_TRUE(map.emplace("two", 22).second);
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("two", 22)));
+}
+
+TYPED_TEST(FlatHashMapTest, CopyMoveSwap) {
+  TypeParam map{{"one", 1}, {"two", 2}};
+  TypeParam copy = map;
+  EXPECT_THAT(copy, UnorderedElementsAre(Pair("one", 1), Pair("two", 2)));
+  EXPECT_THAT(copy, map);
+  copy["three"] = 3;
+  EXPECT_THAT(map, SizeIs(2));
+  EXPECT_NE(copy, map);
+  TypeParam moved = std::move(copy);
+  EXPECT_THAT(moved, SizeIs(3));
+  EXPECT_THAT(copy, IsEmpty());  // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+  copy = moved;
+  EXPECT_THAT(copy, moved);
+  swap(map, moved);
+  EXPECT_THAT(map, SizeIs(3));
+  EXPECT_THAT(moved, SizeIs(2));
+  map.clear();
+  EXPECT_THAT(map, IsEmpty());
+  EXPECT_FALSE(map.contains("one"));
+  map = moved;
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("one", 1), Pair("two", 2)));
+}
+
+TYPED_TEST(FlatHashMapTest, ReserveAndRehash) {
+  TypeParam map;
+  map.reserve(100);
+  const std::size_t capacity = map.capacity();
+  EXPECT_GE(capacity, 100);
+  for (int idx = 0; idx < 100; ++idx) {
+    map[absl::StrCat("key_", idx)] = idx;
+  }
+  EXPECT_THAT(map.capacity(), capacity);
+  map.rehash(0);
+  EXPECT_THAT(map, SizeIs(100));
+  for (int idx = 0; idx < 100; ++idx) {
+    ASSERT_THAT(map.at(absl::StrCat("key_", idx)), idx);
+  }
+}
+
+// Compares random inserts and erases against `std::unordered_map`, which covers growth, tombstones and reuse of
+// deleted slots.
+TYPED_TEST(FlatHashMapTest, RandomOperations) {
+  TypeParam map;
+  std::unordered_map<std::string, int> expected;
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Tests must be repeatable.
+  std::mt19937 rng(42);
+  for (int step = 0; step < 20'000; ++step) {
+    const std::string key = absl::StrCat("key_", rng() % 2'000);
+    switch (rng() % 3) {
+      case 0:
+      case 1:
+        ASSERT_THAT(map.insert_or_assign(key, step).second, expected.insert_or_assign(key, step).second) << key;
+        break;
+      default: ASSERT_THAT(map.erase(key), expected.erase(key)) << key; break;
+    }
+    ASSERT_THAT(map.size(), expected.size());
+  }
+  for (const auto& [key, value] : expected) {
+    ASSERT_TRUE(map.contains(key)) << key;
+    ASSERT_THAT(map.at(key), value) << key;
+  }
+  EXPECT_THAT(static_cast<std::size_t>(std::distance(map.begin(), map.end())), expected.size());
+  EXPECT_LE(map.load_factor(), 1.0F);
+}
+
+TYPED_TEST(FlatHashMapTest, AtThrows) {
+  TypeParam map{{"one", 1}};
+  if constexpr (!::mbo::config::kRequireThrows) {
+    ASSERT_DEATH(map.at("two"), "Out of range");
+  } else {
+#if __cpp_exceptions
+# if !HAS_ADDRESS_SANITIZER
+    // Disabled due to https://github.com/google/sanitizers/issues/749
+    bool caught = false;
+    try {
+      map.at("two");
+    } catch (const std::runtime_error& error) {
+      caught = true;
+      EXPECT_THAT(error.what(), HasSubstr("Out of range"));
+    }
+    ASSERT_TRUE(caught);
+# endif  // !HAS_ADDRESS_SANITIZER
+#endif   // __cpp_exceptions
+  }
+}
+
+struct FlatHashMapOtherTest : ::testing::Test {
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+};
+
+TEST_F(FlatHashMapOtherTest, IntegerKeys) {
+  FlatHashMap<int, std::string> map;
+  for (int idx = 0; idx < 1'000; ++idx) {
+    map.try_emplace(idx * 3, absl::StrCat(idx));
+  }
+  EXPECT_THAT(map, SizeIs(1'000));
+  EXPECT_THAT(map.at(300), "100");
+  EXPECT_FALSE(map.contains(301));
+}
+
+TEST_F(FlatHashMapOtherTest, MoveOnlyValues) {
+  FlatHashMap<std::string_view, std::unique_ptr<int>> map;
+  for (int idx = 0; idx < 100; ++idx) {
+    static const std::vector<std::string> kKeys = [] {
+      std::vector<std::string> keys;
+      for (int key = 0; key < 100; ++key) {
+        keys.push_back(absl::StrCat("key_", key));
+      }
+      return keys;
+    }();
+    map.try_emplace(kKeys[static_cast<std::size_t>(idx)], std::make_unique<int>(idx));
+  }
+  ASSERT_THAT(map, SizeIs(100));
+  EXPECT_THAT(*map.at("key_42"), 42);
+}
+
+// A hash whose low 7 bits are all equal, so every lookup has to compare keys (or stored hashes).
+struct CollidingHash {
+  using is_transparent = void;
+
+  uint64_t operator()(std::string_view data) const noexcept { return std::hash<std::string_view>{}(data) << 7U; }
+};
+
+TEST_F(FlatHashMapOtherTest, CollidingH2) {
+  FlatHashMapWithHash<std::string, int, CollidingHash> map;
+  for (int idx = 0; idx < 500; ++idx) {
+    map.try_emplace(absl::StrCat(idx), idx);
+  }
+  for (int idx = 0; idx < 500; ++idx) {
+    ASSERT_THAT(map.at(absl::StrCat(idx)), idx);
+    ASSERT_FALSE(map.contains(absl::StrCat("x", idx)));
+  }
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
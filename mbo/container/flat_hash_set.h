@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_CONTAINER_FLAT_HASH_SET_H_
+#define MBO_CONTAINER_FLAT_HASH_SET_H_
+
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+
+#include "mbo/container/internal/flat_hash_table.h"
+
+namespace mbo::container {
+namespace container_internal {
+
+template<typename Key>
+struct FlatHashSetPolicy {
+  using key_type = Key;
+  using value_type = Key;
+
+  static const Key& GetKey(const value_type& value) noexcept { return value; }
+};
+
+}  // namespace container_internal
+
+// NOLINTBEGIN(readability-identifier-naming)
+
+// An unordered set in the style of `absl::flat_hash_set`, the set counterpart of `FlatHashMap` which explains the
+// hashing and the `StoreHash` option.
+//
+// Elements cannot be modified in place, so `iterator` is the same as `const_iterator`.
+template<
+    typename Key,
+    typename Hash = container_internal::FlatHashDefaultHash<Key>,
+    typename Eq = std::equal_to<>,
+    bool StoreHash = false>
+class FlatHashSet final
+    : public container_internal::FlatHashTable<container_internal::FlatHashSetPolicy<Key>, Hash, Eq, StoreHash> {
+  using Base = container_internal::FlatHashTable<container_internal::FlatHashSetPolicy<Key>, Hash, Eq, StoreHash>;
+
+ public:
+  using typename Base::const_iterator;
+  using typename Base::iterator;
+  using typename Base::value_type;
+
+  using Base::Base;
+
+  FlatHashSet() noexcept = default;
+
+  FlatHashSet(std::initializer_list<value_type> list) { Base::insert(list); }
+
+  template<std::input_iterator It>
+  FlatHashSet(It first, It last) {
+    Base::insert(first, last);
+  }
+};
+
+// Same as `FlatHashSet` but with `StoreHash` set.
+template<typename Key, typename Hash = container_internal::FlatHashDefaultHash<Key>, typename Eq = std::equal_to<>>
+using FlatHashSetWithHash = FlatHashSet<Key, Hash, Eq, true>;
+
+// NOLINTEND(readability-identifier-naming)
+
+}  // namespace mbo::container
+
+#endif  // MBO_CONTAINER_FLAT_HASH_SET_H_
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/container/flat_hash_set.h"
+
+#include <random>
+#include <ranges>  // IWYU pragma: keep
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+using ::testing::UnorderedElementsAre;
+
+static_assert(std::ranges::forward_range<FlatHashSet<std::string>>);
+static_assert(std::is_same_v<FlatHashSet<std::string>::iterator, FlatHashSet<std::string>::const_iterator>);
+static_assert(std::is_const_v<std::remove_reference_t<decltype(*FlatHashSet<std::string>().begin())>>);
+
+template<typename Set>
+class FlatHashSetTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+};
+
+using FlatHashSetTypes = ::testing::Types<FlatHashSet<std::string>, FlatHashSetWithHash<std::string>>;
+TYPED_TEST_SUITE(FlatHashSetTest, FlatHashSetTypes);
+
+TYPED_TEST(FlatHashSetTest, Basics) {
+  TypeParam set{"one", "two", "one"};
+  EXPECT_THAT(set, UnorderedElementsAre("one", "two"));
+  EXPECT_TRUE(set.insert("three").second);
+  EXPECT_FALSE(set.emplace("two").second);
+  EXPECT_TRUE(set.contains(std::string_view("three")));
+  EXPECT_FALSE(set.contains("four"));
+  EXPECT_THAT(set.erase(std::string_view("one")), 1);
+  EXPECT_THAT(set, UnorderedElementsAre("two", "three"));
+  set.clear();
+  EXPECT_THAT(set, IsEmpty());
+}
+
+TYPED_TEST(FlatHashSetTest, RandomOperations) {
+  TypeParam set;
+  std::set<std::string> expected;
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Tests must be repeatable.
+  std::mt19937 rng(42);
+  for (int step = 0; step < 10'000; ++step) {
+    const std::string key = absl::StrCat(rng() % 1'000);
+    if (rng() % 3 != 0) {
+      ASSERT_THAT(set.insert(key).second, expected.insert(key).second) << key;
+    } else {
+      ASSERT_THAT(set.erase(key), expected.erase(key)) << key;
+    }
+  }
+  ASSERT_THAT(set, SizeIs(expected.size()));
+  const std::set<std::string> actual(set.begin(), set.end());
+  EXPECT_THAT(actual, expected);
+}
+
+TYPED_TEST(FlatHashSetTest, FromRange) {
+  const std::vector<std::string> values{"a", "b", "c", "b"};
+  const TypeParam set(values.begin(), values.end());
+  EXPECT_THAT(set, UnorderedElementsAre("a", "b", "c"));
+  const TypeParam copy = set;
+  EXPECT_THAT(copy, set);
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
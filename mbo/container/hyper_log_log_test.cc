@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/container/hyper_log_log.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "absl/log/initialize.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/hash/hash.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::testing::DoubleNear;
+using ::testing::Le;
+
+template<typename Sketch>
+class HyperLogLogTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  static void AddKeys(Sketch& sketch, std::string_view prefix, std::size_t begin, std::size_t end) {
+    for (std::size_t idx = begin; idx < end; ++idx) {
+      sketch.Add(std::string(prefix) + std::to_string(idx));
+    }
+  }
+};
+
+using HyperLogLogTypes = ::testing::Types<HyperLogLog<>, HyperLogLog<hash::Hasher<hash::siphash::Algorithm>>>;
+TYPED_TEST_SUITE(HyperLogLogTest, HyperLogLogTypes);
+
+TYPED_TEST(HyperLogLogTest, Empty) {
+  const TypeParam sketch;
+  EXPECT_TRUE(sketch.is_sparse());
+  EXPECT_EQ(sketch.precision(), 14);
+  EXPECT_EQ(sketch.num_registers(), 16'384);
+  EXPECT_EQ(sketch.Estimate(), 0.0);
+}
+
+// Small cardinalities stay sparse and are nearly exact.
+TYPED_TEST(HyperLogLogTest, Sparse) {
+  TypeParam sketch;
+  for (int repeat = 0; repeat < 3; ++repeat) {
+    TestFixture::AddKeys(sketch, "key_", 0, 1'000);
+  }
+  EXPECT_TRUE(sketch.is_sparse());
+  EXPECT_THAT(sketch.Estimate(), DoubleNear(1'000, 2));
+}
+
+// Checks the relative error against three times the standard error across the sparse to dense transition and the
+// range where plain HyperLogLog needs bias correction.
+TYPED_TEST(HyperLogLogTest, Accuracy) {
+  for (const int precision : {10, 14}) {
+    TypeParam sketch(precision);
+    const double max_error = 3 * 1.04 / std::sqrt(static_cast<double>(sketch.num_registers()));
+    std::size_t added = 0;
+    for (const std::size_t count : {100, 1'000, 5'000, 20'000, 100'000, 1'000'000}) {
+      TestFixture::AddKeys(sketch, "key_", added, count);
+      added = count;
+      EXPECT_THAT(sketch.Estimate() / static_cast<double>(count), DoubleNear(1.0, max_error))
+          << "Precision: " << precision << ", count: " << count;
+    }
+    EXPECT_FALSE(sketch.is_sparse());
+    EXPECT_THAT(sketch.byte_size(), Le(sketch.num_registers()));
+  }
+}
+
+// Estimates after every key across the sparse to dense threshold (a quarter of the registers as sparse entries), so
+// that an estimate sees a buffer whose flush would convert. Estimating must not change the form.
+TYPED_TEST(HyperLogLogTest, EstimateAtDenseThreshold) {
+  for (const int precision : {10, 14}) {
+    TypeParam sketch(precision);
+    const double max_error = 3 * 1.04 / std::sqrt(static_cast<double>(sketch.num_registers()));
+    const std::size_t threshold = sketch.num_registers() / 4;
+    for (std::size_t count = 1; count <= threshold + 200; ++count) {
+      TestFixture::AddKeys(sketch, "key_", count - 1, count);
+      const bool is_sparse = sketch.is_sparse();
+      ASSERT_THAT(sketch.Estimate() / static_cast<double>(count), DoubleNear(1.0, max_error))
+          << "Precision: " << precision << ", count: " << count;
+      ASSERT_EQ(sketch.is_sparse(), is_sparse);
+    }
+    EXPECT_FALSE(sketch.is_sparse());
+    EXPECT_THAT(sketch.byte_size(), Le(sketch.num_registers()));
+  }
+}
+
+TYPED_TEST(HyperLogLogTest, Merge) {
+  for (const std::size_t count : {100, 100'000}) {
+    TypeParam lhs;
+    TypeParam rhs;
+    TypeParam both;
+    TestFixture::AddKeys(lhs, "key_", 0, count);
+    TestFixture::AddKeys(rhs, "key_", count / 2, count * 2);
+    TestFixture::AddKeys(both, "key_", 0, count * 2);
+    ASSERT_TRUE(lhs.Merge(rhs).ok());
+    EXPECT_EQ(lhs.Estimate(), both.Estimate()) << "Count: " << count;
+    EXPECT_EQ(lhs.Serialize(), both.Serialize()) << "Count: " << count;
+  }
+}
+
+TYPED_TEST(HyperLogLogTest, MergeSparseIntoDense) {
+  TypeParam dense;
+  TypeParam sparse;
+  TypeParam both;
+  TestFixture::AddKeys(dense, "key_", 0, 50'000);
+  TestFixture::AddKeys(sparse, "other_", 0, 100);
+  TestFixture::AddKeys(both, "key_", 0, 50'000);
+  TestFixture::AddKeys(both, "other_", 0, 100);
+  ASSERT_FALSE(dense.is_sparse());
+  ASSERT_TRUE(sparse.is_sparse());
+  TypeParam dense_first = dense;
+  ASSERT_TRUE(dense_first.Merge(sparse).ok());
+  ASSERT_TRUE(sparse.Merge(dense).ok());
+  EXPECT_EQ(dense_first.Serialize(), both.Serialize());
+  EXPECT_EQ(sparse.Serialize(), both.Serialize());
+}
+
+TYPED_TEST(HyperLogLogTest, MergeMismatch) {
+  TypeParam sketch;
+  EXPECT_EQ(sketch.Merge(TypeParam(12)).code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(sketch.Merge(TypeParam(14, 1)).code(), absl::StatusCode::kInvalidArgument);
+}
+
+TYPED_TEST(HyperLogLogTest, SerializeRoundTrip) {
+  for (const std::size_t count : {0, 100, 100'000}) {
+    TypeParam sketch(12, 42);
+    TestFixture::AddKeys(sketch, "key_", 0, count);
+    const auto restored = TypeParam::Deserialize(sketch.Serialize());
+    ASSERT_TRUE(restored.ok()) << restored.status();
+    EXPECT_EQ(restored->precision(), 12);
+    EXPECT_EQ(restored->seed(), 42);
+    EXPECT_EQ(restored->is_sparse(), sketch.is_sparse());
+    EXPECT_EQ(restored->Estimate(), sketch.Estimate()) << "Count: " << count;
+  }
+}
+
+TYPED_TEST(HyperLogLogTest, DeserializeErrors) {
+  for (const std::size_t count : {100, 100'000}) {
+    TypeParam sketch;
+    TestFixture::AddKeys(sketch, "key_", 0, count);
+    const std::string bytes = sketch.Serialize();
+    EXPECT_EQ(TypeParam::Deserialize("").status().code(), absl::StatusCode::kInvalidArgument);
+    EXPECT_EQ(
+        TypeParam::Deserialize(bytes.substr(0, bytes.size() - 1)).status().code(), absl::StatusCode::kInvalidArgument);
+    EXPECT_EQ(TypeParam::Deserialize(absl::StrCat(bytes, "x")).status().code(), absl::StatusCode::kInvalidArgument);
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    EXPECT_EQ(TypeParam::Deserialize(bad_magic).status().code(), absl::StatusCode::kInvalidArgument);
+    std::string bad_precision = bytes;
+    bad_precision[8] = 30;
+    EXPECT_EQ(TypeParam::Deserialize(bad_precision).status().code(), absl::StatusCode::kInvalidArgument);
+  }
+}
+
+TYPED_TEST(HyperLogLogTest, Clear) {
+  TypeParam sketch;
+  TestFixture::AddKeys(sketch, "key_", 0, 100'000);
+  sketch.Clear();
+  EXPECT_TRUE(sketch.is_sparse());
+  EXPECT_EQ(sketch.Estimate(), 0.0);
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
@@ -0,0 +1,744 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_CONTAINER_INTERNAL_FLAT_HASH_TABLE_H_
+#define MBO_CONTAINER_INTERNAL_FLAT_HASH_TABLE_H_
+
+#include <algorithm>
+#include <bit>
+#include <concepts>  // IWYU pragma: keep
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "absl/hash/hash.h"
+#include "mbo/config/require.h"
+#include "mbo/hash/hash.h"
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+namespace mbo::container::container_internal {
+
+// NOLINTBEGIN(*-pro-type-union-access,*-pro-bounds-pointer-arithmetic,*-pro-bounds-constant-array-index)
+// NOLINTBEGIN(*-magic-numbers)
+// The table keeps its slots in a union array, so that unused slots stay uninitialized, and walks the control bytes
+// with pointers. This is the implementation.
+
+// NOLINTBEGIN(readability-identifier-naming)
+
+// A control byte per slot: `kEmpty`, `kDeleted` or, for a full slot, the 7 bit hash fragment `H2` (0..127).
+// `kSentinel` marks the end of the slots for iteration.
+enum class FlatHashCtrl : int8_t {
+  kEmpty = -128,  // 0b10000000
+  kDeleted = -2,  // 0b11111110
+  kSentinel = -1,  // 0b11111111
+};
+
+using FlatHashCtrlByte = int8_t;
+
+inline constexpr FlatHashCtrlByte kFlatHashEmpty = static_cast<FlatHashCtrlByte>(FlatHashCtrl::kEmpty);
+inline constexpr FlatHashCtrlByte kFlatHashDeleted = static_cast<FlatHashCtrlByte>(FlatHashCtrl::kDeleted);
+inline constexpr FlatHashCtrlByte kFlatHashSentinel = static_cast<FlatHashCtrlByte>(FlatHashCtrl::kSentinel);
+
+constexpr bool FlatHashIsFull(FlatHashCtrlByte ctrl) noexcept { return ctrl >= 0; }
+
+constexpr bool FlatHashIsEmptyOrDeleted(FlatHashCtrlByte ctrl) noexcept { return ctrl < kFlatHashSentinel; }
+
+// The set bits of a group match, each `Shift` wide, lowest first.
+template<typename T, int Shift>
+class FlatHashBitMask {
+ public:
+  explicit constexpr FlatHashBitMask(T mask) noexcept : mask_(mask) {}
+
+  constexpr explicit operator bool() const noexcept { return mask_ != 0; }
+
+  constexpr std::size_t Lowest() const noexcept { return static_cast<std::size_t>(std::countr_zero(mask_)) >> Shift; }
+
+  constexpr FlatHashBitMask& operator++() noexcept {
+    mask_ &= mask_ - 1;
+    return *this;
+  }
+
+  constexpr std::size_t operator*() const noexcept { return Lowest(); }
+
+  constexpr FlatHashBitMask begin() const noexcept { return *this; }
+
+  constexpr FlatHashBitMask end() const noexcept { return FlatHashBitMask(0); }
+
+  friend constexpr bool operator==(const FlatHashBitMask& lhs, const FlatHashBitMask& rhs) noexcept {
+    return lhs.mask_ == rhs.mask_;
+  }
+
+ private:
+  T mask_;
+};
+
+#if defined(__SSE2__)
+
+// Compares 16 control bytes per instruction.
+struct FlatHashGroup {
+  static constexpr std::size_t kWidth = 16;
+
+  using BitMask = FlatHashBitMask<uint32_t, 0>;
+
+  explicit FlatHashGroup(const FlatHashCtrlByte* pos) noexcept
+      : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}  // NOLINT(*-reinterpret-cast)
+
+  BitMask Match(uint8_t h2) const noexcept {
+    return BitMask(ToMask(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(h2)), ctrl)));
+  }
+
+  BitMask MaskEmpty() const noexcept { return BitMask(ToMask(_mm_cmpeq_epi8(_mm_set1_epi8(kFlatHashEmpty), ctrl))); }
+
+  BitMask MaskEmptyOrDeleted() const noexcept {
+    return BitMask(ToMask(_mm_cmpgt_epi8(_mm_set1_epi8(kFlatHashSentinel), ctrl)));
+  }
+
+  static uint32_t ToMask(__m128i bytes) noexcept { return static_cast<uint32_t>(_mm_movemask_epi8(bytes)); }
+
+  __m128i ctrl;
+};
+
+#else  // defined(__SSE2__)
+
+// Compares 8 control bytes in a 64 bit word. `Match` can report false positives, but only for full slots that follow
+// a real match, and the caller compares the keys anyway.
+struct FlatHashGroup {
+  static constexpr std::size_t kWidth = 8;
+
+  using BitMask = FlatHashBitMask<uint64_t, 3>;
+
+  static constexpr uint64_t kMsbs = 0x8080808080808080ULL;
+  static constexpr uint64_t kLsbs = 0x0101010101010101ULL;
+
+  explicit FlatHashGroup(const FlatHashCtrlByte* pos) noexcept {
+    std::memcpy(&ctrl, pos, sizeof(ctrl));
+    if constexpr (std::endian::native == std::endian::big) {
+      ctrl = __builtin_bswap64(ctrl);
+    }
+  }
+
+  BitMask Match(uint8_t h2) const noexcept {
+    const uint64_t bytes = ctrl ^ (kLsbs * h2);
+    return BitMask((bytes - kLsbs) & ~bytes & kMsbs);
+  }
+
+  BitMask MaskEmpty() const noexcept { return BitMask(ctrl & ~(ctrl << 6U) & kMsbs); }
+
+  BitMask MaskEmptyOrDeleted() const noexcept { return BitMask(ctrl & ~(ctrl << 7U) & kMsbs); }
+
+  uint64_t ctrl = 0;
+};
+
+#endif  // defined(__SSE2__)
+
+// Control bytes of a table without slots: the sentinel, then a group of empty bytes that all probes stop at.
+alignas(16) inline constexpr FlatHashCtrlByte kFlatHashEmptyGroup[32] = {  // NOLINT(*-avoid-c-arrays)
+    kFlatHashSentinel, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty,
+    kFlatHashEmpty,    kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty,
+    kFlatHashEmpty,    kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty,
+    kFlatHashEmpty,    kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty,
+    kFlatHashEmpty,    kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty, kFlatHashEmpty,
+    kFlatHashEmpty,    kFlatHashEmpty,
+};
+
+// Hash used for string like keys: `mbo::hash::DefaultHasher` whose low bits are strong enough to be used as they
+// are. Other keys use `absl::Hash`.
+template<typename Key>
+using FlatHashDefaultHash = std::
+    conditional_t<std::constructible_from<std::string_view, const Key&>, mbo::hash::DefaultHasher, absl::Hash<Key>>;
+
+// Slot counts are `2^n - 1`, so that the count is also the mask for positions.
+constexpr std::size_t FlatHashNormalizeCapacity(std::size_t size) noexcept {
+  return size == 0 ? 1 : ~std::size_t{0} >> std::countl_zero(size);
+}
+
+// Maximum load factor of 7/8. Small tables can be filled completely, as long as every group probe still sees an empty
+// control byte behind the cloned bytes.
+constexpr std::size_t FlatHashCapacityToGrowth(std::size_t capacity) noexcept {
+  if (FlatHashGroup::kWidth == 8 && capacity == 7) {
+    return 6;
+  }
+  return capacity - (capacity / 8);
+}
+
+constexpr std::size_t FlatHashGrowthToCapacity(std::size_t growth) noexcept {
+  if (growth == 0) {
+    return 0;
+  }
+  if (FlatHashGroup::kWidth == 8 && growth == 7) {
+    return 8;
+  }
+  return growth + ((growth - 1) / 7);
+}
+
+// An open addressing hash table in the style of Abseil's Swiss tables: a control byte per slot holds 7 bits of the
+// hash, and lookups compare a group of control bytes at once (SSE2 16, otherwise 8), so a key is usually found or
+// missed with one group probe and at most one key comparison.
+//
+// The hash is used as it comes from `Hash`: `H2` are its low 7 bits, `H1` (the probe start) the remaining bits.
+// That requires a hash with strong low bits, which all `mbo::hash` algorithms have, instead of re-mixing it.
+//
+// With `StoreHash` every slot also keeps its full 64 bit hash. Then growing the table never hashes a key again, and
+// lookups compare the stored hash before the key, which avoids touching keys on `H2` collisions.
+//
+// `Policy` provides `key_type`, `value_type` and `static const key_type& GetKey(const value_type&)`.
+template<typename Policy, typename Hash, typename Eq, bool StoreHash>
+class FlatHashTable {
+ public:
+  using key_type = typename Policy::key_type;
+  using value_type = typename Policy::value_type;
+  using hasher = Hash;
+  using key_equal = Eq;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+
+  static constexpr bool kStoreHash = StoreHash;
+
+ protected:
+  using Group = FlatHashGroup;
+  using CtrlByte = FlatHashCtrlByte;
+
+  static constexpr std::size_t kWidth = Group::kWidth;
+  static constexpr std::size_t kNumClonedBytes = kWidth - 1;
+
+  union Slot {
+    Slot() noexcept {}  // NOLINT(*-member-init,modernize-use-equals-default)
+
+    ~Slot() noexcept {}  // NOLINT(modernize-use-equals-default)
+
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+    Slot(Slot&&) = delete;
+    Slot& operator=(Slot&&) = delete;
+
+    value_type value;
+  };
+
+  // Transparent lookups need both a transparent hash and a transparent comparison.
+  static constexpr bool kTransparent = requires {
+    typename Hash::is_transparent;
+    typename Eq::is_transparent;
+  };
+
+ public:
+  template<typename K>
+  static constexpr bool kIsForeignKey = kTransparent && !std::same_as<std::remove_cvref_t<K>, key_type>;
+
+  template<bool kConst>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = FlatHashTable::value_type;
+    using reference = std::conditional_t<kConst, const value_type&, value_type&>;
+    using pointer = std::conditional_t<kConst, const value_type*, value_type*>;
+
+    Iterator() noexcept = default;
+
+    Iterator(const CtrlByte* ctrl, Slot* slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+
+    template<bool kOtherConst>
+    requires(kConst && !kOtherConst)
+    Iterator(const Iterator<kOtherConst>& other) noexcept  // NOLINT(*-explicit-*)
+        : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+    reference operator*() const noexcept { return slot_->value; }
+
+    pointer operator->() const noexcept { return &slot_->value; }
+
+    Iterator& operator++() noexcept {
+      ++ctrl_;
+      ++slot_;
+      SkipEmptyOrDeleted();
+      return *this;
+    }
+
+    Iterator operator++(int) noexcept {  // NOLINT(cert-dcl21-cpp)
+      Iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.ctrl_ == rhs.ctrl_; }
+
+   private:
+    friend class FlatHashTable;
+
+    template<bool kOtherConst>
+    friend class Iterator;
+
+    void SkipEmptyOrDeleted() noexcept {
+      while (FlatHashIsEmptyOrDeleted(*ctrl_)) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+    const CtrlByte* ctrl_ = nullptr;
+    Slot* slot_ = nullptr;
+  };
+
+  // Sets only provide const access, as modifying a key would break the table.
+  using iterator = std::conditional_t<std::same_as<key_type, value_type>, Iterator<true>, Iterator<false>>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashTable() noexcept = default;
+
+  explicit FlatHashTable(std::size_t bucket_count, const Hash& hash = Hash(), const Eq& eq = Eq())
+      : hash_(hash), eq_(eq) {
+    if (bucket_count > 0) {
+      Resize(FlatHashNormalizeCapacity(bucket_count));
+    }
+  }
+
+  FlatHashTable(const FlatHashTable& other) : hash_(other.hash_), eq_(other.eq_) { CopyFrom(other); }
+
+  FlatHashTable(FlatHashTable&& other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, EmptyCtrl())),
+        slots_(std::exchange(other.slots_, nullptr)),
+        hashes_(std::exchange(other.hashes_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        size_(std::exchange(other.size_, 0)),
+        growth_left_(std::exchange(other.growth_left_, 0)),
+        hash_(other.hash_),
+        eq_(other.eq_) {}
+
+  FlatHashTable& operator=(const FlatHashTable& other) {
+    if (this != &other) {
+      DestroyAll();
+      hash_ = other.hash_;
+      eq_ = other.eq_;
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  FlatHashTable& operator=(FlatHashTable&& other) noexcept {
+    if (this != &other) {
+      DestroyAll();
+      ctrl_ = std::exchange(other.ctrl_, EmptyCtrl());
+      slots_ = std::exchange(other.slots_, nullptr);
+      hashes_ = std::exchange(other.hashes_, nullptr);
+      capacity_ = std::exchange(other.capacity_, 0);
+      size_ = std::exchange(other.size_, 0);
+      growth_left_ = std::exchange(other.growth_left_, 0);
+      hash_ = other.hash_;
+      eq_ = other.eq_;
+    }
+    return *this;
+  }
+
+  ~FlatHashTable() noexcept { DestroyAll(); }
+
+  // Iteration (in no particular order).
+
+  iterator begin() noexcept {
+    iterator it(ctrl_, slots_);
+    it.SkipEmptyOrDeleted();
+    return it;
+  }
+
+  const_iterator begin() const noexcept { return const_cast<FlatHashTable*>(this)->begin(); }  // NOLINT(*-const-cast)
+
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(ctrl_ + capacity_, nullptr); }
+
+  const_iterator end() const noexcept { return const_cast<FlatHashTable*>(this)->end(); }  // NOLINT(*-const-cast)
+
+  const_iterator cend() const noexcept { return end(); }
+
+  // Size and capacity.
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  std::size_t size() const noexcept { return size_; }
+
+  std::size_t capacity() const noexcept { return capacity_; }
+
+  std::size_t max_size() const noexcept { return std::numeric_limits<std::size_t>::max() / sizeof(Slot); }
+
+  float load_factor() const noexcept {
+    return capacity_ == 0 ? 0.0F : static_cast<float>(size_) / static_cast<float>(capacity_);
+  }
+
+  void clear() noexcept {
+    DestroyAll();
+    ctrl_ = EmptyCtrl();
+    slots_ = nullptr;
+    hashes_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growth_left_ = 0;
+  }
+
+  // Makes room for `count` elements without growing.
+  void reserve(std::size_t count) {
+    if (count > size_ + growth_left_) {
+      Resize(FlatHashNormalizeCapacity(FlatHashGrowthToCapacity(count)));
+    }
+  }
+
+  // Rebuilds the table with at least `count` slots (and room for all elements), which also drops tombstones.
+  void rehash(std::size_t count) {
+    const std::size_t min_capacity = std::max(count, FlatHashGrowthToCapacity(size_));
+    if (min_capacity == 0) {
+      clear();
+      return;
+    }
+    Resize(FlatHashNormalizeCapacity(min_capacity));
+  }
+
+  hasher hash_function() const { return hash_; }
+
+  key_equal key_eq() const { return eq_; }
+
+  // Lookup: find, contains, count
+
+  iterator find(const key_type& key) { return FindImpl(key, HashOf(key)); }
+
+  const_iterator find(const key_type& key) const { return const_cast<FlatHashTable*>(this)->find(key); }  // NOLINT
+
+  template<typename K>
+  requires(kIsForeignKey<K>)
+  iterator find(const K& key) {
+    return FindImpl(key, HashOf(key));
+  }
+
+  template<typename K>
+  requires(kIsForeignKey<K>)
+  const_iterator find(const K& key) const {
+    return const_cast<FlatHashTable*>(this)->find(key);  // NOLINT(*-const-cast)
+  }
+
+  bool contains(const key_type& key) const { return find(key) != end(); }
+
+  template<typename K>
+  requires(kIsForeignKey<K>)
+  bool contains(const K& key) const {
+    return find(key) != end();
+  }
+
+  std::size_t count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+  template<typename K>
+  requires(kIsForeignKey<K>)
+  std::size_t count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  // Modification: insert, emplace, erase, swap
+
+  std::pair<iterator, bool> insert(const value_type& value) { return EmplaceWithKey(Policy::GetKey(value), value); }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return EmplaceWithKey(Policy::GetKey(value), std::move(value));
+  }
+
+  template<std::input_iterator It>
+  void insert(It first, It last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  void insert(std::initializer_list<value_type> list) { insert(list.begin(), list.end()); }
+
+  template<typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    // The key is needed first, so the value is built up front. Map types provide `try_emplace` to avoid that.
+    value_type value(std::forward<Args>(args)...);
+    return EmplaceWithKey(Policy::GetKey(value), std::move(value));
+  }
+
+  // Erases the element at `pos`, which must be valid. The slot becomes a tombstone, so no hash is needed.
+  void erase(const_iterator pos) noexcept {
+    const std::size_t index = static_cast<std::size_t>(pos.ctrl_ - ctrl_);
+    std::destroy_at(&slots_[index].value);
+    SetCtrl(index, kFlatHashDeleted);
+    --size_;
+  }
+
+  void erase(iterator pos) noexcept
+  requires(!std::same_as<iterator, const_iterator>)
+  {
+    erase(const_iterator(pos));
+  }
+
+  iterator erase(const_iterator first, const_iterator last) noexcept {
+    while (first != last) {
+      erase(first++);
+    }
+    return iterator(last.ctrl_, last.slot_);
+  }
+
+  std::size_t erase(const key_type& key) {
+    const iterator it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  template<typename K>
+  requires(kIsForeignKey<K> && !std::convertible_to<K, const_iterator>)
+  std::size_t erase(const K& key) {
+    const iterator it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  void swap(FlatHashTable& other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+    std::swap(hashes_, other.hashes_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(hash_, other.hash_);
+    std::swap(eq_, other.eq_);
+  }
+
+  friend void swap(FlatHashTable& lhs, FlatHashTable& rhs) noexcept { lhs.swap(rhs); }
+
+  // Equal if both have the same elements (for maps also the same values).
+  friend bool operator==(const FlatHashTable& lhs, const FlatHashTable& rhs) {
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+    return std::all_of(lhs.begin(), lhs.end(), [&rhs](const value_type& value) {
+      const auto it = rhs.find(Policy::GetKey(value));
+      return it != rhs.end() && *it == value;
+    });
+  }
+
+ protected:
+  template<typename K>
+  uint64_t HashOf(const K& key) const {
+    return static_cast<uint64_t>(hash_(key));
+  }
+
+  static constexpr uint8_t H2(uint64_t hash) noexcept { return static_cast<uint8_t>(hash & 0x7FU); }
+
+  static constexpr std::size_t H1(uint64_t hash) noexcept { return static_cast<std::size_t>(hash >> 7U); }
+
+  template<typename K>
+  iterator FindImpl(const K& key, uint64_t hash) {
+    std::size_t offset = H1(hash) & capacity_;
+    std::size_t step = 0;
+    while (true) {
+      const Group group(ctrl_ + offset);
+      for (const std::size_t pos : group.Match(H2(hash))) {
+        const std::size_t index = (offset + pos) & capacity_;
+        if constexpr (StoreHash) {
+          if (hashes_[index] != hash) {
+            continue;
+          }
+        }
+        if (eq_(Policy::GetKey(slots_[index].value), key)) [[likely]] {
+          return iterator(ctrl_ + index, slots_ + index);
+        }
+      }
+      if (group.MaskEmpty()) [[likely]] {
+        return end();
+      }
+      step += kWidth;
+      offset = (offset + step) & capacity_;
+    }
+  }
+
+  // Finds the slot for a new element: the first empty or deleted slot in its probe sequence.
+  std::size_t FindFirstNonFull(uint64_t hash) const noexcept {
+    std::size_t offset = H1(hash) & capacity_;
+    std::size_t step = 0;
+    while (true) {
+      const Group group(ctrl_ + offset);
+      if (const auto mask = group.MaskEmptyOrDeleted()) {
+        return (offset + mask.Lowest()) & capacity_;
+      }
+      step += kWidth;
+      offset = (offset + step) & capacity_;
+    }
+  }
+
+  // Inserts a value (constructed from `args`) for `key` unless `key` exists.
+  template<typename K, typename... Args>
+  std::pair<iterator, bool> EmplaceWithKey(const K& key, Args&&... args) {
+    const uint64_t hash = HashOf(key);
+    const iterator it = FindImpl(key, hash);
+    if (it != end()) {
+      return {it, false};
+    }
+    const std::size_t index = PrepareInsert(hash);
+    std::construct_at(&slots_[index].value, std::forward<Args>(args)...);
+    return {iterator(ctrl_ + index, slots_ + index), true};
+  }
+
+  // Claims a slot for a new element with `hash`, growing the table if needed, and returns its index. The caller
+  // must construct the value.
+  std::size_t PrepareInsert(uint64_t hash) {
+    std::size_t index = FindFirstNonFull(hash);
+    if (growth_left_ == 0 && ctrl_[index] != kFlatHashDeleted) [[unlikely]] {
+      // Many tombstones: rebuild at the same size, otherwise double.
+      Resize(size_ <= FlatHashCapacityToGrowth(capacity_) / 2 && capacity_ > 0 ? capacity_ : (capacity_ * 2) + 1);
+      index = FindFirstNonFull(hash);
+    }
+    if (ctrl_[index] == kFlatHashEmpty) {
+      --growth_left_;
+    }
+    ++size_;
+    SetCtrl(index, H2(hash));
+    if constexpr (StoreHash) {
+      hashes_[index] = hash;
+    }
+    return index;
+  }
+
+  // Writes a control byte, and its clone if it is in the first group.
+  void SetCtrl(std::size_t index, CtrlByte ctrl) noexcept {
+    ctrl_[index] = ctrl;
+    ctrl_[((index - kNumClonedBytes) & capacity_) + (kNumClonedBytes & capacity_)] = ctrl;
+  }
+
+  void Resize(std::size_t new_capacity) {
+    CtrlByte* const old_ctrl = ctrl_;
+    Slot* const old_slots = slots_;
+    uint64_t* const old_hashes = hashes_;
+    const std::size_t old_capacity = capacity_;
+    Allocate(new_capacity);
+    for (std::size_t index = 0; index < old_capacity; ++index) {
+      if (FlatHashIsFull(old_ctrl[index])) {
+        uint64_t hash = 0;
+        if constexpr (StoreHash) {
+          hash = old_hashes[index];
+        } else {
+          hash = HashOf(Policy::GetKey(old_slots[index].value));
+        }
+        const std::size_t new_index = FindFirstNonFull(hash);
+        SetCtrl(new_index, H2(hash));
+        if constexpr (StoreHash) {
+          hashes_[new_index] = hash;
+        }
+        std::construct_at(&slots_[new_index].value, std::move(old_slots[index].value));
+        std::destroy_at(&old_slots[index].value);
+      }
+    }
+    growth_left_ = FlatHashCapacityToGrowth(capacity_) - size_;
+    Deallocate(old_ctrl, old_slots, old_hashes, old_capacity);
+  }
+
+  void CopyFrom(const FlatHashTable& other) {
+    ctrl_ = EmptyCtrl();
+    slots_ = nullptr;
+    hashes_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growth_left_ = 0;
+    if (other.size_ == 0) {
+      return;
+    }
+    reserve(other.size_);
+    for (std::size_t index = 0; index < other.capacity_; ++index) {
+      if (FlatHashIsFull(other.ctrl_[index])) {
+        uint64_t hash = 0;
+        if constexpr (StoreHash) {
+          hash = other.hashes_[index];
+        } else {
+          hash = HashOf(Policy::GetKey(other.slots_[index].value));
+        }
+        const std::size_t new_index = PrepareInsert(hash);
+        std::construct_at(&slots_[new_index].value, other.slots_[index].value);
+      }
+    }
+  }
+
+  static CtrlByte* EmptyCtrl() noexcept {
+    // Never written to: a table without slots has no `growth_left_`, so the first insert allocates.
+    return const_cast<CtrlByte*>(&kFlatHashEmptyGroup[0]);  // NOLINT(*-const-cast)
+  }
+
+  void Allocate(std::size_t capacity) {
+    // Also tells the compiler that `ctrl_size` does not wrap, so the sentinel is in range.
+    MBO_CONFIG_REQUIRE(
+        capacity > 0 && (capacity & (capacity + 1)) == 0 && capacity < max_size(),
+        "Capacity must be a 2^n-1 mask.");
+    const std::size_t ctrl_size = capacity + 1 + kNumClonedBytes;
+    ctrl_ = new CtrlByte[ctrl_size];
+    std::fill_n(ctrl_, ctrl_size, kFlatHashEmpty);
+    ctrl_[capacity] = kFlatHashSentinel;
+    slots_ = new Slot[capacity];
+    if constexpr (StoreHash) {
+      hashes_ = new uint64_t[capacity];
+    }
+    capacity_ = capacity;
+    growth_left_ = FlatHashCapacityToGrowth(capacity) - size_;
+  }
+
+  static void Deallocate(CtrlByte* ctrl, Slot* slots, uint64_t* hashes, std::size_t capacity) noexcept {
+    if (capacity > 0) {
+      delete[] ctrl;
+      delete[] slots;
+      delete[] hashes;
+    }
+  }
+
+  void DestroyAll() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      for (std::size_t index = 0; index < capacity_; ++index) {
+        if (FlatHashIsFull(ctrl_[index])) {
+          std::destroy_at(&slots_[index].value);
+        }
+      }
+    }
+    Deallocate(ctrl_, slots_, hashes_, capacity_);
+  }
+
+  CtrlByte* ctrl_ = EmptyCtrl();
+  Slot* slots_ = nullptr;
+  uint64_t* hashes_ = nullptr;  // Only with `StoreHash`.
+  std::size_t capacity_ = 0;
+  std::size_t size_ = 0;
+  std::size_t growth_left_ = 0;
+  [[no_unique_address]] Hash hash_;
+  [[no_unique_address]] Eq eq_;
+};
+
+// NOLINTEND(readability-identifier-naming)
+
+// NOLINTEND(*-magic-numbers)
+// NOLINTEND(*-pro-type-union-access,*-pro-bounds-pointer-arithmetic,*-pro-bounds-constant-array-index)
+
+}  // namespace mbo::container::container_internal
+
+#endif  // MBO_CONTAINER_INTERNAL_FLAT_HASH_TABLE_H_
@@ -17,8 +17,12 @@
 #define MBO_CONTAINER_INTERNAL_LIMITED_ORDERED_H_
 
 #include <algorithm>
+#include <bit>
 #include <compare>   // IWYU pragma: keep
 #include <concepts>  // IWYU pragma: keep
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <new>  // IWYU pragma: keep
@@ -31,6 +35,16 @@
 #include "mbo/types/compare.h"              // IWYU pragma: export
 #include "mbo/types/traits.h"
 
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__)
+# include <nmmintrin.h>
+# define MBO_LIMITED_SIMD_COMPARE_64 1
+#else
+# define MBO_LIMITED_SIMD_COMPARE_64 0
+#endif
+
 #ifdef MBO_FORCE_INLINE
 # undef MBO_FORCE_INLINE
 #endif
@@ -62,6 +76,88 @@ concept LimitedOrderedValid =  //
     std::move_constructible<std::remove_const_t<Key>> && std::move_constructible<Mapped>
     && LimitedOrderedValidImpl<Key, Mapped, Value>;
 
+// Keys that `LimitedOptionsFlag::kSimdIndexOf` supports: integers in their natural order.
+template<typename Key, typename Compare>
+concept LimitedSimdIndexOfKey =
+    std::integral<Key> && !std::same_as<Key, bool>
+    && (sizeof(Key) == 1 || sizeof(Key) == 2 || sizeof(Key) == 4 || sizeof(Key) == 8)
+    && (std::same_as<Compare, std::less<Key>> || std::same_as<Compare, std::less<>>
+        || std::same_as<Compare, mbo::types::CompareLess<Key>>);
+
+// Returns the number of `keys` that are less than `key`. For sorted `keys` that is the position of
+// `key` if present. With SSE2 this compares 16 bytes of keys per instruction (64 bit keys need
+// SSE4.2) and sums up the comparison results. Otherwise it counts scalar but branch free,
+// which compilers can vectorize.
+//
+// The SIMD path supports `size < 512`.
+template<typename Key>
+requires(LimitedSimdIndexOfKey<Key, std::less<Key>>)
+MBO_ALWAYS_INLINE inline std::size_t LimitedSimdLowerBound(const Key* keys, std::size_t size, Key key) noexcept {
+  std::size_t pos = 0;
+  std::size_t count = 0;
+#if defined(__SSE2__)
+  if constexpr (sizeof(Key) < 8 || MBO_LIMITED_SIMD_COMPARE_64) {
+    constexpr std::size_t kLanes = 16 / sizeof(Key);
+    // SSE compares signed integers, so unsigned ones get their sign bit flipped.
+    const auto bias = [] {
+      if constexpr (std::is_signed_v<Key>) {
+        return _mm_setzero_si128();
+      } else if constexpr (sizeof(Key) == 1) {
+        return _mm_set1_epi8(static_cast<char>(0x80));
+      } else if constexpr (sizeof(Key) == 2) {
+        return _mm_set1_epi16(static_cast<int16_t>(0x8000));
+      } else if constexpr (sizeof(Key) == 4) {
+        return _mm_set1_epi32(static_cast<int32_t>(0x8000'0000U));
+      } else {
+        return _mm_set1_epi64x(static_cast<int64_t>(0x8000'0000'0000'0000ULL));
+      }
+    }();
+    const auto needle = [&] {
+      if constexpr (sizeof(Key) == 1) {
+        return _mm_xor_si128(_mm_set1_epi8(static_cast<char>(key)), bias);
+      } else if constexpr (sizeof(Key) == 2) {
+        return _mm_xor_si128(_mm_set1_epi16(static_cast<int16_t>(key)), bias);
+      } else if constexpr (sizeof(Key) == 4) {
+        return _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(key)), bias);
+      } else {
+        return _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(key)), bias);
+      }
+    }();
+    // All bytes of the lanes less than `key` are set (-1).
+    const auto less = [&](const Key* data) -> __m128i {
+      // NOLINTNEXTLINE(*-reinterpret-cast): Intrinsics take unaligned vector pointers.
+      const __m128i value = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), bias);
+      if constexpr (sizeof(Key) == 1) {
+        return _mm_cmpgt_epi8(needle, value);
+      } else if constexpr (sizeof(Key) == 2) {
+        return _mm_cmpgt_epi16(needle, value);
+      } else if constexpr (sizeof(Key) == 4) {
+        return _mm_cmpgt_epi32(needle, value);
+      } else {
+#if MBO_LIMITED_SIMD_COMPARE_64
+        return _mm_cmpgt_epi64(needle, value);
+#else
+        return value;  // Not reached.
+#endif
+      }
+    };
+    // Counting all blocks instead of stopping at the first one that is not all less than `key`
+    // keeps the loop free of data dependent branches. Each byte counts its own matches, which
+    // fits as long as there are less than 256 blocks.
+    __m128i bytes = _mm_setzero_si128();
+    for (; pos + kLanes <= size; pos += kLanes) {
+      bytes = _mm_sub_epi8(bytes, less(keys + pos));
+    }
+    const __m128i sums = _mm_sad_epu8(bytes, _mm_setzero_si128());
+    count = static_cast<std::size_t>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4)) / sizeof(Key);
+  }
+#endif  // defined(__SSE2__)
+  for (; pos < size; ++pos) {
+    count += keys[pos] < key ? 1 : 0;
+  }
+  return count;
+}
+
 template<typename Key, typename Mapped, typename Value, auto options, typename Compare = std::less<Key>>
 requires(LimitedOrderedValid<Key, Mapped, Value>)
 class [[nodiscard]] LimitedOrdered {
@@ -78,6 +174,32 @@ class [[nodiscard]] LimitedOrdered {
   static constexpr bool kOptimizeIndexOf = !Options::Has(LimitedOptionsFlag::kNoOptimizeIndexOf);
   static constexpr bool kCustomIndexOfBeyondUnroll = Options::Has(LimitedOptionsFlag::kCustomIndexOfBeyondUnroll);
 
+  // With `LimitedOptionsFlag::kEytzinger` lookups search a copy of the keys in `eytzinger_`.
+  static constexpr bool kEytzinger = Options::Has(LimitedOptionsFlag::kEytzinger);
+  static_assert(
+      !kEytzinger || (std::is_trivially_copyable_v<Key> && std::is_trivially_destructible_v<Key>),
+      "Flag `kEytzinger` requires trivially copyable and destructible keys.");
+  // Keys per cache line. Eytzinger searches prefetch the descendants of a node `log2` of this many levels down, which
+  // are the `kEytzingerPrefetch` keys from `node * kEytzingerPrefetch` on.
+  static constexpr std::size_t kEytzingerPrefetch = std::bit_floor(std::max<std::size_t>(1, 64 / sizeof(Key)));
+
+  // Maps with `LimitedOptionsFlag::kSeparateKeys` mirror their keys in `keys_` and search those.
+  static constexpr bool kSeparateKeys = !kKeyOnly && !kEytzinger && Options::Has(LimitedOptionsFlag::kSeparateKeys);
+  static_assert(
+      !kSeparateKeys || (std::is_trivially_copyable_v<Key> && std::is_trivially_destructible_v<Key>),
+      "Flag `kSeparateKeys` requires trivially copyable and destructible keys.");
+
+  // The vectorized `index_of` requires contiguous keys: sets and maps with `kSeparateKeys`.
+  static constexpr bool kSimdIndexOf = kOptimizeIndexOf && !kEytzinger && (kKeyOnly || kSeparateKeys)
+                                       && Options::Has(LimitedOptionsFlag::kSimdIndexOf)
+                                       && LimitedSimdIndexOfKey<Key, Compare>;
+  // Above this many keys `index_of` binary searches before scanning vectorized.
+  static constexpr std::size_t kSimdIndexOfWindow = 32;
+  static_assert(kSimdIndexOfWindow < 512);  // See `LimitedSimdLowerBound`.
+
+  template<typename K>
+  static constexpr bool kSimdIndexOfFor = kSimdIndexOf && std::same_as<std::remove_cvref_t<K>, Key>;
+
   static constexpr std::size_t kUnrollMaxCapacityLimit = 32;  // The maximum supported in code.
   static constexpr std::size_t kUnrollMaxCapacity = ::mbo::config::kUnrollMaxCapacityDefault;  // MUST MATCH `index_of`.
   static_assert(
@@ -113,6 +235,27 @@ class [[nodiscard]] LimitedOrdered {
     None none;
   };
 
+  // Only used with `kSeparateKeys`, so `Key` is trivially copyable and destructible.
+  union KeyData {
+    constexpr KeyData() noexcept : none{} {}
+
+    Key key;
+    None none;
+  };
+
+  struct SeparateKeys {
+    KeyData keys[Capacity == 0 ? 1 : Capacity];  // NOLINT(*-avoid-c-arrays)
+  };
+
+  // The keys in Eytzinger order (breadth first of the implicit search tree, 1-based: the children of `n` are `2n` and
+  // `2n+1`) and for each its index in `values_`. Aligned so the keys prefetched as a group share a cache line.
+  using EytzingerIndex = std::conditional_t<(Capacity <= 0xFFFF), std::uint16_t, std::uint32_t>;
+
+  struct alignas(64) EytzingerKeys {
+    KeyData keys[Capacity + 1];                // NOLINT(*-avoid-c-arrays)
+    EytzingerIndex index[Capacity + 1] = {};  // NOLINT(*-avoid-c-arrays)
+  };
+
  public:
   using key_type = Key;
   using value_type = Value;
@@ -421,13 +564,16 @@ class [[nodiscard]] LimitedOrdered {
     for (; size_ < other.size_; ++size_) {
       std::construct_at(const_cast<RawValue*>(&values_[size_].data), other.values_[size_].data);
     }
+    SyncKeys(0);
   }
 
   constexpr LimitedOrdered& operator=(const LimitedOrdered& other) noexcept {
     if (this != &other) {
       clear();
-      size_ = other.size_;
-      values_ = other.values_;
+      for (; size_ < other.size_; ++size_) {
+        std::construct_at(const_cast<RawValue*>(&values_[size_].data), other.values_[size_].data);
+      }
+      SyncKeys(0);
     }
     return *this;
   }
@@ -437,6 +583,7 @@ class [[nodiscard]] LimitedOrdered {
       std::construct_at(const_cast<RawValue*>(&values_[size_].data), std::move(other.values_[size_].data));
     }
     other.size_ = 0;
+    SyncKeys(0);
   }
 
   constexpr LimitedOrdered& operator=(LimitedOrdered&& other) noexcept {
@@ -445,6 +592,7 @@ class [[nodiscard]] LimitedOrdered {
       std::construct_at(const_cast<RawValue*>(&values_[size_].data), std::move(other.values_[size_].data));
     }
     other.size_ = 0;
+    SyncKeys(0);
     return *this;
   }
 
@@ -461,10 +609,11 @@ class [[nodiscard]] LimitedOrdered {
       if constexpr (Options::Has(LimitedOptionsFlag::kRequireSortedInput)) {
         std::construct_at(const_cast<RawValue*>(&values_[size_++].data), *first);
       } else {
-        emplace(*first);
+        EmplaceUnsynced(*first);
       }
       ++first;
     }
+    SyncKeys(0);
   }
 
   constexpr LimitedOrdered(const std::initializer_list<value_type>& list, const Compare& key_comp = Compare()) noexcept
@@ -521,19 +670,35 @@ class [[nodiscard]] LimitedOrdered {
   // Find and search: lower_bound, upper_bound, equal_range, find, contains, count
 
   MBO_FORCE_INLINE constexpr iterator lower_bound(const Key& key) {
-    return std::lower_bound(begin(), end(), key, val_comp_);
+    if constexpr (kSeparateKeys || kEytzinger) {
+      return begin() + static_cast<difference_type>(LowerBoundIndex(key));
+    } else {
+      return std::lower_bound(begin(), end(), key, val_comp_);
+    }
   }
 
   MBO_FORCE_INLINE constexpr const_iterator lower_bound(const Key& key) const {
-    return std::lower_bound(begin(), end(), key, val_comp_);
+    if constexpr (kSeparateKeys || kEytzinger) {
+      return begin() + static_cast<difference_type>(LowerBoundIndex(key));
+    } else {
+      return std::lower_bound(begin(), end(), key, val_comp_);
+    }
   }
 
   MBO_FORCE_INLINE constexpr iterator upper_bound(const Key& key) {
-    return std::upper_bound(begin(), end(), key, val_comp_);
+    if constexpr (kSeparateKeys || kEytzinger) {
+      return begin() + static_cast<difference_type>(UpperBoundIndex(key));
+    } else {
+      return std::upper_bound(begin(), end(), key, val_comp_);
+    }
   }
 
   MBO_FORCE_INLINE constexpr const_iterator upper_bound(const Key& key) const {
-    return std::upper_bound(begin(), end(), key, val_comp_);
+    if constexpr (kSeparateKeys || kEytzinger) {
+      return begin() + static_cast<difference_type>(UpperBoundIndex(key));
+    } else {
+      return std::upper_bound(begin(), end(), key, val_comp_);
+    }
   }
 
   // Transparent overloads. Each is constrained on `kIsForeignKey`, so it only
@@ -544,25 +709,72 @@ class [[nodiscard]] LimitedOrdered {
   template<typename K>
   requires(kIsForeignKey<K>)
   MBO_FORCE_INLINE constexpr iterator lower_bound(const K& key) {
-    return std::lower_bound(begin(), end(), key, val_comp_);
+    if constexpr (kSeparateKeys || kEytzinger) {
+      return begin() + static_cast<difference_type>(LowerBoundIndex(key));
+    } else {
+      return std::lower_bound(begin(), end(), key, val_comp_);
+    }
   }
 
   template<typename K>
   requires(kIsForeignKey<K>)
   MBO_FORCE_INLINE constexpr const_iterator lower_bound(const K& key) const {
-    return std::lower_bound(begin(), end(), key, val_comp_);
+    if constexpr (kSeparateKeys || kEytzinger) {
+      return begin() + static_cast<difference_type>(LowerBoundIndex(key));
+    } else {
+      return std::lower_bound(begin(), end(), key, val_comp_);
+    }
   }
 
   template<typename K>
   requires(kIsForeignKey<K>)
   MBO_FORCE_INLINE constexpr iterator upper_bound(const K& key) {
-    return std::upper_bound(begin(), end(), key, val_comp_);
+    if constexpr (kSeparateKeys || kEytzinger) {
+      return begin() + static_cast<difference_type>(UpperBoundIndex(key));
+    } else {
+      return std::upper_bound(begin(), end(), key, val_comp_);
+    }
   }
 
   template<typename K>
   requires(kIsForeignKey<K>)
   MBO_FORCE_INLINE constexpr const_iterator upper_bound(const K& key) const {
-    return std::upper_bound(begin(), end(), key, val_comp_);
+    if constexpr (kSeparateKeys || kEytzinger) {
+      return begin() + static_cast<difference_type>(UpperBoundIndex(key));
+    } else {
+      return std::upper_bound(begin(), end(), key, val_comp_);
+    }
+  }
+
+  // With `LimitedOptionsFlag::kSimdIndexOf`: binary search down to `kSimdIndexOfWindow` keys, then
+  // find the position with `LimitedSimdLowerBound`. Constant evaluation uses the same steps scalar.
+  template<typename K = Key>
+  requires(std::same_as<std::remove_cvref_t<K>, std::remove_cvref_t<Key>> || kIsForeignKey<K>)
+  MBO_ALWAYS_INLINE constexpr std::size_t index_of(const K& key) const
+  requires(kSimdIndexOfFor<K>)
+  {
+    std::size_t left = 0;
+    std::size_t right = size_;
+    while (right - left > kSimdIndexOfWindow) {
+      const std::size_t pos = left + ((right - left) >> 1U);
+      if (KeyAt(pos) < key) {
+        left = pos + 1;
+      } else {
+        right = pos;
+      }
+    }
+    if (std::is_constant_evaluated()) {
+      while (left < right && KeyAt(left) < key) {
+        ++left;
+      }
+    } else if constexpr (kSeparateKeys) {
+      static_assert(sizeof(KeyData) == sizeof(Key));
+      left += LimitedSimdLowerBound(&keys_.keys[left].key, right - left, key);
+    } else {
+      static_assert(sizeof(Data) == sizeof(Key));
+      left += LimitedSimdLowerBound(&values_[left].data, right - left, key);
+    }
+    return left < size_ && KeyAt(left) == key ? left : npos;
   }
 
   // NOLINTBEGIN(*-magic-numbers,*-macro-usage,*-function-size,readability-function-cognitive-complexity)
@@ -573,7 +785,7 @@ class [[nodiscard]] LimitedOrdered {
   template<typename K = Key>
   requires(std::same_as<std::remove_cvref_t<K>, std::remove_cvref_t<Key>> || kIsForeignKey<K>)
   MBO_ALWAYS_INLINE constexpr std::size_t index_of(const K& key) const
-  requires(kOptimizeIndexOf && Capacity <= kUnrollMaxCapacity)
+  requires(kOptimizeIndexOf && !kEytzinger && !kSimdIndexOfFor<K> && Capacity <= kUnrollMaxCapacity)
   {
 #define MBO_CASE_LIMITED_POS_COMP(POS)                                     \
   static_assert((POS) + 1 <= kUnrollMaxCapacityLimit);                     \
@@ -581,7 +793,7 @@ class [[nodiscard]] LimitedOrdered {
     if constexpr ((POS) >= Capacity) {                                     \
       return npos;                                                         \
     } else if constexpr (mbo::types::IsCompareLess<Compare>) {             \
-      const auto comp = key_comp_.Compare(key, GetKey(values_[POS].data)); \
+      const auto comp = key_comp_.Compare(key, KeyAt(POS));                \
       if (comp >= 0) [[unlikely]] {                                        \
         if (comp > 0) [[likely]] {                                         \
           return npos;                                                     \
@@ -590,8 +802,8 @@ class [[nodiscard]] LimitedOrdered {
         }                                                                  \
       }                                                                    \
     } else {                                                               \
-      if (!key_comp_(key, GetKey(values_[POS].data))) [[unlikely]] {       \
-        if (key_comp_(GetKey(values_[POS].data), key)) [[likely]] {        \
+      if (!key_comp_(key, KeyAt(POS))) [[unlikely]] {                      \
+        if (key_comp_(KeyAt(POS), key)) [[likely]] {                       \
           return npos;                                                     \
         } else [[unlikely]] {                                              \
           return POS;                                                      \
@@ -642,14 +854,14 @@ class [[nodiscard]] LimitedOrdered {
   requires(std::same_as<std::remove_cvref_t<K>, std::remove_cvref_t<Key>> || kIsForeignKey<K>)
   MBO_ALWAYS_INLINE constexpr std::size_t index_of(const K& key) const
   requires(
-      kOptimizeIndexOf && kCustomIndexOfBeyondUnroll
+      kOptimizeIndexOf && !kEytzinger && !kSimdIndexOfFor<K> && kCustomIndexOfBeyondUnroll
       && mbo::types::IsCompareLess<Compare> && Capacity > kUnrollMaxCapacity)
   {
     std::size_t left = 0;
     std::size_t right = size_;
     while (left < right) [[likely]] {
       const std::size_t pos = left + ((right - left) >> 1U);
-      auto cmp = key_comp_.Compare(key, GetKey(values_[pos]));
+      auto cmp = key_comp_.Compare(key, KeyAt(pos));
       if (cmp < 0) [[unlikely]] {
         right = pos;
       } else if (cmp > 0) {
@@ -665,7 +877,7 @@ class [[nodiscard]] LimitedOrdered {
   requires(std::same_as<std::remove_cvref_t<K>, std::remove_cvref_t<Key>> || kIsForeignKey<K>)
   MBO_ALWAYS_INLINE std::size_t index_of(const K& key) const
   requires(
-      kOptimizeIndexOf && kCustomIndexOfBeyondUnroll
+      kOptimizeIndexOf && !kEytzinger && !kSimdIndexOfFor<K> && kCustomIndexOfBeyondUnroll
       && !mbo::types::IsCompareLess<Compare> && Capacity > kUnrollMaxCapacity)
   {
     if (size_ == 0) {
@@ -676,14 +888,14 @@ class [[nodiscard]] LimitedOrdered {
     while (true) {
       const std::size_t diff = (right - left) >> 1U;
       const std::size_t pos = left + diff;
-      if (key_comp_(key, GetKey(values_[pos]))) [[likely]] {
+      if (key_comp_(key, KeyAt(pos))) [[likely]] {
         if (diff == 0) [[unlikely]] {
           return npos;
         }
         right = pos;
       } else {
         if (diff == 0) [[unlikely]] {
-          if (key_comp_(GetKey(values_[left]), key)) [[likely]] {
+          if (key_comp_(KeyAt(left), key)) [[likely]] {
             return npos;
           } else [[unlikely]] {
             return left;
@@ -697,12 +909,26 @@ class [[nodiscard]] LimitedOrdered {
   template<typename K = Key>
   requires(std::same_as<std::remove_cvref_t<K>, std::remove_cvref_t<Key>> || kIsForeignKey<K>)
   MBO_ALWAYS_INLINE constexpr std::size_t index_of(const K& key) const
-  requires(!kOptimizeIndexOf || (kOptimizeIndexOf && !kCustomIndexOfBeyondUnroll && Capacity > kUnrollMaxCapacity))
+  requires(
+      !kOptimizeIndexOf
+      || (kOptimizeIndexOf && !kEytzinger && !kSimdIndexOfFor<K> && !kCustomIndexOfBeyondUnroll
+          && Capacity > kUnrollMaxCapacity))
   {
     const const_iterator it = lower_bound(key);
     return it == end() || key_comp_(key, GetKey(*it)) ? npos : it - begin();
   }
 
+  // With `LimitedOptionsFlag::kEytzinger` at any capacity. The found key is in `eytzinger_`, so a miss does not touch
+  // `values_` at all.
+  template<typename K = Key>
+  requires(std::same_as<std::remove_cvref_t<K>, std::remove_cvref_t<Key>> || kIsForeignKey<K>)
+  MBO_ALWAYS_INLINE constexpr std::size_t index_of(const K& key) const
+  requires(kOptimizeIndexOf && kEytzinger)
+  {
+    const std::size_t node = EytzingerLowerBound(key);
+    return node == 0 || key_comp_(key, eytzinger_.keys[node].key) ? npos : eytzinger_.index[node];
+  }
+
   MBO_FORCE_INLINE constexpr value_type& at_index(size_type pos) {
     MBO_CONFIG_REQUIRE(pos < size_, "Out of range");
     return values_[pos].data;
@@ -888,32 +1114,31 @@ class [[nodiscard]] LimitedOrdered {
         std::swap(values_[pos].data.second, other.values_[pos].data.second);
       }
     }
+    // The remaining values go past the end of the shorter side. Their insertion must search `values_`, the key copies
+    // are only synced at the end.
     const std::size_t other_size = other.size_;
     const std::size_t this_size = size_;
     for (; pos < size_; ++pos) {
-      other.emplace(std::move(values_[pos].data));
+      other.EmplaceUnsynced(std::move(values_[pos].data));
+      std::destroy_at(&values_[pos].data);
     }
     for (; pos < other.size(); ++pos) {
-      emplace(std::move(other.values_[pos].data));
+      EmplaceUnsynced(std::move(other.values_[pos].data));
+      std::destroy_at(&other.values_[pos].data);
     }
     size_ = other_size;
     other.size_ = this_size;
+    SyncKeys(0);
+    other.SyncKeys(0);
   }
 
   template<typename... Args>
   constexpr std::pair<iterator, bool> emplace(Args&&... args) noexcept(!kRequireThrows) {
-    const RawValue new_val(std::forward<Args>(args)...);
-    const iterator dst = lower_bound(GetKey(new_val));
-    if (dst != end() && !key_comp_(GetKey(*dst), GetKey(new_val)) && !key_comp_(GetKey(new_val), GetKey(*dst))) {
-      return std::make_pair(dst, false);
+    const std::pair<iterator, bool> result = EmplaceUnsynced(std::forward<Args>(args)...);
+    if (result.second) {
+      SyncKeys(static_cast<std::size_t>(result.first - begin()));
     }
-    MBO_CONFIG_REQUIRE(size_ < Capacity, "Called `emplace` at capacity.");
-    for (iterator next = end(); next > dst; --next) {
-      std::construct_at(const_cast<RawValue*>(&*next), std::move(*std::prev(next)));
-    }
-    std::construct_at(const_cast<RawValue*>(&*dst), std::move(new_val));
-    ++size_;
-    return std::make_pair(dst, true);
+    return result;
   }
 
   template<typename It>
@@ -921,28 +1146,31 @@ class [[nodiscard]] LimitedOrdered {
   constexpr iterator erase(It pos) noexcept(!kRequireThrows) {
     MBO_CONFIG_REQUIRE(begin() <= pos && pos < end(), "Invalid `pos`.");
     auto dst = to_iterator(pos);
+    const auto index = static_cast<std::size_t>(dst - begin());
     --size_;
     std::destroy_at(&*dst);
     for (; dst < end(); ++dst) {
       std::construct_at(const_cast<RawValue*>(&*dst), std::move(*std::next(dst)));
     }
+    SyncKeys(index);
     return pos > end() ? end() : to_iterator(pos);
   }
 
   constexpr iterator erase(const_iterator first, const_iterator last) noexcept(!kRequireThrows) {
-    MBO_CONFIG_REQUIRE(begin() <= first && first <= last && last <= end(), "Invalid `first` or `last`.");
-    std::size_t deleted = 0;
-    for (const_iterator it = first; it < last; ++it) {
-      std::destroy_at(it);
-      ++deleted;
-    }
+    MBO_CONFIG_REQUIRE(cbegin() <= first && first <= last && last <= cend(), "Invalid `first` or `last`.");
     auto dst = to_iterator(first);
     auto src = to_iterator(last);
+    const auto index = static_cast<std::size_t>(dst - begin());
+    for (auto it = dst; it < src; ++it) {
+      std::destroy_at(&*it);
+    }
     for (; src < end(); ++src, ++dst) {
-      *dst = std::move(*src);
+      std::construct_at(const_cast<RawValue*>(&*dst), std::move(*src));
+      std::destroy_at(&*src);
     }
-    size_ -= deleted;
-    return to_iterator(first);
+    size_ = static_cast<std::size_t>(dst - begin());
+    SyncKeys(index);
+    return begin() + static_cast<difference_type>(index);
   }
 
   constexpr size_type erase(const Key& key) {
@@ -1042,6 +1270,7 @@ class [[nodiscard]] LimitedOrdered {
         const_cast<RawValue*>(&*dst), std::piecewise_construct, std::forward_as_tuple(key),
         std::forward_as_tuple(std::forward<Args>(args)...));
     ++size_;
+    SyncKeys(static_cast<std::size_t>(dst - begin()));
     return std::make_pair(dst, true);
   }
 
@@ -1061,6 +1290,7 @@ class [[nodiscard]] LimitedOrdered {
     // But that creates issues with conversion. However, we know the two types, so we do not need piecewise.
     std::construct_at(const_cast<RawValue*>(&*dst), std::move(key), Mapped(std::forward<Args>(args)...));
     ++size_;
+    SyncKeys(static_cast<std::size_t>(dst - begin()));
     return std::make_pair(dst, true);
   }
 
@@ -1078,6 +1308,7 @@ class [[nodiscard]] LimitedOrdered {
     }
     std::construct_at(const_cast<RawValue*>(&*dst), key, std::forward<V>(value));
     ++size_;
+    SyncKeys(static_cast<std::size_t>(dst - begin()));
     return std::make_pair(dst, true);
   }
 
@@ -1095,6 +1326,7 @@ class [[nodiscard]] LimitedOrdered {
     }
     std::construct_at(const_cast<RawValue*>(&*dst), std::move(key), std::forward<V>(value));
     ++size_;
+    SyncKeys(static_cast<std::size_t>(dst - begin()));
     return std::make_pair(dst, true);
   }
 
@@ -1153,7 +1385,7 @@ class [[nodiscard]] LimitedOrdered {
  protected:
   static constexpr iterator to_iterator(iterator pos) noexcept { return pos; }
 
-  static constexpr iterator to_iterator(const const_iterator& pos) noexcept { return iterator(pos.pos); }
+  constexpr iterator to_iterator(const const_iterator& pos) noexcept { return begin() + (pos - cbegin()); }
 
   // NOLINTNEXTLINE(bugprone-return-const-ref-from-parameter)
   static constexpr const Key& GetKey(const Key& key) noexcept { return key; }
@@ -1173,12 +1405,135 @@ class [[nodiscard]] LimitedOrdered {
   }
 
  private:
+  // The key at `pos`, from `keys_` with `kSeparateKeys`.
+  MBO_ALWAYS_INLINE constexpr const Key& KeyAt(std::size_t pos) const noexcept {
+    if constexpr (kSeparateKeys) {
+      return keys_.keys[pos].key;
+    } else {
+      return GetKey(values_[pos].data);
+    }
+  }
+
+  // The `emplace` without `SyncKeys`, so it only searches `values_`. The iterator constructor uses this, so that it
+  // builds `eytzinger_` once, not per element.
+  template<typename... Args>
+  constexpr std::pair<iterator, bool> EmplaceUnsynced(Args&&... args) noexcept(!kRequireThrows) {
+    const RawValue new_val(std::forward<Args>(args)...);
+    const iterator dst = std::lower_bound(begin(), end(), GetKey(new_val), val_comp_);
+    if (dst != end() && !key_comp_(GetKey(*dst), GetKey(new_val)) && !key_comp_(GetKey(new_val), GetKey(*dst))) {
+      return std::make_pair(dst, false);
+    }
+    MBO_CONFIG_REQUIRE(size_ < Capacity, "Called `emplace` at capacity.");
+    for (iterator next = end(); next > dst; --next) {
+      std::construct_at(const_cast<RawValue*>(&*next), std::move(*std::prev(next)));  // NOLINT(*-const-cast)
+    }
+    std::construct_at(const_cast<RawValue*>(&*dst), std::move(new_val));  // NOLINT(*-const-cast)
+    ++size_;
+    return std::make_pair(dst, true);
+  }
+
+  // With `kSeparateKeys` copies the keys of all values from `pos` on into `keys_`, with `kEytzinger` rebuilds all of
+  // `eytzinger_`. Must be called after every modification that changes keys or their positions.
+  constexpr void SyncKeys(std::size_t pos) noexcept {
+    if constexpr (kSeparateKeys) {
+      for (; pos < size_; ++pos) {
+        keys_.keys[pos].key = values_[pos].data.first;
+      }
+    } else if constexpr (kEytzinger) {
+      BuildEytzinger(0, 1);
+    }
+  }
+
+  // Fills the subtree at `node` in order from `values_[pos]` on and returns the position after it.
+  constexpr std::size_t BuildEytzinger(std::size_t pos, std::size_t node) noexcept {
+    if (node <= size_) {
+      pos = BuildEytzinger(pos, 2 * node);
+      eytzinger_.keys[node].key = GetKey(values_[pos].data);
+      eytzinger_.index[node] = static_cast<EytzingerIndex>(pos);
+      pos = BuildEytzinger(pos + 1, 2 * node + 1);
+    }
+    return pos;
+  }
+
+  // Returns the node of the first key in `eytzinger_` that is not less than `key`, or 0 if there is none. The descent
+  // has no data dependent branches: each step goes left or right and the node after the last right turn is the result.
+  template<typename K>
+  MBO_ALWAYS_INLINE constexpr std::size_t EytzingerLowerBound(const K& key) const noexcept {
+    std::size_t node = 1;
+    while (node <= size_) {
+      if (!std::is_constant_evaluated()) {
+        __builtin_prefetch(&eytzinger_.keys[std::min(node * kEytzingerPrefetch, Capacity)]);
+      }
+      node = 2 * node + (key_comp_(eytzinger_.keys[node].key, key) ? 1 : 0);
+    }
+    return node >> (std::countr_one(node) + 1);
+  }
+
+  // Same as `EytzingerLowerBound` but for the first key greater than `key`.
+  template<typename K>
+  MBO_ALWAYS_INLINE constexpr std::size_t EytzingerUpperBound(const K& key) const noexcept {
+    std::size_t node = 1;
+    while (node <= size_) {
+      if (!std::is_constant_evaluated()) {
+        __builtin_prefetch(&eytzinger_.keys[std::min(node * kEytzingerPrefetch, Capacity)]);
+      }
+      node = 2 * node + (key_comp_(key, eytzinger_.keys[node].key) ? 0 : 1);
+    }
+    return node >> (std::countr_one(node) + 1);
+  }
+
+  template<typename K>
+  constexpr std::size_t LowerBoundIndex(const K& key) const noexcept {
+    if constexpr (kEytzinger) {
+      const std::size_t node = EytzingerLowerBound(key);
+      return node == 0 ? size_ : eytzinger_.index[node];
+    }
+    std::size_t left = 0;
+    std::size_t count = size_;
+    while (count > 0) {
+      const std::size_t step = count >> 1U;
+      if (key_comp_(KeyAt(left + step), key)) {
+        left += step + 1;
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+    return left;
+  }
+
+  template<typename K>
+  constexpr std::size_t UpperBoundIndex(const K& key) const noexcept {
+    if constexpr (kEytzinger) {
+      const std::size_t node = EytzingerUpperBound(key);
+      return node == 0 ? size_ : eytzinger_.index[node];
+    }
+    std::size_t left = 0;
+    std::size_t count = size_;
+    while (count > 0) {
+      const std::size_t step = count >> 1U;
+      if (!key_comp_(key, KeyAt(left + step))) {
+        left += step + 1;
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+    return left;
+  }
+
   std::size_t size_{0};
 
   // Array would be better but that does not work with ASAN builds.
   // std::array<Data, Capacity == 0 ? 1 : Capacity> values_;
   Data values_[Capacity == 0 ? 1 : Capacity];  // NOLINT(*-avoid-c-arrays)
 
+  // Dense copy of the keys of `values_` for `kSeparateKeys` maps.
+  [[no_unique_address]] std::conditional_t<kSeparateKeys, SeparateKeys, None> keys_;
+
+  // Search tree of the keys of `values_` for `kEytzinger`.
+  [[no_unique_address]] std::conditional_t<kEytzinger, EytzingerKeys, None> eytzinger_;
+
   const key_compare key_comp_ = {};
   const value_compare val_comp_ = value_compare(key_comp_);
 };
@@ -1197,4 +1552,6 @@ class [[nodiscard]] LimitedOrdered {
 # undef MBO_ALWAYS_INLINE
 #endif
 
+#undef MBO_LIMITED_SIMD_COMPARE_64
+
 #endif  // MBO_CONTAINER_INTERNAL_LIMITED_ORDERED_H_
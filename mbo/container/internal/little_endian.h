@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_CONTAINER_INTERNAL_LITTLE_ENDIAN_H_
+#define MBO_CONTAINER_INTERNAL_LITTLE_ENDIAN_H_
+
+#include <concepts>  // IWYU pragma: keep
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace mbo::container::container_internal {
+
+// Byte order independent serialization of unsigned integers as used by the serialized forms of the filters and
+// sketches in this package.
+
+template<std::unsigned_integral T>
+inline void AppendLittleEndian(std::string& out, T value) {
+  for (std::size_t byte = 0; byte < sizeof(T); ++byte) {
+    out.push_back(static_cast<char>(static_cast<unsigned char>(value >> (8U * byte))));
+  }
+}
+
+// Reads a `T` at `pos`, the caller must ensure that `data` has at least `pos + sizeof(T)` bytes.
+template<std::unsigned_integral T>
+inline T ReadLittleEndian(std::string_view data, std::size_t pos) noexcept {
+  T value = 0;
+  for (std::size_t byte = 0; byte < sizeof(T); ++byte) {
+    value |= static_cast<T>(static_cast<T>(static_cast<unsigned char>(data[pos + byte])) << (8U * byte));
+  }
+  return value;
+}
+
+}  // namespace mbo::container::container_internal
+
+#endif  // MBO_CONTAINER_INTERNAL_LITTLE_ENDIAN_H_
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares `LimitedMap` lookups with the default layout against `LimitedOptionsFlag::kSeparateKeys`
+// for mapped types of different sizes.
+// Run with: bazel run -c opt //mbo/container:limited_map_benchmark
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mbo/container/limited_map.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+template<std::size_t Size>
+struct Mapped {
+  std::array<char, Size> data{};
+};
+
+constexpr std::size_t kNumMaps = 64;  // More maps than fit into the L1 cache at the larger sizes.
+
+template<std::size_t Capacity, typename Map>
+void BmFind(benchmark::State& state) {
+  const bool hit = state.range(0) != 0;
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+  std::mt19937 rng(42);
+  std::vector<std::string> keys;
+  for (std::size_t idx = 0; idx < 2 * Capacity; ++idx) {
+    keys.push_back(std::to_string(rng()));
+  }
+  std::vector<Map> maps(kNumMaps);
+  for (Map& map : maps) {
+    for (std::size_t idx = 0; idx < Capacity; ++idx) {
+      map.emplace(keys[idx], typename Map::mapped_type{});
+    }
+  }
+  std::vector<std::string_view> input;
+  for (std::size_t idx = 0; idx < 1'000; ++idx) {
+    input.emplace_back(keys[(rng() % Capacity) + (hit ? 0 : Capacity)]);
+  }
+  std::size_t map = 0;
+  std::size_t item = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(maps[map].find(input[item]));
+    map = (map + 1) % kNumMaps;
+    item = (item + 1) % input.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<std::size_t Capacity, std::size_t MappedSize>
+using DefaultMap = LimitedMap<std::string_view, Mapped<MappedSize>, Capacity>;
+
+template<std::size_t Capacity, std::size_t MappedSize>
+using SeparateKeysMap =
+    LimitedMap<std::string_view, Mapped<MappedSize>, LimitedOptions<Capacity, LimitedOptionsFlag::kSeparateKeys>{}>;
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+
+#define MBO_REGISTER_BENCHMARKS(Capacity, MappedSize)                              \
+  BENCHMARK(BmFind<Capacity, DefaultMap<Capacity, MappedSize>>)->Arg(1)->Arg(0); \
+  BENCHMARK(BmFind<Capacity, SeparateKeysMap<Capacity, MappedSize>>)->Arg(1)->Arg(0)
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+MBO_REGISTER_BENCHMARKS(16, 8);
+MBO_REGISTER_BENCHMARKS(16, 256);
+MBO_REGISTER_BENCHMARKS(128, 8);
+MBO_REGISTER_BENCHMARKS(128, 64);
+MBO_REGISTER_BENCHMARKS(128, 256);
+MBO_REGISTER_BENCHMARKS(128, 1024);
+
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+#undef MBO_REGISTER_BENCHMARKS
+
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
+
+BENCHMARK_MAIN();  // NOLINT
@@ -16,6 +16,8 @@
 #include "mbo/container/limited_map.h"
 
 #include <array>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iterator>   // IWYU pragma: keep
@@ -52,6 +54,7 @@ namespace {
 using ::mbo::testing::CapacityIs;
 using ::testing::Contains;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::Eq;
 using ::testing::Ge;
 using ::testing::Gt;
@@ -627,6 +630,144 @@ TEST_F(LimitedMapTest, InsertingOperationsStillRequireARealKey) {
   static_assert(CanAtWith<TransparentMap, MapKey>);
 }
 
+template<std::size_t Capacity>
+using SeparateKeysMap =
+    LimitedMap<std::string_view, std::string, LimitedOptions<Capacity, LimitedOptionsFlag::kSeparateKeys>{}>;
+
+TEST_F(LimitedMapTest, SeparateKeysConstexpr) {
+  using Map = LimitedMap<int, int, LimitedOptions<4, LimitedOptionsFlag::kSeparateKeys>{}>;
+  static constexpr Map kTest{{3, 30}, {1, 10}, {2, 20}};
+  static_assert(kTest.contains(1));
+  static_assert(!kTest.contains(4));
+  static_assert(kTest.at(2) == 20);
+  static_assert(kTest.index_of(3) == 2);
+  static_assert(kTest.lower_bound(2) == kTest.begin() + 1);
+  static_assert(kTest.upper_bound(2) == kTest.begin() + 2);
+  EXPECT_THAT(kTest, ElementsAre(Pair(1, 10), Pair(2, 20), Pair(3, 30)));
+  constexpr auto kErased = [] {
+    Map test{{3, 30}, {1, 10}, {2, 20}};
+    test.erase(2);
+    test.try_emplace(4, 40);
+    return test;
+  }();
+  static_assert(kErased.contains(4));
+  static_assert(!kErased.contains(2));
+  EXPECT_THAT(kErased, ElementsAre(Pair(1, 10), Pair(3, 30), Pair(4, 40)));
+}
+
+// Every modification must keep the separate keys of `Map` in sync, which the lookups reveal.
+template<typename Map>
+void KeyCopyModificationsFor() {
+  const std::vector<std::string_view> keys{"m", "c", "x", "a", "q", "f", "z", "b"};
+  Map test;
+  LimitedMap<std::string_view, std::string, 8> expected;
+  const auto check = [&](std::string_view step) {
+    SCOPED_TRACE(step);
+    ASSERT_THAT(test, ElementsAreArray(expected));
+    for (const std::string_view key : {"", "a", "b", "c", "d", "f", "m", "q", "x", "y", "z", "zz"}) {
+      ASSERT_THAT(test.contains(key), expected.contains(key)) << key;
+      ASSERT_THAT(test.index_of(key), expected.index_of(key)) << key;
+      ASSERT_THAT(test.lower_bound(key) - test.begin(), expected.lower_bound(key) - expected.begin()) << key;
+      ASSERT_THAT(test.upper_bound(key) - test.begin(), expected.upper_bound(key) - expected.begin()) << key;
+    }
+  };
+  for (const std::string_view key : keys) {
+    test.emplace(key, std::string(key));
+    expected.emplace(key, std::string(key));
+    check("emplace");
+  }
+  test.erase("c");
+  expected.erase("c");
+  check("erase key");
+  test.erase(test.begin());
+  expected.erase(expected.begin());
+  check("erase iterator");
+  test.erase(test.cbegin() + 1, test.cbegin() + 3);
+  expected.erase(expected.cbegin() + 1, expected.cbegin() + 3);
+  check("erase range");
+  test.try_emplace("d", "try");
+  expected.try_emplace("d", "try");
+  check("try_emplace");
+  test.insert_or_assign("y", "assign");
+  expected.insert_or_assign("y", "assign");
+  check("insert_or_assign");
+  test["a"] = "subscript";
+  expected["a"] = "subscript";
+  check("operator[]");
+  const Map copy(test);
+  test.clear();
+  expected.clear();
+  check("clear");
+  test = copy;
+  expected = LimitedMap<std::string_view, std::string, 8>(copy.begin(), copy.end());
+  check("copy");
+  Map other{{"k", "k"}};
+  test.swap(other);
+  EXPECT_THAT(test, ElementsAre(Pair("k", "k")));
+  EXPECT_TRUE(test.contains("k"));
+  EXPECT_FALSE(test.contains("y"));
+  test.swap(other);
+  check("swap");
+  const Map moved(std::move(test));
+  EXPECT_THAT(moved, ElementsAreArray(expected));
+  EXPECT_TRUE(moved.contains("y"));
+}
+
+TEST_F(LimitedMapTest, SeparateKeysModifications) { KeyCopyModificationsFor<SeparateKeysMap<8>>(); }
+
+TEST_F(LimitedMapTest, EytzingerModifications) {
+  using Map = LimitedMap<std::string_view, std::string, LimitedOptions<8, LimitedOptionsFlag::kEytzinger>{}>;
+  KeyCopyModificationsFor<Map>();
+}
+
+// The values of the longer side go past the end of the shorter side, whose separate keys are stale until the swap ends.
+TEST_F(LimitedMapTest, SeparateKeysSwap) {
+  SeparateKeysMap<8> test1{{"b", "1"}, {"d", "2"}, {"f", "3"}};
+  SeparateKeysMap<8> test2{{"a", "4"}, {"c", "5"}, {"e", "6"}, {"g", "7"}, {"h", "8"}};
+  test1.swap(test2);
+  EXPECT_THAT(test1, ElementsAre(Pair("a", "4"), Pair("c", "5"), Pair("e", "6"), Pair("g", "7"), Pair("h", "8")));
+  EXPECT_THAT(test2, ElementsAre(Pair("b", "1"), Pair("d", "2"), Pair("f", "3")));
+  for (const std::string_view key : {"a", "c", "e", "g", "h"}) {
+    EXPECT_THAT(test1.index_of(key), test1.find(key) - test1.begin()) << key;
+    EXPECT_FALSE(test2.contains(key)) << key;
+  }
+  for (const std::string_view key : {"b", "d", "f"}) {
+    EXPECT_THAT(test2.index_of(key), test2.find(key) - test2.begin()) << key;
+    EXPECT_FALSE(test1.contains(key)) << key;
+  }
+  test1.swap(test2);
+  EXPECT_THAT(test1, ElementsAre(Pair("b", "1"), Pair("d", "2"), Pair("f", "3")));
+  EXPECT_THAT(test2, ElementsAre(Pair("a", "4"), Pair("c", "5"), Pair("e", "6"), Pair("g", "7"), Pair("h", "8")));
+  EXPECT_TRUE(test1.contains("f"));
+  EXPECT_FALSE(test1.contains("h"));
+  EXPECT_TRUE(test2.contains("h"));
+}
+
+TEST_F(LimitedMapTest, SeparateKeysIteratorsReturnReferences) {
+  SeparateKeysMap<4> test{{"a", "1"}, {"b", "2"}};
+  static_assert(std::same_as<decltype(*test.begin()), std::pair<const std::string_view, std::string>&>);
+  test.find("b")->second = "3";
+  for (auto& [key, value] : test) {
+    value += std::string(key);
+  }
+  EXPECT_THAT(test, ElementsAre(Pair("a", "1a"), Pair("b", "3b")));
+}
+
+TEST_F(LimitedMapTest, SeparateKeysSimdIndexOf) {
+  using Map = LimitedMap<
+      uint32_t, std::string,
+      LimitedOptions<100, LimitedOptionsFlag::kSeparateKeys, LimitedOptionsFlag::kSimdIndexOf>{}>;
+  Map test;
+  for (uint32_t key = 0; key < 100; ++key) {
+    test.emplace(key * 0x0200'0000U + 1, "");
+  }
+  for (uint32_t key = 0; key < 100; ++key) {
+    ASSERT_THAT(test.index_of(key * 0x0200'0000U + 1), key);
+    ASSERT_THAT(test.index_of(key * 0x0200'0000U), Map::npos);
+    ASSERT_THAT(test.index_of(key * 0x0200'0000U + 2), Map::npos);
+  }
+}
+
 // NOLINTEND(*-magic-numbers)
 
 }  // namespace
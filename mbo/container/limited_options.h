@@ -45,6 +45,26 @@ enum class LimitedOptionsFlag {
   // Tf true, then a customized `index_of` implementation will be used beyond loop unrolling. That can be particularly
   // good for some systems in cases where the vast majority of calls to `contains`, `find` or `index_of` are non hits.
   kCustomIndexOfBeyondUnroll,
+
+  // If true, then `LimitedSet` with integral keys ordered by `std::less` (or `mbo::types::CompareLess`) uses a
+  // vectorized `index_of` (and thus `contains` and `find`) at any capacity. That compares 16 bytes of keys per
+  // instruction (SSE2, 64 bit keys need SSE4.2) and uses a binary search to narrow down larger sets first. Constant
+  // evaluation and other platforms use scalar code. `LimitedMap` only supports this with `kSeparateKeys`, as its keys
+  // are otherwise interleaved with the values.
+  kSimdIndexOf,
+
+  // If true, then `LimitedMap` additionally keeps its keys in a dense array and all lookups search only that. This is
+  // meant for large mapped types, whose values would otherwise be strided over. The key type must be trivially
+  // copyable and destructible (e.g. `std::string_view` or integers). The values are still stored as `value_type`, so
+  // iterators keep returning real references. No effect on `LimitedSet`.
+  kSeparateKeys,
+
+  // If true, then `LimitedSet` and `LimitedMap` additionally keep their keys in Eytzinger order (the implicit binary
+  // search tree stored breadth first) and all lookups descend that tree branch free, prefetching the cache line of
+  // descendants a few levels ahead (four for 32 bit keys). This is meant for large tables that are built once and
+  // then only queried (e.g. `static constexpr` with `kRequireSortedInput`): every modification rebuilds the tree. The
+  // key type must be trivially copyable and destructible. Takes precedence over `kSeparateKeys` and `kSimdIndexOf`.
+  kEytzinger,
 };
 
 // Type used to control `LimitedSet` and `LimitedMap`.
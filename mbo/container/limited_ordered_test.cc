@@ -100,6 +100,7 @@ TEST_F(LimitedOrderedTest, ConstexprRequireSortedInputThrows) {
   if constexpr (kRequireThrows) {
 #if __cpp_exceptions
     using ::testing::HasSubstr;
+    bool caught = false;
     try {
       // Passing the value list direvtly into the constructor of `LimitedOrdered` results in a compile time exception.
       // That exception cannot be tested here, so the values are being passed at run-time using a vector. That allows
@@ -16,6 +16,7 @@
 #ifndef MBO_CONTAINER_LIMITED_SET_BENCHMARK_H_
 #define MBO_CONTAINER_LIMITED_SET_BENCHMARK_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
@@ -70,11 +71,16 @@ class Benchmarks {
   static constexpr std::size_t kNumTestsValues = 100'000;
 
   static BenchmarkedContainer GetData(Random& random) {
-    BenchmarkedContainer data;
-    while (data.size() < Size) {
-      data.insert(random.Uniform());
+    // Sorted first, so that the larger sizes are not built by shifting (or rebuilding the search tree) per insert.
+    std::vector<int> values;
+    while (values.size() < Size) {
+      values.push_back(random.Uniform());
+      if (values.size() == Size) {  // Drop duplicates, then top up.
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+      }
     }
-    return data;
+    return BenchmarkedContainer(values.begin(), values.end());
   }
 
   static std::vector<int> GetInput(Random& random, const BenchmarkedContainer& data) {
@@ -27,9 +27,11 @@ namespace mbo::container {
 #define MBO_REGISTER_BENCHMARK(Size, Compare, Func, HaveOrMiss, Flags) \
   BENCHMARK(Benchmarks<Size, HaveOrMiss, Compare, Flags>::Func)->Name(MakeName<HaveOrMiss>(#Compare, #Flags, #Func))
 
-#define MBO_REGISTER_BENCHMARKS_FLAGS(Size, Compare, Func, HaveOrMiss)                   \
-  MBO_REGISTER_BENCHMARK(Size, Compare, Func, HaveOrMiss, LimitedOptionsFlag::kDefault); \
-  MBO_REGISTER_BENCHMARK(Size, Compare, Func, HaveOrMiss, LimitedOptionsFlag::kNoOptimizeIndexOf)
+#define MBO_REGISTER_BENCHMARKS_FLAGS(Size, Compare, Func, HaveOrMiss)                             \
+  MBO_REGISTER_BENCHMARK(Size, Compare, Func, HaveOrMiss, LimitedOptionsFlag::kDefault);           \
+  MBO_REGISTER_BENCHMARK(Size, Compare, Func, HaveOrMiss, LimitedOptionsFlag::kNoOptimizeIndexOf); \
+  MBO_REGISTER_BENCHMARK(Size, Compare, Func, HaveOrMiss, LimitedOptionsFlag::kSimdIndexOf);       \
+  MBO_REGISTER_BENCHMARK(Size, Compare, Func, HaveOrMiss, LimitedOptionsFlag::kEytzinger)
 
 #define MBO_REGISTER_BENCHMARKS_COMPARE(Size, Func, HaveOrMiss)       \
   MBO_REGISTER_BENCHMARKS_FLAGS(Size, std::less<>, Func, HaveOrMiss); \
@@ -96,6 +98,13 @@ MBO_REGISTER_BENCHMARKS_SIZE(47);
 MBO_REGISTER_BENCHMARKS_SIZE(48);
 MBO_REGISTER_BENCHMARKS_SIZE(49);
 MBO_REGISTER_BENCHMARKS_SIZE(50);
+MBO_REGISTER_BENCHMARKS_SIZE(64);
+MBO_REGISTER_BENCHMARKS_SIZE(128);
+MBO_REGISTER_BENCHMARKS_SIZE(256);
+MBO_REGISTER_BENCHMARKS_SIZE(512);
+MBO_REGISTER_BENCHMARKS_SIZE(1024);
+MBO_REGISTER_BENCHMARKS_SIZE(2048);
+MBO_REGISTER_BENCHMARKS_SIZE(4096);
 
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
 // NOLINTEND(cppcoreguidelines-macro-usage)
@@ -15,9 +15,12 @@
 
 #include "mbo/container/limited_set.h"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <ranges>     // IWYU pragma: keep
 #include <stdexcept>  // IWYU pragma: keep
 #include <string>
@@ -548,8 +551,135 @@ TEST_F(LimitedSetTest, CompareAllTheSizes_CompareLess_NoOptimizeIndexOf) {
   CompareAllTheSizes<mbo::types::CompareLess, LimitedOptionsFlag::kNoOptimizeIndexOf>();
 }
 
+TEST_F(LimitedSetTest, CompareAllTheSizes_StdLess_SimdIndexOf) {
+  CompareAllTheSizes<std::less, LimitedOptionsFlag::kSimdIndexOf>();
+}
+
+TEST_F(LimitedSetTest, CompareAllTheSizes_CompareLess_SimdIndexOf) {
+  CompareAllTheSizes<mbo::types::CompareLess, LimitedOptionsFlag::kSimdIndexOf>();
+}
+
+TEST_F(LimitedSetTest, CompareAllTheSizes_StdLess_Eytzinger) {
+  CompareAllTheSizes<std::less, LimitedOptionsFlag::kEytzinger>();
+}
+
+TEST_F(LimitedSetTest, CompareAllTheSizes_CompareLess_Eytzinger) {
+  CompareAllTheSizes<mbo::types::CompareLess, LimitedOptionsFlag::kEytzinger>();
+}
+
 // NOLINTEND(google-readability-avoid-underscore-in-googletest-name)
 
+template<typename Key, std::size_t Capacity>
+void SimdIndexOfFor() {
+  using Set = LimitedSet<Key, LimitedOptions<Capacity, LimitedOptionsFlag::kSimdIndexOf>{}>;
+  using Unsigned = std::make_unsigned_t<Key>;
+  // Spread the keys over the whole range, so that signed and unsigned ordering differ.
+  constexpr Key kMin = std::numeric_limits<Key>::min();
+  constexpr Key kMax = std::numeric_limits<Key>::max();
+  constexpr Unsigned kStep = std::numeric_limits<Unsigned>::max() / Capacity;
+  std::vector<Key> keys;
+  for (std::size_t idx = 0; idx < Capacity; ++idx) {
+    keys.push_back(static_cast<Key>(static_cast<Unsigned>(static_cast<Unsigned>(kMin) + idx * kStep + 1)));
+  }
+  for (std::size_t size = 0; size <= Capacity; size += (size < 70 ? 1 : 37)) {
+    SCOPED_TRACE(absl::StrCat("Size: ", size, " Capacity: ", Capacity, " Key size: ", sizeof(Key)));
+    const Set data(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(size));
+    for (std::size_t idx = 0; idx < size; ++idx) {
+      ASSERT_THAT(data.index_of(keys[idx]), idx);
+      ASSERT_THAT(data.index_of(static_cast<Key>(keys[idx] - 1)), Set::npos);
+      ASSERT_THAT(data.index_of(static_cast<Key>(keys[idx] + 1)), Set::npos);
+    }
+    ASSERT_THAT(data.index_of(kMin), Set::npos);
+    ASSERT_THAT(data.index_of(kMax), Set::npos);
+  }
+}
+
+TEST_F(LimitedSetTest, SimdIndexOf) {
+  SimdIndexOfFor<int8_t, 100>();
+  SimdIndexOfFor<uint8_t, 100>();
+  SimdIndexOfFor<int16_t, 100>();
+  SimdIndexOfFor<uint16_t, 300>();
+  SimdIndexOfFor<int32_t, 100>();
+  SimdIndexOfFor<uint32_t, 300>();
+  SimdIndexOfFor<int64_t, 100>();
+  SimdIndexOfFor<uint64_t, 300>();
+}
+
+TEST_F(LimitedSetTest, SimdIndexOfConstexpr) {
+  static constexpr LimitedSet<int, LimitedOptions<4, LimitedOptionsFlag::kSimdIndexOf>{}> kData{-1, 0, 25, 42};
+  static_assert(kData.index_of(25) == 2);
+  static_assert(kData.index_of(24) == kData.npos);
+  static_assert(kData.contains(-1));
+  EXPECT_THAT(kData.index_of(42), 3);
+  EXPECT_THAT(kData.find(0), kData.begin() + 1);
+}
+
+TEST_F(LimitedSetTest, EytzingerBounds) {
+  constexpr std::size_t kCapacity = 300;
+  using Set = LimitedSet<int, LimitedOptions<kCapacity, LimitedOptionsFlag::kEytzinger>{}>;
+  std::vector<int> keys;
+  for (std::size_t idx = 0; idx < kCapacity; ++idx) {
+    keys.push_back(static_cast<int>(2 * idx));
+  }
+  for (std::size_t size = 0; size <= kCapacity; size += (size < 70 ? 1 : 23)) {
+    SCOPED_TRACE(absl::StrCat("Size: ", size));
+    const auto last = keys.begin() + static_cast<std::ptrdiff_t>(size);
+    const Set data(keys.begin(), last);
+    for (int key = -1; key <= static_cast<int>(2 * size); ++key) {
+      const auto expected = std::lower_bound(keys.begin(), last, key) - keys.begin();
+      ASSERT_THAT(data.lower_bound(key) - data.begin(), expected) << "Key: " << key;
+      ASSERT_THAT(data.upper_bound(key) - data.begin(), std::upper_bound(keys.begin(), last, key) - keys.begin());
+      ASSERT_THAT(data.index_of(key), key % 2 == 0 && key < static_cast<int>(2 * size) ? expected : Set::npos);
+    }
+  }
+}
+
+TEST_F(LimitedSetTest, EytzingerModifications) {
+  LimitedSet<int, LimitedOptions<16, LimitedOptionsFlag::kEytzinger>{}> data{5, 3, 9};
+  EXPECT_THAT(data, ElementsAre(3, 5, 9));
+  data.insert(7);
+  data.emplace(1);
+  EXPECT_THAT(data, ElementsAre(1, 3, 5, 7, 9));
+  EXPECT_THAT(data.index_of(7), 3);
+  data.erase(3);
+  EXPECT_THAT(data.index_of(7), 2);
+  EXPECT_FALSE(data.contains(3));
+  LimitedSet<int, LimitedOptions<16, LimitedOptionsFlag::kEytzinger>{}> other{2, 4};
+  data.swap(other);
+  EXPECT_THAT(data, ElementsAre(2, 4));
+  EXPECT_TRUE(data.contains(4));
+  EXPECT_FALSE(data.contains(5));
+  EXPECT_THAT(other, ElementsAre(1, 5, 7, 9));
+  EXPECT_THAT(other.index_of(9), 3);
+  data = other;
+  EXPECT_THAT(data.index_of(5), 1);
+  data.clear();
+  EXPECT_FALSE(data.contains(5));
+  EXPECT_THAT(data.lower_bound(5), data.end());
+}
+
+TEST_F(LimitedSetTest, EytzingerConstexpr) {
+  static constexpr std::size_t kCapacity = 1'000;
+  using Set = LimitedSet<
+      int, LimitedOptions<kCapacity, LimitedOptionsFlag::kEytzinger, LimitedOptionsFlag::kRequireSortedInput>{}>;
+  static constexpr Set kData = [] {
+    std::array<int, kCapacity> keys{};
+    for (std::size_t idx = 0; idx < kCapacity; ++idx) {
+      keys[idx] = static_cast<int>(3 * idx);
+    }
+    return Set(keys.begin(), keys.end());
+  }();
+  static_assert(kData.size() == kCapacity);
+  static_assert(kData.index_of(0) == 0);
+  static_assert(kData.index_of(300) == 100);
+  static_assert(kData.index_of(301) == Set::npos);
+  static_assert(kData.contains(2'997));
+  static_assert(!kData.contains(3'000));
+  EXPECT_THAT(kData.index_of(1'500), 500);
+  EXPECT_THAT(kData.find(2'997), kData.end() - 1);
+  EXPECT_THAT(kData.lower_bound(1'501), kData.begin() + 501);
+}
+
 TEST_F(LimitedSetTest, PreSortedInput) {
   constexpr LimitedSet<int, LimitedOptions<4, LimitedOptionsFlag::kRequireSortedInput>{}> kData{0, 1, 2, 42};
   EXPECT_THAT(kData, ElementsAre(0, 1, 2, 42));
@@ -0,0 +1,321 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_CONTAINER_PERFECT_HASH_MAP_H_
+#define MBO_CONTAINER_PERFECT_HASH_MAP_H_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>  // IWYU pragma: keep
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "mbo/config/config.h"
+#include "mbo/config/require.h"
+#include "mbo/container/limited_vector.h"
+#include "mbo/hash/hash.h"
+#include "mbo/types/traits.h"
+
+namespace mbo::container {
+
+// NOLINTBEGIN(readability-identifier-naming)
+
+template<typename Key>
+concept PerfectHashMapKey = std::constructible_from<std::string_view, const Key&> && std::copy_constructible<Key>;
+
+// Implements a read-only, `std::map` like container of up to `Capacity` string keyed entries, which finds keys with a
+// minimal amount of work: one hash, one probe and one compare. This is meant for the typical `static constexpr` lookup
+// tables of names with hundreds of entries, where the ordered search of `LimitedMap` needs `log2(n)` string compares.
+//
+// The keys are distributed over a power of two number of slots (2 to 4 per key) by a perfect hash that the
+// constructor determines - at compile time for `constexpr` maps: The keys are hashed with `mbo::hash::GetHash64` and
+// a seed, grouped into buckets (2 to 4 keys per bucket), and for each bucket, largest first, a `pilot` is searched
+// that moves all of its keys into free slots. If a bucket cannot be placed, the next seed is tried.
+//
+// The entries are kept in construction order, which is also the iteration order. Values can be modified, but entries
+// can neither be added nor removed after construction. Duplicate keys are an error (`MBO_CONFIG_REQUIRE`).
+//
+// Can be constructed with helper `ToPerfectHashMap`.
+//
+// Example:
+//
+// ```c++
+// using mbo::container::ToPerfectHashMap;
+//
+// constexpr auto kMyData = ToPerfectHashMap<std::string_view, int>({{"one", 1}, {"two", 2}, {"three", 3}});
+//
+// static_assert(kMyData.at("two") == 2);
+// ```
+template<typename Key, typename Value, std::size_t Capacity>
+requires(PerfectHashMapKey<Key> && std::move_constructible<Value>)
+class PerfectHashMap final {
+ private:
+  using Values = LimitedVector<std::pair<const Key, Value>, Capacity>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = typename Values::iterator;
+  using const_iterator = typename Values::const_iterator;
+
+  static constexpr std::size_t kNumSlots = std::bit_ceil(2 * std::max<std::size_t>(1, Capacity));
+  static constexpr std::size_t kNumBuckets = std::bit_ceil(std::max<std::size_t>(1, (Capacity + 3) / 4));
+
+  constexpr PerfectHashMap() noexcept = default;
+
+  template<std::input_iterator It>
+  requires std::constructible_from<value_type, std::iter_reference_t<It>>
+  constexpr PerfectHashMap(It first, It last) noexcept(!::mbo::config::kRequireThrows) {
+    for (; first != last; ++first) {
+      MBO_CONFIG_REQUIRE(values_.size() < Capacity, "Too many values.");
+      values_.emplace_back(*first);
+    }
+    Build();
+  }
+
+  constexpr PerfectHashMap(const std::initializer_list<value_type>& list) noexcept(!::mbo::config::kRequireThrows)
+      : PerfectHashMap(list.begin(), list.end()) {}
+
+  constexpr PerfectHashMap(const PerfectHashMap&) noexcept = default;
+  constexpr PerfectHashMap& operator=(const PerfectHashMap&) noexcept = default;
+  constexpr PerfectHashMap(PerfectHashMap&&) noexcept = default;
+  constexpr PerfectHashMap& operator=(PerfectHashMap&&) noexcept = default;
+  constexpr ~PerfectHashMap() noexcept = default;
+
+  // Lookup: find, contains, count, at
+
+  constexpr iterator find(std::string_view key) noexcept {
+    const std::size_t index = IndexOf(key);
+    return index == values_.size() ? end() : &values_[index];
+  }
+
+  constexpr const_iterator find(std::string_view key) const noexcept {
+    const std::size_t index = IndexOf(key);
+    return index == values_.size() ? end() : &values_[index];
+  }
+
+  constexpr bool contains(std::string_view key) const noexcept { return IndexOf(key) != values_.size(); }
+
+  constexpr std::size_t count(std::string_view key) const noexcept { return contains(key) ? 1 : 0; }
+
+  constexpr Value& at(std::string_view key) {
+    auto it = find(key);
+    MBO_CONFIG_REQUIRE(it != end(), "Out of range");
+    return it->second;
+  }
+
+  constexpr const Value& at(std::string_view key) const {
+    auto it = find(key);
+    MBO_CONFIG_REQUIRE(it != end(), "Out of range");
+    return it->second;
+  }
+
+  // Size and iteration, in construction order.
+
+  constexpr std::size_t size() const noexcept { return values_.size(); }
+
+  constexpr std::size_t max_size() const noexcept { return Capacity; }
+
+  constexpr std::size_t capacity() const noexcept { return Capacity; }
+
+  constexpr bool empty() const noexcept { return values_.empty(); }
+
+  constexpr iterator begin() noexcept { return values_.begin(); }
+
+  constexpr const_iterator begin() const noexcept { return values_.begin(); }
+
+  constexpr const_iterator cbegin() const noexcept { return values_.cbegin(); }
+
+  constexpr iterator end() noexcept { return values_.end(); }
+
+  constexpr const_iterator end() const noexcept { return values_.end(); }
+
+  constexpr const_iterator cend() const noexcept { return values_.cend(); }
+
+  // The seed for `mbo::hash::GetHash64` that the constructor found.
+  constexpr uint64_t seed() const noexcept { return seed_; }
+
+ private:
+  using Index = std::conditional_t<(Capacity <= 0xFFFF), uint16_t, uint32_t>;
+  using Pilot = uint16_t;
+
+  static constexpr uint64_t kPilotMul = 0x9E3779B97F4A7C15ULL;
+  static constexpr uint64_t kSlotMul = 0xD6E8FEB86659FD93ULL;
+  static constexpr std::size_t kSlotShift = 64 - std::countr_zero(kNumSlots);  // At least 2 slots, so < 64.
+  static constexpr uint64_t kMaxSeeds = 1'000;
+
+  static constexpr std::size_t BucketOf(uint64_t hash) noexcept {
+    return static_cast<std::size_t>(hash >> 32U) & (kNumBuckets - 1);  // NOLINT(*-magic-numbers)
+  }
+
+  // The pilot perturbs the hash before a multiplicative hash picks the slot from the top bits of the product. So
+  // different hashes end up in different slots for some pilot, even if their lower bits are the same.
+  static constexpr std::size_t SlotOf(uint64_t hash, Pilot pilot) noexcept {
+    return static_cast<std::size_t>(((hash ^ (pilot * kPilotMul)) * kSlotMul) >> kSlotShift);
+  }
+
+  // The index of `key` in `values_`, or `size()` if not present.
+  constexpr std::size_t IndexOf(std::string_view key) const noexcept {
+    if (values_.empty()) {
+      return 0;
+    }
+    const uint64_t hash = mbo::hash::GetHash64(key, seed_);
+    const std::size_t index = slots_[SlotOf(hash, pilots_[BucketOf(hash)])];
+    return std::string_view(values_[index].first) == key ? index : values_.size();
+  }
+
+  constexpr void Build() noexcept(!::mbo::config::kRequireThrows) {
+    for (seed_ = 0; !TryBuild(); ++seed_) {
+      MBO_CONFIG_REQUIRE(seed_ < kMaxSeeds, "Cannot find a perfect hash.");
+    }
+  }
+
+  // NOLINTBEGIN(*-avoid-unchecked-container-access): All indices are bounded by construction.
+
+  // Attempts to place all keys with `seed_`.
+  constexpr bool TryBuild() noexcept(!::mbo::config::kRequireThrows) {
+    const std::size_t size = values_.size();
+    std::array<uint64_t, Capacity> hashes{};
+    std::array<Index, kNumBuckets + 1> starts{};  // Start of each bucket's keys in `keys`.
+    for (std::size_t idx = 0; idx < size; ++idx) {
+      hashes[idx] = mbo::hash::GetHash64(std::string_view(values_[idx].first), seed_);
+      ++starts[BucketOf(hashes[idx]) + 1];
+    }
+    for (std::size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+      starts[bucket + 1] += starts[bucket];
+    }
+    std::array<Index, Capacity> keys{};  // Key indices grouped by bucket.
+    std::array<Index, kNumBuckets> fill = {};
+    for (std::size_t idx = 0; idx < size; ++idx) {
+      const std::size_t bucket = BucketOf(hashes[idx]);
+      keys[starts[bucket] + fill[bucket]++] = static_cast<Index>(idx);
+    }
+    std::array<Index, kNumBuckets> order{};
+    for (std::size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+      order[bucket] = static_cast<Index>(bucket);
+    }
+    std::sort(order.begin(), order.end(), [&fill](Index lhs, Index rhs) {
+      return fill[lhs] > fill[rhs] || (fill[lhs] == fill[rhs] && lhs < rhs);
+    });
+    std::array<bool, kNumSlots> taken{};
+    for (const Index bucket : order) {
+      const std::size_t first = starts[bucket];
+      const std::size_t last = starts[bucket + 1];
+      if (first == last) {
+        break;
+      }
+      for (std::size_t lhs = first; lhs < last; ++lhs) {
+        for (std::size_t rhs = lhs + 1; rhs < last; ++rhs) {
+          if (hashes[keys[lhs]] == hashes[keys[rhs]]) {
+            MBO_CONFIG_REQUIRE(
+                std::string_view(values_[keys[lhs]].first) != std::string_view(values_[keys[rhs]].first),
+                "Duplicate key.");
+            return false;  // Same hash, no pilot can separate them.
+          }
+        }
+      }
+      if (!PlaceBucket(hashes, keys, first, last, bucket, taken)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Finds the first pilot that moves all keys of `bucket` (`keys[first, last)`) into distinct free slots.
+  constexpr bool PlaceBucket(
+      const std::array<uint64_t, Capacity>& hashes,
+      const std::array<Index, Capacity>& keys,
+      std::size_t first,
+      std::size_t last,
+      std::size_t bucket,
+      std::array<bool, kNumSlots>& taken) noexcept {
+    for (std::size_t pilot = 0; pilot <= std::numeric_limits<Pilot>::max(); ++pilot) {
+      std::size_t pos = first;
+      for (; pos < last; ++pos) {
+        const std::size_t slot = SlotOf(hashes[keys[pos]], static_cast<Pilot>(pilot));
+        if (taken[slot]) {
+          break;
+        }
+        taken[slot] = true;
+        slots_[slot] = keys[pos];
+      }
+      if (pos == last) {
+        pilots_[bucket] = static_cast<Pilot>(pilot);
+        return true;
+      }
+      while (pos-- > first) {  // Undo the partial placement.
+        taken[SlotOf(hashes[keys[pos]], static_cast<Pilot>(pilot))] = false;
+      }
+    }
+    return false;
+  }
+
+  // NOLINTEND(*-avoid-unchecked-container-access)
+
+  uint64_t seed_ = 0;
+  Values values_;
+  std::array<Index, kNumSlots> slots_{};  // Empty slots refer to entry 0, whose key then does not match.
+  std::array<Pilot, kNumBuckets> pilots_{};
+};
+
+// NOLINTBEGIN(*-avoid-c-arrays)
+
+template<typename KV, std::size_t N>
+requires(types::IsPair<std::remove_cvref_t<KV>>)
+constexpr auto ToPerfectHashMap(KV (&array)[N]) {
+  return PerfectHashMap<typename std::remove_cvref_t<KV>::first_type, typename std::remove_cvref_t<KV>::second_type, N>(
+      std::begin(array), std::end(array));
+}
+
+template<typename KV, std::size_t N>
+requires(types::IsPair<std::remove_cvref_t<KV>>)
+constexpr auto ToPerfectHashMap(KV (&&array)[N]) {
+  return PerfectHashMap<typename std::remove_cvref_t<KV>::first_type, typename std::remove_cvref_t<KV>::second_type, N>(
+      std::make_move_iterator(std::begin(array)), std::make_move_iterator(std::end(array)));
+}
+
+template<typename K, typename V, std::size_t N>
+requires(!types::IsPair<std::remove_cvref_t<K>>)
+constexpr auto ToPerfectHashMap(std::pair<K, V> (&array)[N]) {
+  return PerfectHashMap<K, V, N>(std::begin(array), std::end(array));
+}
+
+template<typename K, typename V, std::size_t N>
+requires(!types::IsPair<std::remove_cvref_t<K>>)
+constexpr auto ToPerfectHashMap(std::pair<K, V> (&&array)[N]) {
+  return PerfectHashMap<K, V, N>(std::make_move_iterator(std::begin(array)), std::make_move_iterator(std::end(array)));
+}
+
+// NOLINTEND(*-avoid-c-arrays)
+
+// NOLINTEND(readability-identifier-naming)
+
+}  // namespace mbo::container
+
+#endif  // MBO_CONTAINER_PERFECT_HASH_MAP_H_
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares string keyed lookups in `PerfectHashMap` against `LimitedMap`.
+// Run with: bazel run -c opt //mbo/container:perfect_hash_map_benchmark
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mbo/container/limited_map.h"
+#include "mbo/container/perfect_hash_map.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+// Identifier like names of 4 to 20 characters, the typical keys of lookup tables.
+std::vector<std::string> MakeNames(std::size_t size) {
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+  std::mt19937 rng(42);
+  std::vector<std::string> names;
+  while (names.size() < size) {
+    std::string name(4 + (rng() % 17), ' ');
+    for (char& chr : name) {
+      chr = static_cast<char>('a' + (rng() % 26));
+    }
+    names.push_back(std::move(name));
+  }
+  return names;
+}
+
+template<typename Map, std::size_t Size>
+void BmFind(benchmark::State& state) {
+  const bool hit = state.range(0) != 0;
+  // Built once from `2 * Size` names. The first half are the keys, the second the misses.
+  const std::vector<std::string> names = MakeNames(2 * Size);
+  std::vector<std::pair<std::string_view, int>> pairs;
+  for (std::size_t idx = 0; idx < Size; ++idx) {
+    pairs.emplace_back(names[idx], static_cast<int>(idx));
+  }
+  const Map map(pairs.begin(), pairs.end());
+  std::vector<std::string_view> input;
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+  std::mt19937 rng(7);
+  for (std::size_t idx = 0; idx < 1'000; ++idx) {
+    input.emplace_back(names[(rng() % Size) + (hit ? 0 : Size)]);
+  }
+  std::size_t item = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(input[item]));
+    item = (item + 1) % input.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+
+#define MBO_REGISTER_BENCHMARKS(Size)                                                \
+  BENCHMARK(BmFind<LimitedMap<std::string_view, int, Size>, Size>)->Arg(1)->Arg(0); \
+  BENCHMARK(BmFind<PerfectHashMap<std::string_view, int, Size>, Size>)->Arg(1)->Arg(0)
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+MBO_REGISTER_BENCHMARKS(8);
+MBO_REGISTER_BENCHMARKS(32);
+MBO_REGISTER_BENCHMARKS(128);
+MBO_REGISTER_BENCHMARKS(512);
+MBO_REGISTER_BENCHMARKS(2048);
+
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+#undef MBO_REGISTER_BENCHMARKS
+
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
+
+BENCHMARK_MAIN();  // NOLINT
@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/container/perfect_hash_map.h"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <ranges>     // IWYU pragma: keep
+#include <stdexcept>  // IWYU pragma: keep
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/config/config.h"
+
+// Clang has issues with exception tracing in ASAN, so corresponding tests must
+// be disabled. But we do so for all known ASAN identification methods.
+#ifndef HAS_ADDRESS_SANITIZER
+# if defined(__has_feature)
+#  if __has_feature(address_sanitizer)
+#   define HAS_ADDRESS_SANITIZER 1
+#  endif
+# elif defined(__SANITIZE_ADDRESS__)
+#  define HAS_ADDRESS_SANITIZER 1
+# endif
+#endif
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+using ::testing::SizeIs;
+
+static_assert(std::ranges::range<PerfectHashMap<std::string_view, int, 3>>);
+static_assert(std::contiguous_iterator<PerfectHashMap<std::string_view, int, 3>::const_iterator>);
+
+struct PerfectHashMapTest : ::testing::Test {
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+};
+
+TEST_F(PerfectHashMapTest, Empty) {
+  static constexpr PerfectHashMap<std::string_view, int, 4> kEmpty;
+  static_assert(kEmpty.empty());
+  static_assert(!kEmpty.contains(""));
+  EXPECT_THAT(kEmpty, IsEmpty());
+  EXPECT_THAT(kEmpty.find("any"), kEmpty.end());
+  EXPECT_THAT(kEmpty.capacity(), 4);
+}
+
+TEST_F(PerfectHashMapTest, Constexpr) {
+  static constexpr auto kData = ToPerfectHashMap<std::string_view, int>({{"one", 1}, {"two", 2}, {"three", 3}});
+  static_assert(kData.size() == 3);
+  static_assert(kData.at("two") == 2);
+  static_assert(kData.contains("three"));
+  static_assert(!kData.contains("four"));
+  static_assert(kData.count("one") == 1);
+  static_assert(kData.find("") == kData.end());
+  EXPECT_THAT(kData, ElementsAre(Pair("one", 1), Pair("two", 2), Pair("three", 3)));
+  EXPECT_THAT(kData.find("one"), kData.begin());
+  EXPECT_THAT(kData.find(std::string("three"))->second, 3);
+}
+
+TEST_F(PerfectHashMapTest, ToPerfectHashMapFromPairs) {
+  static constexpr std::pair<std::string_view, int> kPairs[] = {{"a", 1}, {"b", 2}};  // NOLINT(*-avoid-c-arrays)
+  static constexpr auto kData = ToPerfectHashMap(kPairs);
+  static_assert(kData.at("a") == 1);
+  static_assert(kData.at("b") == 2);
+  EXPECT_THAT(kData, SizeIs(2));
+}
+
+constexpr std::size_t kManyKeys = 300;
+
+// Names `k0` .. `k299` in static storage, so that a `constexpr` map can refer to them.
+constexpr std::array<std::array<char, 4>, kManyKeys> kNames = [] {
+  std::array<std::array<char, 4>, kManyKeys> names{};
+  for (std::size_t idx = 0; idx < kManyKeys; ++idx) {
+    names[idx][0] = 'k';
+    names[idx][1] = static_cast<char>('0' + (idx / 100));
+    names[idx][2] = static_cast<char>('0' + ((idx / 10) % 10));
+    names[idx][3] = static_cast<char>('0' + (idx % 10));
+  }
+  return names;
+}();
+
+TEST_F(PerfectHashMapTest, ManyKeysConstexpr) {
+  using Map = PerfectHashMap<std::string_view, std::size_t, kManyKeys>;
+  static constexpr Map kData = [] {
+    std::array<std::pair<std::string_view, std::size_t>, kManyKeys> pairs{};
+    for (std::size_t idx = 0; idx < kManyKeys; ++idx) {
+      pairs[idx] = {std::string_view(kNames[idx].data(), kNames[idx].size()), idx};
+    }
+    return Map(pairs.begin(), pairs.end());
+  }();
+  static_assert(kData.size() == kManyKeys);
+  static_assert(kData.at("k000") == 0);
+  static_assert(kData.at("k123") == 123);
+  static_assert(kData.at("k299") == 299);
+  static_assert(!kData.contains("k300"));
+  static_assert(!kData.contains("k12"));
+  for (std::size_t idx = 0; idx < kManyKeys; ++idx) {
+    const std::string_view key(kNames[idx].data(), kNames[idx].size());
+    ASSERT_THAT(kData.find(key), kData.begin() + static_cast<std::ptrdiff_t>(idx)) << key;
+  }
+}
+
+TEST_F(PerfectHashMapTest, ManyKeysRuntime) {
+  constexpr std::size_t kCapacity = 2'000;
+  std::vector<std::pair<std::string, int>> pairs;
+  for (std::size_t idx = 0; idx < kCapacity; ++idx) {
+    pairs.emplace_back(absl::StrCat("key_", idx * 7), static_cast<int>(idx));
+  }
+  auto data = PerfectHashMap<std::string, int, kCapacity>(pairs.begin(), pairs.end());
+  ASSERT_THAT(data, SizeIs(kCapacity));
+  for (std::size_t idx = 0; idx < kCapacity; ++idx) {
+    ASSERT_THAT(data.at(pairs[idx].first), idx) << pairs[idx].first;
+    ASSERT_FALSE(data.contains(absl::StrCat("key_", idx * 7 + 1)));
+  }
+  data.at("key_7") = -1;
+  EXPECT_THAT(data.begin()[1], Pair("key_7", -1));
+}
+
+TEST_F(PerfectHashMapTest, FewerValuesThanCapacity) {
+  const auto data = PerfectHashMap<std::string_view, int, 10>{{"x", 1}, {"y", 2}};
+  EXPECT_THAT(data, ElementsAre(Pair("x", 1), Pair("y", 2)));
+  EXPECT_TRUE(data.contains("y"));
+  EXPECT_FALSE(data.contains("z"));
+}
+
+TEST_F(PerfectHashMapTest, DuplicateKeyThrows) {
+  const std::vector<std::pair<std::string_view, int>> pairs{{"a", 1}, {"b", 2}, {"a", 3}};
+  if constexpr (!::mbo::config::kRequireThrows) {
+    ASSERT_DEATH((PerfectHashMap<std::string_view, int, 3>(pairs.begin(), pairs.end())), "Duplicate key");
+  } else {
+#if __cpp_exceptions
+# if !HAS_ADDRESS_SANITIZER
+    // Disabled due to https://github.com/google/sanitizers/issues/749
+    bool caught = false;
+    try {
+      const PerfectHashMap<std::string_view, int, 3> data(pairs.begin(), pairs.end());
+    } catch (const std::runtime_error& error) {
+      caught = true;
+      EXPECT_THAT(error.what(), HasSubstr("Duplicate key"));
+    }
+    ASSERT_TRUE(caught);
+# endif  // !HAS_ADDRESS_SANITIZER
+#endif   // __cpp_exceptions
+  }
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
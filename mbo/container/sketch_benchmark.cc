@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Add and merge throughput of `HyperLogLog` and `CountMinSketch`, with the default hasher and with siphash.
+// Run with: bazel run -c opt //mbo/container:sketch_benchmark
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mbo/container/count_min_sketch.h"
+#include "mbo/container/hyper_log_log.h"
+#include "mbo/hash/hash.h"
+
+namespace mbo::container {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+constexpr std::size_t kNumKeys = 1 << 16;
+
+using SipHasher = hash::Hasher<hash::siphash::Algorithm>;
+
+// Distinct keys of 8 to 40 characters.
+const std::vector<std::string>& Keys() {
+  static const auto* const kKeys = [] {
+    auto* keys = new std::vector<std::string>();  // NOLINT(cppcoreguidelines-owning-memory)
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+    std::mt19937_64 rng(42);
+    for (std::size_t idx = 0; idx < kNumKeys; ++idx) {
+      std::string key(8 + (rng() % 33), ' ');
+      for (char& chr : key) {
+        chr = static_cast<char>('a' + (rng() % 26));
+      }
+      keys->push_back(std::move(key));
+    }
+    return keys;
+  }();
+  return *kKeys;
+}
+
+// The argument is the number of distinct keys, which decides whether the sketch is sparse or dense.
+template<typename Hasher>
+void BmHyperLogLogAdd(benchmark::State& state) {
+  const std::vector<std::string>& keys = Keys();
+  const auto num_keys = static_cast<std::size_t>(state.range(0));
+  HyperLogLog<Hasher> sketch;
+  std::size_t item = 0;
+  for (auto _ : state) {
+    sketch.Add(keys[item]);
+    item = item + 1 < num_keys ? item + 1 : 0;
+  }
+  benchmark::DoNotOptimize(sketch.Estimate());
+  state.SetItemsProcessed(state.iterations());
+}
+
+// The argument is the precision, the throughput is in registers. Both sketches get enough keys to be dense.
+template<typename Hasher>
+void BmHyperLogLogMerge(benchmark::State& state) {
+  const int precision = static_cast<int>(state.range(0));
+  HyperLogLog<Hasher> lhs(precision);
+  HyperLogLog<Hasher> rhs(precision);
+  for (const std::string_view suffix : {"0", "1", "2", "3"}) {
+    for (const std::string& key : Keys()) {
+      lhs.Add(key + "lhs" + std::string(suffix));
+      rhs.Add(key + "rhs" + std::string(suffix));
+    }
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs.Merge(rhs));
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(lhs.num_registers()));
+}
+
+template<typename Hasher>
+void BmHyperLogLogEstimate(benchmark::State& state) {
+  HyperLogLog<Hasher> sketch(static_cast<int>(state.range(0)));
+  for (const std::string& key : Keys()) {
+    sketch.Add(key);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sketch.Estimate());
+  }
+}
+
+// The argument is the width, depth is 5 (`delta` below 1%).
+template<typename Hasher>
+void BmCountMinSketchAdd(benchmark::State& state) {
+  const std::vector<std::string>& keys = Keys();
+  CountMinSketch<Hasher> sketch(static_cast<std::size_t>(state.range(0)), 5);
+  std::size_t item = 0;
+  for (auto _ : state) {
+    sketch.Add(keys[item]);
+    item = (item + 1) % kNumKeys;
+  }
+  benchmark::DoNotOptimize(sketch.total());
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Hasher>
+void BmCountMinSketchEstimate(benchmark::State& state) {
+  const std::vector<std::string>& keys = Keys();
+  CountMinSketch<Hasher> sketch(static_cast<std::size_t>(state.range(0)), 5);
+  for (const std::string& key : keys) {
+    sketch.Add(key);
+  }
+  std::size_t item = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sketch.Estimate(keys[item]));
+    item = (item + 1) % kNumKeys;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// The throughput is in counters.
+template<typename Hasher>
+void BmCountMinSketchMerge(benchmark::State& state) {
+  CountMinSketch<Hasher> lhs(static_cast<std::size_t>(state.range(0)), 5);
+  CountMinSketch<Hasher> rhs(static_cast<std::size_t>(state.range(0)), 5);
+  for (const std::string& key : Keys()) {
+    lhs.Add(key);
+    rhs.Add(key);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs.Merge(rhs));
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(lhs.width() * lhs.depth()));
+}
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+
+#define MBO_REGISTER_BENCHMARKS(Hasher)                                                  \
+  BENCHMARK(BmHyperLogLogAdd<Hasher>)->Arg(1 << 10)->Arg(1 << 16);                       \
+  BENCHMARK(BmHyperLogLogMerge<Hasher>)->Arg(10)->Arg(14)->Arg(18);                      \
+  BENCHMARK(BmHyperLogLogEstimate<Hasher>)->Arg(10)->Arg(14)->Arg(18);                   \
+  BENCHMARK(BmCountMinSketchAdd<Hasher>)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20);      \
+  BENCHMARK(BmCountMinSketchEstimate<Hasher>)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20); \
+  BENCHMARK(BmCountMinSketchMerge<Hasher>)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20)
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+MBO_REGISTER_BENCHMARKS(hash::DefaultHasher);
+MBO_REGISTER_BENCHMARKS(SipHasher);
+
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+#undef MBO_REGISTER_BENCHMARKS
+
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::container
+
+BENCHMARK_MAIN();  // NOLINT
@@ -42,8 +42,8 @@ class BaseDiff {
   BaseDiff(const file::Artefact& lhs, const file::Artefact& rhs, const DiffOptions& opts)
       : options_(opts),
         header_(FileHeaders(lhs, rhs, options_)),
-        lhs_data_(opts, opts.regex_replace_lhs, lhs.data),
-        rhs_data_(opts, opts.regex_replace_rhs, rhs.data) {}
+        lhs_data_(opts, opts.regex_replace_lhs, lhs.Text()),
+        rhs_data_(opts, opts.regex_replace_rhs, rhs.Text()) {}
 
   ~BaseDiff() = default;
   BaseDiff(const BaseDiff&) = delete;
@@ -56,7 +56,7 @@ def diff_test(
         file_old:                 The old file.
         file_new:                 The new file.
         file_header_use:          Select which file header to use.
-        algorithm:                Algorithm to use ('myers', 'naive', 'direct'; 'unified' is a deprecated alias for 'myers' implying unified format).
+        algorithm:                Algorithm to use ('myers', 'naive', 'direct', 'streaming', 'histogram'; 'unified' is a deprecated alias for 'myers' implying unified format).
         context:                  Produces a diff with number of context lines (defaults to 0 for direct diff and normal format, 3 otherwise).
         failure_message:          Additional message to log if the files don't match.
         format:                   Output format to use ('unified', 'context', 'normal', 'side-by-side').
@@ -216,7 +216,7 @@ _diff_test = rule(
         "algorithm": attr.string(
             default = "myers",
             doc = "The diff algorithm to use ('unified' is a deprecated alias for 'myers', implying unified format).",
-            values = ["direct", "myers", "naive", "unified"],
+            values = ["direct", "histogram", "myers", "naive", "streaming", "unified"],
         ),
         "context": attr.int(
             default = -1,
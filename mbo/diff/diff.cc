@@ -17,11 +17,15 @@
 
 #include <string>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "mbo/diff/impl/diff_direct.h"
+#include "mbo/diff/impl/diff_histogram.h"
 #include "mbo/diff/impl/diff_myers.h"
 #include "mbo/diff/impl/diff_naive.h"
+#include "mbo/diff/impl/diff_streaming.h"
 #include "mbo/file/artefact.h"
+#include "mbo/status/status_macros.h"
 
 namespace mbo::diff {
 
@@ -33,8 +37,25 @@ absl::StatusOr<std::string> Diff::FileDiff(
     case Diff::Options::Algorithm::kNaive: return DiffNaive::FileDiff(lhs, rhs, options);
     case Diff::Options::Algorithm::kDirect: return DiffDirect::FileDiff(lhs, rhs, options);
     case Diff::Options::Algorithm::kMyers: return DiffMyers::FileDiff(lhs, rhs, options);
+    case Diff::Options::Algorithm::kStreaming: return DiffStreaming::FileDiff(lhs, rhs, options);
+    case Diff::Options::Algorithm::kHistogram: return DiffHistogram::FileDiff(lhs, rhs, options);
   }
   return absl::InvalidArgumentError("Unknown algorithm selected.");
 }
 
+absl::Status Diff::StreamDiff(
+    const file::Artefact& lhs,
+    const file::Artefact& rhs,
+    const Options& options,
+    const Sink& sink) {
+  if (options.algorithm == Diff::Options::Algorithm::kStreaming) {
+    return DiffStreaming::FileDiff(lhs, rhs, options, sink);
+  }
+  MBO_ASSIGN_OR_RETURN(const std::string output, FileDiff(lhs, rhs, options));
+  if (!output.empty()) {
+    sink(output);
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace mbo::diff
@@ -16,8 +16,11 @@
 #ifndef MBO_DIFF_DIFF_H_
 #define MBO_DIFF_DIFF_H_
 
+#include <functional>
 #include <string>
+#include <string_view>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "mbo/diff/diff_options.h"
 #include "mbo/file/artefact.h"
@@ -33,12 +36,25 @@ class Diff final {
  public:
   using Options = DiffOptions;
 
+  // Receives the diff output in pieces, in order.
+  using Sink = std::function<void(std::string_view)>;
+
   // Algorithm selected by `options.algorithm`.
   static absl::StatusOr<std::string> FileDiff(
       const file::Artefact& lhs,
       const file::Artefact& rhs,
       const Options& options = Options::Default());
 
+  // Same as `FileDiff` but passes the output to `sink` rather than returning
+  // it. With `Algorithm::kStreaming` every chunk is passed as soon as it is
+  // complete and the output is never held as a whole; the other algorithms
+  // pass their complete output at once. Nothing is passed for equal inputs.
+  static absl::Status StreamDiff(
+      const file::Artefact& lhs,
+      const file::Artefact& rhs,
+      const Options& options,
+      const Sink& sink);
+
   Diff() = delete;
 };
 
@@ -18,11 +18,15 @@
 //   edits:    scattered single line changes (the common case).
 //   moved:    a block of lines moved to another position.
 //   disjoint: no common lines at all (worst case).
+//   one_edit: a single changed line in a large file (what `streaming` trims).
 //
 //   bazel run -c opt //mbo/diff:diff_benchmark
 
+#include <array>
 #include <cstddef>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/str_cat.h"
@@ -66,6 +70,18 @@ std::string EditedLines(std::size_t count, std::string_view tag, std::size_t eve
   return text;
 }
 
+std::string OneEditedLine(std::size_t count, std::string_view tag, std::size_t edit_pos) {
+  std::string text;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i == edit_pos) {
+      absl::StrAppend(&text, "edited-", i, "\n");
+    } else {
+      absl::StrAppend(&text, tag, i % 97, "-", i, "\n");
+    }
+  }
+  return text;
+}
+
 // Distinct long mixed-case lines; every `edit_every`-th line differs (none
 // for 0). Stresses the tokenizer rather than the middle snake search.
 std::string LongLines(
@@ -124,6 +140,9 @@ const std::vector<Case>& Cases() {
       {.name = "disjoint_2k",
        .lhs = {.data = NumberedLines(2'000, "left-"), .name = "lhs"},
        .rhs = {.data = NumberedLines(2'000, "right-"), .name = "rhs"}},
+      {.name = "one_edit_1m",
+       .lhs = {.data = NumberedLines(1'000'000, "line-"), .name = "lhs"},
+       .rhs = {.data = OneEditedLine(1'000'000, "line-", 500'000), .name = "rhs"}},
       {.name = "tokenize_20k_long",
        .lhs = {.data = LongLines(20'000, 120, 0), .name = "lhs"},
        .rhs = {.data = LongLines(20'000, 120, 500), .name = "rhs"}},
@@ -165,9 +184,14 @@ void BmDiff(benchmark::State& state, DiffOptions::Algorithm algorithm, std::size
 }
 
 void RegisterAll() {
+  static constexpr auto kAlgorithms = std::to_array<std::pair<std::string_view, DiffOptions::Algorithm>>({
+      {"myers", DiffOptions::Algorithm::kMyers},
+      {"naive", DiffOptions::Algorithm::kNaive},
+      {"streaming", DiffOptions::Algorithm::kStreaming},
+      {"histogram", DiffOptions::Algorithm::kHistogram},
+  });
   for (std::size_t idx = 0; idx < Cases().size(); ++idx) {
-    for (const auto& [algo_name, algorithm] :
-         {std::pair{"myers", DiffOptions::Algorithm::kMyers}, std::pair{"naive", DiffOptions::Algorithm::kNaive}}) {
+    for (const auto& [algo_name, algorithm] : kAlgorithms) {
       benchmark::RegisterBenchmark(
           absl::StrCat("BmDiff<", algo_name, ">/", Cases().at(idx).name),
           [algorithm, idx](benchmark::State& state) { BmDiff(state, algorithm, idx); })
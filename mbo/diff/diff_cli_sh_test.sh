@@ -35,7 +35,7 @@ declare -r TESTDATA
 # output in testdata; a missing file fails the matrix test, so an engine or
 # format added without coverage (or an unsupported combination) is spotted
 # immediately.
-declare -ra ALGORITHMS=(myers naive direct)
+declare -ra ALGORITHMS=(myers naive direct streaming histogram)
 declare -ra FORMATS=(unified context normal side-by-side)
 
 [[ -x ${DIFF} ]] || die "Program diff not found."
@@ -91,7 +91,8 @@ function test::all_algorithms_and_formats_accepted() {
 function test::engine_format_matrix() {
   # Per (engine, format) expected outputs on the Myers paper example
   # (ABCABBA vs CBABAC), where every engine legitimately differs: myers is
-  # minimal (5 edits), naive resyncs greedily (7), direct pairs by position.
+  # minimal (5 edits), naive resyncs greedily (7), direct pairs by position,
+  # histogram anchors on the only unique line 'C' (7).
   for algorithm in "${ALGORITHMS[@]}"; do
     for format in "${FORMATS[@]}"; do
       local expected="${TESTDATA}/engine_${algorithm}_${format}.txt"
@@ -116,7 +117,7 @@ function test::width_controls_side_by_side() {
 
 function test::usage_names_all_formats_and_algorithms() {
   "${DIFF}" --help >"${TEST_TMPDIR}/help.out" 2>&1 || true
-  for keyword in context normal side-by-side unified myers naive direct '--format' '--algorithm'; do
+  for keyword in context normal side-by-side unified myers naive direct streaming histogram '--format' '--algorithm'; do
     grep -q -- "${keyword}" "${TEST_TMPDIR}/help.out" || die "Usage/help is missing '${keyword}'."
   done
 }
@@ -49,7 +49,7 @@ extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size
   const std::string_view rhs = payload.substr(3 * part_size);
 
   mbo::diff::DiffOptions options{
-      .algorithm = static_cast<Algorithm>(data[0] % 3U),
+      .algorithm = static_cast<Algorithm>(data[0] % 5U),
       .output_format = static_cast<OutputFormat>(data[1] % 4U),
       .context_size = data[2] % 16U,
       .side_by_side_width = 3U + (data[3] % 253U),
@@ -66,6 +66,7 @@ extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size
       .skip_left_deletions = (data[6] & 0x02U) != 0,
       .strip_file_header_prefix = std::string(replacement),
       .max_diff_chunk_length = 1U + (data[7] % 64U),
+      .streaming_window = 1U + (data[2] >> 4U),
       .time_format = "",
   };
 
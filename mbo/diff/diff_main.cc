@@ -27,6 +27,7 @@
 #include "absl/flags/usage.h"
 #include "absl/log/absl_log.h"
 #include "absl/log/initialize.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "mbo/diff/diff.h"
 #include "mbo/diff/internal/update_absl_log_flags.h"
@@ -43,8 +44,10 @@ ABSL_FLAG(  //
     "myers",
     R"(Diff algorithm:
 - direct:  Direct side-by-side comparison.
+- histogram: Histogram diff like git's, fast on files with many unique lines (not minimal).
 - myers:   Myers diff, produces minimal diffs like GNU diff and git (default).
 - naive:   Naive line diff that resynchronizes on the closest matching line (not minimal).
+- streaming: Myers diff for very large files with memory bounded by '--streaming_window'.
 The old name 'unified' remains a deprecated alias for 'myers' and implies '--format=unified'.
 )");
 ABSL_FLAG(  //
@@ -132,7 +135,8 @@ ABSL_FLAG(  //
     minimal,
     false,
     "Guarantees minimal diffs for '--algorithm=myers' by disabling its cost cap (like GNU `diff "
-    "--minimal`). Slower on large, highly divergent inputs. No effect on the other algorithms.");
+    "--minimal`). Slower on large, highly divergent inputs. Also applies to the Myers parts of 'streaming' and "
+    "'histogram', no effect on the other algorithms.");
 ABSL_FLAG(  //
     std::string,
     regex_replace_lhs,
@@ -164,6 +168,11 @@ ABSL_FLAG(  //
     skip_time,
     false,
     "Sets the time to the unix epoch 0.");
+ABSL_FLAG(  //
+    std::size_t,
+    streaming_window,
+    65'536,  // NOLINT(*-magic-numbers)
+    "Lines per side that '--algorithm=streaming' diffs at once, which bounds its memory use.");
 ABSL_FLAG(  //
     std::size_t,
     width,
@@ -199,11 +208,12 @@ namespace {
 using mbo::diff::Diff;
 using mbo::file::Artefact;
 
+// Whole files are mapped rather than copied (the diff runs on the mapping).
 absl::StatusOr<Artefact> Read(std::string_view file_name) {
   const Artefact::Options options{.skip_time = absl::GetFlag(FLAGS_skip_time)};
   const std::size_t max_lines = absl::GetFlag(FLAGS_max_lines);
   auto result =
-      max_lines > 0 ? Artefact::ReadMaxLines(file_name, max_lines, options) : Artefact::Read(file_name, options);
+      max_lines > 0 ? Artefact::ReadMaxLines(file_name, max_lines, options) : Artefact::Map(file_name, options);
   if (!result.ok()) {
     ABSL_LOG(ERROR) << "ERROR: " << result.status();
   }
@@ -290,6 +300,7 @@ Diff::Options MakeDiffOptions() {
       .regex_replace_lhs{Diff::Options::ParseRegexReplaceFlag(absl::GetFlag(FLAGS_regex_replace_lhs))},
       .regex_replace_rhs{Diff::Options::ParseRegexReplaceFlag(absl::GetFlag(FLAGS_regex_replace_rhs))},
       .strip_file_header_prefix = absl::GetFlag(FLAGS_strip_file_header_prefix),
+      .streaming_window = absl::GetFlag(FLAGS_streaming_window),
   };
 }
 
@@ -303,16 +314,18 @@ int Diff(std::string_view lhs_name, std::string_view rhs_name) {
     return kExitTrouble;
   }
   const Diff::Options diff_options = MakeDiffOptions();
-  const auto result = Diff::FileDiff(*lhs, *rhs, diff_options);
+  // Chunks get written as they come (`--algorithm=streaming` produces them
+  // incrementally), so a huge diff is never held in memory as a whole.
+  bool different = false;
+  const absl::Status result = Diff::StreamDiff(*lhs, *rhs, diff_options, [&different](std::string_view output) {
+    different = true;
+    std::cout << output;
+  });
   if (!result.ok()) {
-    ABSL_LOG(ERROR) << "ERROR: " << result.status();
+    ABSL_LOG(ERROR) << "ERROR: " << result;
     return kExitTrouble;
   }
-  if (!result->empty()) {
-    std::cout << *result;
-    return kExitDifferent;
-  }
-  return kExitEqual;
+  return different ? kExitDifferent : kExitEqual;
 }
 
 }  // namespace
@@ -325,7 +338,7 @@ int main(int argc, char* argv[]) {
 
     Performs a unified diff (diff -du) between files <old/left> and <new/right>.
     Other output formats ('context', 'normal', 'side-by-side') can be selected
-    with '--format', the algorithm ('myers', 'naive', 'direct') with '--algorithm'.
+    with '--format', the algorithm ('myers', 'naive', 'direct', 'streaming', 'histogram') with '--algorithm'.
   )"));
   absl::InitializeLog();
   const std::vector<char*> args = absl::ParseCommandLine(argc, argv);
@@ -33,8 +33,10 @@ namespace mbo::diff {
 std::optional<DiffOptions::Algorithm> DiffOptions::ParseAlgorithmFlag(std::string_view flag) {
   constexpr auto kFlagMapping = mbo::container::ToLimitedMap<std::string_view, DiffOptions::Algorithm>({
       {"direct", DiffOptions::Algorithm::kDirect},
+      {"histogram", DiffOptions::Algorithm::kHistogram},
       {"myers", DiffOptions::Algorithm::kMyers},
       {"naive", DiffOptions::Algorithm::kNaive},
+      {"streaming", DiffOptions::Algorithm::kStreaming},
       {"unified", DiffOptions::Algorithm::kMyers},  // Deprecated alias; implies unified format.
   });
   auto it = kFlagMapping.find(flag);
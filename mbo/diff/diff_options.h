@@ -42,6 +42,20 @@ struct DiffOptions final {
     // and git implement). The default. The old flag name `unified` maps here
     // (and implies unified format). See `mbo::diff::DiffMyers`.
     kMyers = 2,
+
+    // Bounded memory Myers for very large inputs: the byte-identical common
+    // prefix and suffix are skipped without splitting them into lines and the
+    // rest is diffed in windows of `streaming_window` lines per side. Output
+    // matches `kMyers` when the differing region fits into one window. Use
+    // `Diff::StreamDiff` to receive chunks as they are produced. Selectable as
+    // `streaming`. See `mbo::diff::DiffStreaming`.
+    kStreaming = 3,
+
+    // Histogram diff (git's `--histogram`): splits at the rarest common lines,
+    // which is much faster than `kMyers` on large inputs with many unique
+    // lines and keeps moved blocks readable, but is not necessarily minimal.
+    // Selectable as `histogram`. See `mbo::diff::DiffHistogram`.
+    kHistogram = 4,
   };
 
   enum class OutputFormat {
@@ -117,7 +131,8 @@ struct DiffOptions final {
   bool ignore_missing_final_newline : 1 = false;
   // Disables the `kMyers` cost cap: diffs are guaranteed minimal at the price
   // of O((L+R)*D) worst case time on highly divergent inputs (like GNU
-  // `diff --minimal`). No effect on the other algorithms.
+  // `diff --minimal`). For `kStreaming` and `kHistogram` it applies to their
+  // Myers windows and fallback ranges. No effect on the other algorithms.
   bool minimal : 1 = false;
   bool show_chunk_headers : 1 = true;
   bool skip_left_deletions : 1 = false;
@@ -136,6 +151,10 @@ struct DiffOptions final {
   // work with an internal cost cap instead and `kDirect` needs no bound.
   std::size_t max_diff_chunk_length = 1'337'000;  // NOLINT(*-magic-numbers)
 
+  // Lines per side that `kStreaming` diffs at once; bounds its memory. Edits
+  // spanning more than a window may come out less than minimal.
+  std::size_t streaming_window = 65'536;  // NOLINT(*-magic-numbers)
+
   // The `absl::FormatTime` pattern for each file's timestamp in the unified/context header.
   // An empty string omits the timestamp entirely, producing a git-style header (`--- name`)
   // whose output is reproducible across machines and time zones.
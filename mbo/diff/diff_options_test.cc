@@ -39,6 +39,8 @@ TEST_F(DiffOptionsTest, ParsesEveryAlgorithm) {
   EXPECT_THAT(DiffOptions::ParseAlgorithmFlag("naive"), Optional(Eq(DiffOptions::Algorithm::kNaive)));
   EXPECT_THAT(DiffOptions::ParseAlgorithmFlag("direct"), Optional(Eq(DiffOptions::Algorithm::kDirect)));
   EXPECT_THAT(DiffOptions::ParseAlgorithmFlag("myers"), Optional(Eq(DiffOptions::Algorithm::kMyers)));
+  EXPECT_THAT(DiffOptions::ParseAlgorithmFlag("streaming"), Optional(Eq(DiffOptions::Algorithm::kStreaming)));
+  EXPECT_THAT(DiffOptions::ParseAlgorithmFlag("histogram"), Optional(Eq(DiffOptions::Algorithm::kHistogram)));
 }
 
 TEST_F(DiffOptionsTest, UnifiedIsADeprecatedAliasForMyers) {
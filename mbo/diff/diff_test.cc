@@ -34,6 +34,7 @@
 #include "gtest/gtest.h"
 #include "mbo/container/convert_container.h"
 #include "mbo/file/artefact.h"
+#include "mbo/file/file.h"
 #include "mbo/status/status_macros.h"
 #include "mbo/strings/indent.h"
 #include "mbo/testing/status.h"
@@ -50,6 +51,7 @@ using ::testing::IsEmpty;
 using ::testing::Lt;
 using ::testing::Not;
 using ::testing::Optional;
+using ::testing::SizeIs;
 
 class DiffTest : public ::testing::Test {
  public:
@@ -1115,6 +1117,106 @@ TEST_F(DiffTest, MyersRoundTrip) {
   }
 }
 
+TEST_F(DiffTest, StreamingRoundTripWithSmallWindows) {
+  // Property test: with windows far smaller than the differing regions the
+  // streaming diff may be less than minimal, but it must still be a valid diff.
+  std::mt19937 rng(20'261'016);  // NOLINT(*-magic-numbers)
+  const auto make_file = [&rng](std::size_t lines, std::size_t alphabet) {
+    std::string text;
+    for (std::size_t i = 0; i < lines; ++i) {
+      absl::StrAppend(&text, "l", rng() % alphabet, "\n");
+    }
+    return text;
+  };
+  std::vector<std::pair<std::string, std::string>> cases;
+  cases.emplace_back("", make_file(50, 5));
+  cases.emplace_back(make_file(50, 5), "");
+  static constexpr std::array kLineCounts = std::to_array<std::size_t>({5, 20, 100, 250});
+  static constexpr std::array kAlphabetSizes = std::to_array<std::size_t>({2, 5, 40});
+  for (const std::size_t lines : kLineCounts) {
+    for (const std::size_t alphabet : kAlphabetSizes) {
+      const std::string common = make_file(lines, alphabet);
+      cases.emplace_back(
+          absl::StrCat(make_file(lines, alphabet), common, make_file(lines / 2, alphabet)),
+          absl::StrCat(make_file(lines, alphabet), common, make_file(lines / 3, alphabet)));
+    }
+  }
+  static constexpr std::array kWindows = std::to_array<std::size_t>({1, 3, 16});
+  for (const std::size_t window : kWindows) {
+    const Diff::Options options{
+        .algorithm = Diff::Options::Algorithm::kStreaming,
+        .context_size = 0,
+        .file_header_use = Diff::Options::FileHeaderUse::kNone,
+        .streaming_window = window,
+    };
+    for (std::size_t idx = 0; idx < cases.size(); ++idx) {
+      const auto& [lhs, rhs] = cases.at(idx);
+      MBO_ASSERT_OK_AND_ASSIGN(
+          const std::string result,
+          mbo::diff::Diff::FileDiff({.data = lhs, .name = "lhs"}, {.data = rhs, .name = "rhs"}, options));
+      const std::optional<std::string> applied = ApplyUnifiedDiff(lhs, result);
+      EXPECT_THAT(applied, Optional(rhs)) << "window: " << window << " case: " << idx << " diff:\n" << result;
+    }
+  }
+}
+
+TEST_F(DiffTest, HistogramRoundTrip) {
+  // Property test: histogram diffs are not necessarily minimal, but they must
+  // be valid. Small alphabets make every line too frequent to anchor on, which
+  // exercises the Myers fallback; large ones give mostly unique anchors.
+  std::mt19937 rng(20'261'017);  // NOLINT(*-magic-numbers)
+  const auto make_file = [&rng](std::size_t lines, std::size_t alphabet) {
+    std::string text;
+    for (std::size_t i = 0; i < lines; ++i) {
+      absl::StrAppend(&text, "l", rng() % alphabet, "\n");
+    }
+    return text;
+  };
+  static constexpr std::array kLineCounts = std::to_array<std::size_t>({0, 5, 20, 100, 400});
+  static constexpr std::array kAlphabetSizes = std::to_array<std::size_t>({2, 5, 40, 1'000});
+  const Diff::Options options{
+      .algorithm = Diff::Options::Algorithm::kHistogram,
+      .context_size = 0,
+      .file_header_use = Diff::Options::FileHeaderUse::kNone,
+  };
+  for (const std::size_t lines : kLineCounts) {
+    for (const std::size_t alphabet : kAlphabetSizes) {
+      const std::string common = make_file(lines, alphabet);
+      const std::string lhs = absl::StrCat(make_file(lines / 3, alphabet), common, make_file(lines / 2, alphabet));
+      const std::string rhs = absl::StrCat(make_file(lines / 2, alphabet), common, make_file(lines / 3, alphabet));
+      MBO_ASSERT_OK_AND_ASSIGN(
+          const std::string result,
+          mbo::diff::Diff::FileDiff({.data = lhs, .name = "lhs"}, {.data = rhs, .name = "rhs"}, options));
+      EXPECT_THAT(ApplyUnifiedDiff(lhs, result), Optional(rhs))
+          << "lines: " << lines << " alphabet: " << alphabet << " diff:\n"
+          << result;
+    }
+  }
+}
+
+TEST_F(DiffTest, StreamDiffPassesTheOutputToTheSink) {
+  const file::Artefact lhs{.data = "a\nb\nc\nd\ne\nf\ng\nh\ni\nj\n", .name = "lhs"};
+  const file::Artefact rhs{.data = "A\nb\nc\nd\ne\nf\ng\nh\ni\nJ\n", .name = "rhs"};
+  using Algorithm = Diff::Options::Algorithm;
+  static constexpr std::array kAlgorithms = std::to_array<std::pair<Algorithm, std::size_t>>({
+      {Algorithm::kMyers, 1},      // Complete output at once.
+      {Algorithm::kStreaming, 2},  // One piece per chunk.
+  });
+  for (const auto& [algorithm, pieces] : kAlgorithms) {
+    const Diff::Options options{.algorithm = algorithm, .context_size = 1};
+    std::vector<std::string> output;
+    ASSERT_OK(mbo::diff::Diff::StreamDiff(
+        lhs, rhs, options, [&output](std::string_view piece) { output.emplace_back(piece); }));
+    EXPECT_THAT(output, SizeIs(pieces)) << "algorithm: " << static_cast<int>(algorithm);
+    EXPECT_THAT(mbo::diff::Diff::FileDiff(lhs, rhs, options), IsOkAndHolds(absl::StrJoin(output, "")))
+        << "algorithm: " << static_cast<int>(algorithm);
+    output.clear();
+    ASSERT_OK(mbo::diff::Diff::StreamDiff(
+        lhs, lhs, options, [&output](std::string_view piece) { output.emplace_back(piece); }));
+    EXPECT_THAT(output, IsEmpty()) << "algorithm: " << static_cast<int>(algorithm);
+  }
+}
+
 TEST_F(DiffTest, AlgorithmFeatureMatrix) {
   // Every comparison-affecting option must work identically for every
   // algorithm: inputs that differ only in the ignored aspect produce an empty
@@ -1126,6 +1228,8 @@ TEST_F(DiffTest, AlgorithmFeatureMatrix) {
         {"naive", Algorithm::kNaive},
         {"myers", Algorithm::kMyers},
         {"direct", Algorithm::kDirect},
+        {"streaming", Algorithm::kStreaming},
+        {"histogram", Algorithm::kHistogram},
     });
     for (const auto& [algo_name, algorithm] : kAlgorithms) {
       const Diff::Options options = make_options(algorithm);
@@ -1171,8 +1275,8 @@ TEST_F(DiffTest, AlgorithmFeatureMatrix) {
     };
   });
   // Sanity: without the option every algorithm reports the difference.
-  static constexpr std::array kAlgorithms =
-      std::to_array<Algorithm>({Algorithm::kNaive, Algorithm::kMyers, Algorithm::kDirect});
+  static constexpr std::array kAlgorithms = std::to_array<Algorithm>(
+      {Algorithm::kNaive, Algorithm::kMyers, Algorithm::kDirect, Algorithm::kStreaming, Algorithm::kHistogram});
   for (const Algorithm algorithm : kAlgorithms) {
     EXPECT_THAT(Diff({"aBc\n", "lhs"}, {"AbC\n", "rhs"}, {.algorithm = algorithm}), IsOkAndHolds(Not(IsEmpty())))
         << "algorithm: " << static_cast<int>(algorithm);
@@ -1370,5 +1474,30 @@ TEST_F(DiffTest, RegexReplace) {
       << "Different replacements that producr the same results lead to same zero differences.";
 }
 
+TEST_F(DiffTest, MappedArtefactsDiffLikeReadOnes) {
+  const std::string dir = ::testing::TempDir();
+  const std::string lhs_name = absl::StrCat(dir, "/mapped_lhs.txt");
+  const std::string rhs_name = absl::StrCat(dir, "/mapped_rhs.txt");
+  ASSERT_OK(file::SetContents(lhs_name, "a\nb\nc\nd\n"));
+  ASSERT_OK(file::SetContents(rhs_name, "a\nx\nc\nd"));
+  const file::Artefact::Options file_options{.skip_time = true};
+  MBO_ASSERT_OK_AND_ASSIGN(const file::Artefact lhs_read, file::Artefact::Read(lhs_name, file_options));
+  MBO_ASSERT_OK_AND_ASSIGN(const file::Artefact rhs_read, file::Artefact::Read(rhs_name, file_options));
+  MBO_ASSERT_OK_AND_ASSIGN(const file::Artefact lhs_mapped, file::Artefact::Map(lhs_name, file_options));
+  MBO_ASSERT_OK_AND_ASSIGN(const file::Artefact rhs_mapped, file::Artefact::Map(rhs_name, file_options));
+  static constexpr std::array kAlgorithms = std::to_array<Diff::Options::Algorithm>({
+      Diff::Options::Algorithm::kNaive,
+      Diff::Options::Algorithm::kDirect,
+      Diff::Options::Algorithm::kMyers,
+  });
+  for (const Diff::Options::Algorithm algorithm : kAlgorithms) {
+    const Diff::Options options{.algorithm = algorithm};
+    MBO_ASSERT_OK_AND_ASSIGN(const std::string expected, mbo::diff::Diff::FileDiff(lhs_read, rhs_read, options));
+    EXPECT_THAT(expected, Not(IsEmpty()));
+    EXPECT_THAT(mbo::diff::Diff::FileDiff(lhs_mapped, rhs_mapped, options), IsOkAndHolds(expected));
+    EXPECT_THAT(mbo::diff::Diff::FileDiff(lhs_mapped, lhs_mapped, options), IsOkAndHolds(IsEmpty()));
+  }
+}
+
 }  // namespace
 }  // namespace mbo::diff
@@ -26,7 +26,7 @@ absl::StatusOr<std::string> DiffDirect::FileDiff(
     const file::Artefact& lhs,
     const file::Artefact& rhs,
     const DiffOptions& options) {
-  if (lhs.data == rhs.data) {
+  if (lhs.Text() == rhs.Text()) {
     return std::string();
   }
   DiffDirect diff(lhs, rhs, options);
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/diff/impl/diff_histogram.h"
+
+#include <cstddef>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "mbo/diff/diff_options.h"
+#include "mbo/diff/internal/histogram.h"
+#include "mbo/diff/internal/myers.h"
+#include "mbo/file/artefact.h"
+
+namespace mbo::diff {
+
+absl::StatusOr<std::string> DiffHistogram::FileDiff(
+    const file::Artefact& lhs,
+    const file::Artefact& rhs,
+    const DiffOptions& options) {
+  if (lhs.Text() == rhs.Text()) {
+    return std::string();
+  }
+  return DiffHistogram(lhs, rhs, options).Compute();
+}
+
+DiffHistogram::DiffHistogram(const file::Artefact& lhs, const file::Artefact& rhs, const DiffOptions& options)
+    : ChunkedDiff(lhs, rhs, options) {}
+
+absl::StatusOr<std::string> DiffHistogram::Compute() {
+  diff_internal::Tokenizer tokenizer(Options().ignore_case);
+  tokenizer.Tokenize(LhsData(), lhs_tokens_);
+  tokenizer.Tokenize(RhsData(), rhs_tokens_);
+  using Edit = diff_internal::Histogram::Edit;
+  diff_internal::Histogram(lhs_tokens_, rhs_tokens_, Options().minimal).Run([this](Edit edit, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      switch (edit) {
+        case Edit::kEqual: PushEqual(); break;
+        case Edit::kLhs: PushLhs(); break;
+        case Edit::kRhs: PushRhs(); break;
+      }
+    }
+  });
+  return Finalize();
+}
+
+}  // namespace mbo::diff
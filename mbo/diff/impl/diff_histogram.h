@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_DIFF_IMPL_DIFF_HISTOGRAM_H_
+#define MBO_DIFF_IMPL_DIFF_HISTOGRAM_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "mbo/diff/chunked_diff.h"
+#include "mbo/diff/diff_options.h"
+#include "mbo/diff/internal/myers.h"
+#include "mbo/file/artefact.h"
+
+namespace mbo::diff {
+
+// Histogram diff implementation (git's `--histogram`). See
+// `diff_internal::Histogram` for the kernel.
+//
+// Lines are interned into the same integer tokens as for `DiffMyers` and the
+// edit script is replayed through `ChunkedDiff`, so chunking, context handling,
+// filtering and all output formats are shared with the other algorithms.
+//
+// Ranges get split at their rarest common lines, which takes time linear in
+// the range size per split. That is much faster than Myers on large inputs
+// with many unique lines (typical source code), and since unique lines are
+// preferred as anchors, moved blocks tend to read better. The script is not
+// necessarily minimal. Ranges whose common lines all repeat too often are
+// diffed with `diff_internal::Myers`, honoring `DiffOptions::minimal`.
+class DiffHistogram final : private ChunkedDiff {
+ public:
+  static absl::StatusOr<std::string> FileDiff(
+      const file::Artefact& lhs,
+      const file::Artefact& rhs,
+      const DiffOptions& options);
+
+  DiffHistogram() = delete;
+
+ private:
+  DiffHistogram(const file::Artefact& lhs, const file::Artefact& rhs, const DiffOptions& options);
+
+  absl::StatusOr<std::string> Compute();
+
+  std::vector<diff_internal::Token> lhs_tokens_;
+  std::vector<diff_internal::Token> rhs_tokens_;
+};
+
+}  // namespace mbo::diff
+
+#endif  // MBO_DIFF_IMPL_DIFF_HISTOGRAM_H_
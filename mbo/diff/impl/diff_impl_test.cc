@@ -13,24 +13,31 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
+#include <cstddef>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "mbo/diff/diff_options.h"
 #include "mbo/diff/impl/diff_direct.h"
+#include "mbo/diff/impl/diff_histogram.h"
 #include "mbo/diff/impl/diff_myers.h"
 #include "mbo/diff/impl/diff_naive.h"
+#include "mbo/diff/impl/diff_streaming.h"
 #include "mbo/file/artefact.h"
 #include "mbo/testing/status.h"
 
-// Tests the three diff algorithm implementations directly, not through the
+// Tests the diff algorithm implementations directly, not through the
 // `Diff::FileDiff` dispatcher: each is its own library, and each deserves its own
-// contract checks. All three replay their edit scripts through `ChunkedDiff`, so
-// where their algorithms must agree (a single-line change has exactly one minimal
-// script) their unified output must be byte-identical; where they legitimately
+// contract checks. All of them render through the shared `Chunk`, so where their
+// algorithms must agree (a single-line change has exactly one minimal script)
+// their unified output must be byte-identical; where they legitimately
 // differ (naive is greedy, direct is positional side-by-side) the tests say so
 // rather than over-constraining.
 
@@ -39,6 +46,7 @@ namespace {
 
 using ::mbo::testing::IsOkAndHolds;
 using ::testing::AllOf;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::Not;
@@ -53,6 +61,15 @@ struct DiffImplTest : ::testing::Test {
   }
 
   static file::Artefact Text(std::string_view text) { return {.data = std::string(text)}; }
+
+  // The lines `{prefix}0` to `{prefix}{count - 1}`, each with a newline.
+  static std::string Lines(std::string_view prefix, std::size_t count) {
+    std::string result;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      absl::StrAppend(&result, prefix, idx, "\n");
+    }
+    return result;
+  }
 };
 
 // Identical inputs -------------------------------------------------------------
@@ -136,5 +153,106 @@ TEST_F(DiffImplTest, DirectShowsChangedLinesSideBySide) {
       IsOkAndHolds(AllOf(HasSubstr("b"), HasSubstr("X"))));
 }
 
+// Streaming trims the common prefix and suffix by bytes and diffs the rest in
+// windows: within one window it must reproduce Myers byte for byte, including
+// line numbers and context taken from the trimmed parts.
+
+TEST_F(DiffImplTest, StreamingIdenticalInputsProduceNoDiff) {
+  EXPECT_THAT(DiffStreaming::FileDiff(Text("a\nb\n"), Text("a\nb\n"), BareOptions()), IsOkAndHolds(IsEmpty()));
+}
+
+TEST_F(DiffImplTest, StreamingMatchesMyersWithinOneWindow) {
+  DiffOptions options = BareOptions();
+  options.context_size = 2;
+  const std::string common = Lines("line", 100);
+  const auto cases = std::to_array<std::pair<std::string, std::string>>({
+      {"a\nb\nc\n", "a\nX\nc\n"},
+      {"a\nc\n", "a\nb\nc\n"},
+      {"a\nb\n", "a\nb"},
+      {"a\nb", "a\nc"},
+      {"", "a\n"},
+      {common + "old\n" + common, common + "new\n" + common},
+      {common + "x\n" + common + "y\n" + common, common + common + "y\nz\n" + common},
+      {common, common + "tail"},
+  });
+  for (const auto& [lhs, rhs] : cases) {
+    MBO_ASSERT_OK_AND_ASSIGN(const std::string myers, DiffMyers::FileDiff(Text(lhs), Text(rhs), options));
+    EXPECT_THAT(DiffStreaming::FileDiff(Text(lhs), Text(rhs), options), IsOkAndHolds(myers))
+        << "lhs:\n" << lhs << "\nrhs:\n" << rhs;
+  }
+}
+
+TEST_F(DiffImplTest, StreamingNumbersLinesAfterTheTrimmedPrefix) {
+  DiffOptions options = BareOptions();
+  options.context_size = 1;
+  const std::string common = Lines("line", 1000);
+  EXPECT_THAT(
+      DiffStreaming::FileDiff(Text(common + "old\n" + common), Text(common + "new\n" + common), options),
+      IsOkAndHolds("@@ -1000,3 +1000,3 @@\n line999\n-old\n+new\n line0\n"));
+}
+
+TEST_F(DiffImplTest, StreamingSmallWindowsResynchronize) {
+  DiffOptions options = BareOptions();
+  options.context_size = 1;
+  options.streaming_window = 3;
+  const std::string lhs = Lines("line", 20);
+  std::string rhs = lhs;
+  rhs.replace(rhs.find("line5\n"), 6, "five\n");
+  rhs.replace(rhs.find("line12\n"), 7, "");
+  rhs.append("line20\n");
+  MBO_ASSERT_OK_AND_ASSIGN(const std::string myers, DiffMyers::FileDiff(Text(lhs), Text(rhs), options));
+  EXPECT_THAT(DiffStreaming::FileDiff(Text(lhs), Text(rhs), options), IsOkAndHolds(myers));
+}
+
+TEST_F(DiffImplTest, StreamingWindowsKeepTheNoNewlineMarker) {
+  DiffOptions options = BareOptions();
+  options.streaming_window = 1;
+  EXPECT_THAT(
+      DiffStreaming::FileDiff(Text("a\nb\nc"), Text("x\ny\n"), options),
+      IsOkAndHolds("@@ -1,3 +1,2 @@\n-a\n-b\n-c\n\\ No newline at end of file\n+x\n+y\n"));
+}
+
+TEST_F(DiffImplTest, StreamingPassesChunksToTheSinkAsTheyComplete) {
+  const std::string common = Lines("line", 50);
+  std::vector<std::string> chunks;
+  ASSERT_OK(DiffStreaming::FileDiff(
+      Text("a\n" + common + "b\n"), Text("A\n" + common + "B\n"), BareOptions(),
+      [&chunks](std::string_view chunk) { chunks.emplace_back(chunk); }));
+  EXPECT_THAT(chunks, ElementsAre("@@ -1 +1 @@\n-a\n+A\n", "@@ -52 +52 @@\n-b\n+B\n"));
+}
+
+TEST_F(DiffImplTest, StreamingRegexReplaceDisablesTrimming) {
+  // The replacement makes byte-identical lines differ, so nothing may be
+  // skipped as common.
+  DiffOptions options = BareOptions();
+  options.regex_replace_lhs = DiffOptions::ParseRegexReplaceFlag("/a/b/");
+  MBO_ASSERT_OK_AND_ASSIGN(const std::string myers, DiffMyers::FileDiff(Text("a\nc\n"), Text("a\nd\n"), options));
+  EXPECT_THAT(myers, "@@ -1,2 +1,2 @@\n-a\n-c\n+a\n+d\n");
+  EXPECT_THAT(DiffStreaming::FileDiff(Text("a\nc\n"), Text("a\nd\n"), options), IsOkAndHolds(myers));
+}
+
+// Histogram splits at the rarest common lines: single changes read exactly as
+// with Myers, but a unique line wins over a longer run of repeated ones.
+
+TEST_F(DiffImplTest, HistogramIdenticalInputsProduceNoDiff) {
+  EXPECT_THAT(DiffHistogram::FileDiff(Text("a\nb\n"), Text("a\nb\n"), BareOptions()), IsOkAndHolds(IsEmpty()));
+}
+
+TEST_F(DiffImplTest, HistogramAgreesWithMyersOnASingleLineChange) {
+  const std::string lhs = absl::StrCat(Lines("line", 50), "old\n", Lines("tail", 50));
+  const std::string rhs = absl::StrCat(Lines("line", 50), "new\n", Lines("tail", 50));
+  MBO_ASSERT_OK_AND_ASSIGN(const std::string myers, DiffMyers::FileDiff(Text(lhs), Text(rhs), DiffOptions{}));
+  EXPECT_THAT(DiffHistogram::FileDiff(Text(lhs), Text(rhs), DiffOptions{}), IsOkAndHolds(myers));
+}
+
+TEST_F(DiffImplTest, HistogramAnchorsOnUniqueLines) {
+  EXPECT_THAT(
+      DiffMyers::FileDiff(Text("u\nd\nd\nd\n"), Text("d\nd\nd\nu\n"), BareOptions()),
+      IsOkAndHolds("@@ -1 +0,0 @@\n-u\n@@ -4,0 +4 @@\n+u\n"));
+  EXPECT_THAT(
+      DiffHistogram::FileDiff(Text("u\nd\nd\nd\n"), Text("d\nd\nd\nu\n"), BareOptions()),
+      IsOkAndHolds("@@ -0,0 +1,3 @@\n+d\n+d\n+d\n@@ -2,3 +4,0 @@\n-d\n-d\n-d\n"));
+}
+
 }  // namespace
 }  // namespace mbo::diff
@@ -16,14 +16,13 @@
 #ifndef MBO_DIFF_IMPL_DIFF_MYERS_H_
 #define MBO_DIFF_IMPL_DIFF_MYERS_H_
 
-#include <cstddef>
-#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "absl/status/statusor.h"
 #include "mbo/diff/chunked_diff.h"
 #include "mbo/diff/diff_options.h"
+#include "mbo/diff/internal/myers.h"
 #include "mbo/file/artefact.h"
 
 namespace mbo::diff {
@@ -42,7 +41,8 @@ namespace mbo::diff {
 // differing lines. Once a subdivision exceeds a cost of max(64, sqrt(L+R))
 // it splits at the furthest reaching path found so far (the same heuristic
 // git uses), which bounds pathological inputs at the expense of minimality;
-// `DiffOptions::minimal` disables the cap.
+// `DiffOptions::minimal` disables the cap. The kernel itself lives in
+// `diff_internal::Myers`, shared with `DiffStreaming`.
 class DiffMyers final : private ChunkedDiff {
  public:
   static absl::StatusOr<std::string> FileDiff(
@@ -53,39 +53,12 @@ class DiffMyers final : private ChunkedDiff {
   DiffMyers() = delete;
 
  private:
-  using Token = std::uint32_t;
-
-  // A pending piece of work: either a not yet diffed range of lines
-  // (`*_end` exclusive) or, if `equals != 0`, a run of common lines to emit.
-  struct Span {
-    std::size_t lhs_begin = 0;
-    std::size_t lhs_end = 0;
-    std::size_t rhs_begin = 0;
-    std::size_t rhs_end = 0;
-    std::size_t equals = 0;
-  };
-
-  // A (possibly empty) run of common lines that splits a span into two
-  // independently diffable halves.
-  struct Snake {
-    std::size_t lhs_begin = 0;
-    std::size_t rhs_begin = 0;
-    std::size_t length = 0;
-  };
-
   DiffMyers(const file::Artefact& lhs, const file::Artefact& rhs, const DiffOptions& options);
 
   absl::StatusOr<std::string> Compute();
 
-  void Tokenize();
-  void Loop();
-  Snake FindMiddleSnake(const Span& span);
-
-  std::vector<Token> lhs_tokens_;
-  std::vector<Token> rhs_tokens_;
-  std::vector<std::ptrdiff_t> fwd_;  // Forward furthest-reaching x per diagonal.
-  std::vector<std::ptrdiff_t> bwd_;  // Backward equivalent, in reversed coordinates.
-  std::size_t max_cost_ = 0;
+  std::vector<diff_internal::Token> lhs_tokens_;
+  std::vector<diff_internal::Token> rhs_tokens_;
 };
 
 }  // namespace mbo::diff
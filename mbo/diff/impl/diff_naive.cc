@@ -37,7 +37,7 @@ absl::StatusOr<std::string> DiffNaive::FileDiff(
     const file::Artefact& lhs,
     const file::Artefact& rhs,
     const DiffOptions& options) {
-  if (lhs.data == rhs.data) {
+  if (lhs.Text() == rhs.Text()) {
     return std::string();
   }
   return DiffNaive(lhs, rhs, options).Compute();
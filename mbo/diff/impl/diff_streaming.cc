@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/diff/impl/diff_streaming.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mbo/diff/base_diff.h"
+#include "mbo/diff/diff_options.h"
+#include "mbo/diff/internal/data.h"
+#include "mbo/diff/internal/myers.h"
+#include "mbo/file/artefact.h"
+#include "mbo/status/status_macros.h"
+
+namespace mbo::diff {
+
+namespace {
+
+// Block size for the `memcmp` scans over the common prefix and suffix.
+constexpr std::size_t kCompareBlock = 4096;
+
+std::size_t CommonPrefix(std::string_view lhs, std::string_view rhs) {
+  const std::size_t size = std::min(lhs.size(), rhs.size());
+  std::size_t pos = 0;
+  while (pos + kCompareBlock <= size && std::memcmp(lhs.data() + pos, rhs.data() + pos, kCompareBlock) == 0) {
+    pos += kCompareBlock;
+  }
+  while (pos < size && lhs[pos] == rhs[pos]) {
+    ++pos;
+  }
+  return pos;
+}
+
+std::size_t CommonSuffix(std::string_view lhs, std::string_view rhs) {
+  const std::size_t size = std::min(lhs.size(), rhs.size());
+  const char* lhs_end = lhs.data() + lhs.size();
+  const char* rhs_end = rhs.data() + rhs.size();
+  std::size_t len = 0;
+  while (len + kCompareBlock <= size
+         && std::memcmp(lhs_end - len - kCompareBlock, rhs_end - len - kCompareBlock, kCompareBlock) == 0) {
+    len += kCompareBlock;
+  }
+  while (len < size && lhs[lhs.size() - len - 1] == rhs[rhs.size() - len - 1]) {
+    ++len;
+  }
+  return len;
+}
+
+// The first `lines` lines of `text` including their newlines.
+std::string_view HeadLines(std::string_view text, std::size_t lines) {
+  std::size_t pos = 0;
+  while (lines-- > 0 && pos < text.size()) {
+    const std::size_t eol = text.find('\n', pos);
+    if (eol == std::string_view::npos) {
+      return text;
+    }
+    pos = eol + 1;
+  }
+  return text.substr(0, pos);
+}
+
+// The last `lines` lines of `text`, which must be empty or end in a newline.
+std::string_view TailLines(std::string_view text, std::size_t lines) {
+  std::size_t pos = text.size();
+  while (lines-- > 0 && pos > 0) {
+    const std::size_t eol = pos >= 2 ? text.rfind('\n', pos - 2) : std::string_view::npos;
+    pos = eol == std::string_view::npos ? 0 : eol + 1;
+  }
+  return text.substr(pos);
+}
+
+// The current line of `data` (a window over `text`) as a view that outlives
+// `data`. That is a view into `text`, except for a last line without newline:
+// `Data` renders that with the `\ No newline at end of file` marker into its
+// own storage, so it gets copied into `storage`.
+std::string_view StableLine(
+    const diff_internal::Data& data,
+    std::string_view text,
+    const DiffOptions& options,
+    std::string& storage) {
+  const std::string_view line = data.Line();
+  if (options.ignore_missing_final_newline || text.ends_with('\n') || data.Idx() + 1 != data.Size()) {
+    return line;
+  }
+  storage.assign(line);
+  return storage;
+}
+
+}  // namespace
+
+absl::Status DiffStreaming::FileDiff(
+    const file::Artefact& lhs,
+    const file::Artefact& rhs,
+    const DiffOptions& options,
+    const Sink& sink) {
+  if (lhs.Text() == rhs.Text()) {
+    return absl::OkStatus();
+  }
+  DiffStreaming(lhs, rhs, options, sink).Compute();
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> DiffStreaming::FileDiff(
+    const file::Artefact& lhs,
+    const file::Artefact& rhs,
+    const DiffOptions& options) {
+  std::string output;
+  MBO_RETURN_IF_ERROR(FileDiff(lhs, rhs, options, [&output](std::string_view chunk) { output.append(chunk); }));
+  return output;
+}
+
+DiffStreaming::DiffStreaming(
+    const file::Artefact& lhs,
+    const file::Artefact& rhs,
+    const DiffOptions& options,
+    const Sink& sink)
+    : options_(options),
+      chunk_(BaseDiff::FileHeaders(lhs, rhs, options), options, sink),
+      lhs_text_(lhs.Text()),
+      rhs_text_(rhs.Text()) {}
+
+void DiffStreaming::Compute() {
+  Trim();
+  while (!DiffWindow()) {
+  }
+}
+
+void DiffStreaming::Trim() {
+  if (options_.regex_replace_lhs.has_value() || options_.regex_replace_rhs.has_value()) {
+    return;
+  }
+  // Byte-identical lines are equal under every other option. Both cuts must
+  // be on line boundaries (on both sides), so the prefix ends after its last
+  // newline and the suffix starts after its first newline unless it already
+  // starts a line on both sides.
+  std::size_t prefix = CommonPrefix(lhs_text_, rhs_text_);
+  const std::size_t prefix_eol = lhs_text_.substr(0, prefix).rfind('\n');
+  prefix = prefix_eol == std::string_view::npos ? 0 : prefix_eol + 1;
+  const std::string_view common = lhs_text_.substr(0, prefix);
+  lhs_text_.remove_prefix(prefix);
+  rhs_text_.remove_prefix(prefix);
+  std::size_t suffix = CommonSuffix(lhs_text_, rhs_text_);
+  const auto starts_line = [&suffix](std::string_view text) {
+    const std::size_t pos = text.size() - suffix;
+    return pos == 0 || text[pos - 1] == '\n';
+  };
+  if (suffix > 0 && (!starts_line(lhs_text_) || !starts_line(rhs_text_))) {
+    const std::size_t suffix_eol = lhs_text_.substr(lhs_text_.size() - suffix).find('\n');
+    suffix = suffix_eol == std::string_view::npos ? 0 : suffix - suffix_eol - 1;
+  }
+  suffix_ = lhs_text_.substr(lhs_text_.size() - suffix);
+  lhs_text_.remove_suffix(suffix);
+  rhs_text_.remove_suffix(suffix);
+  lhs_idx_ = static_cast<std::size_t>(std::ranges::count(common, '\n'));
+  rhs_idx_ = lhs_idx_;
+  // Only the prefix lines that can become context get preprocessed.
+  diff_internal::Data context(options_, options_.regex_replace_lhs, TailLines(common, options_.context_size));
+  std::size_t idx = lhs_idx_ - context.Size();
+  while (!context.Done()) {
+    chunk_.PushBoth(idx, idx, context.Next());
+    ++idx;
+  }
+}
+
+bool DiffStreaming::DiffWindow() {
+  const std::size_t window = std::max<std::size_t>(1, options_.streaming_window);
+  const std::string_view lhs_window = HeadLines(lhs_text_, window);
+  const std::string_view rhs_window = HeadLines(rhs_text_, window);
+  const bool last = lhs_window.size() == lhs_text_.size() && rhs_window.size() == rhs_text_.size();
+  diff_internal::Data lhs_data(options_, options_.regex_replace_lhs, lhs_window);
+  diff_internal::Data rhs_data(options_, options_.regex_replace_rhs, rhs_window);
+  std::vector<diff_internal::Token> lhs_tokens;
+  std::vector<diff_internal::Token> rhs_tokens;
+  {
+    // Per window, so the interning table stays bounded as well.
+    diff_internal::Tokenizer tokenizer(options_.ignore_case);
+    tokenizer.Tokenize(lhs_data, lhs_tokens);
+    tokenizer.Tokenize(rhs_data, rhs_tokens);
+  }
+  using Edit = diff_internal::Myers::Edit;
+  struct Run {
+    Edit edit;
+    std::size_t count;
+  };
+
+  std::vector<Run> script;
+  diff_internal::Myers(lhs_tokens, rhs_tokens, options_.minimal).Run([&script](Edit edit, std::size_t count) {
+    script.push_back({.edit = edit, .count = count});
+  });
+  auto commit = script.end();
+  if (!last) {
+    const auto last_equal = std::ranges::find(std::views::reverse(script), Edit::kEqual, &Run::edit);
+    if (last_equal != script.rend()) {
+      commit = last_equal.base();
+    }
+  }
+  for (auto run = script.begin(); run != commit; ++run) {
+    for (std::size_t i = 0; i < run->count; ++i) {
+      switch (run->edit) {
+        case Edit::kEqual:
+          chunk_.PushBoth(lhs_idx_++, rhs_idx_++, StableLine(lhs_data, lhs_window, options_, lhs_last_line_));
+          lhs_data.Next();
+          rhs_data.Next();
+          break;
+        case Edit::kLhs:
+          chunk_.PushLhs(lhs_idx_++, rhs_idx_, StableLine(lhs_data, lhs_window, options_, lhs_last_line_));
+          lhs_data.Next();
+          break;
+        case Edit::kRhs:
+          chunk_.PushRhs(lhs_idx_, rhs_idx_++, StableLine(rhs_data, rhs_window, options_, rhs_last_line_));
+          rhs_data.Next();
+          break;
+      }
+    }
+  }
+  if (last) {
+    Finish();
+    return true;
+  }
+  lhs_text_.remove_prefix(HeadLines(lhs_text_, lhs_data.Idx()).size());
+  rhs_text_.remove_prefix(HeadLines(rhs_text_, rhs_data.Idx()).size());
+  return false;
+}
+
+void DiffStreaming::Finish() {
+  // Only the suffix lines that can become context get preprocessed.
+  diff_internal::Data context(options_, options_.regex_replace_lhs, HeadLines(suffix_, options_.context_size));
+  while (!context.Done()) {
+    chunk_.PushBoth(lhs_idx_++, rhs_idx_++, context.Next());
+  }
+  chunk_.MoveOutput();
+}
+
+}  // namespace mbo::diff
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_DIFF_IMPL_DIFF_STREAMING_H_
+#define MBO_DIFF_IMPL_DIFF_STREAMING_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mbo/diff/diff_options.h"
+#include "mbo/diff/internal/chunk.h"
+#include "mbo/file/artefact.h"
+
+namespace mbo::diff {
+
+// Bounded memory variant of `DiffMyers` for very large inputs (multi-GB logs
+// and golden files), whose memory is proportional to the differing region
+// rather than to the file sizes:
+//
+// * The byte-identical common prefix and suffix are found with `memcmp` and
+//   skipped without splitting them into lines; only the `context_size` lines
+//   next to the differing region get preprocessed (and the prefix lines
+//   counted, so line numbers stay right). Trimming is skipped if either side
+//   has a regex replacement, as that can make identical lines differ.
+// * The remaining middle is diffed in windows of `streaming_window` lines per
+//   side. Each window runs the `diff_internal::Myers` kernel and commits the
+//   edit script up to (including) its last run of common lines. The rest gets
+//   diffed again as part of the next window, so edits crossing the window end
+//   still resynchronize. A window without common lines is committed as a
+//   whole. The last window (both sides end in it) is committed completely.
+// * Chunks are passed to the sink as soon as they are complete.
+//
+// If the differing region fits into one window, the diff is as short as the one
+// from `DiffMyers` (and identical unless comparison options make several
+// alignments equally short). Otherwise it is valid but may be less than minimal.
+class DiffStreaming final {
+ public:
+  using Sink = diff_internal::Chunk::Sink;
+
+  // Streams the diff into `sink`. Nothing is written for identical inputs.
+  static absl::Status FileDiff(
+      const file::Artefact& lhs,
+      const file::Artefact& rhs,
+      const DiffOptions& options,
+      const Sink& sink);
+
+  // Collects the whole diff (for parity with the other algorithms).
+  static absl::StatusOr<std::string> FileDiff(
+      const file::Artefact& lhs,
+      const file::Artefact& rhs,
+      const DiffOptions& options);
+
+  DiffStreaming() = delete;
+
+ private:
+  DiffStreaming(const file::Artefact& lhs, const file::Artefact& rhs, const DiffOptions& options, const Sink& sink);
+
+  void Compute();
+
+  // Skips the common prefix and suffix, pushing the prefix' trailing context.
+  void Trim();
+
+  // Diffs the next window of the middle. Returns true once the middle is done,
+  // in which case the output was finished while the last window was alive.
+  bool DiffWindow();
+
+  // Pushes the leading context lines of the common suffix and flushes.
+  void Finish();
+
+  const DiffOptions& options_;
+  diff_internal::Chunk chunk_;
+  std::string_view lhs_text_;  // Not yet diffed part of the middle.
+  std::string_view rhs_text_;
+  std::string_view suffix_;    // The common suffix (identical on both sides).
+  std::size_t lhs_idx_ = 0;    // Line index of the start of `lhs_text_`.
+  std::size_t rhs_idx_ = 0;
+  std::string lhs_last_line_;  // Stable copies of a last line without newline.
+  std::string rhs_last_line_;
+};
+
+}  // namespace mbo::diff
+
+#endif  // MBO_DIFF_IMPL_DIFF_STREAMING_H_
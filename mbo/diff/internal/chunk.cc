@@ -127,6 +127,10 @@ void Chunk::OutputChunk() {
           .rhs_size = rhs_size_,
       },
       data_);
+  if (sink_) {
+    sink_(output_);
+    output_.clear();
+  }
 }
 
 void Chunk::Clear() {
@@ -17,8 +17,11 @@
 #define MBO_DIFF_INTERNAL_CHUNK_H_
 
 #include <cstddef>
+#include <functional>
 #include <list>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "mbo/diff/diff_options.h"
@@ -29,12 +32,21 @@ namespace mbo::diff::diff_internal {
 
 class Chunk {
  public:
+  // Receives the output incrementally: the header together with the first
+  // rendered chunk, then each further chunk as soon as it is complete.
+  using Sink = std::function<void(std::string_view)>;
+
   Chunk() = delete;
   ~Chunk() = default;
 
   Chunk(std::string header, const DiffOptions& options)
       : options_(options), output_(std::move(header)), context_(options) {}
 
+  // With a `sink` nothing accumulates in the output: `MoveOutput` flushes the
+  // last chunk and returns an empty string.
+  Chunk(std::string header, const DiffOptions& options, Sink sink)
+      : options_(options), output_(std::move(header)), context_(options), sink_(std::move(sink)) {}
+
   Chunk(const Chunk&) = delete;
   Chunk& operator=(const Chunk&) = delete;
   Chunk(Chunk&&) = delete;
@@ -58,6 +70,7 @@ class Chunk {
   const DiffOptions& options_;
   std::string output_;
   Context context_;
+  const Sink sink_;
   std::vector<ChunkEntry> data_;
   std::list<std::string_view> lhs_;
   std::list<std::string_view> rhs_;
@@ -13,8 +13,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -23,6 +25,8 @@
 #include "mbo/diff/internal/chunk.h"
 #include "mbo/diff/internal/context.h"
 #include "mbo/diff/internal/data.h"
+#include "mbo/diff/internal/histogram.h"
+#include "mbo/diff/internal/myers.h"
 #include "mbo/diff/internal/output.h"
 #include "mbo/diff/internal/update_absl_log_flags.h"
 
@@ -32,10 +36,14 @@
 namespace mbo::diff::diff_internal {
 namespace {
 
+using ::testing::AnyOf;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::IsFalse;
 using ::testing::IsTrue;
+using ::testing::Not;
+using ::testing::SizeIs;
 
 struct DiffInternalTest : ::testing::Test {
   static DiffOptions Options(std::size_t context) {
@@ -156,6 +164,27 @@ TEST_F(DiffInternalTest, ChunkWithNoDiffsRendersNothing) {
   EXPECT_THAT(chunk.MoveOutput(), IsEmpty());
 }
 
+TEST_F(DiffInternalTest, ChunkWithSinkPassesEachHunkWhenComplete) {
+  const DiffOptions options = Options(0);
+  std::vector<std::string> parts;
+  Chunk chunk("header\n", options, [&parts](std::string_view part) { parts.emplace_back(part); });
+  chunk.PushLhs(0, 0, "old");
+  chunk.PushBoth(1, 0, "same");
+  EXPECT_THAT(parts, ElementsAre("header\n@@ -1 +0,0 @@\n-old\n")) << "header comes with the first hunk";
+  chunk.PushRhs(2, 1, "new");
+  EXPECT_THAT(chunk.MoveOutput(), IsEmpty()) << "nothing accumulates";
+  EXPECT_THAT(parts, ElementsAre("header\n@@ -1 +0,0 @@\n-old\n", "@@ -2,0 +2 @@\n+new\n"));
+}
+
+TEST_F(DiffInternalTest, ChunkWithSinkPassesNothingWithoutDiffs) {
+  const DiffOptions options = Options(0);
+  std::vector<std::string> parts;
+  Chunk chunk("header\n", options, [&parts](std::string_view part) { parts.emplace_back(part); });
+  chunk.PushBoth(0, 0, "same");
+  EXPECT_THAT(chunk.MoveOutput(), IsEmpty());
+  EXPECT_THAT(parts, IsEmpty());
+}
+
 TEST_F(DiffInternalTest, AppendChunkRendersUnifiedFormat) {
   const DiffOptions options = Options(0);
   std::string output;
@@ -174,6 +203,121 @@ TEST_F(DiffInternalTest, AppendChunkRendersContextLines) {
   EXPECT_THAT(output, "@@ -1,3 +1,3 @@\n a\n-b\n+X\n c\n");
 }
 
+// Tokenizer + Myers: the kernel shared by `DiffMyers` and `DiffStreaming`. ------
+
+struct EditRun {
+  Myers::Edit edit;
+  std::size_t count;
+
+  bool operator==(const EditRun& other) const = default;
+};
+
+template<typename Kernel = Myers>
+std::vector<EditRun> EditScript(const std::vector<Token>& lhs, const std::vector<Token>& rhs, bool minimal = false) {
+  std::vector<EditRun> script;
+  Kernel(lhs, rhs, minimal).Run([&script](Myers::Edit edit, std::size_t count) {
+    script.push_back({.edit = edit, .count = count});
+  });
+  return script;
+}
+
+TEST_F(DiffInternalTest, TokenizerInternsEqualLinesIntoEqualTokens) {
+  const DiffOptions options = Options(0);
+  const Data lhs(options, std::nullopt, "a\nb\na\n");
+  const Data rhs(options, std::nullopt, "b\nc\n");
+  Tokenizer tokenizer(/*ignore_case=*/false);
+  std::vector<Token> lhs_tokens;
+  std::vector<Token> rhs_tokens;
+  tokenizer.Tokenize(lhs, lhs_tokens);
+  tokenizer.Tokenize(rhs, rhs_tokens);
+  ASSERT_THAT(lhs_tokens, SizeIs(3));
+  ASSERT_THAT(rhs_tokens, SizeIs(2));
+  EXPECT_THAT(lhs_tokens[0], lhs_tokens[2]);
+  EXPECT_THAT(lhs_tokens[1], rhs_tokens[0]);
+  EXPECT_THAT(rhs_tokens[1], Not(AnyOf(lhs_tokens[0], lhs_tokens[1])));
+}
+
+TEST_F(DiffInternalTest, TokenizerFoldsCase) {
+  const DiffOptions options = Options(0);
+  const Data data(options, std::nullopt, "Abc\naBC\n");
+  Tokenizer tokenizer(/*ignore_case=*/true);
+  std::vector<Token> tokens;
+  tokenizer.Tokenize(data, tokens);
+  ASSERT_THAT(tokens, SizeIs(2));
+  EXPECT_THAT(tokens[0], tokens[1]);
+}
+
+TEST_F(DiffInternalTest, MyersEmitsRunsInOrder) {
+  using enum Myers::Edit;
+  EXPECT_THAT(EditScript({}, {}), IsEmpty());
+  EXPECT_THAT(EditScript({1, 2}, {1, 2}), ElementsAre(EditRun{kEqual, 2}));
+  EXPECT_THAT(EditScript({1, 2, 3}, {}), ElementsAre(EditRun{kLhs, 3}));
+  EXPECT_THAT(EditScript({}, {4}), ElementsAre(EditRun{kRhs, 1}));
+  EXPECT_THAT(
+      EditScript({1, 2, 3, 4}, {1, 5, 3, 4}),
+      ElementsAre(EditRun{kEqual, 1}, EditRun{kLhs, 1}, EditRun{kRhs, 1}, EditRun{kEqual, 2}));
+}
+
+TEST_F(DiffInternalTest, MyersScriptIsMinimal) {
+  // The paper's example (ABCABBA vs CBABAC) has an edit distance of 5.
+  const std::vector<Token> lhs{1, 2, 3, 1, 2, 2, 1};
+  const std::vector<Token> rhs{3, 2, 1, 2, 1, 3};
+  std::size_t edits = 0;
+  std::size_t lhs_pos = 0;
+  std::size_t rhs_pos = 0;
+  for (const EditRun& run : EditScript(lhs, rhs, /*minimal=*/true)) {
+    for (std::size_t i = 0; i < run.count; ++i) {
+      switch (run.edit) {
+        case Myers::Edit::kEqual: EXPECT_THAT(lhs.at(lhs_pos++), rhs.at(rhs_pos++)); break;
+        case Myers::Edit::kLhs: ++lhs_pos; break;
+        case Myers::Edit::kRhs: ++rhs_pos; break;
+      }
+      edits += run.edit == Myers::Edit::kEqual ? 0 : 1;
+    }
+  }
+  EXPECT_THAT(lhs_pos, lhs.size());
+  EXPECT_THAT(rhs_pos, rhs.size());
+  EXPECT_THAT(edits, 5);
+}
+
+// Histogram: anchors on rare lines, falls back to Myers. -------------------------
+
+TEST_F(DiffInternalTest, HistogramEmitsRunsInOrder) {
+  using enum Myers::Edit;
+  EXPECT_THAT(EditScript<Histogram>({}, {}), IsEmpty());
+  EXPECT_THAT(EditScript<Histogram>({1, 2}, {1, 2}), ElementsAre(EditRun{kEqual, 2}));
+  EXPECT_THAT(EditScript<Histogram>({1, 2, 3}, {}), ElementsAre(EditRun{kLhs, 3}));
+  EXPECT_THAT(EditScript<Histogram>({}, {4}), ElementsAre(EditRun{kRhs, 1}));
+  EXPECT_THAT(
+      EditScript<Histogram>({1, 2, 3, 4}, {1, 5, 3, 4}),
+      ElementsAre(EditRun{kEqual, 1}, EditRun{kLhs, 1}, EditRun{kRhs, 1}, EditRun{kEqual, 2}));
+  // Nothing in common: a deletion plus an insertion.
+  EXPECT_THAT(EditScript<Histogram>({1, 2}, {3, 4}), ElementsAre(EditRun{kLhs, 2}, EditRun{kRhs, 2}));
+}
+
+TEST_F(DiffInternalTest, HistogramPrefersUniqueAnchors) {
+  // Myers keeps the three common 9s (cost 2); histogram anchors on the unique
+  // 1 instead (cost 6), which is what makes moved blocks readable.
+  using enum Myers::Edit;
+  const std::vector<Token> lhs{1, 9, 9, 9};
+  const std::vector<Token> rhs{9, 9, 9, 1};
+  EXPECT_THAT(EditScript(lhs, rhs), ElementsAre(EditRun{kLhs, 1}, EditRun{kEqual, 3}, EditRun{kRhs, 1}));
+  EXPECT_THAT(
+      EditScript<Histogram>(lhs, rhs), ElementsAre(EditRun{kRhs, 3}, EditRun{kEqual, 1}, EditRun{kLhs, 3}));
+}
+
+TEST_F(DiffInternalTest, HistogramFallsBackToMyersForFrequentLines) {
+  // Every common line occurs more than `kMaxChainLength` times.
+  using enum Myers::Edit;
+  constexpr std::size_t kCount = Histogram::kMaxChainLength + 6;
+  std::vector<Token> lhs{2};
+  lhs.insert(lhs.end(), kCount, 1);
+  std::vector<Token> rhs(kCount, 1);
+  rhs.push_back(3);
+  EXPECT_THAT(
+      EditScript<Histogram>(lhs, rhs), ElementsAre(EditRun{kLhs, 1}, EditRun{kEqual, kCount}, EditRun{kRhs, 1}));
+}
+
 // UpdateAbslLogFlags: must be callable without crashing; it only adjusts flags.
 
 TEST_F(DiffInternalTest, UpdateAbslLogFlagsIsSafeToCall) {
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/diff/internal/histogram.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "mbo/diff/internal/myers.h"
+
+namespace mbo::diff::diff_internal {
+
+// NOLINTBEGIN(*-avoid-unchecked-container-access): Positions stay inside the
+// span being diffed and tokens index the histogram which is sized to the
+// largest token of both sides, on the hot path of the diff.
+namespace {
+
+// End of a position chain.
+constexpr std::size_t kNone = std::numeric_limits<std::size_t>::max();
+
+// Twice the distance between the centers of a run and the left range.
+std::size_t CenterDistance(std::size_t range_begin, std::size_t range_end, std::size_t run_begin, std::size_t length) {
+  const std::size_t range_center = range_begin + range_end;
+  const std::size_t run_center = (2 * run_begin) + length;
+  return range_center > run_center ? range_center - run_center : run_center - range_center;
+}
+
+Token MaxToken(std::span<const Token> tokens) {
+  return tokens.empty() ? 0 : *std::max_element(tokens.begin(), tokens.end());
+}
+
+}  // namespace
+
+Histogram::Histogram(std::span<const Token> lhs, std::span<const Token> rhs, bool minimal)
+    : lhs_tokens_(lhs), rhs_tokens_(rhs), minimal_(minimal) {
+  const std::size_t num_tokens = std::size_t{std::max(MaxToken(lhs), MaxToken(rhs))} + 1;
+  counts_.assign(num_tokens, 0);
+  heads_.assign(num_tokens, kNone);
+  next_.assign(lhs.size(), kNone);
+}
+
+void Histogram::Run(EditFunc emit) {
+  // Work stack, processed leftmost first: a range gets split at its anchor
+  // into (left half, anchor equals, right half) pushed in reverse.
+  std::vector<Span> stack;
+  stack.push_back({.lhs_end = lhs_tokens_.size(), .rhs_end = rhs_tokens_.size()});
+  while (!stack.empty()) {
+    Span span = stack.back();
+    stack.pop_back();
+    if (span.equals > 0) {
+      emit(Edit::kEqual, span.equals);
+      continue;
+    }
+    std::size_t prefix = 0;
+    while (span.lhs_begin < span.lhs_end && span.rhs_begin < span.rhs_end
+           && lhs_tokens_[span.lhs_begin] == rhs_tokens_[span.rhs_begin]) {
+      ++span.lhs_begin;
+      ++span.rhs_begin;
+      ++prefix;
+    }
+    if (prefix > 0) {
+      emit(Edit::kEqual, prefix);
+    }
+    std::size_t suffix = 0;
+    while (span.lhs_end > span.lhs_begin && span.rhs_end > span.rhs_begin
+           && lhs_tokens_[span.lhs_end - 1] == rhs_tokens_[span.rhs_end - 1]) {
+      --span.lhs_end;
+      --span.rhs_end;
+      ++suffix;
+    }
+    if (suffix > 0) {
+      stack.push_back({.equals = suffix});
+    }
+    const std::size_t lhs_size = span.lhs_end - span.lhs_begin;
+    const std::size_t rhs_size = span.rhs_end - span.rhs_begin;
+    if (lhs_size == 0 || rhs_size == 0) {
+      if (lhs_size > 0) {
+        emit(Edit::kLhs, lhs_size);
+      }
+      if (rhs_size > 0) {
+        emit(Edit::kRhs, rhs_size);
+      }
+      continue;
+    }
+    const Anchor anchor = FindAnchor(span);
+    if (anchor.length == 0) {
+      if (anchor.has_common) {
+        Myers(lhs_tokens_.subspan(span.lhs_begin, lhs_size), rhs_tokens_.subspan(span.rhs_begin, rhs_size), minimal_)
+            .Run(emit);
+      } else {
+        emit(Edit::kLhs, lhs_size);
+        emit(Edit::kRhs, rhs_size);
+      }
+      continue;
+    }
+    stack.push_back(
+        {.lhs_begin = anchor.lhs_begin + anchor.length,
+         .lhs_end = span.lhs_end,
+         .rhs_begin = anchor.rhs_begin + anchor.length,
+         .rhs_end = span.rhs_end,
+         .equals = 0});
+    stack.push_back({.equals = anchor.length});
+    stack.push_back(
+        {.lhs_begin = span.lhs_begin,
+         .lhs_end = anchor.lhs_begin,
+         .rhs_begin = span.rhs_begin,
+         .rhs_end = anchor.rhs_begin,
+         .equals = 0});
+  }
+}
+
+Histogram::Anchor Histogram::FindAnchor(const Span& span) {
+  // Histogram of the left range, built backwards so the chains ascend.
+  for (std::size_t pos = span.lhs_end; pos-- > span.lhs_begin;) {
+    const Token token = lhs_tokens_[pos];
+    next_[pos] = heads_[token];
+    heads_[token] = pos;
+    ++counts_[token];
+  }
+  Anchor best;
+  std::size_t best_count = kMaxChainLength + 1;
+  std::size_t best_distance = kNone;
+  std::size_t rhs_pos = span.rhs_begin;
+  while (rhs_pos < span.rhs_end) {
+    const std::size_t count = counts_[rhs_tokens_[rhs_pos]];
+    std::size_t rhs_next = rhs_pos + 1;
+    best.has_common |= count > 0;
+    if (count == 0 || count > best_count) {
+      rhs_pos = rhs_next;
+      continue;
+    }
+    for (std::size_t lhs_pos = heads_[rhs_tokens_[rhs_pos]]; lhs_pos != kNone; lhs_pos = next_[lhs_pos]) {
+      // Grow the match in both directions, tracking the rarest line in it.
+      std::size_t lhs_begin = lhs_pos;
+      std::size_t rhs_begin = rhs_pos;
+      std::size_t lhs_end = lhs_pos + 1;
+      std::size_t rhs_end = rhs_pos + 1;
+      std::size_t run_count = count;
+      while (lhs_begin > span.lhs_begin && rhs_begin > span.rhs_begin
+             && lhs_tokens_[lhs_begin - 1] == rhs_tokens_[rhs_begin - 1]) {
+        --lhs_begin;
+        --rhs_begin;
+        run_count = std::min(run_count, counts_[lhs_tokens_[lhs_begin]]);
+      }
+      while (lhs_end < span.lhs_end && rhs_end < span.rhs_end && lhs_tokens_[lhs_end] == rhs_tokens_[rhs_end]) {
+        run_count = std::min(run_count, counts_[lhs_tokens_[lhs_end]]);
+        ++lhs_end;
+        ++rhs_end;
+      }
+      // Lines inside this run cannot start a better one.
+      rhs_next = std::max(rhs_next, rhs_end);
+      const std::size_t length = lhs_end - lhs_begin;
+      const std::size_t distance = CenterDistance(span.lhs_begin, span.lhs_end, lhs_begin, length);
+      if (best.length < length || run_count < best_count
+          || (best.length == length && best_count == run_count && distance < best_distance)) {
+        best.lhs_begin = lhs_begin;
+        best.rhs_begin = rhs_begin;
+        best.length = length;
+        best_count = run_count;
+        best_distance = distance;
+      }
+    }
+    rhs_pos = rhs_next;
+  }
+  for (std::size_t pos = span.lhs_begin; pos < span.lhs_end; ++pos) {
+    counts_[lhs_tokens_[pos]] = 0;
+    heads_[lhs_tokens_[pos]] = kNone;
+  }
+  return best;
+}
+
+// NOLINTEND(*-avoid-unchecked-container-access)
+
+}  // namespace mbo::diff::diff_internal
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_DIFF_INTERNAL_HISTOGRAM_H_
+#define MBO_DIFF_INTERNAL_HISTOGRAM_H_
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "mbo/diff/internal/myers.h"
+
+namespace mbo::diff::diff_internal {
+
+// The token level histogram kernel (git's default `--histogram`, derived from
+// JGit's HistogramDiff, an extension of Bram Cohen's patience diff).
+//
+// A range is split at the longest common run anchored on the left line that
+// occurs least often (at most `kMaxChainLength` times) in the left range, and
+// both sides of the anchor are diffed recursively. Lines that are unique in
+// the left range make the best anchors, so moved or reordered blocks read
+// better than in a minimal script. Ranges without any common line become a
+// deletion plus an insertion; ranges whose common lines are all too frequent
+// to anchor fall back to `Myers`.
+//
+// Each level is linear in the range size. Unlike git, ties between equally rare
+// and long runs go to the one closest to the middle of the range: with many
+// unique lines (scattered edits) every run is a candidate, and always taking
+// the first one would split off tiny ranges and make the recursion quadratic.
+class Histogram final {
+ public:
+  using Edit = Myers::Edit;
+  using EditFunc = Myers::EditFunc;
+
+  // Lines occurring more often than this in a range are never anchors.
+  static constexpr std::size_t kMaxChainLength = 64;
+
+  Histogram() = delete;
+  ~Histogram() = default;
+
+  // Both token sequences must outlive the instance. The `minimal` flag gets
+  // passed to the `Myers` fallback.
+  Histogram(std::span<const Token> lhs, std::span<const Token> rhs, bool minimal);
+
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+  Histogram(Histogram&&) = delete;
+  Histogram& operator=(Histogram&&) = delete;
+
+  // Computes the edit script and passes it to `emit`.
+  void Run(EditFunc emit);
+
+ private:
+  // Same as `Myers::Span`: a not yet diffed range (`*_end` exclusive) or, if
+  // `equals != 0`, a run of common lines to emit.
+  struct Span {
+    std::size_t lhs_begin = 0;
+    std::size_t lhs_end = 0;
+    std::size_t rhs_begin = 0;
+    std::size_t rhs_end = 0;
+    std::size_t equals = 0;
+  };
+
+  // The best common run found in a span. Empty (`length == 0`) if there is
+  // none, in which case `has_common` tells whether the span has common lines
+  // that were too frequent to anchor on.
+  struct Anchor {
+    std::size_t lhs_begin = 0;
+    std::size_t rhs_begin = 0;
+    std::size_t length = 0;
+    bool has_common = false;
+  };
+
+  Anchor FindAnchor(const Span& span);
+
+  const std::span<const Token> lhs_tokens_;
+  const std::span<const Token> rhs_tokens_;
+  const bool minimal_;
+  // Per token histogram of the current left range: the number of occurrences
+  // and the first position (or `kNone`). `next_` chains the positions of equal
+  // tokens in ascending order.
+  std::vector<std::size_t> counts_;
+  std::vector<std::size_t> heads_;
+  std::vector<std::size_t> next_;
+};
+
+}  // namespace mbo::diff::diff_internal
+
+#endif  // MBO_DIFF_INTERNAL_HISTOGRAM_H_
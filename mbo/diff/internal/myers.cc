@@ -0,0 +1,297 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/diff/internal/myers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "mbo/diff/internal/data.h"
+
+// This file uses the notation from Myers' paper throughout: `n`/`m` are the two
+// sequence lengths, `d` the edit cost, `k` the diagonal, `x`/`y` the grid
+// coordinates, `kf`/`kr` the forward and reverse diagonals, and `lo`/`hi` the
+// window bounds. Expanding those to three-character names would break the
+// correspondence to the paper that makes this code checkable, so the length
+// rule is waived here rather than per line.
+// NOLINTBEGIN(readability-identifier-length)
+
+namespace mbo::diff::diff_internal {
+
+void Tokenizer::Tokenize(const Data& data, std::vector<Token>& tokens) {
+  // Under `ignore_case` each line is folded once into a reused buffer (fast
+  // word-wise hashing and exact equality beat fold-aware per-byte functors,
+  // measured in `diff_benchmark`); only distinct folded lines get stable arena
+  // storage.
+  constexpr Token kIgnoreToken = 0;
+  tokens.reserve(tokens.size() + data.Size());
+  for (std::size_t pos = 0; pos < data.Size(); ++pos) {
+    const Data::LineCache& cache = data.GetCache(pos);
+    if (cache.matches_ignore) {
+      tokens.push_back(kIgnoreToken);
+      continue;
+    }
+    std::string_view key = cache.processed;
+    if (fold_) {
+      fold_buffer_.assign(key);
+      absl::AsciiStrToLower(&fold_buffer_);
+      key = fold_buffer_;
+    }
+    auto it = ids_.find(key);
+    if (it == ids_.end()) {
+      if (fold_) {
+        key = fold_arena_.emplace_back(fold_buffer_);
+      }
+      it = ids_.emplace(key, static_cast<Token>(ids_.size() + 1)).first;
+    }
+    tokens.push_back(it->second);
+  }
+}
+
+// NOLINTBEGIN(*-avoid-unchecked-container-access): This IS the Myers kernel:
+// every subscript is a diagonal index the algorithm keeps in range by
+// construction (kOutside sentinels pad both ends), on the hot path of the diff.
+namespace {
+
+// Sentinel written just outside the current diagonal window: smaller than any
+// reachable x, so the boundary comparisons pick the interior neighbor.
+constexpr std::ptrdiff_t kOutside = -1;
+
+std::size_t ISqrt(std::size_t value) {
+  return static_cast<std::size_t>(std::sqrt(static_cast<double>(value)));
+}
+
+// Clamps the diagonal window [-d, d] to the edit grid [lo, hi], keeping the
+// parity of d (valid diagonals at cost d satisfy k == d (mod 2)).
+void ClampWindow(std::ptrdiff_t d, std::ptrdiff_t lo, std::ptrdiff_t hi, std::ptrdiff_t& kmin, std::ptrdiff_t& kmax) {
+  kmin = -d < lo ? lo + ((d + lo) & 1 ? 1 : 0) : -d;
+  kmax = d > hi ? hi - ((d + hi) & 1 ? 1 : 0) : d;
+}
+
+}  // namespace
+
+Myers::Myers(std::span<const Token> lhs, std::span<const Token> rhs, bool minimal)
+    : lhs_tokens_(lhs), rhs_tokens_(rhs) {
+  max_cost_ =
+      minimal ? std::numeric_limits<std::size_t>::max() : std::max<std::size_t>(64, ISqrt(lhs.size() + rhs.size()));
+  const std::size_t v_size = (2 * (std::max(lhs.size(), rhs.size()) + 2)) + 1;
+  fwd_.assign(v_size, kOutside);
+  bwd_.assign(v_size, kOutside);
+}
+
+void Myers::Run(EditFunc emit) {
+  // Work stack, processed leftmost first: a range gets split at its middle
+  // snake into (left half, snake equals, right half) pushed in reverse.
+  std::vector<Span> stack;
+  stack.push_back({.lhs_end = lhs_tokens_.size(), .rhs_end = rhs_tokens_.size()});
+  while (!stack.empty()) {
+    Span span = stack.back();
+    stack.pop_back();
+    if (span.equals > 0) {
+      emit(Edit::kEqual, span.equals);
+      continue;
+    }
+    // Emit the common prefix right away.
+    std::size_t prefix = 0;
+    while (span.lhs_begin < span.lhs_end && span.rhs_begin < span.rhs_end
+           && lhs_tokens_[span.lhs_begin] == rhs_tokens_[span.rhs_begin]) {
+      ++span.lhs_begin;
+      ++span.rhs_begin;
+      ++prefix;
+    }
+    if (prefix > 0) {
+      emit(Edit::kEqual, prefix);
+    }
+    // The common suffix is emitted (LIFO) after everything in between.
+    std::size_t suffix = 0;
+    while (span.lhs_end > span.lhs_begin && span.rhs_end > span.rhs_begin
+           && lhs_tokens_[span.lhs_end - 1] == rhs_tokens_[span.rhs_end - 1]) {
+      --span.lhs_end;
+      --span.rhs_end;
+      ++suffix;
+    }
+    if (suffix > 0) {
+      stack.push_back({.equals = suffix});
+    }
+    if (span.lhs_begin == span.lhs_end) {
+      if (span.rhs_begin < span.rhs_end) {
+        emit(Edit::kRhs, span.rhs_end - span.rhs_begin);
+      }
+      continue;
+    }
+    if (span.rhs_begin == span.rhs_end) {
+      emit(Edit::kLhs, span.lhs_end - span.lhs_begin);
+      continue;
+    }
+    const Snake snake = FindMiddleSnake(span);
+    stack.push_back(
+        {.lhs_begin = snake.lhs_begin + snake.length,
+         .lhs_end = span.lhs_end,
+         .rhs_begin = snake.rhs_begin + snake.length,
+         .rhs_end = span.rhs_end,
+         .equals = 0});
+    if (snake.length > 0) {
+      stack.push_back({.equals = snake.length});
+    }
+    stack.push_back(
+        {.lhs_begin = span.lhs_begin,
+         .lhs_end = snake.lhs_begin,
+         .rhs_begin = span.rhs_begin,
+         .rhs_end = snake.rhs_begin,
+         .equals = 0});
+  }
+}
+
+// The forward/reverse D-path search is one algorithm from Myers' paper, and the bookkeeping (the two
+// diagonal windows, the parity rule and the overlap test) only makes sense read together. Splitting
+// it into helpers would hide the correspondence to the paper without making any part simpler.
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+Myers::Snake Myers::FindMiddleSnake(const Span& span) {
+  // The span was trimmed: both sides are non-empty and neither the first nor
+  // the last lines match, so the minimal cost is >= 2 and the first overlap
+  // of the forward and backward searches yields a valid middle snake.
+  const auto n = static_cast<std::ptrdiff_t>(span.lhs_end - span.lhs_begin);
+  const auto m = static_cast<std::ptrdiff_t>(span.rhs_end - span.rhs_begin);
+  const std::ptrdiff_t delta = n - m;
+  const bool odd = (delta & 1) != 0;
+  const Token* lhs = lhs_tokens_.data() + span.lhs_begin;
+  const Token* rhs = rhs_tokens_.data() + span.rhs_begin;
+  const auto center = static_cast<std::ptrdiff_t>(fwd_.size() / 2);
+  // Cost 0: neither search extends (the corner lines differ).
+  fwd_[center] = 0;
+  bwd_[center] = 0;
+  std::ptrdiff_t bwd_kmin = 0;  // Window written by the last backward pass.
+  std::ptrdiff_t bwd_kmax = 0;
+  // Furthest reaching points seen, for the cost cap fallback split.
+  std::ptrdiff_t best_fwd_x = 0;
+  std::ptrdiff_t best_fwd_y = 0;
+  std::ptrdiff_t best_bwd_x = 0;
+  std::ptrdiff_t best_bwd_y = 0;
+  const std::ptrdiff_t d_max = ((n + m + 1) / 2) + 1;
+  for (std::ptrdiff_t d = 1; d <= d_max; ++d) {
+    std::ptrdiff_t kmin = 0;
+    std::ptrdiff_t kmax = 0;
+    // Forward pass.
+    ClampWindow(d, -m, n, kmin, kmax);
+    fwd_[center + kmin - 1] = kOutside;
+    fwd_[center + kmax + 1] = kOutside;
+    for (std::ptrdiff_t k = kmin; k <= kmax; k += 2) {
+      std::ptrdiff_t x = k == -d || (k != d && fwd_[center + k - 1] < fwd_[center + k + 1]) ? fwd_[center + k + 1]
+                                                                                            : fwd_[center + k - 1] + 1;
+      // A path hitting a grid edge continues on other diagonals: the furthest
+      // reach on this diagonal is the edge point itself.
+      x = std::min({x, m + k, n});
+      std::ptrdiff_t y = x - k;
+      const std::ptrdiff_t x_begin = x;
+      while (x < n && y < m && lhs[x] == rhs[y]) {
+        ++x;
+        ++y;
+      }
+      fwd_[center + k] = x;
+      if (x + y > best_fwd_x + best_fwd_y) {
+        best_fwd_x = x;
+        best_fwd_y = y;
+      }
+      if (odd) {
+        // Overlap with the backward (d-1)-path on the same real diagonal?
+        const std::ptrdiff_t kr = delta - k;
+        if (kr >= bwd_kmin && kr <= bwd_kmax && x + bwd_[center + kr] >= n) {
+          return {
+              .lhs_begin = span.lhs_begin + static_cast<std::size_t>(x_begin),
+              .rhs_begin = span.rhs_begin + static_cast<std::size_t>(x_begin - k),
+              .length = static_cast<std::size_t>(x - x_begin),
+          };
+        }
+      }
+    }
+    const std::ptrdiff_t fwd_kmin = kmin;
+    const std::ptrdiff_t fwd_kmax = kmax;
+    // Backward pass: a forward search over both sequences reversed.
+    ClampWindow(d, -m, n, kmin, kmax);
+    bwd_[center + kmin - 1] = kOutside;
+    bwd_[center + kmax + 1] = kOutside;
+    for (std::ptrdiff_t k = kmin; k <= kmax; k += 2) {
+      std::ptrdiff_t x = k == -d || (k != d && bwd_[center + k - 1] < bwd_[center + k + 1]) ? bwd_[center + k + 1]
+                                                                                            : bwd_[center + k - 1] + 1;
+      x = std::min({x, m + k, n});
+      std::ptrdiff_t y = x - k;
+      const std::ptrdiff_t x_begin = x;
+      while (x < n && y < m && lhs[n - 1 - x] == rhs[m - 1 - y]) {
+        ++x;
+        ++y;
+      }
+      bwd_[center + k] = x;
+      if (x + y > best_bwd_x + best_bwd_y) {
+        best_bwd_x = x;
+        best_bwd_y = y;
+      }
+      if (!odd) {
+        // Overlap with the forward d-path on the same real diagonal?
+        const std::ptrdiff_t kf = delta - k;
+        if (kf >= fwd_kmin && kf <= fwd_kmax && fwd_[center + kf] + x >= n) {
+          return {
+              .lhs_begin = span.lhs_begin + static_cast<std::size_t>(n - x),
+              .rhs_begin = span.rhs_begin + static_cast<std::size_t>(m - y),
+              .length = static_cast<std::size_t>(x - x_begin),
+          };
+        }
+      }
+    }
+    bwd_kmin = kmin;
+    bwd_kmax = kmax;
+    if (std::cmp_less(d, max_cost_)) {
+      continue;
+    }
+    // Too expensive (like git): split at the furthest reaching point. Both
+    // searches took at least one step, so the split is strictly inside the
+    // span and both halves shrink; the result stays a valid edit script, it
+    // just may no longer be minimal.
+    std::ptrdiff_t split_x = best_fwd_x;
+    std::ptrdiff_t split_y = best_fwd_y;
+    if (best_bwd_x + best_bwd_y > best_fwd_x + best_fwd_y) {
+      split_x = n - best_bwd_x;
+      split_y = m - best_bwd_y;
+    }
+    while (split_x + split_y >= n + m) {  // Keep the split off the far corner.
+      split_x > 0 ? --split_x : --split_y;
+    }
+    return {
+        .lhs_begin = span.lhs_begin + static_cast<std::size_t>(split_x),
+        .rhs_begin = span.rhs_begin + static_cast<std::size_t>(split_y),
+        .length = 0,
+    };
+  }
+  // Unreachable: the searches must overlap within d_max. Split in a valid
+  // spot anyway rather than misbehaving.
+  return {
+      .lhs_begin = span.lhs_begin + static_cast<std::size_t>(best_fwd_x),
+      .rhs_begin = span.rhs_begin + static_cast<std::size_t>(best_fwd_y),
+      .length = 0,
+  };
+}
+
+// NOLINTEND(*-avoid-unchecked-container-access)
+
+}  // namespace mbo::diff::diff_internal
+
+// NOLINTEND(readability-identifier-length)
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_DIFF_INTERNAL_MYERS_H_
+#define MBO_DIFF_INTERNAL_MYERS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "mbo/diff/internal/data.h"
+#include "mbo/hash/hash.h"
+
+namespace mbo::diff::diff_internal {
+
+// Lines are compared as integer tokens: equal tokens means equal lines.
+using Token = std::uint32_t;
+
+// Interns lines into tokens following `BaseDiff::CompareEq`: lines matching
+// `ignore_matching_lines` are all mutually equal (they share one token), all
+// other lines compare by their preprocessed text, case folded for `ignore_case`.
+//
+// Keys are `std::string_view`s into the preprocessed line caches, so every
+// tokenized `Data` must outlive the `Tokenizer`. Use one instance for both
+// sides of a diff, otherwise their tokens are unrelated.
+class Tokenizer final {
+ public:
+  explicit Tokenizer(bool ignore_case) : fold_(ignore_case) {}
+
+  // Appends the tokens of all lines in `data` to `tokens`.
+  void Tokenize(const Data& data, std::vector<Token>& tokens);
+
+ private:
+  struct KeyHash {
+    std::size_t operator()(std::string_view text) const noexcept { return mbo::hash::GetHash64(text); }
+  };
+
+  const bool fold_;
+  absl::flat_hash_map<std::string_view, Token, KeyHash> ids_;
+  std::string fold_buffer_;
+  std::deque<std::string> fold_arena_;
+};
+
+// The token level Myers kernel ("An O(ND) Difference Algorithm and Its
+// Variations", Myers 1986) using the linear space middle-snake divide and
+// conquer variant. See `DiffMyers` for the complexity and the cost cap.
+class Myers final {
+ public:
+  enum class Edit {
+    kEqual = 0,  // Lines common to both sides.
+    kLhs = 1,    // Lines only on the left side (deletions).
+    kRhs = 2,    // Lines only on the right side (insertions).
+  };
+
+  // Receives the edit script in order as runs of `count` (> 0) lines.
+  using EditFunc = absl::FunctionRef<void(Edit edit, std::size_t count)>;
+
+  Myers() = delete;
+  ~Myers() = default;
+
+  // Both token sequences must outlive the instance.
+  Myers(std::span<const Token> lhs, std::span<const Token> rhs, bool minimal);
+
+  Myers(const Myers&) = delete;
+  Myers& operator=(const Myers&) = delete;
+  Myers(Myers&&) = delete;
+  Myers& operator=(Myers&&) = delete;
+
+  // Computes the edit script and passes it to `emit`.
+  void Run(EditFunc emit);
+
+ private:
+  // A pending piece of work: either a not yet diffed range of lines
+  // (`*_end` exclusive) or, if `equals != 0`, a run of common lines to emit.
+  struct Span {
+    std::size_t lhs_begin = 0;
+    std::size_t lhs_end = 0;
+    std::size_t rhs_begin = 0;
+    std::size_t rhs_end = 0;
+    std::size_t equals = 0;
+  };
+
+  // A (possibly empty) run of common lines that splits a span into two
+  // independently diffable halves.
+  struct Snake {
+    std::size_t lhs_begin = 0;
+    std::size_t rhs_begin = 0;
+    std::size_t length = 0;
+  };
+
+  Snake FindMiddleSnake(const Span& span);
+
+  const std::span<const Token> lhs_tokens_;
+  const std::span<const Token> rhs_tokens_;
+  std::vector<std::ptrdiff_t> fwd_;  // Forward furthest-reaching x per diagonal.
+  std::vector<std::ptrdiff_t> bwd_;  // Backward equivalent, in reversed coordinates.
+  std::size_t max_cost_ = 0;
+};
+
+}  // namespace mbo::diff::diff_internal
+
+#endif  // MBO_DIFF_INTERNAL_MYERS_H_
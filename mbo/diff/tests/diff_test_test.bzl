@@ -166,7 +166,7 @@ def diff_test_formats_test(
         file_old:       The old file.
         file_new:       The new file.
         expected_diffs: Dict of output format ('unified', 'context', 'normal') to expected diff result.
-        algorithms:     List of algorithms ('naive', 'myers', 'direct') to run each format with.
+        algorithms:     List of algorithms ('naive', 'myers', 'direct', 'streaming', 'histogram') to run each format with.
         **kwargs:       Keyword args to pass down to `diff_test_test`.
     """
     for algorithm in algorithms:
@@ -19,13 +19,16 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "mbo/digest/digest_blake2b.h"   // IWYU pragma: export
 #include "mbo/digest/digest_blake3.h"    // IWYU pragma: export
 #include "mbo/digest/digest_concepts.h"  // IWYU pragma: export
 #include "mbo/digest/digest_hmac.h"      // IWYU pragma: export
+#include "mbo/digest/digest_many.h"
 #include "mbo/digest/digest_md5.h"       // IWYU pragma: export
 #include "mbo/digest/digest_sha1.h"      // IWYU pragma: export
 #include "mbo/digest/digest_sha256.h"    // IWYU pragma: export
@@ -77,6 +80,34 @@ class Streamer {
   Algo::StreamState state_;
 };
 
+// Digests of many independent messages: `result[i] == Algo::Digest(messages[i])`.
+//
+//   const std::vector<std::array<uint8_t, 32>> digests = DigestMany<sha256::Algorithm>(messages);
+//
+// SHA-256, SHA-224 and BLAKE2b (both sizes) hash several messages in lockstep,
+// one per SIMD lane (SHA-256: 16 lanes with AVX-512, 8 with AVX2; BLAKE2b: 8
+// and 4), which pays off for batches of messages where a single stream cannot
+// fill the vector units. SHA-256 lanes only run where they beat the SHA
+// instructions (with AVX-512, from 16 messages on). Any other algorithm, and
+// `digest_internal::Kernel::kPortable`, digests one message after the other.
+template<typename Algo>
+requires IsDigestAlgorithm<Algo>
+std::vector<typename Algo::DigestType> DigestMany(std::span<const std::string_view> messages) {
+  std::vector<typename Algo::DigestType> digests(messages.size());
+  if constexpr (digest_internal::HasStreamState<Algo, sha2_internal::State>) {
+    digest_internal::Sha256Many(
+        messages, Algo::StreamInit().hash, Algo::kDigestSize, std::as_writable_bytes(std::span(digests)));
+  } else if constexpr (digest_internal::HasStreamState<Algo, blake2b_internal::State>) {
+    digest_internal::Blake2bMany(
+        messages, Algo::StreamInit().hash, Algo::kDigestSize, std::as_writable_bytes(std::span(digests)));
+  } else {
+    for (std::size_t index = 0; index < messages.size(); ++index) {
+      digests[index] = Algo::Digest(messages[index]);
+    }
+  }
+  return digests;
+}
+
 // Lowercase hex rendering, the conventional presentation of a digest (matches
 // e.g. `sha256sum` and python's `hexdigest()`).
 template<std::size_t N>
@@ -0,0 +1,332 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Length-bucketed benchmark for the mbo::digest algorithms: one-shot `Digest`
+// at exact lengths from 0 B to 64 MiB, one-shot throughput over the Short/Web
+// length distributions, `Streamer` over a range of chunk sizes, `DigestMany`
+// over batches of equal-length messages, and `Hmac`.
+// Run with: bazel run -c opt //mbo/digest:digest_benchmark
+//
+// The length sets (FAST by default, FULL with MBO_HASH_BENCHMARK_FULL=1), the
+// distributions and the dataset context are mbo/hash's (see
+// hash_benchmark_lengths.h), so the results go through the same report
+// pipeline: `mbo/hash/measurements/hash_benchmark_report.py run --benchmark
+// digest`.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "benchmark/benchmark.h"
+#include "mbo/digest/digest.h"
+#include "mbo/digest/digest_blake3_parallel.h"
+#include "mbo/digest/digest_kernel.h"
+#include "mbo/hash/hash_benchmark_lengths.h"
+#include "mbo/hash/hash_test_util.h"
+#include "mbo/thread/executor.h"
+
+namespace mbo::digest {
+namespace {
+
+// NOLINTBEGIN(*-array-index,*-magic-numbers)
+
+using ::mbo::hash::bench::kCdfPoints;
+using ::mbo::hash::bench::kLatencyDists;
+using ::mbo::hash::bench::kLatencyKeys;
+using ::mbo::hash::bench::ThroughputKeys;
+using ::mbo::hash::bench::ThroughputSizes;
+using Kernel = digest_internal::Kernel;
+
+// Exact lengths beyond the hash sets (which end at one page): the bulk regime
+// from L1-resident through LLC-sized to DRAM-streaming inputs.
+constexpr auto kBulkSizes = std::to_array<int>({
+    16 << 10,
+    64 << 10,
+    256 << 10,
+    1 << 20,
+    4 << 20,
+    16 << 20,
+    64 << 20,
+});
+
+// `Streamer` feeds one message of this length in chunks of each size below;
+// the small chunks measure the buffering overhead, the large ones converge on
+// one-shot throughput.
+constexpr int kStreamLength = 1 << 20;
+constexpr auto kChunkSizes = std::to_array<int>({1, 16, 64, 256, 1 << 10, 4 << 10, 64 << 10, 1 << 20});
+
+// `DigestMany` hashes batches of this many distinct messages of each length.
+constexpr std::size_t kManyBatch = 64;
+constexpr auto kManyLengths = std::to_array<int>({64, 256, 1 << 10, 4 << 10, 16 << 10});
+
+constexpr std::string_view kHmacKey = "0123456789abcdef0123456789abcdef";
+
+// One random message of the largest length, built once; every exact-length
+// case hashes a prefix of it.
+std::string_view Message(std::size_t length) {
+  static const std::string kMessage = [] {
+    // NOLINTNEXTLINE(cert-msc51-cpp,cert-msc32-c,bugprone-random-generator-seed): fixed data
+    std::mt19937_64 rng(0x1234);
+    return hash::algo::RandomString(rng, static_cast<std::size_t>(kBulkSizes.back()));
+  }();
+  return std::string_view(kMessage).substr(0, length);
+}
+
+std::vector<int> DigestSizes() {
+  std::vector<int> sizes = {0};
+  const std::span<const int> sizes_hash = ThroughputSizes();
+  sizes.insert(sizes.end(), sizes_hash.begin(), sizes_hash.end());
+  sizes.insert(sizes.end(), kBulkSizes.begin(), kBulkSizes.end());
+  return sizes;
+}
+
+// Selects the compression kernel for one benchmark run (see digest_kernel.h).
+class KernelScope final {
+ public:
+  explicit KernelScope(Kernel kernel) : previous_(digest_internal::GetKernel()) { digest_internal::SetKernel(kernel); }
+
+  ~KernelScope() { digest_internal::SetKernel(previous_); }
+
+  KernelScope(const KernelScope&) = delete;
+  KernelScope& operator=(const KernelScope&) = delete;
+  KernelScope(KernelScope&&) = delete;
+  KernelScope& operator=(KernelScope&&) = delete;
+
+ private:
+  const Kernel previous_;
+};
+
+template<typename Algo>
+struct OneShot {
+  auto operator()(std::string_view data) const noexcept { return Algo::Digest(data); }
+};
+
+// The lane kernel the `digest` binary uses for BLAKE3, on the calling thread
+// only (one core, comparable to the other algorithms).
+struct Blake3Lanes {
+  auto operator()(std::string_view data) const {
+    static thread::InlineExecutor executor;
+    return blake3::DigestParallel(data, executor);
+  }
+};
+
+template<typename Digester>
+void BmDigest(benchmark::State& state, Kernel kernel) {
+  const KernelScope scope(kernel);
+  const auto length = static_cast<std::size_t>(state.range(0));
+  const std::string_view data = Message(length);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Digester{}(data));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(length));
+}
+
+template<typename Digester>
+void BmDigestThroughput(benchmark::State& state, std::size_t dist_index, std::size_t bound_index) {
+  const std::vector<std::string>& keys = ThroughputKeys(dist_index, bound_index);
+  int64_t total_bytes = 0;
+  for (const std::string& key : keys) {
+    total_bytes += static_cast<int64_t>(key.size());
+  }
+  std::size_t counter = 0;
+  for (auto _ : state) {
+    // NOLINTNEXTLINE(*-avoid-unchecked-container-access): timed loop; the power-of-two mask keeps it in range.
+    benchmark::DoNotOptimize(Digester{}(keys[counter++ & (kLatencyKeys - 1)]));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * (total_bytes / static_cast<int64_t>(kLatencyKeys)));
+}
+
+template<typename Algo>
+void BmDigestStreamer(benchmark::State& state, std::size_t chunk) {
+  const std::string_view data = Message(kStreamLength);
+  for (auto _ : state) {
+    Streamer<Algo> stream;
+    for (std::size_t pos = 0; pos < data.size(); pos += chunk) {
+      stream.Update(data.substr(pos, chunk));
+    }
+    benchmark::DoNotOptimize(stream.Finalize());
+  }
+  state.SetBytesProcessed(state.iterations() * int64_t{kStreamLength});
+}
+
+template<typename Algo>
+struct Many {
+  auto operator()(std::span<const std::string_view> messages) const { return DigestMany<Algo>(messages); }
+};
+
+// The one-message-at-a-time baseline for `Many`.
+template<typename Algo>
+struct Loop {
+  auto operator()(std::span<const std::string_view> messages) const {
+    std::vector<typename Algo::DigestType> digests(messages.size());
+    for (std::size_t index = 0; index < messages.size(); ++index) {
+      digests[index] = Algo::Digest(messages[index]);
+    }
+    return digests;
+  }
+};
+
+template<typename Batcher>
+void BmDigestMany(benchmark::State& state, std::size_t length) {
+  std::vector<std::string_view> messages;
+  const std::string_view data = Message(kManyBatch * length);
+  for (std::size_t index = 0; index < kManyBatch; ++index) {
+    messages.push_back(data.substr(index * length, length));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Batcher{}(messages));
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kManyBatch));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(kManyBatch * length));
+}
+
+template<typename Algo>
+void BmHmac(benchmark::State& state) {
+  const auto length = static_cast<std::size_t>(state.range(0));
+  const std::string_view data = Message(length);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Hmac<Algo>::Digest(kHmacKey, data));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(length));
+}
+
+std::vector<std::string>& AlgoNames() {
+  static std::vector<std::string> names;
+  return names;
+}
+
+// Exact-length and distribution throughput for one one-shot digester, named
+// "BmDigest<name>/<length>" and "BmDigestThroughput<name>/<Short|Web>:<bound>".
+template<typename Digester>
+void RegisterOneShot(const std::string& name, Kernel kernel = Kernel::kAuto) {
+  AlgoNames().push_back(name);
+  auto* const exact = benchmark::RegisterBenchmark(
+      absl::StrCat("BmDigest<", name, ">"), [kernel](benchmark::State& state) { BmDigest<Digester>(state, kernel); });
+  for (const int size : DigestSizes()) {
+    exact->Arg(size);
+  }
+  if (kernel != Kernel::kAuto) {
+    return;  // Kernel comparisons only need the exact-length curve.
+  }
+  for (std::size_t dist = 0; dist < kLatencyDists.size(); ++dist) {
+    for (std::size_t bound = 0; bound < kCdfPoints; ++bound) {
+      benchmark::RegisterBenchmark(
+          absl::StrCat(
+              "BmDigestThroughput<", name, ">/", kLatencyDists.at(dist).name, ":",
+              kLatencyDists.at(dist).cdf.at(bound).second),
+          [dist, bound](benchmark::State& state) { BmDigestThroughput<Digester>(state, dist, bound); });
+    }
+  }
+}
+
+// `RegisterOneShot` plus "BmDigestStreamer<name>/Chunk:<size>" over a 1 MiB
+// message.
+template<typename Algo>
+void RegisterAlgo(const std::string& name) {
+  RegisterOneShot<OneShot<Algo>>(name);
+  for (const int chunk : kChunkSizes) {
+    benchmark::RegisterBenchmark(
+        absl::StrCat("BmDigestStreamer<", name, ">/Chunk:", chunk),
+        [chunk](benchmark::State& state) { BmDigestStreamer<Algo>(state, static_cast<std::size_t>(chunk)); });
+  }
+}
+
+// "BmDigestMany<name>/Length:<length>" for `DigestMany` and, as the baseline,
+// "BmDigestMany<name-loop>/Length:<length>" for one `Digest` per message.
+template<typename Algo>
+void RegisterMany(const std::string& name) {
+  for (const int length : kManyLengths) {
+    benchmark::RegisterBenchmark(
+        absl::StrCat("BmDigestMany<", name, ">/Length:", length),
+        [length](benchmark::State& state) { BmDigestMany<Many<Algo>>(state, static_cast<std::size_t>(length)); });
+    benchmark::RegisterBenchmark(
+        absl::StrCat("BmDigestMany<", name, "-loop>/Length:", length),
+        [length](benchmark::State& state) { BmDigestMany<Loop<Algo>>(state, static_cast<std::size_t>(length)); });
+  }
+}
+
+// "BmHmac<name>/<length>" with a 32-byte key.
+template<typename Algo>
+void RegisterHmac(const std::string& name) {
+  auto* const hmac = benchmark::RegisterBenchmark(absl::StrCat("BmHmac<", name, ">"), BmHmac<Algo>);
+  for (const int size : DigestSizes()) {
+    hmac->Arg(size);
+  }
+}
+
+constexpr std::size_t kShakeOutputSize = 32;
+
+void RegisterAll() {
+  RegisterAlgo<md5::Algorithm>("md5");
+  RegisterAlgo<sha1::Algorithm>("sha1");
+  RegisterAlgo<sha224::Algorithm>("sha224");
+  RegisterAlgo<sha256::Algorithm>("sha256");
+  RegisterAlgo<sha384::Algorithm>("sha384");
+  RegisterAlgo<sha512::Algorithm>("sha512");
+  RegisterAlgo<sha512_256::Algorithm>("sha512-256");
+  RegisterAlgo<sha3_256::Algorithm>("sha3-256");
+  RegisterAlgo<sha3_512::Algorithm>("sha3-512");
+  RegisterAlgo<shake128::Algorithm<kShakeOutputSize>>("shake128");
+  RegisterAlgo<shake256::Algorithm<kShakeOutputSize>>("shake256");
+  RegisterAlgo<blake2b::Algorithm>("blake2b");
+  RegisterAlgo<blake2b_256::Algorithm>("blake2b-256");
+  RegisterAlgo<blake3::Algorithm>("blake3");
+  RegisterOneShot<Blake3Lanes>("blake3-lanes");
+  // The portable compression for the algorithms with SHA-instruction kernels.
+  RegisterOneShot<OneShot<sha1::Algorithm>>("sha1-portable", Kernel::kPortable);
+  RegisterOneShot<OneShot<sha256::Algorithm>>("sha256-portable", Kernel::kPortable);
+
+  RegisterMany<sha256::Algorithm>("sha256");
+  RegisterMany<blake2b::Algorithm>("blake2b");
+  RegisterMany<blake2b_256::Algorithm>("blake2b-256");
+
+  RegisterHmac<md5::Algorithm>("md5");
+  RegisterHmac<sha1::Algorithm>("sha1");
+  RegisterHmac<sha256::Algorithm>("sha256");
+  RegisterHmac<sha512::Algorithm>("sha512");
+  RegisterHmac<sha3_256::Algorithm>("sha3-256");
+  RegisterHmac<blake2b::Algorithm>("blake2b");
+}
+
+// NOLINTEND(*-array-index,*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::digest
+
+int main(int argc, char** argv) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);  // NO ASLR
+  mbo::hash::bench::PinToFirstCore();
+  mbo::digest::RegisterAll();
+  benchmark::Initialize(&argc, argv);
+  benchmark::AddCustomContext("algos", absl::StrJoin(mbo::digest::AlgoNames(), ", "));
+  mbo::hash::bench::AddLengthContext();
+  // The digest tables span the whole range: 0 B, the curated hash sizes and the
+  // bulk lengths (the report tool prefers `table_sizes` over `readme_sizes`).
+  std::vector<int> table_sizes = {0};
+  table_sizes.insert(table_sizes.end(), mbo::hash::bench::kReadmeSizes.begin(), mbo::hash::bench::kReadmeSizes.end());
+  table_sizes.insert(table_sizes.end(), mbo::digest::kBulkSizes.begin(), mbo::digest::kBulkSizes.end());
+  benchmark::AddCustomContext("table_sizes", absl::StrJoin(table_sizes, ","));
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -32,7 +32,10 @@
 // Merkle-tree structure that lets other implementations parallelize is
 // faithfully computed (values are the canonical BLAKE3 values, pinned against
 // the official test-vector suite), but no SIMD/thread parallelism is used,
-// matching this library's constexpr single-path design.
+// matching this library's constexpr single-path design. The runtime-only
+// `blake3::DigestParallel` / `blake3::ParallelStreamer`
+// (digest_blake3_parallel.h) hash whole subtrees across threads and SIMD
+// lanes and feed them back through `PushSubtree`.
 //
 // All three modes are provided:
 // - `Digest` / `DigestXof<N>`: plain hashing (default 32 bytes; any output
@@ -240,6 +243,29 @@ constexpr void PushChunkChaining(State& state, std::array<uint32_t, 8> chaining,
   ++state.stack_len;
 }
 
+// Closes the current (full) chunk into the subtree stack and starts the next
+// one. Only valid once more input is known to follow.
+constexpr void CloseChunk(State& state) noexcept {
+  const std::array<uint32_t, 8> chunk_chaining = ChainingValue(ChunkOutput(state));
+  PushChunkChaining(state, chunk_chaining, state.chunk_counter + 1);
+  ++state.chunk_counter;
+  state.chunk_chaining = state.key;
+  state.block = {};
+  state.block_len = 0;
+  state.blocks_compressed = 0;
+  state.chunk_len = 0;
+}
+
+// Pushes the chaining value of a complete subtree of `1 << level` chunks that
+// was hashed elsewhere (see digest_blake3_parallel.h). Preconditions: no chunk
+// is pending (`chunk_len == 0`) and the chunk counter is a multiple of the
+// subtree size, so the subtree is one aligned node of the canonical tree and
+// merges exactly as if its chunks had been absorbed one by one.
+constexpr void PushSubtree(State& state, const std::array<uint32_t, 8>& chaining, std::size_t level) noexcept {
+  state.chunk_counter += uint64_t{1} << level;
+  PushChunkChaining(state, chaining, state.chunk_counter >> level);
+}
+
 constexpr void Update(State& state, std::string_view data) noexcept {
   const char* ptr = data.data();
   std::size_t remaining = data.size();
@@ -247,14 +273,7 @@ constexpr void Update(State& state, std::string_view data) noexcept {
     // A full chunk is only closed once more input arrives, so the final
     // chunk (even a full one) stays pending for ChunkOutput at finalize.
     if (state.chunk_len == kChunkSize) {
-      const std::array<uint32_t, 8> chunk_chaining = ChainingValue(ChunkOutput(state));
-      PushChunkChaining(state, chunk_chaining, state.chunk_counter + 1);
-      ++state.chunk_counter;
-      state.chunk_chaining = state.key;
-      state.block = {};
-      state.block_len = 0;
-      state.blocks_compressed = 0;
-      state.chunk_len = 0;
+      CloseChunk(state);
     }
     // Same one level down: a full block is only compressed once more input
     // arrives within the chunk.
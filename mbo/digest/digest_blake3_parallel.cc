@@ -0,0 +1,372 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/digest/digest_blake3_parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "mbo/digest/digest.h"
+#include "mbo/hash/hash_internal_util.h"
+#include "mbo/thread/executor.h"
+
+// The lane kernel must inline into each target clone to be compiled for it.
+#if defined(__GNUC__) || defined(__clang__)
+# define MBO_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+# define MBO_FORCE_INLINE __forceinline
+#else
+# define MBO_FORCE_INLINE inline
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# define MBO_DIGEST_BLAKE3_X86_CLONES 1
+#else
+# define MBO_DIGEST_BLAKE3_X86_CLONES 0
+#endif
+
+namespace mbo::digest {
+
+// NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-easily-swappable-parameters,*-avoid-unchecked-container-access)
+
+namespace blake3_internal {
+namespace {
+
+using ChainingWords = std::array<uint32_t, 8>;
+
+constexpr std::size_t kLanes = 8;                 // Chunks (or parents) per compression call.
+constexpr std::size_t kMinSubtreeChunks = kLanes;  // Fill all lanes where the input allows.
+constexpr std::size_t kMaxSubtreeChunks = 256;     // 256 KiB per task; bounds the per-task CV buffer.
+constexpr std::size_t kTasksPerThread = 4;
+
+// One word per lane; every lane-wise statement below is a plain loop over the
+// lanes, which the compiler maps to one vector instruction.
+using LaneWords = std::array<uint32_t, kLanes>;
+
+// The per-round message word order: round `r` reads word `kSchedule[r][i]` of
+// the original block, replacing the per-round permutation of `Compress`.
+constexpr std::array<std::array<uint8_t, 16>, 7> kSchedule = [] {
+  std::array<std::array<uint8_t, 16>, 7> schedule = {};
+  for (std::size_t i = 0; i < 16; ++i) {
+    schedule[0][i] = static_cast<uint8_t>(i);
+  }
+  for (std::size_t round = 1; round < 7; ++round) {
+    for (std::size_t i = 0; i < 16; ++i) {
+      schedule[round][i] = schedule[round - 1][kMsgPermutation[i]];
+    }
+  }
+  return schedule;
+}();
+
+MBO_FORCE_INLINE LaneWords Broadcast(uint32_t word) noexcept {
+  LaneWords lanes;  // NOLINT(*-member-init): fully assigned below.
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    lanes[lane] = word;
+  }
+  return lanes;
+}
+
+// NOLINTBEGIN(readability-identifier-length): mirrors `MixG`.
+template<int Shift>
+MBO_FORCE_INLINE void AddXorRotate(LaneWords& a, const LaneWords& b, const LaneWords& m, LaneWords& d) noexcept {
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    a[lane] = a[lane] + b[lane] + m[lane];
+    d[lane] = std::rotr(d[lane] ^ a[lane], Shift);
+  }
+}
+
+template<int Shift>
+MBO_FORCE_INLINE void AddXorRotate(LaneWords& c, const LaneWords& d, LaneWords& b) noexcept {
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    c[lane] = c[lane] + d[lane];
+    b[lane] = std::rotr(b[lane] ^ c[lane], Shift);
+  }
+}
+
+MBO_FORCE_INLINE void LaneG(
+    std::array<LaneWords, 16>& v,
+    std::size_t ia,
+    std::size_t ib,
+    std::size_t ic,
+    std::size_t id,
+    const LaneWords& mx,
+    const LaneWords& my) noexcept {
+  AddXorRotate<16>(v[ia], v[ib], mx, v[id]);
+  AddXorRotate<12>(v[ic], v[id], v[ib]);
+  AddXorRotate<8>(v[ia], v[ib], my, v[id]);
+  AddXorRotate<7>(v[ic], v[id], v[ib]);
+}
+
+// NOLINTEND(readability-identifier-length)
+
+// `Compress` on `kLanes` independent inputs at once, keeping only the new
+// chaining values (interior nodes never need the upper half).
+MBO_FORCE_INLINE void CompressLanes(
+    std::array<LaneWords, 8>& chaining,
+    const std::array<LaneWords, 16>& message,
+    const LaneWords& counter_low,
+    const LaneWords& counter_high,
+    uint32_t flags) noexcept {
+  std::array<LaneWords, 16> state;  // NOLINT(*-member-init): fully assigned below.
+  for (std::size_t i = 0; i < 8; ++i) {
+    state[i] = chaining[i];
+  }
+  for (std::size_t i = 0; i < 4; ++i) {
+    state[8 + i] = Broadcast(kInit[i]);
+  }
+  state[12] = counter_low;
+  state[13] = counter_high;
+  state[14] = Broadcast(static_cast<uint32_t>(kBlockSize));
+  state[15] = Broadcast(flags);
+  for (const std::array<uint8_t, 16>& order : kSchedule) {
+    LaneG(state, 0, 4, 8, 12, message[order[0]], message[order[1]]);
+    LaneG(state, 1, 5, 9, 13, message[order[2]], message[order[3]]);
+    LaneG(state, 2, 6, 10, 14, message[order[4]], message[order[5]]);
+    LaneG(state, 3, 7, 11, 15, message[order[6]], message[order[7]]);
+    LaneG(state, 0, 5, 10, 15, message[order[8]], message[order[9]]);
+    LaneG(state, 1, 6, 11, 12, message[order[10]], message[order[11]]);
+    LaneG(state, 2, 7, 8, 13, message[order[12]], message[order[13]]);
+    LaneG(state, 3, 4, 9, 14, message[order[14]], message[order[15]]);
+  }
+  for (std::size_t i = 0; i < 8; ++i) {
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+      chaining[i][lane] = state[i][lane] ^ state[i + 8][lane];
+    }
+  }
+}
+
+// Hashes `lanes` (<= kLanes) consecutive full chunks starting at chunk index
+// `counter` into their chaining values. Unused lanes compute on zeros.
+MBO_FORCE_INLINE void HashChunks(
+    const char* input,
+    std::size_t lanes,
+    uint64_t counter,
+    const ChainingWords& key,
+    uint32_t flags,
+    ChainingWords* out) noexcept {
+  std::array<LaneWords, 8> chaining;  // NOLINT(*-member-init): fully assigned below.
+  for (std::size_t i = 0; i < 8; ++i) {
+    chaining[i] = Broadcast(key[i]);
+  }
+  LaneWords counter_low = {};
+  LaneWords counter_high = {};
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    counter_low[lane] = static_cast<uint32_t>(counter + lane);
+    counter_high[lane] = static_cast<uint32_t>((counter + lane) >> 32U);
+  }
+  constexpr std::size_t kBlocksPerChunk = kChunkSize / kBlockSize;
+  for (std::size_t block = 0; block < kBlocksPerChunk; ++block) {
+    std::array<LaneWords, 16> message = {};
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      const char* block_ptr = input + (lane * kChunkSize) + (block * kBlockSize);
+      for (std::size_t i = 0; i < 16; ++i) {
+        message[i][lane] = ::mbo::hash::hash_internal::Load32(block_ptr + (4 * i));
+      }
+    }
+    const uint32_t block_flags =
+        flags | (block == 0 ? kChunkStart : 0U) | (block == kBlocksPerChunk - 1 ? kChunkEnd : 0U);
+    CompressLanes(chaining, message, counter_low, counter_high, block_flags);
+  }
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    for (std::size_t i = 0; i < 8; ++i) {
+      out[lane][i] = chaining[i][lane];
+    }
+  }
+}
+
+// Merges `lanes` (<= kLanes) sibling pairs `children[2 * n], children[2 * n + 1]`
+// into `out[n]`. `out` may alias `children` (all inputs are read first).
+MBO_FORCE_INLINE void HashParents(
+    const ChainingWords* children,
+    std::size_t lanes,
+    const ChainingWords& key,
+    uint32_t flags,
+    ChainingWords* out) noexcept {
+  std::array<LaneWords, 8> chaining;  // NOLINT(*-member-init): fully assigned below.
+  for (std::size_t i = 0; i < 8; ++i) {
+    chaining[i] = Broadcast(key[i]);
+  }
+  std::array<LaneWords, 16> message = {};
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    for (std::size_t i = 0; i < 8; ++i) {
+      message[i][lane] = children[2 * lane][i];
+      message[i + 8][lane] = children[(2 * lane) + 1][i];
+    }
+  }
+  CompressLanes(chaining, message, LaneWords{}, LaneWords{}, flags | kParent);
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    for (std::size_t i = 0; i < 8; ++i) {
+      out[lane][i] = chaining[i][lane];
+    }
+  }
+}
+
+// The chaining value of the aligned subtree of `chunks` (a power of two, at
+// most `kMaxSubtreeChunks`) full chunks starting at chunk index `counter`.
+MBO_FORCE_INLINE ChainingWords SubtreeImpl(
+    const char* input,
+    std::size_t chunks,
+    uint64_t counter,
+    const ChainingWords& key,
+    uint32_t flags) noexcept {
+  std::array<ChainingWords, kMaxSubtreeChunks> nodes;  // NOLINT(*-member-init): filled before use.
+  for (std::size_t chunk = 0; chunk < chunks; chunk += kLanes) {
+    HashChunks(
+        input + (chunk * kChunkSize), std::min(kLanes, chunks - chunk), counter + chunk, key, flags,
+        nodes.data() + chunk);
+  }
+  for (std::size_t width = chunks / 2; width > 0; width /= 2) {
+    for (std::size_t parent = 0; parent < width; parent += kLanes) {
+      HashParents(
+          nodes.data() + (2 * parent), std::min(kLanes, width - parent), key, flags, nodes.data() + parent);
+    }
+  }
+  return nodes[0];
+}
+
+using SubtreeFunction = ChainingWords (*)(const char*, std::size_t, uint64_t, const ChainingWords&, uint32_t);
+
+ChainingWords SubtreeGeneric(
+    const char* input,
+    std::size_t chunks,
+    uint64_t counter,
+    const ChainingWords& key,
+    uint32_t flags) noexcept {
+  return SubtreeImpl(input, chunks, counter, key, flags);
+}
+
+#if MBO_DIGEST_BLAKE3_X86_CLONES
+__attribute__((target("avx2"))) ChainingWords SubtreeAvx2(
+    const char* input,
+    std::size_t chunks,
+    uint64_t counter,
+    const ChainingWords& key,
+    uint32_t flags) noexcept {
+  return SubtreeImpl(input, chunks, counter, key, flags);
+}
+
+// AVX-512VL adds native 32-bit rotates on the 256-bit lane vectors.
+__attribute__((target("avx2,avx512f,avx512vl"))) ChainingWords SubtreeAvx512(
+    const char* input,
+    std::size_t chunks,
+    uint64_t counter,
+    const ChainingWords& key,
+    uint32_t flags) noexcept {
+  return SubtreeImpl(input, chunks, counter, key, flags);
+}
+#endif  // MBO_DIGEST_BLAKE3_X86_CLONES
+
+SubtreeFunction SelectSubtree() noexcept {
+#if MBO_DIGEST_BLAKE3_X86_CLONES
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")) {
+    return &SubtreeAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return &SubtreeAvx2;
+  }
+#endif  // MBO_DIGEST_BLAKE3_X86_CLONES
+  return &SubtreeGeneric;
+}
+
+struct SubtreeTask {
+  std::size_t offset = 0;  // Byte offset into the update's data.
+  std::size_t level = 0;   // The subtree has `1 << level` chunks.
+  uint64_t counter = 0;    // Index of its first chunk.
+  ChainingWords chaining = {};
+};
+
+// `Update(state, data)`, with every whole aligned subtree in `data` hashed on
+// `executor`. The last byte always stays with the sequential path, so the
+// final chunk remains pending for `Finalize` exactly as in `Update`.
+void UpdateParallel(State& state, std::string_view data, thread::Executor& executor) {
+  if (state.chunk_len != 0 && state.chunk_len != kChunkSize) {
+    const std::size_t fill = std::min(data.size(), kChunkSize - state.chunk_len);
+    Update(state, data.substr(0, fill));
+    data.remove_prefix(fill);
+  }
+  std::size_t chunks = data.empty() ? 0 : (data.size() - 1) / kChunkSize;
+  if (chunks < 2) {
+    Update(state, data);
+    return;
+  }
+  if (state.chunk_len == kChunkSize) {
+    CloseChunk(state);
+  }
+  const std::size_t target = std::clamp(
+      std::bit_floor(chunks / (kTasksPerThread * executor.Concurrency())), kMinSubtreeChunks, kMaxSubtreeChunks);
+  std::vector<SubtreeTask> tasks;
+  std::size_t offset = 0;
+  uint64_t counter = state.chunk_counter;
+  while (chunks > 0) {
+    std::size_t size = std::min(target, std::bit_floor(chunks));
+    if (counter != 0) {
+      // Subtrees must start at a multiple of their size.
+      size = static_cast<std::size_t>(std::min<uint64_t>(size, counter & (~counter + 1)));
+    }
+    tasks.push_back({.offset = offset, .level = static_cast<std::size_t>(std::countr_zero(size)), .counter = counter});
+    offset += size * kChunkSize;
+    counter += size;
+    chunks -= size;
+  }
+  static const SubtreeFunction kSubtree = SelectSubtree();
+  executor.ParallelFor(tasks.size(), [&](std::size_t index) {
+    SubtreeTask& task = tasks[index];
+    task.chaining =
+        kSubtree(data.data() + task.offset, std::size_t{1} << task.level, task.counter, state.key, state.flags);
+  });
+  for (const SubtreeTask& task : tasks) {
+    PushSubtree(state, task.chaining, task.level);
+  }
+  Update(state, data.substr(offset));
+}
+
+}  // namespace
+}  // namespace blake3_internal
+
+namespace blake3 {
+
+std::array<uint8_t, kDigestSize> DigestParallel(std::string_view data, thread::Executor& executor) {
+  return ParallelStreamer(executor).Update(data).Finalize();
+}
+
+ParallelStreamer::ParallelStreamer(thread::Executor& executor) noexcept
+    : executor_(&executor), state_(Algorithm::StreamInit()) {}
+
+ParallelStreamer::ParallelStreamer(thread::Executor& executor, std::string_view key) noexcept
+    : executor_(&executor), state_(Algorithm::StreamInitKeyed(key)) {}
+
+ParallelStreamer& ParallelStreamer::Update(std::string_view data) {
+  blake3_internal::UpdateParallel(state_, data, *executor_);
+  return *this;
+}
+
+ParallelStreamer::DigestType ParallelStreamer::Finalize() const noexcept {
+  return Algorithm::StreamFinalize(state_);
+}
+
+}  // namespace blake3
+
+// NOLINTEND(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-easily-swappable-parameters,*-avoid-unchecked-container-access)
+
+}  // namespace mbo::digest
+
+#undef MBO_DIGEST_BLAKE3_X86_CLONES
+#undef MBO_FORCE_INLINE
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_DIGEST_DIGEST_BLAKE3_PARALLEL_H_
+#define MBO_DIGEST_DIGEST_BLAKE3_PARALLEL_H_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "mbo/digest/digest.h"
+#include "mbo/thread/executor.h"
+
+// Runtime-only, multi-threaded and SIMD-lane BLAKE3 over the same tree as the
+// constexpr `blake3::Digest` (digest_blake3.h), with identical values.
+//
+// BLAKE3 is a Merkle tree over 1 KiB chunks, so any aligned power-of-two run of
+// chunks is an independent subtree. Input is split into such subtrees (about 4
+// per `Executor::Concurrency()` so uneven threads balance, capped at 256 KiB),
+// each subtree is hashed on the executor with 8 chunks (then 8 parents) per
+// compression call laid out lane-wise, and the subtree chaining values are
+// merged in order through `blake3_internal::PushSubtree`. The lane kernel is
+// plain C++ that the compiler vectorizes; on x86-64 GCC/Clang builds it is also
+// compiled for AVX2 and AVX-512VL and selected at run time.
+//
+// An `InlineExecutor` still gets the lane kernel (no threads); the gain over
+// `Digest` starts at a few KiB of input. Inputs up to 2 KiB take the scalar
+// path unchanged.
+namespace mbo::digest::blake3 {
+
+// Same value as `Digest(data)`.
+std::array<uint8_t, kDigestSize> DigestParallel(std::string_view data, thread::Executor& executor);
+
+// Incremental form of `DigestParallel`, same contract as `Streamer<Algorithm>`
+// (peekable `Finalize`). Each `Update` hashes the whole chunks it can on the
+// executor, so callers should feed large blocks (MiBs) to keep all threads busy.
+// The executor must outlive the streamer.
+class ParallelStreamer {
+ public:
+  using DigestType = Algorithm::DigestType;
+
+  explicit ParallelStreamer(thread::Executor& executor) noexcept;
+
+  // Native keyed mode (see `DigestKeyed`; `key.size() == 32`).
+  ParallelStreamer(thread::Executor& executor, std::string_view key) noexcept;
+
+  ParallelStreamer& Update(std::string_view data);
+
+  [[nodiscard]] DigestType Finalize() const noexcept;
+
+ private:
+  thread::Executor* executor_;
+  Algorithm::StreamState state_;
+};
+
+}  // namespace mbo::digest::blake3
+
+#endif  // MBO_DIGEST_DIGEST_BLAKE3_PARALLEL_H_
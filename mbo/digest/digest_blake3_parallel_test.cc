@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/digest/digest_blake3_parallel.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/digest/digest.h"
+#include "mbo/thread/executor.h"
+
+namespace mbo::digest::blake3 {
+namespace {
+
+using ::testing::ElementsAreArray;
+
+// The official vectors' repeating byte pattern (see digest_test.cc, which pins
+// the constexpr `Digest` against the published values).
+std::string PatternInput(std::size_t len) {
+  std::string input(len, '\0');
+  for (std::size_t i = 0; i < len; ++i) {
+    constexpr std::size_t kPatternPeriod = 251;
+    input.at(i) = static_cast<char>(i % kPatternPeriod);
+  }
+  return input;
+}
+
+// The official vector lengths (every chunk/tree boundary up to 31 KiB) plus
+// sizes that span several subtree tasks and the 256 KiB task cap.
+constexpr auto kLengths = std::to_array<std::size_t>({
+    0,     1,     1'023, 1'024, 1'025,  2'048,  2'049,   3'072,   3'073,     4'096,     4'097,       5'120,
+    5'121, 6'144, 6'145, 7'168, 7'169,  8'192,  8'193,   16'384,  31'744,    102'400,   262'144,     262'145,
+    524'288 + 3 * 1'024,   1'048'576 + 1,   3'000'017,
+});
+
+class Blake3ParallelTest : public ::testing::Test {
+ protected:
+  thread::InlineExecutor inline_executor_;
+  thread::ThreadPool pool_{4};
+};
+
+TEST_F(Blake3ParallelTest, MatchesDigest) {
+  for (const std::size_t len : kLengths) {
+    const std::string input = PatternInput(len);
+    const auto expected = Digest(input);
+    EXPECT_THAT(DigestParallel(input, inline_executor_), ElementsAreArray(expected)) << "len " << len;
+    EXPECT_THAT(DigestParallel(input, pool_), ElementsAreArray(expected)) << "len " << len;
+  }
+}
+
+TEST_F(Blake3ParallelTest, StreamingMatchesDigest) {
+  // Steps that leave partial chunks, land on chunk boundaries, and force
+  // unaligned chunk counters before the next subtree run.
+  constexpr auto kSteps = std::to_array<std::size_t>({1, 1'000, 1'024, 3 * 1'024, 5'000, 65'536, 300'001});
+  const std::string input = PatternInput(1'048'576 + 77);
+  const auto expected = Digest(input);
+  for (const std::size_t step : kSteps) {
+    ParallelStreamer streamer(pool_);
+    for (std::size_t pos = 0; pos < input.size(); pos += step) {
+      streamer.Update(std::string_view(input).substr(pos, step));
+    }
+    EXPECT_THAT(streamer.Finalize(), ElementsAreArray(expected)) << "step " << step;
+  }
+}
+
+TEST_F(Blake3ParallelTest, FinalizeIsPeekable) {
+  const std::string input = PatternInput(40'000);
+  ParallelStreamer streamer(pool_);
+  streamer.Update(std::string_view(input).substr(0, 20'000));
+  EXPECT_THAT(streamer.Finalize(), ElementsAreArray(Digest(std::string_view(input).substr(0, 20'000))));
+  streamer.Update(std::string_view(input).substr(20'000));
+  EXPECT_THAT(streamer.Finalize(), ElementsAreArray(Digest(input)));
+}
+
+TEST_F(Blake3ParallelTest, KeyedMatchesDigestKeyed) {
+  constexpr std::string_view kKey = "whats the Elvish word for friend";
+  for (const std::size_t len : kLengths) {
+    const std::string input = PatternInput(len);
+    EXPECT_THAT(
+        ParallelStreamer(pool_, kKey).Update(input).Finalize(), ElementsAreArray(DigestKeyed(kKey, input)))
+        << "len " << len;
+  }
+}
+
+}  // namespace
+}  // namespace mbo::digest::blake3
@@ -18,8 +18,8 @@
 # Tests the `digest` binary's CLI surface: algorithm selection, the
 # checksum-style output format, --reverse, stdin, multi-file processing,
 # --check verification (roundtrip, coreutils interop format, corruption,
-# quiet/status/strict/ignore_missing) and the error paths (directory,
-# missing file, unknown algorithm).
+# quiet/status/strict/ignore_missing), --jobs, --threads and the error paths
+# (directory, missing file, unknown algorithm).
 
 # shellcheck disable=SC2317 # Functions are called by bashtest
 
@@ -96,6 +96,56 @@ function test::algorithm_output_matrix() {
   done
 }
 
+# BLAKE3's tree mode: the value must not depend on --threads, for files
+# spanning many subtree tasks (and not a multiple of the chunk size) as well as
+# for stdin.
+function test::threads_do_not_change_blake3() {
+  local big="${BASHTEST_TMPDIR}/big.bin"
+  head -c 3000017 < <(yes "mbo digest threads") >"${big}"
+  local expected
+  expected="$("${DIGEST}" -a blake3 --threads=1 "${big}")" || die "digest failed for --threads=1."
+  local threads
+  for threads in 0 2 5; do
+    local out
+    out="$("${DIGEST}" -a blake3 --threads="${threads}" "${big}")" || die "digest failed for --threads=${threads}."
+    [[ ${out} == "${expected}" ]] || die "--threads=${threads} changed the value: '${out}' vs '${expected}'"
+  done
+  local stdin_out
+  stdin_out="$("${DIGEST}" -a blake3 --threads=3 - <"${big}")" || die "digest failed for stdin."
+  [[ ${stdin_out} == "${expected%% *}  -" ]] || die "Wrong stdin output: '${stdin_out}'"
+}
+
+# --jobs digests files concurrently but must report them (and errors) in
+# argument order, identical to --jobs=1, including for --check.
+function test::jobs_keep_argument_order() {
+  local dir="${BASHTEST_TMPDIR}/jobs"
+  mkdir -p "${dir}/subdir"
+  local -a args=()
+  local index
+  for index in $(seq 1 300); do
+    printf 'file %d\n' "${index}" >"${dir}/f${index}.txt"
+    args+=("${dir}/f${index}.txt")
+  done
+  args+=("${dir}/subdir" "${dir}/missing.txt" - "${ABC}")
+  local expected_out expected_err out err
+  expected_out="$(printf 'abc' | "${DIGEST}" --jobs=1 "${args[@]}" 2>"${BASHTEST_TMPDIR}/jobs1.err")" \
+    && die "A directory/missing file must fail."
+  expected_err="$(cat "${BASHTEST_TMPDIR}/jobs1.err")"
+  local jobs
+  for jobs in 0 3 8; do
+    out="$(printf 'abc' | "${DIGEST}" --jobs="${jobs}" "${args[@]}" 2>"${BASHTEST_TMPDIR}/jobs.err")" \
+      && die "A directory/missing file must fail (--jobs=${jobs})."
+    err="$(cat "${BASHTEST_TMPDIR}/jobs.err")"
+    [[ ${out} == "${expected_out}" ]] || die "--jobs=${jobs} changed stdout."
+    [[ ${err} == "${expected_err}" ]] || die "--jobs=${jobs} changed stderr."
+  done
+  "${DIGEST}" "${dir}"/f*.txt >"${BASHTEST_TMPDIR}/jobs.sums" || die "digest failed."
+  local expected_check
+  expected_check="$("${DIGEST}" --check --jobs=1 "${BASHTEST_TMPDIR}/jobs.sums")" || die "--check failed."
+  out="$("${DIGEST}" --check --jobs=4 "${BASHTEST_TMPDIR}/jobs.sums")" || die "--check --jobs=4 failed."
+  [[ ${out} == "${expected_check}" ]] || die "--check --jobs=4 changed the report order."
+}
+
 function test::reverse_swaps_columns() {
   local out
   out="$("${DIGEST}" --reverse "${ABC}")" || die "digest failed."
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/digest/digest_kernel.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# include <cpuid.h>
+#endif
+
+namespace mbo::digest::digest_internal {
+namespace {
+
+std::atomic<Kernel> g_kernel{Kernel::kAuto};  // NOLINT(*-avoid-non-const-global-variables)
+
+bool DetectShaInstructions() noexcept {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  // NOLINTBEGIN(*-magic-numbers): CPUID leaf and feature bit numbers.
+  unsigned eax = 0;
+  unsigned ebx = 0;
+  unsigned ecx = 0;
+  unsigned edx = 0;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+    return false;
+  }
+  const bool ssse3 = (ecx & (1U << 9U)) != 0;
+  const bool sse41 = (ecx & (1U << 19U)) != 0;
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+    return false;
+  }
+  const bool sha = (ebx & (1U << 29U)) != 0;
+  return ssse3 && sse41 && sha;
+  // NOLINTEND(*-magic-numbers)
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_SHA2)
+  return true;  // The compiler already targets the instructions.
+#else
+  return false;
+#endif
+}
+
+}  // namespace
+
+void SetKernel(Kernel kernel) noexcept {
+  g_kernel.store(kernel, std::memory_order_relaxed);
+}
+
+Kernel GetKernel() noexcept {
+  return g_kernel.load(std::memory_order_relaxed);
+}
+
+bool HasShaInstructions() noexcept {
+  static const bool kHasShaInstructions = DetectShaInstructions();
+  return kHasShaInstructions;
+}
+
+}  // namespace mbo::digest::digest_internal
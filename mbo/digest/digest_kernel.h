@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_DIGEST_DIGEST_KERNEL_H_
+#define MBO_DIGEST_DIGEST_KERNEL_H_
+
+#include <cstdint>
+
+// Runtime kernel selection for the algorithms with hardware-accelerated
+// compression: SHA-1 and SHA-224/256 use the x86 SHA extensions (SHA-NI,
+// detected at run time via CPUID) or the ARMv8 SHA instructions (when the
+// target enables them, e.g. all Apple arm64). The constexpr transcriptions
+// stay the reference: they are what constant evaluation uses, what CPUs
+// without the instructions run, and what the tests pin the accelerated
+// kernels against.
+namespace mbo::digest::digest_internal {
+
+enum class Kernel : uint8_t {
+  kAuto,      // Accelerated where the CPU supports it (default).
+  kPortable,  // Always the constexpr transcription, also at run time.
+};
+
+// Process-wide selection, for tests and benchmarks that compare both paths.
+void SetKernel(Kernel kernel) noexcept;
+Kernel GetKernel() noexcept;
+
+// Whether this build and CPU have the SHA instructions the accelerated
+// kernels use (independent of `SetKernel`).
+bool HasShaInstructions() noexcept;
+
+}  // namespace mbo::digest::digest_internal
+
+#endif  // MBO_DIGEST_DIGEST_KERNEL_H_
@@ -0,0 +1,504 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/digest/digest_many.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "mbo/digest/digest_blake2b.h"
+#include "mbo/digest/digest_kernel.h"
+#include "mbo/digest/digest_sha256.h"
+#include "mbo/hash/hash_internal_util.h"
+
+// The lane kernels must inline into each target clone to be compiled for it.
+#if defined(__GNUC__) || defined(__clang__)
+# define MBO_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+# define MBO_FORCE_INLINE __forceinline
+#else
+# define MBO_FORCE_INLINE inline
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# define MBO_DIGEST_MANY_X86_CLONES 1
+#else
+# define MBO_DIGEST_MANY_X86_CLONES 0
+#endif
+
+namespace mbo::digest::digest_internal {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-easily-swappable-parameters,*-avoid-unchecked-container-access)
+
+using ::mbo::hash::hash_internal::Load32BE;
+using ::mbo::hash::hash_internal::Load64;
+
+// One message's walk through its blocks: the full blocks are read in place,
+// the padded tail (one or two blocks) from a lane-owned copy.
+template<std::size_t BlockSize>
+struct LaneCursor {
+  std::size_t message = 0;  // Index into the messages (and the output).
+  const char* direct = nullptr;
+  std::size_t direct_blocks = 0;
+  std::size_t tail_blocks = 0;
+  std::size_t tail_offset = 0;
+  uint64_t length = 0;
+  uint64_t counter = 0;  // Bytes through the current block (BLAKE2b's t).
+  std::array<char, 2 * BlockSize> tail = {};
+
+  // The next block; sets `counter` and whether it is the message's last.
+  MBO_FORCE_INLINE const char* Next(bool& last) noexcept {
+    if (direct_blocks > 0) {
+      const char* block = direct;
+      direct += BlockSize;
+      --direct_blocks;
+      counter += BlockSize;
+      last = false;
+      return block;
+    }
+    const char* block = tail.data() + tail_offset;
+    tail_offset += BlockSize;
+    --tail_blocks;
+    counter = length;
+    last = tail_blocks == 0;
+    return block;
+  }
+
+  [[nodiscard]] bool Done() const noexcept { return direct_blocks == 0 && tail_blocks == 0; }
+};
+
+// SHA-256 / SHA-224 (FIPS 180-4): big-endian 32-bit words, the length padding
+// of `Finalize` applied per lane up front.
+struct Sha256Lanes {
+  using Word = uint32_t;
+  using Init = std::array<uint32_t, 8>;
+  static constexpr std::size_t kBlockSize = sha2_internal::kBlockSize;
+
+  static void Start(LaneCursor<kBlockSize>& cursor, std::string_view message) noexcept {
+    const std::size_t rest = message.size() % kBlockSize;
+    cursor.direct = message.data();
+    cursor.direct_blocks = message.size() / kBlockSize;
+    cursor.tail_blocks = rest + 9 <= kBlockSize ? 1 : 2;
+    cursor.tail_offset = 0;
+    cursor.length = message.size();
+    cursor.counter = 0;
+    cursor.tail = {};
+    if (rest > 0) {
+      std::memcpy(cursor.tail.data(), message.data() + (message.size() - rest), rest);
+    }
+    cursor.tail[rest] = static_cast<char>(0x80);
+    const uint64_t total_bits = uint64_t{message.size()} * 8;
+    const std::size_t end = cursor.tail_blocks * kBlockSize;
+    for (std::size_t i = 0; i < 8; ++i) {
+      cursor.tail[end - 8 + i] = static_cast<char>(total_bits >> (56 - (8 * i)));
+    }
+  }
+
+  MBO_FORCE_INLINE static Word Load(const char* ptr) noexcept { return Load32BE(ptr); }
+
+  static void Output(const std::array<Word, 8>& hash, std::size_t digest_size, std::byte* out) noexcept {
+    for (std::size_t i = 0; i < digest_size; ++i) {
+      out[i] = static_cast<std::byte>(hash[i / 4] >> (24 - (8 * (i % 4))));
+    }
+  }
+
+  template<std::size_t kLanes>
+  using LaneWords = std::array<Word, kLanes>;
+
+  // One round with the working variables passed in rotated roles (the caller
+  // permutes the arguments instead of moving eight vectors per round).
+  template<std::size_t kLanes>
+  MBO_FORCE_INLINE static void Round(
+      const LaneWords<kLanes>& a,
+      const LaneWords<kLanes>& b,
+      const LaneWords<kLanes>& c,
+      LaneWords<kLanes>& d,
+      const LaneWords<kLanes>& e,
+      const LaneWords<kLanes>& f,
+      const LaneWords<kLanes>& g,
+      LaneWords<kLanes>& h,
+      const LaneWords<kLanes>& w,
+      uint32_t k) noexcept {
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+      const uint32_t sum1 = std::rotr(e[lane], 6) ^ std::rotr(e[lane], 11) ^ std::rotr(e[lane], 25);
+      const uint32_t choose = (e[lane] & f[lane]) ^ (~e[lane] & g[lane]);
+      const uint32_t temp1 = h[lane] + sum1 + choose + k + w[lane];
+      const uint32_t sum0 = std::rotr(a[lane], 2) ^ std::rotr(a[lane], 13) ^ std::rotr(a[lane], 22);
+      const uint32_t majority = (a[lane] & b[lane]) ^ (a[lane] & c[lane]) ^ (b[lane] & c[lane]);
+      d[lane] += temp1;
+      h[lane] = temp1 + sum0 + majority;
+    }
+  }
+
+  template<std::size_t kLanes>
+  MBO_FORCE_INLINE static void Compress(
+      std::array<LaneWords<kLanes>, 8>& hash,
+      std::array<LaneWords<kLanes>, 16>& w,
+      const LaneWords<kLanes>& /*counter*/,
+      const LaneWords<kLanes>& /*last*/) noexcept {
+    std::array<LaneWords<kLanes>, 8> v = hash;
+    for (std::size_t t = 0; t < 64; t += 8) {
+      if (t >= 16) {
+        for (std::size_t i = t; i < t + 8; ++i) {
+          // Computed into a local: the compiler cannot tell the four ring
+          // slots apart and would not vectorize an in-place update.
+          const LaneWords<kLanes>& w2 = w[(i - 2) % 16];
+          const LaneWords<kLanes>& w7 = w[(i - 7) % 16];
+          const LaneWords<kLanes>& w15 = w[(i - 15) % 16];
+          const LaneWords<kLanes>& w16 = w[i % 16];
+          LaneWords<kLanes> next;  // NOLINT(*-member-init): fully assigned below.
+          for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            const uint32_t s0 = std::rotr(w15[lane], 7) ^ std::rotr(w15[lane], 18) ^ (w15[lane] >> 3U);
+            const uint32_t s1 = std::rotr(w2[lane], 17) ^ std::rotr(w2[lane], 19) ^ (w2[lane] >> 10U);
+            next[lane] = w16[lane] + s0 + s1 + w7[lane];
+          }
+          w[i % 16] = next;
+        }
+      }
+      const std::size_t base = t % 16;
+      Round(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], w[base + 0], sha2_internal::kRoundK[t + 0]);
+      Round(v[7], v[0], v[1], v[2], v[3], v[4], v[5], v[6], w[base + 1], sha2_internal::kRoundK[t + 1]);
+      Round(v[6], v[7], v[0], v[1], v[2], v[3], v[4], v[5], w[base + 2], sha2_internal::kRoundK[t + 2]);
+      Round(v[5], v[6], v[7], v[0], v[1], v[2], v[3], v[4], w[base + 3], sha2_internal::kRoundK[t + 3]);
+      Round(v[4], v[5], v[6], v[7], v[0], v[1], v[2], v[3], w[base + 4], sha2_internal::kRoundK[t + 4]);
+      Round(v[3], v[4], v[5], v[6], v[7], v[0], v[1], v[2], w[base + 5], sha2_internal::kRoundK[t + 5]);
+      Round(v[2], v[3], v[4], v[5], v[6], v[7], v[0], v[1], w[base + 6], sha2_internal::kRoundK[t + 6]);
+      Round(v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[0], w[base + 7], sha2_internal::kRoundK[t + 7]);
+    }
+    for (std::size_t i = 0; i < 8; ++i) {
+      for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        hash[i][lane] += v[i][lane];
+      }
+    }
+  }
+};
+
+// BLAKE2b (RFC 7693): little-endian 64-bit words; the last block (a zero
+// block for the empty message) carries the total length and the final flag.
+struct Blake2bLanes {
+  using Word = uint64_t;
+  using Init = std::array<uint64_t, 8>;
+  static constexpr std::size_t kBlockSize = blake2b_internal::kBlockSize;
+
+  static void Start(LaneCursor<kBlockSize>& cursor, std::string_view message) noexcept {
+    const std::size_t direct = message.empty() ? 0 : (message.size() - 1) / kBlockSize;
+    const std::size_t rest = message.size() - (direct * kBlockSize);
+    cursor.direct = message.data();
+    cursor.direct_blocks = direct;
+    cursor.tail_blocks = 1;
+    cursor.tail_offset = 0;
+    cursor.length = message.size();
+    cursor.counter = 0;
+    std::fill_n(cursor.tail.begin(), kBlockSize, 0);
+    if (rest > 0) {
+      std::memcpy(cursor.tail.data(), message.data() + (direct * kBlockSize), rest);
+    }
+  }
+
+  MBO_FORCE_INLINE static Word Load(const char* ptr) noexcept { return Load64(ptr); }
+
+  static void Output(const std::array<Word, 8>& hash, std::size_t digest_size, std::byte* out) noexcept {
+    for (std::size_t i = 0; i < digest_size; ++i) {
+      out[i] = static_cast<std::byte>(hash[i / 8] >> (8 * (i % 8)));
+    }
+  }
+
+  template<std::size_t kLanes>
+  using LaneWords = std::array<Word, kLanes>;
+
+  template<std::size_t kLanes>
+  MBO_FORCE_INLINE static void MixG(
+      LaneWords<kLanes>& a,
+      LaneWords<kLanes>& b,
+      LaneWords<kLanes>& c,
+      LaneWords<kLanes>& d,
+      const LaneWords<kLanes>& x,
+      const LaneWords<kLanes>& y) noexcept {
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+      a[lane] = a[lane] + b[lane] + x[lane];
+      d[lane] = std::rotr(d[lane] ^ a[lane], 32);
+      c[lane] = c[lane] + d[lane];
+      b[lane] = std::rotr(b[lane] ^ c[lane], 24);
+      a[lane] = a[lane] + b[lane] + y[lane];
+      d[lane] = std::rotr(d[lane] ^ a[lane], 16);
+      c[lane] = c[lane] + d[lane];
+      b[lane] = std::rotr(b[lane] ^ c[lane], 63);
+    }
+  }
+
+  template<std::size_t kLanes>
+  MBO_FORCE_INLINE static void Compress(
+      std::array<LaneWords<kLanes>, 8>& hash,
+      std::array<LaneWords<kLanes>, 16>& m,
+      const LaneWords<kLanes>& counter,
+      const LaneWords<kLanes>& last) noexcept {
+    std::array<LaneWords<kLanes>, 16> v;  // NOLINT(*-member-init): fully assigned below.
+    for (std::size_t i = 0; i < 8; ++i) {
+      v[i] = hash[i];
+      v[i + 8].fill(blake2b_internal::kInit[i]);
+    }
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+      v[12][lane] ^= counter[lane];
+      v[14][lane] ^= last[lane];
+    }
+    for (std::size_t round = 0; round < 12; ++round) {
+      const std::array<uint8_t, 16>& sigma = blake2b_internal::kSigma[round % 10];
+      MixG(v[0], v[4], v[8], v[12], m[sigma[0]], m[sigma[1]]);
+      MixG(v[1], v[5], v[9], v[13], m[sigma[2]], m[sigma[3]]);
+      MixG(v[2], v[6], v[10], v[14], m[sigma[4]], m[sigma[5]]);
+      MixG(v[3], v[7], v[11], v[15], m[sigma[6]], m[sigma[7]]);
+      MixG(v[0], v[5], v[10], v[15], m[sigma[8]], m[sigma[9]]);
+      MixG(v[1], v[6], v[11], v[12], m[sigma[10]], m[sigma[11]]);
+      MixG(v[2], v[7], v[8], v[13], m[sigma[12]], m[sigma[13]]);
+      MixG(v[3], v[4], v[9], v[14], m[sigma[14]], m[sigma[15]]);
+    }
+    for (std::size_t i = 0; i < 8; ++i) {
+      for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        hash[i][lane] ^= v[i][lane] ^ v[i + 8][lane];
+      }
+    }
+  }
+};
+
+// Runs all messages through `kLanes` lanes. Idle lanes (fewer messages left
+// than lanes) compress a zero block whose result is discarded.
+template<typename Lanes, std::size_t kLanes>
+MBO_FORCE_INLINE void HashLanes(
+    std::span<const std::string_view> messages,
+    const typename Lanes::Init& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  using Word = Lanes::Word;
+  using LaneWords = std::array<Word, kLanes>;
+  static constexpr std::array<char, Lanes::kBlockSize> kIdleBlock = {};
+
+  std::array<LaneCursor<Lanes::kBlockSize>, kLanes> cursors;
+  std::array<bool, kLanes> active = {};
+  std::array<LaneWords, 8> hash;  // NOLINT(*-member-init): lanes are set when they start a message.
+  std::size_t next = 0;
+  std::size_t running = 0;
+  const auto start = [&](std::size_t lane) {
+    active[lane] = next < messages.size();
+    if (!active[lane]) {
+      return;
+    }
+    cursors[lane].message = next;
+    Lanes::Start(cursors[lane], messages[next]);
+    for (std::size_t i = 0; i < 8; ++i) {
+      hash[i][lane] = init[i];
+    }
+    ++next;
+    ++running;
+  };
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    start(lane);
+  }
+
+  std::array<const char*, kLanes> blocks = {};
+  std::array<LaneWords, 16> words;  // NOLINT(*-member-init): fully assigned per block.
+  LaneWords counter = {};
+  LaneWords last = {};
+  while (running > 0) {
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+      bool is_last = false;
+      blocks[lane] = active[lane] ? cursors[lane].Next(is_last) : kIdleBlock.data();
+      counter[lane] = active[lane] ? cursors[lane].counter : 0;
+      last[lane] = is_last ? ~Word{0} : 0;
+    }
+    for (std::size_t i = 0; i < 16; ++i) {
+      for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        words[i][lane] = Lanes::Load(blocks[lane] + (i * sizeof(Word)));
+      }
+    }
+    Lanes::template Compress<kLanes>(hash, words, counter, last);
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+      if (!active[lane] || !cursors[lane].Done()) {
+        continue;
+      }
+      std::array<Word, 8> result;  // NOLINT(*-member-init): fully assigned below.
+      for (std::size_t i = 0; i < 8; ++i) {
+        result[i] = hash[i][lane];
+      }
+      Lanes::Output(result, digest_size, out.data() + (cursors[lane].message * digest_size));
+      --running;
+      start(lane);
+    }
+  }
+}
+
+using Sha256ManyFunction =
+    void (*)(std::span<const std::string_view>, const std::array<uint32_t, 8>&, std::size_t, std::span<std::byte>);
+using Blake2bManyFunction =
+    void (*)(std::span<const std::string_view>, const std::array<uint64_t, 8>&, std::size_t, std::span<std::byte>);
+
+// One message at a time through the regular path (which picks the SHA
+// instructions where available).
+void Sha256Sequential(
+    std::span<const std::string_view> messages,
+    const std::array<uint32_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  for (std::size_t index = 0; index < messages.size(); ++index) {
+    sha2_internal::State state = sha2_internal::Init(init);
+    sha2_internal::Update(state, messages[index]);
+    const std::array<uint8_t, 32> digest = sha2_internal::Finalize<32>(state);
+    std::memcpy(out.data() + (index * digest_size), digest.data(), digest_size);
+  }
+}
+
+void Blake2bSequential(
+    std::span<const std::string_view> messages,
+    const std::array<uint64_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  for (std::size_t index = 0; index < messages.size(); ++index) {
+    blake2b_internal::State state = {.hash = init, .buffer = {}, .buffered = 0, .compressed = 0};
+    blake2b_internal::Update(state, messages[index]);
+    const std::array<uint8_t, 64> digest = blake2b_internal::Finalize<64>(state);
+    std::memcpy(out.data() + (index * digest_size), digest.data(), digest_size);
+  }
+}
+
+#if MBO_DIGEST_MANY_X86_CLONES
+__attribute__((target("avx2"))) void Sha256Avx2(
+    std::span<const std::string_view> messages,
+    const std::array<uint32_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  HashLanes<Sha256Lanes, 8>(messages, init, digest_size, out);
+}
+
+__attribute__((target("avx2,avx512f,avx512vl"))) void Sha256Avx512(
+    std::span<const std::string_view> messages,
+    const std::array<uint32_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  HashLanes<Sha256Lanes, 16>(messages, init, digest_size, out);
+}
+
+__attribute__((target("avx2"))) void Blake2bAvx2(
+    std::span<const std::string_view> messages,
+    const std::array<uint64_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  HashLanes<Blake2bLanes, 4>(messages, init, digest_size, out);
+}
+
+__attribute__((target("avx2,avx512f,avx512vl"))) void Blake2bAvx512(
+    std::span<const std::string_view> messages,
+    const std::array<uint64_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  HashLanes<Blake2bLanes, 8>(messages, init, digest_size, out);
+}
+#endif  // MBO_DIGEST_MANY_X86_CLONES
+
+void Sha256Generic(
+    std::span<const std::string_view> messages,
+    const std::array<uint32_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  HashLanes<Sha256Lanes, 4>(messages, init, digest_size, out);
+}
+
+void Blake2bGeneric(
+    std::span<const std::string_view> messages,
+    const std::array<uint64_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  HashLanes<Blake2bLanes, 2>(messages, init, digest_size, out);
+}
+
+// A lane kernel and the batch size from which it beats the sequential path:
+// SHA-256 lanes must all be busy to overtake a single stream (and against the
+// SHA instructions only AVX-512's 16 lanes do), BLAKE2b lanes win from two.
+template<typename Function>
+struct LaneKernel {
+  Function lanes = nullptr;
+  std::size_t min_batch = 0;
+};
+
+LaneKernel<Sha256ManyFunction> SelectSha256() noexcept {
+#if MBO_DIGEST_MANY_X86_CLONES
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")) {
+    return {.lanes = &Sha256Avx512, .min_batch = 16};
+  }
+#endif  // MBO_DIGEST_MANY_X86_CLONES
+  if (HasShaInstructions()) {
+    return {};
+  }
+#if MBO_DIGEST_MANY_X86_CLONES
+  if (__builtin_cpu_supports("avx2")) {
+    return {.lanes = &Sha256Avx2, .min_batch = 8};
+  }
+#endif  // MBO_DIGEST_MANY_X86_CLONES
+  return {.lanes = &Sha256Generic, .min_batch = 4};
+}
+
+LaneKernel<Blake2bManyFunction> SelectBlake2b() noexcept {
+#if MBO_DIGEST_MANY_X86_CLONES
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")) {
+    return {.lanes = &Blake2bAvx512, .min_batch = 2};
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return {.lanes = &Blake2bAvx2, .min_batch = 2};
+  }
+#endif  // MBO_DIGEST_MANY_X86_CLONES
+  return {.lanes = &Blake2bGeneric, .min_batch = 2};
+}
+
+// NOLINTEND(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-easily-swappable-parameters,*-avoid-unchecked-container-access)
+
+}  // namespace
+
+void Sha256Many(
+    std::span<const std::string_view> messages,
+    const std::array<uint32_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  static const LaneKernel<Sha256ManyFunction> kKernel = SelectSha256();
+  if (kKernel.lanes == nullptr || messages.size() < kKernel.min_batch || GetKernel() == Kernel::kPortable) {
+    Sha256Sequential(messages, init, digest_size, out);
+  } else {
+    kKernel.lanes(messages, init, digest_size, out);
+  }
+}
+
+void Blake2bMany(
+    std::span<const std::string_view> messages,
+    const std::array<uint64_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept {
+  static const LaneKernel<Blake2bManyFunction> kKernel = SelectBlake2b();
+  if (messages.size() < kKernel.min_batch || GetKernel() == Kernel::kPortable) {
+    Blake2bSequential(messages, init, digest_size, out);
+  } else {
+    kKernel.lanes(messages, init, digest_size, out);
+  }
+}
+
+}  // namespace mbo::digest::digest_internal
+
+#undef MBO_DIGEST_MANY_X86_CLONES
+#undef MBO_FORCE_INLINE
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_DIGEST_DIGEST_MANY_H_
+#define MBO_DIGEST_DIGEST_MANY_H_
+
+// IWYU pragma: private, include "mbo/digest/digest.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace mbo::digest::digest_internal {
+
+// Whether `Algo` streams through `State`; selects the lane kernel below.
+template<typename Algo, typename State>
+concept HasStreamState = requires { typename Algo::StreamState; } && std::is_same_v<typename Algo::StreamState, State>;
+
+// Multi-buffer kernels behind `DigestMany` (digest.h): independent messages
+// run through the compression function in lockstep, one message per SIMD lane.
+// Each writes `digest_size` bytes per message to `out`, message after message,
+// identical to the one-shot digest of the algorithm with initial hash `init`.
+// Inputs of any length mix freely: a lane that finishes its message picks up
+// the next one.
+
+// SHA-256 and SHA-224 (they differ only in `init` and the truncation).
+void Sha256Many(
+    std::span<const std::string_view> messages,
+    const std::array<uint32_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept;
+
+// Unkeyed BLAKE2b of any digest size (`init` carries the parameter block).
+void Blake2bMany(
+    std::span<const std::string_view> messages,
+    const std::array<uint64_t, 8>& init,
+    std::size_t digest_size,
+    std::span<std::byte> out) noexcept;
+
+}  // namespace mbo::digest::digest_internal
+
+#endif  // MBO_DIGEST_DIGEST_MANY_H_
@@ -0,0 +1,225 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// IWYU pragma: private, include "mbo/digest/digest.h"
+#include "mbo/digest/digest_sha1.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "mbo/digest/digest_kernel.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# define MBO_DIGEST_SHA1_X86 1
+# include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_SHA2)
+# define MBO_DIGEST_SHA1_ARM 1
+# include <arm_neon.h>
+#endif
+
+// The accelerated kernels follow the instruction-set vendors' published
+// usage patterns (Intel's SHA extensions white paper; the Arm ACLE crypto
+// intrinsics): four rounds per instruction, with the message schedule
+// advanced in four-word vectors.
+namespace mbo::digest::sha1_internal {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-reinterpret-cast,*-avoid-unchecked-container-access)
+
+void CompressBlocksPortable(std::array<uint32_t, 5>& hash, const char* blocks, std::size_t count) noexcept {
+  for (std::size_t i = 0; i < count; ++i) {
+    Compress(hash, blocks + (i * kBlockSize));
+  }
+}
+
+#if defined(MBO_DIGEST_SHA1_X86)
+
+// Rounds `4 * Group .. 4 * Group + 3` on `cur` (message words of that group).
+// The E values alternate between two registers: `e_cur` feeds these rounds,
+// `e_next` captures A for the next group's `sha1nexte`. The schedule for
+// group + 4 is built in three steps: `msg1` into `prev` (group - 1 = group + 3),
+// xor into `next2` (group + 2), `msg2` into `next` (group + 1).
+template<std::size_t Group>
+__attribute__((target("sha,sse4.1,ssse3"), always_inline)) inline void Sha1Quad(
+    __m128i& abcd,
+    __m128i& e_cur,
+    __m128i& e_next,
+    const __m128i& cur,
+    __m128i& next,
+    __m128i& next2,
+    __m128i& prev) {
+  if constexpr (Group == 0) {
+    e_cur = _mm_add_epi32(e_cur, cur);
+  } else {
+    e_cur = _mm_sha1nexte_epu32(e_cur, cur);
+  }
+  e_next = abcd;
+  if constexpr (Group >= 3 && Group <= 18) {
+    next = _mm_sha1msg2_epu32(next, cur);
+  }
+  abcd = _mm_sha1rnds4_epu32(abcd, e_cur, Group / 5);
+  if constexpr (Group >= 1 && Group <= 16) {
+    prev = _mm_sha1msg1_epu32(prev, cur);
+  }
+  if constexpr (Group >= 2 && Group <= 17) {
+    next2 = _mm_xor_si128(next2, cur);
+  }
+}
+
+__attribute__((target("sha,sse4.1,ssse3"))) void CompressBlocksShaNi(
+    std::array<uint32_t, 5>& hash,
+    const char* blocks,
+    std::size_t count) noexcept {
+  const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090A0B0C0D0E0FULL);
+  __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hash.data())), 0x1B);
+  __m128i e0 = _mm_set_epi32(static_cast<int>(hash[4]), 0, 0, 0);
+  __m128i e1 = _mm_setzero_si128();
+  for (std::size_t block = 0; block < count; ++block) {
+    const char* data = blocks + (block * kBlockSize);
+    const __m128i abcd_save = abcd;
+    const __m128i e0_save = e0;
+    __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), byte_swap);
+    __m128i msg1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), byte_swap);
+    __m128i msg2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), byte_swap);
+    __m128i msg3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), byte_swap);
+    Sha1Quad<0>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<1>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<2>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<3>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    Sha1Quad<4>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<5>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<6>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<7>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    Sha1Quad<8>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<9>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<10>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<11>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    Sha1Quad<12>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<13>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<14>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<15>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    Sha1Quad<16>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<17>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<18>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<19>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    e0 = _mm_sha1nexte_epu32(e0, e0_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(hash.data()), _mm_shuffle_epi32(abcd, 0x1B));
+  hash[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+}
+
+#elif defined(MBO_DIGEST_SHA1_ARM)
+
+// Rounds `4 * Group .. 4 * Group + 3`; then replaces `cur` with the message
+// words of group + 4 (from groups + 1, + 2 and + 3).
+template<std::size_t Group>
+inline void Sha1Quad(
+    uint32x4_t& abcd,
+    uint32_t& e_cur,
+    uint32_t& e_next,
+    uint32x4_t& cur,
+    uint32x4_t next,
+    uint32x4_t next2,
+    uint32x4_t next3) {
+  static constexpr auto kRoundK = std::to_array<uint32_t>({0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6});
+  const uint32x4_t words = vaddq_u32(cur, vdupq_n_u32(kRoundK[Group / 5]));
+  if constexpr (Group < 16) {
+    cur = vsha1su1q_u32(vsha1su0q_u32(cur, next, next2), next3);
+  }
+  e_next = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+  if constexpr (Group / 5 == 0) {
+    abcd = vsha1cq_u32(abcd, e_cur, words);
+  } else if constexpr (Group / 5 == 2) {
+    abcd = vsha1mq_u32(abcd, e_cur, words);
+  } else {
+    abcd = vsha1pq_u32(abcd, e_cur, words);
+  }
+}
+
+void CompressBlocksArmv8(std::array<uint32_t, 5>& hash, const char* blocks, std::size_t count) noexcept {
+  uint32x4_t abcd = vld1q_u32(hash.data());
+  uint32_t e0 = hash[4];
+  uint32_t e1 = 0;
+  for (std::size_t block = 0; block < count; ++block) {
+    const auto* data = reinterpret_cast<const uint8_t*>(blocks + (block * kBlockSize));
+    const uint32x4_t abcd_save = abcd;
+    const uint32_t e0_save = e0;
+    uint32x4_t msg0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data)));
+    uint32x4_t msg1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+    uint32x4_t msg2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+    uint32x4_t msg3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+    Sha1Quad<0>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<1>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<2>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<3>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    Sha1Quad<4>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<5>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<6>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<7>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    Sha1Quad<8>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<9>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<10>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<11>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    Sha1Quad<12>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<13>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<14>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<15>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    Sha1Quad<16>(abcd, e0, e1, msg0, msg1, msg2, msg3);
+    Sha1Quad<17>(abcd, e1, e0, msg1, msg2, msg3, msg0);
+    Sha1Quad<18>(abcd, e0, e1, msg2, msg3, msg0, msg1);
+    Sha1Quad<19>(abcd, e1, e0, msg3, msg0, msg1, msg2);
+    e0 += e0_save;
+    abcd = vaddq_u32(abcd, abcd_save);
+  }
+  vst1q_u32(hash.data(), abcd);
+  hash[4] = e0;
+}
+
+#endif  // MBO_DIGEST_SHA1_X86 / MBO_DIGEST_SHA1_ARM
+
+using CompressBlocksFunc = void (*)(std::array<uint32_t, 5>&, const char*, std::size_t) noexcept;
+
+CompressBlocksFunc SelectAccelerated() noexcept {
+  if (!digest_internal::HasShaInstructions()) {
+    return nullptr;
+  }
+#if defined(MBO_DIGEST_SHA1_X86)
+  return &CompressBlocksShaNi;
+#elif defined(MBO_DIGEST_SHA1_ARM)
+  return &CompressBlocksArmv8;
+#else
+  return nullptr;
+#endif
+}
+
+// NOLINTEND(*-magic-numbers,*-pointer-arithmetic,*-reinterpret-cast,*-avoid-unchecked-container-access)
+
+}  // namespace
+
+void CompressBlocksRuntime(std::array<uint32_t, 5>& hash, const char* blocks, std::size_t count) noexcept {
+  static const CompressBlocksFunc kAccelerated = SelectAccelerated();
+  if (kAccelerated != nullptr && digest_internal::GetKernel() == digest_internal::Kernel::kAuto) {
+    kAccelerated(hash, blocks, count);
+  } else {
+    CompressBlocksPortable(hash, blocks, count);
+  }
+}
+
+}  // namespace mbo::digest::sha1_internal
+
+#undef MBO_DIGEST_SHA1_X86
+#undef MBO_DIGEST_SHA1_ARM
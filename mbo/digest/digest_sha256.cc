@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// IWYU pragma: private, include "mbo/digest/digest.h"
+#include "mbo/digest/digest_sha256.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "mbo/digest/digest_kernel.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# define MBO_DIGEST_SHA256_X86 1
+# include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_SHA2)
+# define MBO_DIGEST_SHA256_ARM 1
+# include <arm_neon.h>
+#endif
+
+// The accelerated kernels follow the instruction-set vendors' published
+// usage patterns (Intel's SHA extensions white paper; the Arm ACLE crypto
+// intrinsics): four rounds per instruction pair, with the message schedule
+// advanced in four-word vectors.
+namespace mbo::digest::sha2_internal {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-reinterpret-cast,*-avoid-unchecked-container-access)
+
+void CompressBlocksPortable(std::array<uint32_t, 8>& hash, const char* blocks, std::size_t count) noexcept {
+  for (std::size_t i = 0; i < count; ++i) {
+    Compress(hash, blocks + (i * kBlockSize));
+  }
+}
+
+#if defined(MBO_DIGEST_SHA256_X86)
+
+# define MBO_DIGEST_SHA_TARGET __attribute__((target("sha,sse4.1,ssse3"), always_inline)) inline
+
+// Rounds `4 * Group .. 4 * Group + 3` on `cur` (message words of that group).
+// Advances the schedule: `next` (group + 1) gets its second step, which needs
+// `prev` (group - 1); `prev` (= group + 3 after the update) its first step.
+template<std::size_t Group>
+MBO_DIGEST_SHA_TARGET void QuadRound(__m128i& abef, __m128i& cdgh, const __m128i& cur, __m128i& next, __m128i& prev) {
+  __m128i msg = _mm_add_epi32(cur, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&kRoundK[4 * Group])));
+  cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+  if constexpr (Group >= 3 && Group <= 14) {
+    next = _mm_sha256msg2_epu32(_mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4)), cur);
+  }
+  msg = _mm_shuffle_epi32(msg, 0x0E);
+  abef = _mm_sha256rnds2_epu32(abef, cdgh, msg);
+  if constexpr (Group >= 1 && Group <= 12) {
+    prev = _mm_sha256msg1_epu32(prev, cur);
+  }
+}
+
+__attribute__((target("sha,sse4.1,ssse3"))) void CompressBlocksShaNi(
+    std::array<uint32_t, 8>& hash,
+    const char* blocks,
+    std::size_t count) noexcept {
+  const __m128i byte_swap = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+  // The instructions keep the state as {A, B, E, F} and {C, D, G, H}.
+  const __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&hash[0])), 0xB1);
+  const __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&hash[4])), 0x1B);
+  __m128i abef = _mm_alignr_epi8(dcba, efgh, 8);
+  __m128i cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+  for (std::size_t block = 0; block < count; ++block) {
+    const char* data = blocks + (block * kBlockSize);
+    const __m128i abef_save = abef;
+    const __m128i cdgh_save = cdgh;
+    __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), byte_swap);
+    __m128i msg1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), byte_swap);
+    __m128i msg2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), byte_swap);
+    __m128i msg3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), byte_swap);
+    QuadRound<0>(abef, cdgh, msg0, msg1, msg3);
+    QuadRound<1>(abef, cdgh, msg1, msg2, msg0);
+    QuadRound<2>(abef, cdgh, msg2, msg3, msg1);
+    QuadRound<3>(abef, cdgh, msg3, msg0, msg2);
+    QuadRound<4>(abef, cdgh, msg0, msg1, msg3);
+    QuadRound<5>(abef, cdgh, msg1, msg2, msg0);
+    QuadRound<6>(abef, cdgh, msg2, msg3, msg1);
+    QuadRound<7>(abef, cdgh, msg3, msg0, msg2);
+    QuadRound<8>(abef, cdgh, msg0, msg1, msg3);
+    QuadRound<9>(abef, cdgh, msg1, msg2, msg0);
+    QuadRound<10>(abef, cdgh, msg2, msg3, msg1);
+    QuadRound<11>(abef, cdgh, msg3, msg0, msg2);
+    QuadRound<12>(abef, cdgh, msg0, msg1, msg3);
+    QuadRound<13>(abef, cdgh, msg1, msg2, msg0);
+    QuadRound<14>(abef, cdgh, msg2, msg3, msg1);
+    QuadRound<15>(abef, cdgh, msg3, msg0, msg2);
+    abef = _mm_add_epi32(abef, abef_save);
+    cdgh = _mm_add_epi32(cdgh, cdgh_save);
+  }
+  const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+  const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&hash[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&hash[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+# undef MBO_DIGEST_SHA_TARGET
+
+#elif defined(MBO_DIGEST_SHA256_ARM)
+
+// Rounds `4 * Group .. 4 * Group + 3`; then replaces `cur` with the message
+// words of group + 4 (from groups + 1, + 2 and + 3).
+template<std::size_t Group>
+inline void QuadRound(
+    uint32x4_t& abcd,
+    uint32x4_t& efgh,
+    uint32x4_t& cur,
+    uint32x4_t next,
+    uint32x4_t next2,
+    uint32x4_t next3) {
+  const uint32x4_t words = vaddq_u32(cur, vld1q_u32(&kRoundK[4 * Group]));
+  if constexpr (Group < 12) {
+    cur = vsha256su1q_u32(vsha256su0q_u32(cur, next), next2, next3);
+  }
+  const uint32x4_t abcd_in = abcd;
+  abcd = vsha256hq_u32(abcd, efgh, words);
+  efgh = vsha256h2q_u32(efgh, abcd_in, words);
+}
+
+void CompressBlocksArmv8(std::array<uint32_t, 8>& hash, const char* blocks, std::size_t count) noexcept {
+  uint32x4_t abcd = vld1q_u32(&hash[0]);
+  uint32x4_t efgh = vld1q_u32(&hash[4]);
+  for (std::size_t block = 0; block < count; ++block) {
+    const auto* data = reinterpret_cast<const uint8_t*>(blocks + (block * kBlockSize));
+    const uint32x4_t abcd_save = abcd;
+    const uint32x4_t efgh_save = efgh;
+    uint32x4_t msg0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data)));
+    uint32x4_t msg1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+    uint32x4_t msg2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+    uint32x4_t msg3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+    QuadRound<0>(abcd, efgh, msg0, msg1, msg2, msg3);
+    QuadRound<1>(abcd, efgh, msg1, msg2, msg3, msg0);
+    QuadRound<2>(abcd, efgh, msg2, msg3, msg0, msg1);
+    QuadRound<3>(abcd, efgh, msg3, msg0, msg1, msg2);
+    QuadRound<4>(abcd, efgh, msg0, msg1, msg2, msg3);
+    QuadRound<5>(abcd, efgh, msg1, msg2, msg3, msg0);
+    QuadRound<6>(abcd, efgh, msg2, msg3, msg0, msg1);
+    QuadRound<7>(abcd, efgh, msg3, msg0, msg1, msg2);
+    QuadRound<8>(abcd, efgh, msg0, msg1, msg2, msg3);
+    QuadRound<9>(abcd, efgh, msg1, msg2, msg3, msg0);
+    QuadRound<10>(abcd, efgh, msg2, msg3, msg0, msg1);
+    QuadRound<11>(abcd, efgh, msg3, msg0, msg1, msg2);
+    QuadRound<12>(abcd, efgh, msg0, msg1, msg2, msg3);
+    QuadRound<13>(abcd, efgh, msg1, msg2, msg3, msg0);
+    QuadRound<14>(abcd, efgh, msg2, msg3, msg0, msg1);
+    QuadRound<15>(abcd, efgh, msg3, msg0, msg1, msg2);
+    abcd = vaddq_u32(abcd, abcd_save);
+    efgh = vaddq_u32(efgh, efgh_save);
+  }
+  vst1q_u32(&hash[0], abcd);
+  vst1q_u32(&hash[4], efgh);
+}
+
+#endif  // MBO_DIGEST_SHA256_X86 / MBO_DIGEST_SHA256_ARM
+
+using CompressBlocksFunc = void (*)(std::array<uint32_t, 8>&, const char*, std::size_t) noexcept;
+
+CompressBlocksFunc SelectAccelerated() noexcept {
+  if (!digest_internal::HasShaInstructions()) {
+    return nullptr;
+  }
+#if defined(MBO_DIGEST_SHA256_X86)
+  return &CompressBlocksShaNi;
+#elif defined(MBO_DIGEST_SHA256_ARM)
+  return &CompressBlocksArmv8;
+#else
+  return nullptr;
+#endif
+}
+
+// NOLINTEND(*-magic-numbers,*-pointer-arithmetic,*-reinterpret-cast,*-avoid-unchecked-container-access)
+
+}  // namespace
+
+void CompressBlocksRuntime(std::array<uint32_t, 8>& hash, const char* blocks, std::size_t count) noexcept {
+  static const CompressBlocksFunc kAccelerated = SelectAccelerated();
+  if (kAccelerated != nullptr && digest_internal::GetKernel() == digest_internal::Kernel::kAuto) {
+    kAccelerated(hash, blocks, count);
+  } else {
+    CompressBlocksPortable(hash, blocks, count);
+  }
+}
+
+}  // namespace mbo::digest::sha2_internal
+
+#undef MBO_DIGEST_SHA256_X86
+#undef MBO_DIGEST_SHA256_ARM
@@ -23,15 +23,18 @@
 #include <cstddef>
 #include <cstdint>
 #include <string_view>
+#include <type_traits>
 
 #include "mbo/hash/hash_internal_util.h"
 
 // SHA-224 and SHA-256 (FIPS 180-4, the 32-bit-word SHA-2 family), transcribed
-// from the specification; constexpr-safe with one code path for compile time
-// and run time. The two algorithms share the compression function and differ
-// only in the initial hash value and the output truncation. All constants and
-// test vectors are pinned against independent references (see
-// digest_test.cc).
+// from the specification; constexpr-safe. At run time the block compression
+// uses the CPU's SHA instructions where available (SHA-NI, ARMv8 SHA2; see
+// digest_kernel.h); the transcription is the compile-time path and the
+// reference those kernels are tested against. The two algorithms share the
+// compression function and differ only in the initial hash value and the
+// output truncation. All constants and test vectors are pinned against
+// independent references (see digest_test.cc).
 namespace mbo::digest {
 
 // NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-avoid-unchecked-container-access)
@@ -111,6 +114,22 @@ constexpr void Compress(std::array<uint32_t, 8>& hash, const char* block) noexce
   hash[7] += sh;
 }
 
+// Compresses `count` consecutive blocks at run time (digest_sha256.cc): with the
+// CPU's SHA instructions when available (see digest_kernel.h), else `Compress`.
+void CompressBlocksRuntime(std::array<uint32_t, 8>& hash, const char* blocks, std::size_t count) noexcept;
+
+// Constant evaluation uses `Compress`; run time dispatches to the fastest
+// kernel. Both produce identical states (pinned by digest_test.cc).
+constexpr void CompressBlocks(std::array<uint32_t, 8>& hash, const char* blocks, std::size_t count) noexcept {
+  if (!std::is_constant_evaluated()) {
+    CompressBlocksRuntime(hash, blocks, count);
+    return;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    Compress(hash, blocks + (i * kBlockSize));
+  }
+}
+
 // Streaming state shared by SHA-224 and SHA-256. The buffer's fill level is
 // `total_len % kBlockSize` (no separate counter needed).
 struct State {
@@ -138,13 +157,12 @@ constexpr void Update(State& state, std::string_view data) noexcept {
     if (fill + take < kBlockSize) {
       return;
     }
-    Compress(state.hash, state.buffer.data());
-  }
-  while (remaining >= kBlockSize) {
-    Compress(state.hash, ptr);
-    ptr += kBlockSize;
-    remaining -= kBlockSize;
+    CompressBlocks(state.hash, state.buffer.data(), 1);
   }
+  const std::size_t blocks = remaining / kBlockSize;
+  CompressBlocks(state.hash, ptr, blocks);
+  ptr += blocks * kBlockSize;
+  remaining -= blocks * kBlockSize;
   for (std::size_t i = 0; i < remaining; ++i) {
     state.buffer[i] = ptr[i];
   }
@@ -163,7 +181,7 @@ constexpr std::array<uint8_t, DigestSize> Finalize(State state) noexcept {
     for (; fill < kBlockSize; ++fill) {
       state.buffer[fill] = 0;
     }
-    Compress(state.hash, state.buffer.data());
+    CompressBlocks(state.hash, state.buffer.data(), 1);
     fill = 0;
   }
   for (; fill < kBlockSize - 8; ++fill) {
@@ -172,7 +190,7 @@ constexpr std::array<uint8_t, DigestSize> Finalize(State state) noexcept {
   for (std::size_t i = 0; i < 8; ++i) {
     state.buffer[(kBlockSize - 8) + i] = static_cast<char>(total_bits >> (56 - (8 * i)));
   }
-  Compress(state.hash, state.buffer.data());
+  CompressBlocks(state.hash, state.buffer.data(), 1);
 
   std::array<uint8_t, DigestSize> digest = {};
   for (std::size_t i = 0; i < DigestSize; ++i) {
@@ -19,11 +19,15 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "mbo/digest/digest_kernel.h"
 
 // Known-answer vectors: the FIPS 180-4 / NIST CAVP examples plus
 // padding-boundary lengths (55/56/63/64/65 bytes straddle the 0x80+length
@@ -458,6 +462,38 @@ struct AlgoTraits<shake256::Algorithm<kShakeTestOutput>> {
   static constexpr std::string_view kMillionAHex = "3578a7a4ca9137569cdf76ed617d31bb994fca9c1bbf8b184013de8234dfd13a";
 };
 
+// Selects a compression kernel for the lifetime of the object.
+class ScopedKernel final {
+ public:
+  explicit ScopedKernel(digest_internal::Kernel kernel) : previous_(digest_internal::GetKernel()) {
+    digest_internal::SetKernel(kernel);
+  }
+
+  ~ScopedKernel() { digest_internal::SetKernel(previous_); }
+
+  ScopedKernel(const ScopedKernel&) = delete;
+  ScopedKernel& operator=(const ScopedKernel&) = delete;
+  ScopedKernel(ScopedKernel&&) = delete;
+  ScopedKernel& operator=(ScopedKernel&&) = delete;
+
+ private:
+  const digest_internal::Kernel previous_;
+};
+
+// Runs `check` with the accelerated kernels (where the CPU has them) and with
+// the portable transcription, so every vector pins both paths.
+void ForEachKernel(const std::function<void()>& check) {
+  static constexpr std::array kKernels = std::to_array<digest_internal::Kernel>({
+      digest_internal::Kernel::kAuto,
+      digest_internal::Kernel::kPortable,
+  });
+  for (const digest_internal::Kernel kernel : kKernels) {
+    SCOPED_TRACE(kernel == digest_internal::Kernel::kAuto ? "Kernel::kAuto" : "Kernel::kPortable");
+    const ScopedKernel scoped(kernel);
+    check();
+  }
+}
+
 template<typename Algo>
 class DigestTest : public ::testing::Test {};
 
@@ -483,11 +519,13 @@ TYPED_TEST_SUITE(DigestTest, AllAlgorithms);
 
 TYPED_TEST(DigestTest, KnownAnswers) {
   using Traits = AlgoTraits<TypeParam>;
-  for (const TestVector& vector : Traits::kVectors) {
-    EXPECT_THAT(TypeParam::Digest(vector.input), ElementsAreArray(FromHex<TypeParam::kDigestSize>(vector.hex)))
-        << Traits::kName << " input of length " << vector.input.size();
-    EXPECT_THAT(ToHexString(TypeParam::Digest(vector.input)), vector.hex);
-  }
+  ForEachKernel([] {
+    for (const TestVector& vector : Traits::kVectors) {
+      EXPECT_THAT(TypeParam::Digest(vector.input), ElementsAreArray(FromHex<TypeParam::kDigestSize>(vector.hex)))
+          << Traits::kName << " input of length " << vector.input.size();
+      EXPECT_THAT(ToHexString(TypeParam::Digest(vector.input)), vector.hex);
+    }
+  });
 }
 
 TYPED_TEST(DigestTest, ConstexprMatchesRuntime) {
@@ -511,13 +549,15 @@ TYPED_TEST(DigestTest, StreamingMatchesOneShot) {
   }
   const auto expected = TypeParam::Digest(all);
   static constexpr std::array kChunkSizes = std::to_array<std::size_t>({1, 3, 7, 13, 63, 64, 65, 200});
-  for (const std::size_t chunk_size : kChunkSizes) {
-    Streamer<TypeParam> stream;
-    for (std::size_t pos = 0; pos < all.size(); pos += chunk_size) {
-      stream.Update(std::string_view(all).substr(pos, chunk_size));
+  ForEachKernel([&] {
+    for (const std::size_t chunk_size : kChunkSizes) {
+      Streamer<TypeParam> stream;
+      for (std::size_t pos = 0; pos < all.size(); pos += chunk_size) {
+        stream.Update(std::string_view(all).substr(pos, chunk_size));
+      }
+      EXPECT_THAT(stream.Finalize(), ElementsAreArray(expected)) << "chunk size " << chunk_size;
     }
-    EXPECT_THAT(stream.Finalize(), ElementsAreArray(expected)) << "chunk size " << chunk_size;
-  }
+  });
 }
 
 TYPED_TEST(DigestTest, StreamerIsPeekable) {
@@ -531,7 +571,65 @@ TYPED_TEST(DigestTest, StreamerIsPeekable) {
 TYPED_TEST(DigestTest, MillionA) {
   using Traits = AlgoTraits<TypeParam>;
   const std::string input(1'000'000, 'a');
-  EXPECT_THAT(ToHexString(TypeParam::Digest(input)), Traits::kMillionAHex);
+  ForEachKernel([&] { EXPECT_THAT(ToHexString(TypeParam::Digest(input)), Traits::kMillionAHex); });
+}
+
+TYPED_TEST(DigestTest, KernelsAgreeOnAllLengths) {
+  // Every length up to several blocks, over non-repeating content, so each
+  // kernel sees all fill levels and multi-block bulk calls.
+  std::string input;
+  for (std::size_t i = 0; i < 700; ++i) {  // NOLINT(*-magic-numbers)
+    input.push_back(static_cast<char>((i * 131U) ^ (i >> 3U)));  // NOLINT(*-magic-numbers)
+  }
+  for (std::size_t len = 0; len <= input.size(); ++len) {
+    const std::string_view data = std::string_view(input).substr(0, len);
+    const ScopedKernel portable(digest_internal::Kernel::kPortable);
+    const auto expected = TypeParam::Digest(data);
+    const ScopedKernel automatic(digest_internal::Kernel::kAuto);
+    ASSERT_THAT(TypeParam::Digest(data), ElementsAreArray(expected)) << "length " << len;
+  }
+}
+
+TYPED_TEST(DigestTest, DigestManyMatchesDigest) {
+  // Batches below, at and above every lane count, over lengths that hit each
+  // padding case; lanes finish at different times and pick up new messages.
+  std::string input;
+  for (std::size_t i = 0; i < 4'500; ++i) {  // NOLINT(*-magic-numbers)
+    input.push_back(static_cast<char>((i * 167U) ^ (i >> 5U)));  // NOLINT(*-magic-numbers)
+  }
+  std::vector<std::string_view> messages;
+  for (std::size_t i = 0; i < 37; ++i) {  // NOLINT(*-magic-numbers)
+    const std::size_t len = (i * i * 131U) % input.size();  // NOLINT(*-magic-numbers)
+    messages.push_back(std::string_view(input).substr(i, len));
+  }
+  ForEachKernel([&] {
+    EXPECT_THAT(DigestMany<TypeParam>({}), ::testing::IsEmpty());
+    for (std::size_t count = 1; count <= messages.size(); ++count) {
+      const std::span<const std::string_view> batch(messages.data(), count);
+      const std::vector<typename TypeParam::DigestType> digests = DigestMany<TypeParam>(batch);
+      ASSERT_THAT(digests, ::testing::SizeIs(count));
+      for (std::size_t index = 0; index < count; ++index) {
+        ASSERT_THAT(digests[index], ElementsAreArray(TypeParam::Digest(batch[index])))
+            << "message " << index << " of " << count << ", length " << batch[index].size();
+      }
+    }
+  });
+}
+
+TYPED_TEST(DigestTest, DigestManyAllLengths) {
+  std::string input;
+  for (std::size_t i = 0; i < 300; ++i) {  // NOLINT(*-magic-numbers)
+    input.push_back(static_cast<char>((i * 131U) ^ (i >> 3U)));  // NOLINT(*-magic-numbers)
+  }
+  std::vector<std::string_view> messages;
+  for (std::size_t len = 0; len <= input.size(); ++len) {
+    messages.push_back(std::string_view(input).substr(0, len));
+  }
+  const std::vector<typename TypeParam::DigestType> digests = DigestMany<TypeParam>(messages);
+  ASSERT_THAT(digests, ::testing::SizeIs(messages.size()));
+  for (std::size_t len = 0; len < messages.size(); ++len) {
+    ASSERT_THAT(digests[len], ElementsAreArray(TypeParam::Digest(messages[len]))) << "length " << len;
+  }
 }
 
 // BLAKE3 official test-vector suite (BLAKE3-team/BLAKE3
@@ -933,10 +1031,12 @@ using HmacAlgorithms =
 TYPED_TEST_SUITE(HmacTest, HmacAlgorithms);
 
 TYPED_TEST(HmacTest, KnownAnswers) {
-  for (const HmacVector& vector : HmacTraits<TypeParam>::kVectors) {
-    EXPECT_THAT(ToHexString(Hmac<TypeParam>::Digest(vector.key, vector.message)), vector.hex)
-        << "key length " << vector.key.size() << ", message length " << vector.message.size();
-  }
+  ForEachKernel([] {
+    for (const HmacVector& vector : HmacTraits<TypeParam>::kVectors) {
+      EXPECT_THAT(ToHexString(Hmac<TypeParam>::Digest(vector.key, vector.message)), vector.hex)
+          << "key length " << vector.key.size() << ", message length " << vector.message.size();
+    }
+  });
 }
 
 TYPED_TEST(HmacTest, StreamingMatchesOneShotAndPeeks) {
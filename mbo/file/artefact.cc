@@ -16,27 +16,33 @@
 #include "mbo/file/artefact.h"
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #include "absl/status/statusor.h"
 #include "absl/time/time.h"
 #include "mbo/file/file.h"
 
 namespace mbo::file {
+namespace {
+
+absl::StatusOr<absl::Time> GetTime(std::string_view filename, const Artefact::Options& options) {
+  if (options.skip_time) {
+    return absl::UnixEpoch();
+  }
+  return mbo::file::GetMTime(filename);
+}
+
+}  // namespace
 
 absl::StatusOr<Artefact> Artefact::Read(std::string_view filename, const Artefact::Options& options) {
   const auto data = mbo::file::GetContents(filename);
   if (!data.ok()) {
     return data.status();
   }
-  const auto time = [&]() -> absl::StatusOr<absl::Time> {
-    if (options.skip_time) {
-      return absl::UnixEpoch();
-    } else {
-      return mbo::file::GetMTime(filename);
-    }
-  }();
+  const auto time = GetTime(filename, options);
   if (!time.ok()) {
     return time.status();
   }
@@ -56,13 +62,7 @@ absl::StatusOr<Artefact> Artefact::ReadMaxLines(
   if (!data.ok()) {
     return data.status();
   }
-  const auto time = [&]() -> absl::StatusOr<absl::Time> {
-    if (options.skip_time) {
-      return absl::UnixEpoch();
-    } else {
-      return mbo::file::GetMTime(filename);
-    }
-  }();
+  const auto time = GetTime(filename, options);
   if (!time.ok()) {
     return time.status();
   }
@@ -74,4 +74,22 @@ absl::StatusOr<Artefact> Artefact::ReadMaxLines(
   };
 }
 
+absl::StatusOr<Artefact> Artefact::Map(std::string_view filename, const Artefact::Options& options) {
+  auto contents = mbo::file::GetMappedContents(filename);
+  if (!contents.ok()) {
+    return contents.status();
+  }
+  const auto time = GetTime(filename, options);
+  if (!time.ok()) {
+    return time.status();
+  }
+  return Artefact{
+      .data = {},
+      .name = std::string(filename),
+      .time = *time,
+      .tz = options.tz,
+      .mapped = std::make_shared<const MappedContents>(*std::move(contents)),
+  };
+}
+
 }  // namespace mbo::file
@@ -16,11 +16,14 @@
 #ifndef MBO_FILE_ARTEFACT_H_
 #define MBO_FILE_ARTEFACT_H_
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <string_view>
 
 #include "absl/status/statusor.h"
 #include "absl/time/time.h"
+#include "mbo/file/file.h"
 
 namespace mbo::file {
 
@@ -38,10 +41,18 @@ struct Artefact final {
       std::size_t max_lines,
       const Options& options = Options::Default());
 
+  // Like `Read` but without copying the file: `mapped` holds the contents (see
+  // `MappedContents`), `data` stays empty and `Text()` views the mapping.
+  static absl::StatusOr<Artefact> Map(std::string_view filename, const Options& options = Options::Default());
+
+  // The content: the mapped file for `Map`, otherwise `data`.
+  std::string_view Text() const noexcept { return mapped ? mapped->View() : std::string_view(data); }
+
   std::string data;                            // Artefact's 'data' (text or binary content).
   std::string name = "-";                      // Artefact's 'name'.
   absl::Time time = absl::FromUnixSeconds(0);  // Last update/modify 'time'.
   absl::TimeZone tz = absl::UTCTimeZone();
+  std::shared_ptr<const MappedContents> mapped;  // Content of `Map`ped artefacts (shared by copies).
 };
 
 // NOTE: Cannot be `constexpr` because `absl::TimeZone` is not a literal type.
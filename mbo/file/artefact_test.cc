@@ -130,5 +130,39 @@ TEST_F(ArtefactTest, ReadMaxLinesWithZeroReturnsNothing) {
   EXPECT_THAT(artefact.data, IsEmpty());
 }
 
+TEST_F(ArtefactTest, MapViewsTheFileWithoutCopying) {
+  const std::string path = Write("mapped.txt", "hello\nworld\n");
+  MBO_ASSERT_OK_AND_ASSIGN(const Artefact artefact, Artefact::Map(path));
+  EXPECT_THAT(artefact.Text(), "hello\nworld\n");
+  EXPECT_THAT(artefact.data, IsEmpty()) << "the content lives in the mapping only";
+  ASSERT_THAT(artefact.mapped, ::testing::NotNull());
+  EXPECT_THAT(artefact.mapped->IsMapped(), IsTrue());
+  EXPECT_THAT(artefact.name, path);
+}
+
+TEST_F(ArtefactTest, MappedCopiesShareTheMapping) {
+  const std::string path = Write("shared.txt", "abc");
+  MBO_ASSERT_OK_AND_ASSIGN(const Artefact artefact, Artefact::Map(path, {.skip_time = true}));
+  const Artefact copy = artefact;  // NOLINT(performance-unnecessary-copy-initialization): the copy is under test.
+  EXPECT_THAT(copy.Text().data(), artefact.Text().data());
+  EXPECT_THAT(copy.time, absl::FromUnixSeconds(0));
+}
+
+TEST_F(ArtefactTest, MapsAnEmptyFile) {
+  const std::string path = Write("empty.txt", "");
+  MBO_ASSERT_OK_AND_ASSIGN(const Artefact artefact, Artefact::Map(path));
+  EXPECT_THAT(artefact.Text(), IsEmpty());
+}
+
+TEST_F(ArtefactTest, MappingAMissingFileFails) {
+  const auto artefact = Artefact::Map((tmp_dir / "does_not_exist.txt").string());
+  EXPECT_THAT(artefact.ok(), IsFalse());
+}
+
+TEST_F(ArtefactTest, TextIsDataWhenNotMapped) {
+  const Artefact artefact{.data = "in memory"};
+  EXPECT_THAT(artefact.Text(), "in memory");
+}
+
 }  // namespace
 }  // namespace mbo::file
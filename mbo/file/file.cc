@@ -15,6 +15,8 @@
 
 #include "mbo/file/file.h"
 
+#include <array>
+#include <cerrno>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -27,9 +29,12 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <utility>
 
 #ifndef _WIN32
 # include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
 # include <unistd.h>
 #endif
 
@@ -50,6 +55,15 @@ struct FileCloser final {
   }
 };
 
+#ifndef _WIN32
+struct DescriptorCloser final {
+  void operator()(const int* descriptor) const noexcept {
+    // Read-only descriptor: a failing close has nothing left to report.
+    (void)::close(*descriptor);
+  }
+};
+#endif
+
 }  // namespace
 
 std::filesystem::path NormalizePath(const std::filesystem::path& path) {
@@ -173,6 +187,91 @@ absl::StatusOr<std::string> GetMaxLines(const std::filesystem::path& file_name,
   return result;
 }
 
+MappedContents::~MappedContents() noexcept {
+  Reset();
+}
+
+MappedContents::MappedContents(MappedContents&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      owned_(std::move(other.owned_)),
+      data_(std::exchange(other.data_, "")),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedContents& MappedContents::operator=(MappedContents&& other) noexcept {
+  if (this != &other) {
+    Reset();
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    owned_ = std::move(other.owned_);
+    data_ = std::exchange(other.data_, "");
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+void MappedContents::Reset() noexcept {
+#ifndef _WIN32
+  if (mapping_ != nullptr) {
+    (void)::munmap(mapping_, size_);
+  }
+#endif
+  mapping_ = nullptr;
+  owned_.reset();
+  data_ = "";
+  size_ = 0;
+}
+
+absl::StatusOr<MappedContents> GetMappedContents(const std::filesystem::path& file_name) {
+  MappedContents result;
+#ifdef _WIN32
+  absl::StatusOr<std::string> contents = GetContents(file_name);
+  if (!contents.ok()) {
+    return contents.status();
+  }
+  result.owned_ = std::make_unique<std::string>(*std::move(contents));
+#else
+  // The two-argument overload does not consume the variadic mode parameter.
+  const int descriptor = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+  if (descriptor < 0) {
+    return absl::NotFoundError(absl::StrFormat("Unable to read file: '%s'", file_name));
+  }
+  const std::unique_ptr<const int, DescriptorCloser> closer(&descriptor);
+  struct stat info = {};
+  if (::fstat(descriptor, &info) != 0) {
+    return absl::UnknownError(absl::StrFormat("Unable to stat file: '%s'", file_name));
+  }
+  if (S_ISREG(info.st_mode) && info.st_size > 0) {  // NOLINT(*-signed-bitwise)
+    const auto size = static_cast<std::size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapping != MAP_FAILED) {  // NOLINT(*-cstyle-cast,*-int-to-ptr)
+      result.mapping_ = mapping;
+      result.data_ = static_cast<const char*>(mapping);
+      result.size_ = size;
+      return result;
+    }
+  }
+  // Not mappable (or empty, which `mmap` rejects): read to the end, which
+  // also covers files whose size `fstat` does not know (pipes, procfs).
+  result.owned_ = std::make_unique<std::string>();
+  std::array<char, 1 << 16> buffer;  // NOLINT(*-member-init): filled by `read`.
+  while (true) {
+    const ::ssize_t bytes = ::read(descriptor, buffer.data(), buffer.size());
+    if (bytes == 0) {
+      break;
+    }
+    if (bytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::UnknownError(absl::StrFormat("Unable to read file: '%s'", file_name));
+    }
+    result.owned_->append(buffer.data(), static_cast<std::size_t>(bytes));
+  }
+#endif
+  result.data_ = result.owned_->data();
+  result.size_ = result.owned_->size();
+  return result;
+}
+
 absl::StatusOr<absl::Time> GetMTime(const std::filesystem::path& file_name) {
   std::error_code error;
   const auto ftime = std::filesystem::last_write_time(file_name, error);
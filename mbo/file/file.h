@@ -16,7 +16,11 @@
 #ifndef MBO_FILE_FILE_H_
 #define MBO_FILE_FILE_H_
 
+#include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -119,6 +123,48 @@ absl::StatusOr<std::string> GetContents(const std::filesystem::path& file_name);
 //  * absl::StatusCode::kUnknownError: File does not exist or other error.
 absl::StatusOr<std::string> GetMaxLines(const std::filesystem::path& file_name, std::size_t max_lines);
 
+// The read-only contents of a file without copying them into memory: regular
+// files are memory-mapped, anything else (pipes, character devices, procfs
+// files, platforms without `mmap`) is read to its end into an owned buffer.
+// Either way `View()` is stable for the object's lifetime, including across
+// moves. Like all mmap readers, a mapped file that another process truncates
+// faults on access (SIGBUS) instead of returning the old bytes.
+class MappedContents final {
+ public:
+  MappedContents() noexcept = default;
+  ~MappedContents() noexcept;
+
+  MappedContents(const MappedContents&) = delete;
+  MappedContents& operator=(const MappedContents&) = delete;
+  MappedContents(MappedContents&& other) noexcept;
+  MappedContents& operator=(MappedContents&& other) noexcept;
+
+  std::string_view View() const noexcept { return {data_, size_}; }
+
+  std::size_t Size() const noexcept { return size_; }
+
+  // Whether `View()` is a mapping (as opposed to the read fallback).
+  bool IsMapped() const noexcept { return mapping_ != nullptr; }
+
+ private:
+  friend absl::StatusOr<MappedContents> GetMappedContents(const std::filesystem::path& file_name);
+
+  void Reset() noexcept;
+
+  void* mapping_ = nullptr;
+  std::unique_ptr<std::string> owned_;  // The read fallback; heap-held so moves keep `data_` valid.
+  const char* data_ = "";
+  std::size_t size_ = 0;
+};
+
+// Map the contents of the file `file_name` (see `MappedContents`).
+//
+// Returns:
+//  * MappedContents:                  The contents
+//  * absl::StatusCode::kNotFound:     File does not exist or cannot be opened.
+//  * absl::StatusCode::kUnknownError: Other error.
+absl::StatusOr<MappedContents> GetMappedContents(const std::filesystem::path& file_name);
+
 // Return the last modified time.
 //
 // Returns:
@@ -19,7 +19,9 @@
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
 
 #ifndef _WIN32
 # include <sys/stat.h>
@@ -38,7 +40,10 @@ namespace fs = ::std::filesystem;
 using ::mbo::testing::IsOk;
 using ::mbo::testing::IsOkAndHolds;
 using ::mbo::testing::StatusIs;
+using ::std::literals::string_view_literals::operator""sv;
 using ::testing::HasSubstr;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
 
 struct FileTest : public ::testing::Test {
   static std::string TestDir() {
@@ -93,6 +98,58 @@ TEST_F(FileTest, GetContentsRejectsNonSeekableFile) {
 }
 #endif
 
+TEST_F(FileTest, GetMappedContentsMapsRegularFiles) {
+  const fs::path tmp_file = JoinPaths(tmp_dir, "mapped.txt");
+  constexpr std::string_view kContents = "line one\r\nline two\0tail"sv;
+  static_assert(kContents.size() == 23, "Must include the NUL and the tail.");
+  ASSERT_OK(SetContents(tmp_file, kContents));
+  MBO_ASSERT_OK_AND_ASSIGN(const MappedContents contents, GetMappedContents(tmp_file));
+  EXPECT_THAT(contents.IsMapped(), IsTrue());
+  EXPECT_THAT(contents.View(), kContents);
+  EXPECT_THAT(contents.Size(), kContents.size());
+}
+
+TEST_F(FileTest, GetMappedContentsOfEmptyFile) {
+  const fs::path tmp_file = JoinPaths(tmp_dir, "empty.txt");
+  ASSERT_OK(SetContents(tmp_file, ""));
+  MBO_ASSERT_OK_AND_ASSIGN(const MappedContents contents, GetMappedContents(tmp_file));
+  EXPECT_THAT(contents.View(), "");
+}
+
+TEST_F(FileTest, GetMappedContentsOfMissingFile) {
+  EXPECT_THAT(
+      GetMappedContents(JoinPaths(tmp_dir, "missing.txt")),
+      StatusIs(absl::StatusCode::kNotFound, HasSubstr("Unable to read file")));
+}
+
+TEST_F(FileTest, MappedContentsViewSurvivesMoves) {
+  const fs::path tmp_file = JoinPaths(tmp_dir, "moved.txt");
+  ASSERT_OK(SetContents(tmp_file, "moved"));
+  MBO_ASSERT_OK_AND_ASSIGN(MappedContents contents, GetMappedContents(tmp_file));
+  const std::string_view view = contents.View();
+  const MappedContents moved(std::move(contents));
+  EXPECT_THAT(moved.View().data(), view.data());
+  EXPECT_THAT(moved.View(), "moved");
+  EXPECT_THAT(contents.View(), "");  // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved): moved-from is empty.
+  MappedContents assigned;
+  MBO_ASSERT_OK_AND_ASSIGN(assigned, GetMappedContents(tmp_file));
+  EXPECT_THAT(assigned.View(), "moved");
+}
+
+#ifndef _WIN32
+TEST_F(FileTest, GetMappedContentsReadsNonSeekableFile) {
+  const fs::path fifo = JoinPaths(tmp_dir, "mapped.fifo");
+  ASSERT_THAT(::mkfifo(fifo.c_str(), 0600), 0);
+  const std::jthread writer([&fifo] {
+    std::ofstream output(fifo, std::ios_base::binary);
+    output << "piped\ncontent";
+  });
+  MBO_ASSERT_OK_AND_ASSIGN(const MappedContents contents, GetMappedContents(fifo));
+  EXPECT_THAT(contents.IsMapped(), IsFalse());
+  EXPECT_THAT(contents.View(), "piped\ncontent");
+}
+#endif
+
 TEST_F(FileTest, Readable) {
   EXPECT_THAT(
       Readable(tmp_dir),
@@ -19,6 +19,7 @@
 #include <concepts>  // IWYU pragma: keep (std::same_as appears only inside requires-clauses)
 #include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string_view>
 
 #include "mbo/hash/hash_dumbo.h"          // IWYU pragma: export
@@ -56,6 +57,20 @@ concept HasGetHash32 = requires(std::string_view data, uint64_t seed) {
 template<typename Algo>
 concept IsHashAlgorithm = HasGetHash64<Algo> || HasGetHash128<Algo>;
 
+// Batched hashing: an algorithm MAY provide
+//
+//   static void GetHash64Batch(std::span<const std::string_view> data,
+//                              std::span<uint64_t> out, uint64_t seed);
+//
+// hashing `std::min(data.size(), out.size())` keys with exactly the per-key
+// `GetHash64` values, but sharing whatever per-call work the algorithm can
+// hoist out of the key loop (e.g. `mumbo::Algorithm` mixes the seed once).
+// `Hasher::HashMany` falls back to the per-key loop for algorithms without it.
+template<typename Algo>
+concept HasGetHash64Batch = requires(std::span<const std::string_view> data, std::span<uint64_t> out, uint64_t seed) {
+  { Algo::GetHash64Batch(data, out, seed) } noexcept;
+};
+
 // Shrinks a 64-bit hash to 32 bits by XOR-folding the halves, so all 64 input
 // bits contribute. For the strong algorithms plain truncation would also be
 // sound (their finalizers give uniform low bits), but the fold is the correct
@@ -125,6 +140,23 @@ struct Hasher {
       return Hash64To32(GetHash64(data, seed));
     }
   }
+
+  // Writes `GetHash64(data[i], seed)` to `out[i]` for the first
+  // `std::min(data.size(), out.size())` keys, through the algorithm's
+  // `GetHash64Batch` where provided (see `HasGetHash64Batch`).
+  static constexpr void HashMany(
+      std::span<const std::string_view> data,
+      std::span<uint64_t> out,
+      uint64_t seed = kDefaultSeed) noexcept {
+    if constexpr (HasGetHash64Batch<Algo>) {
+      Algo::GetHash64Batch(data, out, seed);
+    } else {
+      const std::size_t count = data.size() < out.size() ? data.size() : out.size();
+      for (std::size_t pos = 0; pos < count; ++pos) {
+        out[pos] = GetHash64(data[pos], seed);  // NOLINT(*-avoid-unchecked-container-access): pos < count
+      }
+    }
+  }
 };
 
 // Streaming (incremental) hashing: an algorithm MAY provide
@@ -196,6 +228,18 @@ constexpr uint64_t GetHash64(std::string_view data, uint64_t seed = kDefaultSeed
   return Hasher<Algo>::GetHash64(data, seed);
 }
 
+// Batched `GetHash64`: `out[i] = GetHash64<Algo>(data[i], seed)` for the first
+// `std::min(data.size(), out.size())` keys (see `Hasher::HashMany`). Prefer it
+// over a per-key loop when many keys are hashed at once: algorithms that
+// specialize it hoist per-call work (seed mixing) out of the key loop.
+template<IsHashAlgorithm Algo = DefaultHashAlgorithm>
+constexpr void GetHash64Batch(
+    std::span<const std::string_view> data,
+    std::span<uint64_t> out,
+    uint64_t seed = kDefaultSeed) noexcept {
+  Hasher<Algo>::HashMany(data, out, seed);
+}
+
 // The 128-bit companion of `GetHash64` (same algorithm selection and stability
 // caveats). For 64-bit-only algorithms the synthesized fallback applies.
 template<IsHashAlgorithm Algo = Default128HashAlgorithm>
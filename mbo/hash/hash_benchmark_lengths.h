@@ -0,0 +1,311 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_HASH_HASH_BENCHMARK_LENGTHS_H_
+#define MBO_HASH_HASH_BENCHMARK_LENGTHS_H_
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+#endif  // __linux__
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "benchmark/benchmark.h"
+#include "mbo/hash/hash_test_util.h"
+
+// The input-length sets, length distributions and dataset context shared by the
+// length-bucketed benchmarks (//mbo/hash:hash_benchmark,
+// //mbo/digest:digest_benchmark), so their datasets go through the same
+// mbo/hash/measurements report pipeline and chart the same way.
+//
+// Two size modes (see mbo/hash/measurements/): the default FAST set is the
+// small, README-published set - cheap enough for CI. Setting the environment
+// variable MBO_HASH_BENCHMARK_FULL=1 selects the dense FULL set that straddles
+// every dispatch-tier boundary and SSO cutoff, for the complete dataset and
+// the ns-vs-length graph.
+namespace mbo::hash::bench {
+
+// NOLINTBEGIN(*-array-index,*-magic-numbers)
+
+// FAST set (default, CI, and the README tables): a dense set straddling every
+// dispatch-tier boundary and SSO cutoff so the small-key cliffs are visible -
+// 7/8 the fully-unrolled <=8 path, 15/16 the <=16 path (15 = libstdc++ SSO
+// cap), 22 the libc++ SSO cap, 38/47/48 and 63/64 the short-chain steps, 127/128
+// bracketing the chain->bulk 128-byte-window edge, with 3/5/11/19/27 filling the
+// small range and 256/1024/4096 the bulk.
+inline constexpr std::array<int, 22> kReadmeSizes = {
+    1, 3, 5, 7, 8, 11, 15, 16, 19, 22, 27, 32, 38, 47, 48, 63, 64, 127, 128, 256, 1'024, 4'096,
+};
+
+// FULL set (MBO_HASH_BENCHMARK_FULL=1): ~3x denser, a slow exponential (ratio
+// ~1.2) from 1..4096 unioned with the boundary set above, so the ns-vs-length
+// curve is smooth and the tier edges stay sampled. For the complete dataset /
+// graph, not for the README tables.
+// Tiny             9
+// GCC/MSVC SSO     7
+// Clang SSO        6
+// Extended/AVX2    9
+// Cache            4
+// Bins             5
+// Medium          14
+// Large           10
+// TOTAL           64
+inline constexpr std::array<int, 64> kFullSizes = {
+    // --- Tiny Keys & Word Alignments ---
+    1, 2, 3,
+    4,  // 32-bit register (optimized fast-paths for integers)
+    5, 6, 7,
+    8,  // 64-bit word (standard 64-bit register boundary)
+    9,
+
+    // --- Register Alignments & GCC/MSVC SSO limits ---
+    11,
+    12,  // 3x 4-byte words / 3D float vectors
+    13,
+    15,  // GCC (libstdc++) & MSVC SSO capacity limit (15 chars + null)
+    16,  // 128-bit vector register boundary (SSE/AVX)
+    18, 19,
+
+    // --- Clang SSO limit & Object sizes ---
+    22,  // Clang (libc++) SSO capacity limit (22 chars + null)
+    23,  // Clang heap spill boundary (first byte to trigger dynamic allocation); Folly fbstring SSO capacity
+    24,  // LLVM's libc++: sizeof(std::string) 3x 8-byte; Folly fbstring SSO capacity
+    25, 27, 29,
+
+    // --- Extended SSO & 256-bit Vector Limits ---
+    31,  // jemalloc 32-byte class boundary
+    32,  // AVX2: 256-bit vector register boundary; MSVC: sizeof(std::string) 4x 8-byte
+    38,
+    40,          // Common loop unrolling (5x 8-byte words)
+    46, 47, 48,  // Alignments around 48 bytes (tcmalloc size class / MSVC heap spill)
+    49,          // Just over 48 bytes (forces allocator to bump to 64-byte class)
+    55,
+
+    // --- CPU Cache Line Boundaries (64 Bytes) ---
+    63,  // Just under cache line (fits entirely within one line)
+    64,  // Exactly one L1 cache line (64 bytes)
+    66,  // Just over cache line (spills into second cache line)
+    72,
+
+    // --- Allocator Bin / Bucket Transitions (jemalloc & tcmalloc) ---
+    79,  // Just under 80-byte allocator bucket
+    80,  // 80-byte allocation class boundary
+    95,  // Just under 96-byte allocator bucket
+    107, 114,
+
+    // --- Dual Cache Line & Medium Keys (Scaling exponentially at ~1.2x) ---
+    127,                 // Just under 2 cache lines
+    128,                 // Exactly 2 cache lines (AVX-512 register size)
+    137, 165, 198, 237,  // Geometric steps mapping allocator classes (144, 176, 208)
+    256,                 // 4 cache lines / 256-byte allocator boundary
+    285, 342, 410, 492, 591, 709, 851,
+
+    // --- Large Keys & Page Boundaries ---
+    1'021,  // Max payload size fitting inside a 1KB allocator block with a null-terminator
+    1'024,  // Exactly 1KB (half a page block step for typical modern slab allocators)
+    1'225, 1'470, 1'764, 2'116, 2'540, 3'048, 3'657,
+    4'096  // Exactly one x86/ARM64 virtual page (often triggering direct mmap)
+};
+
+// Table/chart consistency rule: kReadmeSizes (README tables) must be a subset of
+// kFullSizes (the throughput chart), so every table row has a matching point on
+// the curve. Add a README size to the full set too. Enforced at compile time.
+constexpr bool ReadmeSizesAreSubsetOfFull() {
+  for (const int want : kReadmeSizes) {
+    bool found = false;
+    for (const int have : kFullSizes) {
+      if (have == want) {
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(ReadmeSizesAreSubsetOfFull(), "every kReadmeSizes entry must also appear in kFullSizes");
+
+// The active throughput size set, selected once by the environment.
+inline std::span<const int> ThroughputSizes() {
+  const char* const full = std::getenv("MBO_HASH_BENCHMARK_FULL");  // NOLINT(concurrency-mt-unsafe): startup only
+  if (full != nullptr && std::string_view(full) == "1") {
+    return kFullSizes;
+  }
+  return kReadmeSizes;
+}
+
+// --- Throughput over upper-bounded length ranges ----------------------------
+//
+// The exact-length benchmarks hash ONE input of an exact length in a hot loop:
+// the exact-length -> time curve (the "latency" view). This is the
+// complementary throughput view - how a realistic, upper-BOUNDED range of key
+// lengths translates to a single bytes/s number.
+//
+// Two documented length distributions as inverse-CDF control points (cumulative
+// percentile -> length in bytes), piecewise-linear between points:
+//   - Short: identifiers / DB keys / UUIDs (log-normal), ceiling 128 B.
+//   - Web:   paths, URLs, larger text keys (heavy-tailed), ceiling 4096 B.
+// Each control-point length doubles as an upper BOUND: we run the mix truncated
+// to each bound, with the kept buckets' weights renormalized to 100% (which
+// falls straight out of scaling the percentile draw into [0, cdf[bound].pct)).
+// A run therefore yields (X = upper-bound length, Y = bytes/s), and sweeping the
+// bounds gives the upper-length -> throughput curve. Keys are built once per
+// (distribution, bound) with a fixed seed and shared across every algorithm, so
+// the set is reproducible and identical for all algorithms (only the LENGTHS
+// matter; the bytes are filler). The unpredictable length order defeats the
+// size-dispatch branch predictor - the cost a real mixed workload pays.
+inline constexpr std::size_t kLatencyKeys = 1'024;  // power of two for cheap masking
+inline constexpr std::size_t kCdfPoints = 9;  // inverse-CDF control points per distribution
+
+struct LatencyDist {
+  std::string_view name;
+  std::array<std::pair<double, int>, kCdfPoints> cdf;  // ascending (cumulative pct, length); last = {1.0, Lmax}
+};
+
+inline constexpr std::array<LatencyDist, 2> kLatencyDists = {{
+    {.name = "Short",
+     .cdf = {{
+         {0.10, 8},
+         {0.25, 12},
+         {0.50, 16},
+         {0.75, 23},
+         {0.90, 31},
+         {0.95, 38},
+         {0.99, 53},
+         {0.999, 80},
+         {1.0, 128},  // 100% ceiling: two L1 cache lines / the SSO & AVX-512 transition
+     }}},
+    {.name = "Web",
+     .cdf = {{
+         {0.10, 15},
+         {0.25, 28},
+         {0.50, 45},
+         {0.75, 75},
+         {0.90, 120},
+         {0.95, 220},
+         {0.99, 512},
+         {0.999, 2'048},
+         {1.0, 4'096},  // 100% ceiling: one x86/ARM64 virtual page
+     }}},
+}};
+
+// Inverse CDF: percentile p in [0,1) -> length. Piecewise-linear between control
+// points; below the first point interpolate from (0, 1 byte). Scaling p into
+// [0, cdf[bound].pct) restricts the draw to buckets <= that bound and
+// renormalizes their weights to 100% - the truncation the sweep needs.
+inline std::size_t SampleLength(const LatencyDist& dist, double percentile) {
+  double prev_p = 0.0;
+  double prev_len = 1.0;
+  for (const auto& [pct, len] : dist.cdf) {
+    if (percentile < pct) {
+      const double frac = (percentile - prev_p) / (pct - prev_p);
+      return static_cast<std::size_t>(std::lround(prev_len + (frac * (len - prev_len))));
+    }
+    prev_p = pct;
+    prev_len = len;
+  }
+  return static_cast<std::size_t>(dist.cdf.back().second);
+}
+
+// Key sets built once, one per (distribution, bound), shared by every algorithm.
+// Bound `b` truncates distribution `d` to lengths <= cdf[b].length: 1023 keys
+// drawn from the renormalized truncated distribution, plus one anchor key pinned
+// to the bound length so the boundary is always represented.
+inline const std::vector<std::string>& ThroughputKeys(std::size_t dist_index, std::size_t bound_index) {
+  static const std::array<std::array<std::vector<std::string>, kCdfPoints>, kLatencyDists.size()> kKeySets = [] {
+    std::array<std::array<std::vector<std::string>, kCdfPoints>, kLatencyDists.size()> sets;
+    for (std::size_t dist_idx = 0; dist_idx < kLatencyDists.size(); ++dist_idx) {
+      const LatencyDist& dist = kLatencyDists.at(dist_idx);
+      for (std::size_t point = 0; point < kCdfPoints; ++point) {
+        // NOLINTNEXTLINE(cert-msc51-cpp,cert-msc32-c,bugprone-random-generator-seed): fixed, reproducible set
+        std::mt19937_64 rng(0x1a7e9c1);
+        const double bound_pct = dist.cdf.at(point).first;
+        const auto bound_len = static_cast<std::size_t>(dist.cdf.at(point).second);
+        std::vector<std::string>& keys = sets.at(dist_idx).at(point);
+        keys.reserve(kLatencyKeys);
+        for (std::size_t i = 0; i + 1 < kLatencyKeys; ++i) {
+          const double draw = static_cast<double>(rng()) / (static_cast<double>(UINT64_MAX) + 1.0);
+          keys.push_back(algo::RandomString(rng, SampleLength(dist, draw * bound_pct)));
+        }
+        keys.push_back(algo::RandomString(rng, bound_len));  // anchor at the upper bound
+      }
+    }
+    return sets;
+  }();
+  return kKeySets.at(dist_index).at(bound_index);
+}
+
+// Pins the benchmark to the first available core so a run is not migrated
+// between cores (and their caches) mid-measurement.
+inline void PinToFirstCore() {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(0, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+#endif  // __linux__
+}
+
+// Records what the report tool needs to attribute and render a dataset: the
+// build compiler, the curated README size subset and the throughput length
+// distributions. Call after `benchmark::Initialize`.
+inline void AddLengthContext() {
+  // The build compiler is a first-class axis of a measurement (GCC vs Clang perf
+  // differs), so record what THIS binary was built with in the dataset context;
+  // the stored bundle's filename is tagged with `compiler` too.
+#if defined(__clang__)
+  benchmark::AddCustomContext("compiler", absl::StrCat("clang-", __clang_major__));
+  benchmark::AddCustomContext("compiler_version", __clang_version__);
+#elif defined(__GNUC__)
+  benchmark::AddCustomContext("compiler", absl::StrCat("gcc-", __GNUC__));
+  benchmark::AddCustomContext("compiler_version", __VERSION__);
+#endif
+  // Emit the curated README size subset (kReadmeSizes) so the report tool extracts
+  // the small table straight from a FULL dataset - no separate fast run, and no
+  // second size list to drift (this C++ list is the single source of truth).
+  benchmark::AddCustomContext("readme_sizes", absl::StrJoin(kReadmeSizes, ","));
+  // Export the throughput length distributions in use as "name=pct:len,...;..."
+  // (the full inverse-CDF, not just the bound labels), so a dataset records
+  // exactly which mix produced its `...Throughput<algo>/<name>:<bound>` numbers.
+  for (const auto& throughput_dists : kLatencyDists) {
+    benchmark::AddCustomContext(
+        absl::StrCat("throughput_dists:", throughput_dists.name),
+        absl::StrJoin(throughput_dists.cdf, ",", [](std::string* cdf_out, const std::pair<double, int>& point) {
+          absl::StrAppend(cdf_out, point.first, ":", point.second);
+        }));
+  }
+}
+
+// NOLINTEND(*-array-index,*-magic-numbers)
+
+}  // namespace mbo::hash::bench
+
+#endif  // MBO_HASH_HASH_BENCHMARK_LENGTHS_H_
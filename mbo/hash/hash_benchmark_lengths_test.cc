@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/hash/hash_benchmark_lengths.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace mbo::hash::bench {
+namespace {
+
+using ::testing::SizeIs;
+
+struct HashBenchmarkLengthsTest : ::testing::Test {};
+
+TEST_F(HashBenchmarkLengthsTest, SizeSetsAreAscending) {
+  EXPECT_TRUE(std::ranges::is_sorted(kReadmeSizes));
+  EXPECT_TRUE(std::ranges::is_sorted(kFullSizes));
+  EXPECT_TRUE(std::ranges::adjacent_find(kFullSizes) == kFullSizes.end());
+}
+
+TEST_F(HashBenchmarkLengthsTest, SampleLengthStaysWithinTheDistribution) {
+  for (const LatencyDist& dist : kLatencyDists) {
+    std::size_t prev = 0;
+    for (std::size_t step = 0; step < 1'000; ++step) {
+      const std::size_t length = SampleLength(dist, static_cast<double>(step) / 1'000.0);
+      EXPECT_GE(length, prev) << dist.name << " is not monotonic at step " << step;
+      EXPECT_LE(length, static_cast<std::size_t>(dist.cdf.back().second)) << dist.name;
+      prev = length;
+    }
+  }
+}
+
+TEST_F(HashBenchmarkLengthsTest, ThroughputKeysRespectTheirBound) {
+  for (std::size_t dist = 0; dist < kLatencyDists.size(); ++dist) {
+    for (std::size_t bound = 0; bound < kCdfPoints; ++bound) {
+      const auto bound_len = static_cast<std::size_t>(kLatencyDists.at(dist).cdf.at(bound).second);
+      const std::vector<std::string>& keys = ThroughputKeys(dist, bound);
+      ASSERT_THAT(keys, SizeIs(kLatencyKeys));
+      EXPECT_THAT(keys.back(), SizeIs(bound_len)) << "the anchor key sits at the bound";
+      EXPECT_TRUE(std::ranges::all_of(keys, [&](const std::string& key) { return key.size() <= bound_len; }));
+      EXPECT_EQ(&keys, &ThroughputKeys(dist, bound)) << "key sets are built once";
+    }
+  }
+}
+
+}  // namespace
+}  // namespace mbo::hash::bench
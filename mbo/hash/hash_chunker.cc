@@ -0,0 +1,292 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/hash/hash_chunker.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mbo/config/require.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# include <immintrin.h>
+# define MBO_HASH_CHUNKER_X86_CLONES 1
+#else
+# define MBO_HASH_CHUNKER_X86_CLONES 0
+#endif
+
+namespace mbo::hash {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-avoid-unchecked-container-access)
+
+#if MBO_HASH_CHUNKER_X86_CLONES
+// A byte whose rolling hash passes the loose threshold.
+struct Candidate {
+  std::size_t pos;
+  uint64_t hash;
+};
+
+// Below this the lanes would mostly warm up: scan with the scalar loop.
+constexpr std::size_t kMinLaneScan = 64 * 1024;
+
+void ScanCandidatesScalar(
+    const uint8_t* data,
+    std::size_t begin,
+    std::size_t end,
+    uint64_t hash,
+    const RollingHash::GearTable& gear,
+    uint64_t threshold,
+    std::vector<Candidate>& candidates) {
+  for (std::size_t pos = begin; pos < end; ++pos) {
+    hash = (hash << 1U) + gear[data[pos]];
+    if (hash < threshold) [[unlikely]] {
+      candidates.push_back({.pos = pos, .hash = hash});
+    }
+  }
+}
+
+// The unmasked `_mm512_i64gather_epi64` and `_mm512_srli_epi64` pass an
+// undefined source operand, which gcc 12 reports as `-Wmaybe-uninitialized`.
+// These use the masked forms with all lanes set and a zero source instead.
+template<int kScale>
+__attribute__((target("avx512f"))) __m512i Gather64(__m512i index, const void* base) {
+  return _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF, index, base, kScale);
+}
+
+__attribute__((target("avx512f"))) __m512i ShiftRight64(__m512i value, unsigned bits) {
+  return _mm512_maskz_srli_epi64(0xFF, value, bits);
+}
+
+// 16 lanes in two vectors, each lane scans its own segment of the data (after
+// warming up on the 64 bytes before it). Every 8 steps one gather loads the next
+// 8 bytes of each lane, every step one gather per vector loads the gear values.
+__attribute__((target("avx512f"))) void ScanCandidatesAvx512(
+    const uint8_t* data,
+    std::size_t size,
+    const RollingHash::GearTable& gear,
+    uint64_t threshold,
+    std::vector<Candidate>& candidates) {
+  constexpr std::size_t kLanes = 16;
+  const std::size_t segment = (size / kLanes) & ~std::size_t{7};
+  alignas(64) std::array<uint64_t, kLanes> hashes{};
+  alignas(64) std::array<int64_t, kLanes> starts{};
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    starts[lane] = static_cast<int64_t>(lane * segment);
+    for (std::size_t pos = std::max<std::size_t>(lane * segment, RollingHash::kWindowSize) - RollingHash::kWindowSize;
+         pos < lane * segment; ++pos) {
+      hashes[lane] = (hashes[lane] << 1U) + gear[data[pos]];
+    }
+  }
+  std::array<std::vector<Candidate>, kLanes> lane_candidates;
+  const auto* gear_data = reinterpret_cast<const long long*>(gear.data());  // NOLINT(*-reinterpret-cast)
+  const __m512i threshold_vec = _mm512_set1_epi64(static_cast<int64_t>(threshold));
+  const __m512i byte_mask = _mm512_set1_epi64(0xFF);
+  const __m512i starts_lo = _mm512_load_si512(starts.data());
+  const __m512i starts_hi = _mm512_load_si512(starts.data() + 8);
+  __m512i hash_lo = _mm512_load_si512(hashes.data());
+  __m512i hash_hi = _mm512_load_si512(hashes.data() + 8);
+  for (std::size_t offset = 0; offset < segment; offset += 8) {
+    const __m512i offset_vec = _mm512_set1_epi64(static_cast<int64_t>(offset));
+    const __m512i bytes_lo = Gather64<1>(_mm512_add_epi64(starts_lo, offset_vec), data);
+    const __m512i bytes_hi = Gather64<1>(_mm512_add_epi64(starts_hi, offset_vec), data);
+    for (unsigned step = 0; step < 8; ++step) {
+      const __m512i index_lo = _mm512_and_si512(ShiftRight64(bytes_lo, 8 * step), byte_mask);
+      const __m512i index_hi = _mm512_and_si512(ShiftRight64(bytes_hi, 8 * step), byte_mask);
+      hash_lo = _mm512_add_epi64(_mm512_add_epi64(hash_lo, hash_lo), Gather64<8>(index_lo, gear_data));
+      hash_hi = _mm512_add_epi64(_mm512_add_epi64(hash_hi, hash_hi), Gather64<8>(index_hi, gear_data));
+      const __mmask8 hit_lo = _mm512_cmplt_epu64_mask(hash_lo, threshold_vec);
+      const __mmask8 hit_hi = _mm512_cmplt_epu64_mask(hash_hi, threshold_vec);
+      if ((hit_lo | hit_hi) != 0) [[unlikely]] {
+        _mm512_store_si512(hashes.data(), hash_lo);
+        _mm512_store_si512(hashes.data() + 8, hash_hi);
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+          if (hashes[lane] < threshold) {
+            lane_candidates[lane].push_back({.pos = (lane * segment) + offset + step, .hash = hashes[lane]});
+          }
+        }
+      }
+    }
+  }
+  _mm512_store_si512(hashes.data() + 8, hash_hi);
+  for (const std::vector<Candidate>& lane : lane_candidates) {
+    candidates.insert(candidates.end(), lane.begin(), lane.end());
+  }
+  // The last lane continues into the bytes that did not fill a segment.
+  ScanCandidatesScalar(data, kLanes * segment, size, hashes[kLanes - 1], gear, threshold, candidates);
+}
+
+bool HasAvx512() noexcept {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512f");
+}
+#endif  // MBO_HASH_CHUNKER_X86_CLONES
+
+// Whether the candidate scan is available, else the chunks are cut by the scalar loop.
+bool UseCandidateScan(
+    [[maybe_unused]] ContentChunkerOptions::Kernel kernel,
+    [[maybe_unused]] std::size_t size) noexcept {
+#if MBO_HASH_CHUNKER_X86_CLONES
+  static const bool kHasAvx512 = HasAvx512();
+  return kernel == ContentChunkerOptions::Kernel::kAuto && size >= kMinLaneScan && kHasAvx512;
+#else
+  return false;
+#endif  // MBO_HASH_CHUNKER_X86_CLONES
+}
+
+// NOLINTEND(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-avoid-unchecked-container-access)
+
+}  // namespace
+
+ContentChunker::ContentChunker(Options options)
+    : options_(options),
+      gear_(RollingHash::MakeGearTable(options.seed)),
+      // Normalized chunking level 2: a cut is 4x less likely than `1 / avg_size`
+      // before `avg_size` and 4x more likely after.
+      strict_threshold_((std::numeric_limits<uint64_t>::max() / options.avg_size) >> 2U),
+      loose_threshold_((std::numeric_limits<uint64_t>::max() / options.avg_size) << 2U) {
+  MBO_CONFIG_REQUIRE(options.min_size >= RollingHash::kWindowSize, "The minimum chunk size must be at least 64.");
+  MBO_CONFIG_REQUIRE(
+      options.min_size <= options.avg_size && options.avg_size <= options.max_size,
+      "Chunk sizes must be ordered: min_size <= avg_size <= max_size.");
+}
+
+std::size_t ContentChunker::NextCut(std::string_view data, bool final) const noexcept {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());  // NOLINT(*-reinterpret-cast)
+  if (data.size() <= options_.min_size) {
+    return final ? data.size() : 0;
+  }
+  const std::size_t end = std::min(data.size(), options_.max_size);
+  const std::size_t normal = std::min(end, options_.avg_size - 1);
+  // The first tested byte is the last of the minimum size, its hash covers the 64 bytes up to it.
+  std::size_t pos = options_.min_size - RollingHash::kWindowSize;
+  uint64_t hash = 0;
+  // NOLINTBEGIN(*-pointer-arithmetic,*-constant-array-index)
+  for (; pos < options_.min_size - 1; ++pos) {
+    hash = (hash << 1U) + gear_[bytes[pos]];
+  }
+  for (; pos < normal; ++pos) {
+    hash = (hash << 1U) + gear_[bytes[pos]];
+    if (hash < strict_threshold_) [[unlikely]] {
+      return pos + 1;
+    }
+  }
+  for (; pos < end; ++pos) {
+    hash = (hash << 1U) + gear_[bytes[pos]];
+    if (hash < loose_threshold_) [[unlikely]] {
+      return pos + 1;
+    }
+  }
+  // NOLINTEND(*-pointer-arithmetic,*-constant-array-index)
+  return end == options_.max_size || final ? end : 0;
+}
+
+std::size_t ContentChunker::Cut(std::string_view data, bool final, std::vector<std::size_t>& ends) const {
+  std::size_t start = 0;
+  if (!UseCandidateScan(options_.kernel, data.size())) {
+    while (start < data.size()) {
+      const std::size_t size = NextCut(data.substr(start), final);
+      if (size == 0) {
+        break;
+      }
+      start += size;
+      ends.push_back(start);
+    }
+    return start;
+  }
+#if MBO_HASH_CHUNKER_X86_CLONES
+  std::vector<Candidate> candidates;
+  candidates.reserve((data.size() / options_.avg_size) * 8);
+  // NOLINTNEXTLINE(*-reinterpret-cast)
+  ScanCandidatesAvx512(reinterpret_cast<const uint8_t*>(data.data()), data.size(), gear_, loose_threshold_, candidates);
+  // The same rules as `NextCut`: a candidate ends the chunk if it is at least `min_size` into it and, before
+  // `avg_size`, also passes the strict threshold. Chunks without such a candidate end at `max_size`.
+  for (const Candidate& candidate : candidates) {
+    while (candidate.pos + 1 - start > options_.max_size) {
+      start += options_.max_size;
+      ends.push_back(start);
+    }
+    const std::size_t size = candidate.pos + 1 - start;
+    if (candidate.pos < start || size < options_.min_size
+        || (size < options_.avg_size && candidate.hash >= strict_threshold_)) {
+      continue;
+    }
+    start = candidate.pos + 1;
+    ends.push_back(start);
+  }
+  while (data.size() - start >= options_.max_size) {
+    start += options_.max_size;
+    ends.push_back(start);
+  }
+  if (final && start < data.size()) {
+    start = data.size();
+    ends.push_back(start);
+  }
+#endif  // MBO_HASH_CHUNKER_X86_CLONES
+  return start;
+}
+
+std::vector<std::size_t> ContentChunker::Boundaries(std::string_view data) const {
+  std::vector<std::size_t> ends;
+  Cut(data, /*final=*/true, ends);
+  return ends;
+}
+
+void ContentChunker::Split(std::string_view data, const Sink& sink) const {
+  std::size_t start = 0;
+  for (const std::size_t end : Boundaries(data)) {
+    sink(data.substr(start, end - start));
+    start = end;
+  }
+}
+
+absl::Status ContentChunker::Split(std::istream& input, const Sink& sink) const {
+  std::string buffer(std::max<std::size_t>(4 * options_.max_size, std::size_t{1} << 20U), '\0');
+  std::size_t filled = 0;
+  std::vector<std::size_t> ends;
+  while (true) {
+    // NOLINTNEXTLINE(*-pointer-arithmetic)
+    input.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+    if (input.bad()) {
+      return absl::UnknownError("Unable to read from stream.");
+    }
+    filled += static_cast<std::size_t>(input.gcount());
+    const bool final = input.eof();
+    const std::string_view data(buffer.data(), filled);
+    ends.clear();
+    const std::size_t consumed = Cut(data, final, ends);
+    std::size_t start = 0;
+    for (const std::size_t end : ends) {
+      sink(data.substr(start, end - start));
+      start = end;
+    }
+    if (final) {
+      return absl::OkStatus();
+    }
+    std::memmove(buffer.data(), buffer.data() + consumed, filled - consumed);  // NOLINT(*-pointer-arithmetic)
+    filled -= consumed;
+  }
+}
+
+}  // namespace mbo::hash
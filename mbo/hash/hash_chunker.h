@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_HASH_HASH_CHUNKER_H_
+#define MBO_HASH_HASH_CHUNKER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mbo/hash/hash.h"
+#include "mbo/hash/hash_internal_util.h"
+
+// Content-defined chunking: split data at boundaries chosen by the content
+// itself, so that an insertion or deletion only changes the chunks around it
+// and the other chunks (and their fingerprints) deduplicate against earlier
+// versions of the data.
+//
+//   const mbo::hash::ContentChunker chunker({.min_size = 4096, .avg_size = 16384, .max_size = 131072});
+//   const auto chunks = mbo::hash::FingerprintChunks(chunker, data, mbo::hash::Hash128Fingerprinter<>{});
+//
+// The boundaries are those of FastCDC (Xia et al., "FastCDC: a Fast and
+// Efficient Content-Defined Chunking Approach for Data Deduplication", 2016):
+// a Gear rolling hash with normalized chunking (level 2). Like all values of
+// this library the boundaries are not stable across versions.
+namespace mbo::hash {
+
+// The Gear rolling hash: `hash = (hash << 1) + gear[byte]`. Every byte shifts
+// the older ones one bit further out, so the hash depends on the last
+// `kWindowSize` bytes only and no byte has to be removed explicitly. The 256
+// gear values are derived from the seed.
+class RollingHash final {
+ public:
+  static constexpr std::size_t kWindowSize = 64;
+
+  using GearTable = std::array<uint64_t, 256>;
+
+  static constexpr GearTable MakeGearTable(uint64_t seed) noexcept {
+    GearTable gear{};
+    for (std::size_t byte = 0; byte < gear.size(); ++byte) {
+      // NOLINTNEXTLINE(*-magic-numbers,*-constant-array-index): golden ratio increment.
+      gear[byte] = hash_internal::Fmix64(seed + ((byte + 1) * 0x9E3779B97F4A7C15ULL));
+    }
+    return gear;
+  }
+
+  constexpr explicit RollingHash(uint64_t seed = kDefaultSeed) noexcept : gear_(MakeGearTable(seed)) {}
+
+  constexpr void Roll(uint8_t byte) noexcept {
+    hash_ = (hash_ << 1U) + gear_[byte];  // NOLINT(*-constant-array-index)
+  }
+
+  constexpr RollingHash& Update(std::string_view data) noexcept {
+    for (const char chr : data) {
+      Roll(static_cast<uint8_t>(chr));
+    }
+    return *this;
+  }
+
+  constexpr void Reset() noexcept { hash_ = 0; }
+
+  // The hash of the last `kWindowSize` bytes (or of all bytes if fewer were rolled).
+  constexpr uint64_t value() const noexcept { return hash_; }
+
+  constexpr const GearTable& gear() const noexcept { return gear_; }
+
+ private:
+  GearTable gear_;
+  uint64_t hash_ = 0;
+};
+
+struct ContentChunkerOptions {
+  enum class Kernel : uint8_t {
+    kAuto,      // The AVX-512 candidate scan where the CPU supports it (default).
+    kPortable,  // Always the scalar FastCDC loop (same boundaries).
+  };
+
+  // Chunks are at least `min_size` bytes (except the last), at most `max_size`
+  // and on average about `avg_size`. Requires `64 <= min_size <= avg_size <= max_size`.
+  std::size_t min_size = 2 * 1024;
+  std::size_t avg_size = 8 * 1024;
+  std::size_t max_size = 64 * 1024;
+  uint64_t seed = kDefaultSeed;
+  Kernel kernel = Kernel::kAuto;
+};
+
+// Splits buffers or streams into content-defined chunks.
+//
+// A chunk ends after the first byte at which the rolling hash (of the 64 bytes
+// up to and including that byte) falls below a threshold: a strict one while
+// the chunk is shorter than `avg_size` and a loose one after, which narrows the
+// chunk size distribution around `avg_size`. Bytes before `min_size` are not
+// tested (the scalar loop does not even hash them) and a chunk that reaches
+// `max_size` ends there. Since the hash only sees the chunk's own bytes, the
+// boundaries of a stream do not depend on how it is buffered.
+//
+// With AVX-512 large buffers are scanned by 16 lanes at once (one gather of
+// gear values per lane and byte) for all bytes that pass the loose threshold,
+// then the chunk rules are applied to those candidates.
+class ContentChunker final {
+ public:
+  using Options = ContentChunkerOptions;
+
+  // Receives each chunk. The data is only valid during the call.
+  using Sink = std::function<void(std::string_view chunk)>;
+
+  explicit ContentChunker(Options options = {});
+
+  const Options& options() const noexcept { return options_; }
+
+  // The end offsets of the chunks of `data`: chunk `i` is `[result[i - 1], result[i])`
+  // (from 0 for the first) and the last offset is `data.size()`. Empty for empty data.
+  std::vector<std::size_t> Boundaries(std::string_view data) const;
+
+  void Split(std::string_view data, const Sink& sink) const;
+
+  // Reads `input` to its end and passes its chunks to `sink`. Memory use is
+  // bounded by the read buffer (at least `4 * max_size`).
+  absl::Status Split(std::istream& input, const Sink& sink) const;
+
+ private:
+  // Appends the end offsets of the chunks of `data` to `ends`. Unless `final`,
+  // stops before the first chunk whose end depends on bytes after `data`.
+  // Returns the end of the last chunk.
+  std::size_t Cut(std::string_view data, bool final, std::vector<std::size_t>& ends) const;
+
+  // The end of the chunk starting at `data[0]`, or 0 if it depends on bytes
+  // after `data` and not `final`.
+  std::size_t NextCut(std::string_view data, bool final) const noexcept;
+
+  Options options_;
+  RollingHash::GearTable gear_;
+  uint64_t strict_threshold_;
+  uint64_t loose_threshold_;
+};
+
+// A chunk of the input and its fingerprint.
+template<typename Fingerprint>
+struct FingerprintedChunk {
+  uint64_t offset = 0;
+  std::size_t size = 0;
+  Fingerprint fingerprint{};
+
+  constexpr bool operator==(const FingerprintedChunk& other) const noexcept = default;
+};
+
+// Fingerprints chunks with `GetHash128` (default `jumbo`).
+template<IsHashAlgorithm Algo = Default128HashAlgorithm>
+struct Hash128Fingerprinter {
+  uint64_t seed = kDefaultSeed;
+
+  Hash128 operator()(std::string_view chunk) const noexcept { return Hasher<Algo>::GetHash128(chunk, seed); }
+};
+
+// Fingerprints chunks with a default constructible streamer that has
+// `Update(data)` and `Finalize()`: `mbo::hash::Streamer<Algo>` or a digest,
+// e.g. `mbo::digest::Streamer<mbo::digest::blake3::Algorithm>`.
+template<typename Streamer>
+requires requires(Streamer streamer, std::string_view data) {
+  streamer.Update(data);
+  streamer.Finalize();
+}
+struct StreamerFingerprinter {
+  auto operator()(std::string_view chunk) const {
+    Streamer streamer;
+    streamer.Update(chunk);
+    return streamer.Finalize();
+  }
+};
+
+template<typename Fingerprinter>
+using FingerprintOf = std::invoke_result_t<const Fingerprinter&, std::string_view>;
+
+// Chunks `data` and fingerprints every chunk.
+template<typename Fingerprinter>
+requires std::is_invocable_v<const Fingerprinter&, std::string_view>
+std::vector<FingerprintedChunk<FingerprintOf<Fingerprinter>>> FingerprintChunks(
+    const ContentChunker& chunker,
+    std::string_view data,
+    const Fingerprinter& fingerprinter) {
+  std::vector<FingerprintedChunk<FingerprintOf<Fingerprinter>>> chunks;
+  std::size_t start = 0;
+  for (const std::size_t end : chunker.Boundaries(data)) {
+    const std::string_view chunk = data.substr(start, end - start);
+    chunks.push_back({.offset = start, .size = chunk.size(), .fingerprint = fingerprinter(chunk)});
+    start = end;
+  }
+  return chunks;
+}
+
+// Chunks `input` and passes every fingerprinted chunk to `sink`.
+template<typename Fingerprinter>
+requires std::is_invocable_v<const Fingerprinter&, std::string_view>
+absl::Status FingerprintChunks(
+    const ContentChunker& chunker,
+    std::istream& input,
+    const Fingerprinter& fingerprinter,
+    const std::function<void(const FingerprintedChunk<FingerprintOf<Fingerprinter>>&)>& sink) {
+  uint64_t offset = 0;
+  return chunker.Split(input, [&](std::string_view chunk) {
+    sink({.offset = offset, .size = chunk.size(), .fingerprint = fingerprinter(chunk)});
+    offset += chunk.size();
+  });
+}
+
+}  // namespace mbo::hash
+
+#endif  // MBO_HASH_HASH_CHUNKER_H_
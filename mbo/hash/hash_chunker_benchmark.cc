@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput of `ContentChunker` (portable and auto kernel) and of the chunk + fingerprint pipeline.
+// Run with: bazel run -c opt //mbo/hash:hash_chunker_benchmark
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "benchmark/benchmark.h"
+#include "mbo/hash/hash.h"
+#include "mbo/hash/hash_chunker.h"
+
+namespace mbo::hash {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+constexpr std::size_t kDataSize = 64 << 20;
+
+const std::string& Data() {
+  static const auto* const kData = [] {
+    auto* data = new std::string(kDataSize, '\0');  // NOLINT(cppcoreguidelines-owning-memory)
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+    std::mt19937_64 rng(42);
+    for (char& chr : *data) {
+      chr = static_cast<char>(rng());
+    }
+    return data;
+  }();
+  return *kData;
+}
+
+// The argument is the average chunk size, min and max are a quarter and eight times that.
+template<ContentChunkerOptions::Kernel kKernel>
+void BmBoundaries(benchmark::State& state) {
+  const auto avg_size = static_cast<std::size_t>(state.range(0));
+  const ContentChunker chunker(
+      {.min_size = avg_size / 4, .avg_size = avg_size, .max_size = avg_size * 8, .kernel = kKernel});
+  const std::string& data = Data();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(chunker.Boundaries(data));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+void BmSplitStream(benchmark::State& state) {
+  const ContentChunker chunker;
+  const std::string& data = Data();
+  std::istringstream input(data);
+  for (auto _ : state) {
+    input.clear();
+    input.seekg(0);
+    std::size_t chunks = 0;
+    benchmark::DoNotOptimize(chunker.Split(input, [&](std::string_view /*chunk*/) { ++chunks; }));
+    benchmark::DoNotOptimize(chunks);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+template<typename Fingerprinter>
+void BmFingerprintChunks(benchmark::State& state) {
+  const ContentChunker chunker;
+  const std::string& data = Data();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FingerprintChunks(chunker, data, Fingerprinter{}));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+BENCHMARK(BmBoundaries<ContentChunkerOptions::Kernel::kPortable>)->Arg(1 << 12)->Arg(1 << 13)->Arg(1 << 16);
+BENCHMARK(BmBoundaries<ContentChunkerOptions::Kernel::kAuto>)->Arg(1 << 12)->Arg(1 << 13)->Arg(1 << 16);
+BENCHMARK(BmSplitStream);
+BENCHMARK(BmFingerprintChunks<Hash128Fingerprinter<>>);
+BENCHMARK(BmFingerprintChunks<StreamerFingerprinter<Streamer<mumbo::Algorithm>>>);
+
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::hash
+
+BENCHMARK_MAIN();  // NOLINT
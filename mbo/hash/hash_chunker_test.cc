@@ -0,0 +1,216 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/hash/hash_chunker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/hash/hash.h"
+
+namespace mbo::hash {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::testing::ElementsAre;
+using ::testing::Ge;
+using ::testing::IsEmpty;
+using ::testing::Le;
+using ::testing::Not;
+
+struct ContentChunkerTest : ::testing::Test {
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  static std::string RandomData(std::size_t size, uint64_t seed = 42) {
+    // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Tests must be repeatable.
+    std::mt19937_64 rng(seed);
+    std::string data(size, '\0');
+    for (char& chr : data) {
+      chr = static_cast<char>(rng());
+    }
+    return data;
+  }
+
+  static std::vector<std::string> SplitStream(const ContentChunker& chunker, const std::string& data) {
+    std::istringstream input(data);
+    std::vector<std::string> chunks;
+    EXPECT_TRUE(chunker.Split(input, [&](std::string_view chunk) { chunks.emplace_back(chunk); }).ok());
+    return chunks;
+  }
+};
+
+TEST_F(ContentChunkerTest, RollingHashWindow) {
+  const std::string data = RandomData(1'000);
+  RollingHash full;
+  full.Update(data);
+  RollingHash window;
+  window.Update(std::string_view(data).substr(data.size() - RollingHash::kWindowSize));
+  EXPECT_EQ(full.value(), window.value());
+  std::string changed = data;
+  changed[changed.size() - RollingHash::kWindowSize / 2] ^= 1;
+  RollingHash changed_window;
+  changed_window.Update(changed);
+  EXPECT_NE(full.value(), changed_window.value());
+  full.Reset();
+  EXPECT_EQ(full.value(), 0);
+  EXPECT_NE(RollingHash(1).gear(), RollingHash(2).gear());
+}
+
+TEST_F(ContentChunkerTest, Empty) {
+  const ContentChunker chunker;
+  EXPECT_THAT(chunker.Boundaries(""), IsEmpty());
+  EXPECT_THAT(SplitStream(chunker, ""), IsEmpty());
+}
+
+TEST_F(ContentChunkerTest, Small) {
+  const ContentChunker chunker;
+  EXPECT_THAT(chunker.Boundaries("x"), ElementsAre(1));
+  EXPECT_THAT(chunker.Boundaries(RandomData(2'048)), ElementsAre(2'048));
+  EXPECT_THAT(SplitStream(chunker, "abc"), ElementsAre("abc"));
+}
+
+TEST_F(ContentChunkerTest, SizeBounds) {
+  const ContentChunker chunker({.min_size = 1'024, .avg_size = 4'096, .max_size = 16'384});
+  const std::string data = RandomData(8 << 20);
+  const std::vector<std::size_t> ends = chunker.Boundaries(data);
+  ASSERT_THAT(ends, Not(IsEmpty()));
+  EXPECT_EQ(ends.back(), data.size());
+  std::size_t start = 0;
+  for (std::size_t idx = 0; idx < ends.size(); ++idx) {
+    const std::size_t size = ends[idx] - start;
+    EXPECT_THAT(size, Le(16'384)) << "Chunk: " << idx;
+    if (idx + 1 < ends.size()) {
+      EXPECT_THAT(size, Ge(1'024)) << "Chunk: " << idx;
+    }
+    start = ends[idx];
+  }
+  // Normalized chunking keeps the mean close to `avg_size` (plus the skipped minimum).
+  const double mean = static_cast<double>(data.size()) / static_cast<double>(ends.size());
+  EXPECT_THAT(mean, Ge(3'000));
+  EXPECT_THAT(mean, Le(6'000));
+}
+
+// Data without content boundaries is cut at `max_size`.
+TEST_F(ContentChunkerTest, MaxSize) {
+  for (const auto kernel : {ContentChunkerOptions::Kernel::kAuto, ContentChunkerOptions::Kernel::kPortable}) {
+    const ContentChunker chunker({.min_size = 64, .avg_size = 64, .max_size = 1'000, .kernel = kernel});
+    const std::string data(100'500, 'x');
+    const std::vector<std::size_t> ends = chunker.Boundaries(data);
+    ASSERT_EQ(ends.size(), 101);
+    EXPECT_EQ(ends[0], 1'000);
+    EXPECT_EQ(ends[99], 100'000);
+    EXPECT_EQ(ends[100], 100'500);
+  }
+}
+
+TEST_F(ContentChunkerTest, KernelsAgree) {
+  for (const std::size_t avg_size : {256, 8'192, 65'536}) {
+    for (const std::size_t size : {1'000, 65'536, 100'003, 4 << 20}) {
+      const std::string data = RandomData(size, avg_size + size);
+      const ContentChunker portable(
+          {.min_size = avg_size / 4, .avg_size = avg_size, .max_size = avg_size * 8,
+           .kernel = ContentChunkerOptions::Kernel::kPortable});
+      const ContentChunker automatic({.min_size = avg_size / 4, .avg_size = avg_size, .max_size = avg_size * 8});
+      EXPECT_EQ(portable.Boundaries(data), automatic.Boundaries(data)) << "Avg: " << avg_size << ", size: " << size;
+    }
+  }
+}
+
+TEST_F(ContentChunkerTest, StreamMatchesBuffer) {
+  for (const std::size_t size : {0, 1, 3'000, 1 << 20, (3 << 20) + 17}) {
+    for (const auto kernel : {ContentChunkerOptions::Kernel::kAuto, ContentChunkerOptions::Kernel::kPortable}) {
+      const ContentChunker chunker({.kernel = kernel});
+      const std::string data = RandomData(size);
+      std::vector<std::string> expected;
+      chunker.Split(data, [&](std::string_view chunk) { expected.emplace_back(chunk); });
+      EXPECT_EQ(SplitStream(chunker, data), expected) << "Size: " << size;
+    }
+  }
+}
+
+// An insertion only changes the chunks around it, all others are found again.
+TEST_F(ContentChunkerTest, Locality) {
+  const ContentChunker chunker;
+  const std::string data = RandomData(1 << 20);
+  std::string edited = data;
+  edited.insert(edited.size() / 2, "inserted");
+  const auto before = FingerprintChunks(chunker, data, Hash128Fingerprinter<>{});
+  const auto after = FingerprintChunks(chunker, edited, Hash128Fingerprinter<>{});
+  std::set<Hash128> known;
+  for (const auto& chunk : before) {
+    known.insert(chunk.fingerprint);
+  }
+  std::size_t changed = 0;
+  for (const auto& chunk : after) {
+    changed += known.contains(chunk.fingerprint) ? 0 : 1;
+  }
+  EXPECT_THAT(changed, Le(2));
+  EXPECT_THAT(after.size(), Ge(before.size() - 2));
+}
+
+TEST_F(ContentChunkerTest, Seed) {
+  const std::string data = RandomData(1 << 20);
+  EXPECT_NE(ContentChunker({.seed = 1}).Boundaries(data), ContentChunker({.seed = 2}).Boundaries(data));
+}
+
+TEST_F(ContentChunkerTest, FingerprintChunks) {
+  const ContentChunker chunker;
+  const std::string data = RandomData(1 << 20);
+  const auto chunks = FingerprintChunks(chunker, data, Hash128Fingerprinter<>{});
+  const std::vector<std::size_t> ends = chunker.Boundaries(data);
+  ASSERT_EQ(chunks.size(), ends.size());
+  uint64_t offset = 0;
+  for (std::size_t idx = 0; idx < chunks.size(); ++idx) {
+    EXPECT_EQ(chunks[idx].offset, offset);
+    EXPECT_EQ(chunks[idx].offset + chunks[idx].size, ends[idx]);
+    EXPECT_EQ(
+        chunks[idx].fingerprint,
+        Hasher<Default128HashAlgorithm>::GetHash128(std::string_view(data).substr(offset, chunks[idx].size)));
+    offset = ends[idx];
+  }
+  std::istringstream input(data);
+  std::vector<FingerprintedChunk<Hash128>> streamed;
+  ASSERT_TRUE(FingerprintChunks(chunker, input, Hash128Fingerprinter<>{}, [&](const auto& chunk) {
+                streamed.push_back(chunk);
+              }).ok());
+  EXPECT_EQ(streamed, chunks);
+}
+
+TEST_F(ContentChunkerTest, StreamerFingerprinter) {
+  const ContentChunker chunker;
+  const std::string data = RandomData(100'000);
+  const auto chunks = FingerprintChunks(chunker, data, StreamerFingerprinter<Streamer<mumbo::Algorithm>>{});
+  ASSERT_THAT(chunks, Not(IsEmpty()));
+  for (const auto& chunk : chunks) {
+    Streamer<mumbo::Algorithm> streamer;
+    streamer.Update(std::string_view(data).substr(chunk.offset, chunk.size));
+    EXPECT_EQ(chunk.fingerprint, streamer.Finalize());
+  }
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::hash
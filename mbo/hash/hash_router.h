@@ -0,0 +1,336 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_HASH_HASH_ROUTER_H_
+#define MBO_HASH_HASH_ROUTER_H_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mbo/config/require.h"
+#include "mbo/hash/hash.h"
+#include "mbo/hash/hash_internal_util.h"
+
+// Consistent hashing: map keys to shards (buckets, nodes) so that changing the
+// number of shards only moves the keys that have to move, unlike
+// `GetHash64(key) % shards` which moves almost all of them.
+//
+//   const mbo::hash::ShardRouter router({{"node-a"}, {"node-b", 2.0}, {"node-c"}});
+//   const std::size_t node = router.Route(key);  // Index into `router.nodes()`.
+//
+// Like all values of this library the routes are not stable across versions.
+namespace mbo::hash {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+// Jump consistent hash (Lamping, Veach: "A Fast, Minimal Memory, Consistent
+// Hash Algorithm", 2014): the bucket in `[0, buckets)` of a (well mixed) key
+// hash. Going from `n` to `n + 1` buckets moves `1 / (n + 1)` of the keys, all
+// into the new bucket. Buckets are numbered, so only the last one can be
+// removed; use `ShardRouter` for named nodes. Returns -1 if `buckets <= 0`.
+constexpr int32_t JumpConsistentHash(uint64_t key_hash, int32_t buckets) noexcept {
+  int64_t bucket = -1;
+  int64_t next = 0;
+  while (next < buckets) {
+    bucket = next;
+    key_hash = (key_hash * 2862933555777941757ULL) + 1;
+    const double jump = static_cast<double>(1ULL << 31U) / static_cast<double>((key_hash >> 33U) + 1);
+    next = static_cast<int64_t>(static_cast<double>(bucket + 1) * jump);
+  }
+  return static_cast<int32_t>(bucket);
+}
+
+namespace hash_internal {
+
+// Maps a rendezvous score onto `(0, 1)`.
+inline double RendezvousUnit(uint64_t score) noexcept {
+  return (static_cast<double>(score >> 11U) + 0.5) * 0x1.0p-53;
+}
+
+// Whether a node with `weight` and rendezvous `unit` may beat `best_score`. Since `-log(unit) >= 1 - unit` its
+// weighted score is at most `weight / (1 - unit)`; the margin covers rounding, so no possible winner is skipped and
+// the logarithm is only needed for about `weight / total_weight` of the nodes once a good score was found.
+inline bool MayWinWeighted(double unit, double weight, double best_score) noexcept {
+  return weight * (1.0 + 0x1.0p-30) > best_score * (1.0 - unit);
+}
+
+}  // namespace hash_internal
+
+// The rendezvous (highest random weight) score of a key for a node: the node
+// with the highest score wins. Node seeds must be well mixed (e.g. `GetHash64`
+// of the node name).
+constexpr uint64_t RendezvousScore(uint64_t key_hash, uint64_t node_seed) noexcept {
+  return hash_internal::Fmix64(key_hash ^ node_seed);
+}
+
+// The weighted rendezvous score (Schindelhauer, Schomaker: "Weighted
+// Distributed Hash Tables", 2005): `weight / -log(u)` for the score mapped to
+// `u` in `(0, 1)`. A node wins a share of the keys proportional to its weight.
+inline double WeightedRendezvousScore(uint64_t key_hash, uint64_t node_seed, double weight) noexcept {
+  return weight / -std::log(hash_internal::RendezvousUnit(RendezvousScore(key_hash, node_seed)));
+}
+
+// The index of the node with the highest `RendezvousScore`, the first on ties.
+// Adding a node only moves keys to it, removing one only moves its own keys.
+// Returns 0 for no nodes.
+constexpr std::size_t RendezvousSelect(uint64_t key_hash, std::span<const uint64_t> node_seeds) noexcept {
+  std::size_t best = 0;
+  uint64_t best_score = 0;
+  for (std::size_t node = 0; node < node_seeds.size(); ++node) {
+    const uint64_t score = RendezvousScore(key_hash, node_seeds[node]);
+    if (node == 0 || score > best_score) {
+      best = node;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+// The index of the node with the highest `WeightedRendezvousScore`. Requires
+// `weights.size() == node_seeds.size()` and positive weights.
+inline std::size_t WeightedRendezvousSelect(
+    uint64_t key_hash,
+    std::span<const uint64_t> node_seeds,
+    std::span<const double> weights) noexcept {
+  std::size_t best = 0;
+  double best_score = -1.0;
+  for (std::size_t node = 0; node < node_seeds.size() && node < weights.size(); ++node) {
+    const double unit = hash_internal::RendezvousUnit(RendezvousScore(key_hash, node_seeds[node]));
+    if (!hash_internal::MayWinWeighted(unit, weights[node], best_score)) {
+      continue;
+    }
+    const double score = weights[node] / -std::log(unit);
+    if (score > best_score) {
+      best = node;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+// A named node of a `ShardRouter`.
+struct ShardNode {
+  std::string name;
+  double weight = 1.0;
+};
+
+struct ShardRouterOptions {
+  // Seeds the key hashes, the node seeds and the lookup table.
+  uint64_t seed = kDefaultSeed;
+
+  // If not 0, the number of slots of a lookup table that maps each key hash to
+  // a slot and each slot to its rendezvous winner. Routing then costs O(1)
+  // instead of O(nodes), building the table O(slots * nodes) (about 1 ns per
+  // slot and node). The keys of a slot move together, so use many more slots
+  // than nodes (e.g. 64 per node) for an even distribution and fine grained
+  // movement.
+  std::size_t lookup_table_size = 0;
+};
+
+// Routes keys to named, weighted nodes with weighted rendezvous hashing. The
+// per-node seeds (hash of the node name) are computed once. When all weights
+// are equal, the integer `RendezvousScore` is used and no logarithm is needed;
+// otherwise the logarithm is skipped for nodes that cannot win.
+//
+// `RouteMany` / `RouteHashes` route a batch of keys with the nodes in the outer
+// loop, so a node's state stays in registers while a block of keys is scored.
+// With `lookup_table_size` the router precomputes the winner of every slot.
+//
+// Routes only depend on the names, weights and seed: routers built from the
+// same nodes in any order agree (up to the order of the indices). Node names
+// must be unique and weights positive and finite.
+template<typename Hasher = DefaultHasher>
+class ShardRouter final {
+ public:
+  using Options = ShardRouterOptions;
+
+  explicit ShardRouter(std::vector<ShardNode> nodes, Options options = {})
+      : nodes_(std::move(nodes)), options_(options) {
+    MBO_CONFIG_REQUIRE(!nodes_.empty(), "A ShardRouter needs at least one node.");
+    MBO_CONFIG_REQUIRE(
+        nodes_.size() <= std::numeric_limits<uint32_t>::max(), "A ShardRouter supports at most 2^32 - 1 nodes.");
+    node_seeds_.reserve(nodes_.size());
+    weights_.reserve(nodes_.size());
+    for (const ShardNode& node : nodes_) {
+      MBO_CONFIG_REQUIRE(
+          node.weight > 0.0 && std::isfinite(node.weight), "ShardRouter node weights must be positive and finite.");
+      node_seeds_.push_back(Hasher::GetHash64(node.name, options_.seed));
+      weights_.push_back(node.weight);
+      uniform_ = uniform_ && node.weight == nodes_.front().weight;
+    }
+    std::vector<std::string_view> names;
+    names.reserve(nodes_.size());
+    for (const ShardNode& node : nodes_) {
+      names.emplace_back(node.name);
+    }
+    std::ranges::sort(names);
+    MBO_CONFIG_REQUIRE(
+        std::ranges::adjacent_find(names) == names.end(), "ShardRouter node names must be unique.");
+    if (options_.lookup_table_size > 0) {
+      BuildLookupTable();
+    }
+  }
+
+  const std::vector<ShardNode>& nodes() const noexcept { return nodes_; }
+
+  const ShardNode& node(std::size_t index) const noexcept { return nodes_[index]; }
+
+  std::size_t size() const noexcept { return nodes_.size(); }
+
+  const Options& options() const noexcept { return options_; }
+
+  bool has_lookup_table() const noexcept { return !table_.empty(); }
+
+  // The hash the router uses for `key`.
+  uint64_t KeyHash(std::string_view key) const noexcept { return Hasher::GetHash64(key, options_.seed); }
+
+  // The index of the node for `key`.
+  std::size_t Route(std::string_view key) const noexcept { return RouteHash(KeyHash(key)); }
+
+  std::size_t RouteHash(uint64_t key_hash) const noexcept {
+    if (!table_.empty()) {
+      return table_[Slot(key_hash)];
+    }
+    if (uniform_) {
+      return RendezvousSelect(key_hash, node_seeds_);
+    }
+    return WeightedRendezvousSelect(key_hash, node_seeds_, weights_);
+  }
+
+  // Writes `Route(keys[i])` to `out[i]` for the first `std::min(keys.size(), out.size())` keys.
+  void RouteMany(std::span<const std::string_view> keys, std::span<std::size_t> out) const noexcept {
+    std::array<uint64_t, kBlockSize> hashes;  // NOLINT(*-member-init)
+    const std::size_t count = std::min(keys.size(), out.size());
+    for (std::size_t pos = 0; pos < count; pos += kBlockSize) {
+      const std::size_t block = std::min(kBlockSize, count - pos);
+      Hasher::HashMany(keys.subspan(pos, block), std::span(hashes).first(block), options_.seed);
+      RouteHashes(std::span<const uint64_t>(hashes).first(block), out.subspan(pos, block));
+    }
+  }
+
+  // Writes `RouteHash(key_hashes[i])` to `out[i]` for the first `std::min(key_hashes.size(), out.size())` hashes.
+  void RouteHashes(std::span<const uint64_t> key_hashes, std::span<std::size_t> out) const noexcept {
+    const std::size_t count = std::min(key_hashes.size(), out.size());
+    if (!table_.empty()) {
+      for (std::size_t pos = 0; pos < count; ++pos) {
+        out[pos] = table_[Slot(key_hashes[pos])];
+      }
+      return;
+    }
+    for (std::size_t pos = 0; pos < count; pos += kBlockSize) {
+      const std::size_t block = std::min(kBlockSize, count - pos);
+      if (uniform_) {
+        SelectBlock(key_hashes.subspan(pos, block), out.subspan(pos, block));
+      } else {
+        SelectWeightedBlock(key_hashes.subspan(pos, block), out.subspan(pos, block));
+      }
+    }
+  }
+
+ private:
+  static constexpr std::size_t kBlockSize = 64;
+
+  std::size_t Slot(uint64_t key_hash) const noexcept {
+    // Maps the hash onto `[0, table_.size())` by its high bits (multiply-shift, no modulo).
+    return static_cast<std::size_t>(hash_internal::Mult128(key_hash, table_.size()).h2);
+  }
+
+  // The block loops always run over `kBlockSize` keys (padded with zeros) and use 64 bit values only, so the
+  // compiler vectorizes them.
+  void SelectBlock(std::span<const uint64_t> key_hashes, std::span<std::size_t> out) const noexcept {
+    alignas(64) std::array<uint64_t, kBlockSize> hashes{};
+    alignas(64) std::array<uint64_t, kBlockSize> best_score;  // NOLINT(*-member-init)
+    alignas(64) std::array<uint64_t, kBlockSize> best{};
+    std::ranges::copy(key_hashes, hashes.begin());
+    for (std::size_t pos = 0; pos < kBlockSize; ++pos) {
+      best_score[pos] = RendezvousScore(hashes[pos], node_seeds_[0]);
+    }
+    for (uint64_t node = 1; node < node_seeds_.size(); ++node) {
+      const uint64_t node_seed = node_seeds_[node];
+      for (std::size_t pos = 0; pos < kBlockSize; ++pos) {
+        const uint64_t score = RendezvousScore(hashes[pos], node_seed);
+        const bool wins = score > best_score[pos];
+        best_score[pos] = wins ? score : best_score[pos];
+        best[pos] = wins ? node : best[pos];
+      }
+    }
+    std::copy_n(best.begin(), key_hashes.size(), out.begin());
+  }
+
+  // Computes the units and which keys a node may win for the whole block, then takes the logarithm only for those.
+  void SelectWeightedBlock(std::span<const uint64_t> key_hashes, std::span<std::size_t> out) const noexcept {
+    static_assert(kBlockSize == 64, "One bit per key in a `uint64_t` mask.");
+    alignas(64) std::array<uint64_t, kBlockSize> hashes{};
+    alignas(64) std::array<double, kBlockSize> units;  // NOLINT(*-member-init)
+    alignas(64) std::array<double, kBlockSize> best_score;  // NOLINT(*-member-init)
+    alignas(64) std::array<uint64_t, kBlockSize> best{};
+    std::ranges::copy(key_hashes, hashes.begin());
+    best_score.fill(-1.0);
+    for (uint64_t node = 0; node < node_seeds_.size(); ++node) {
+      const uint64_t node_seed = node_seeds_[node];
+      const double weight = weights_[node];
+      uint64_t candidates = 0;
+      for (std::size_t pos = 0; pos < kBlockSize; ++pos) {
+        units[pos] = hash_internal::RendezvousUnit(RendezvousScore(hashes[pos], node_seed));
+        candidates |= static_cast<uint64_t>(hash_internal::MayWinWeighted(units[pos], weight, best_score[pos])) << pos;
+      }
+      while (candidates != 0) {
+        const auto pos = static_cast<std::size_t>(std::countr_zero(candidates));
+        candidates &= candidates - 1;
+        const double score = weight / -std::log(units[pos]);
+        if (score > best_score[pos]) {
+          best_score[pos] = score;
+          best[pos] = node;
+        }
+      }
+    }
+    std::copy_n(best.begin(), key_hashes.size(), out.begin());
+  }
+
+  void BuildLookupTable() {
+    const std::size_t slots = options_.lookup_table_size;
+    std::vector<uint64_t> slot_hashes(slots);
+    for (std::size_t slot = 0; slot < slots; ++slot) {
+      // Each slot is routed like a key with its own well mixed hash.
+      slot_hashes[slot] = hash_internal::Fmix64(options_.seed + slot);
+    }
+    std::vector<std::size_t> winners(slots);
+    RouteHashes(slot_hashes, winners);
+    table_.assign(winners.begin(), winners.end());
+  }
+
+  std::vector<ShardNode> nodes_;
+  Options options_;
+  std::vector<uint64_t> node_seeds_;
+  std::vector<double> weights_;
+  std::vector<uint32_t> table_;
+  bool uniform_ = true;
+};
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace mbo::hash
+
+#endif  // MBO_HASH_HASH_ROUTER_H_
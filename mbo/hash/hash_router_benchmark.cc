@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Routes per second of `JumpConsistentHash` and `ShardRouter` (single, batched, weighted and with a lookup table).
+// Run with: bazel run -c opt //mbo/hash:hash_router_benchmark
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mbo/hash/hash.h"
+#include "mbo/hash/hash_router.h"
+
+namespace mbo::hash {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+constexpr std::size_t kNumKeys = 1 << 12;
+
+const std::vector<std::string>& Keys() {
+  static const auto* const kKeys = [] {
+    auto* keys = new std::vector<std::string>();  // NOLINT(cppcoreguidelines-owning-memory)
+    for (std::size_t idx = 0; idx < kNumKeys; ++idx) {
+      keys->push_back("user/" + std::to_string(idx * 7919));
+    }
+    return keys;
+  }();
+  return *kKeys;
+}
+
+// The number of nodes is the argument. With `kWeighted` every other node has weight 2.
+template<bool kWeighted>
+std::vector<ShardNode> Nodes(std::size_t count) {
+  std::vector<ShardNode> nodes;
+  for (std::size_t idx = 0; idx < count; ++idx) {
+    nodes.push_back({.name = "node-" + std::to_string(idx), .weight = kWeighted && idx % 2 == 1 ? 2.0 : 1.0});
+  }
+  return nodes;
+}
+
+void BmJumpConsistentHash(benchmark::State& state) {
+  const auto buckets = static_cast<int32_t>(state.range(0));
+  const std::vector<std::string>& keys = Keys();
+  std::size_t item = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(JumpConsistentHash(GetHash64(keys[item]), buckets));
+    item = (item + 1) % kNumKeys;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// `kTableSlotsPerNode` 0 routes without a lookup table.
+template<bool kWeighted, std::size_t kTableSlotsPerNode>
+void BmRoute(benchmark::State& state) {
+  const auto num_nodes = static_cast<std::size_t>(state.range(0));
+  const ShardRouter router(Nodes<kWeighted>(num_nodes), {.lookup_table_size = num_nodes * kTableSlotsPerNode});
+  const std::vector<std::string>& keys = Keys();
+  std::size_t item = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(router.Route(keys[item]));
+    item = (item + 1) % kNumKeys;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<bool kWeighted, std::size_t kTableSlotsPerNode>
+void BmRouteMany(benchmark::State& state) {
+  const auto num_nodes = static_cast<std::size_t>(state.range(0));
+  const ShardRouter router(Nodes<kWeighted>(num_nodes), {.lookup_table_size = num_nodes * kTableSlotsPerNode});
+  const std::vector<std::string_view> keys(Keys().begin(), Keys().end());
+  std::vector<std::size_t> routes(keys.size());
+  for (auto _ : state) {
+    router.RouteMany(keys, routes);
+    benchmark::DoNotOptimize(routes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(keys.size()));
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+BENCHMARK(BmJumpConsistentHash)->Arg(10)->Arg(1'000)->Arg(100'000);
+BENCHMARK(BmRoute<false, 0>)->Arg(10)->Arg(100)->Arg(1'000);
+BENCHMARK(BmRoute<true, 0>)->Arg(10)->Arg(100)->Arg(1'000);
+BENCHMARK(BmRoute<true, 64>)->Arg(10)->Arg(100)->Arg(1'000)->Arg(2'000);
+BENCHMARK(BmRouteMany<false, 0>)->Arg(10)->Arg(100)->Arg(1'000);
+BENCHMARK(BmRouteMany<true, 0>)->Arg(10)->Arg(100)->Arg(1'000);
+BENCHMARK(BmRouteMany<true, 64>)->Arg(10)->Arg(100)->Arg(1'000)->Arg(2'000);
+
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-owning-memory)
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::hash
+
+BENCHMARK_MAIN();  // NOLINT
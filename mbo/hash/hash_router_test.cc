@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/hash/hash_router.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/hash/hash.h"
+
+namespace mbo::hash {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::testing::DoubleNear;
+
+constexpr std::size_t kNumKeys = 100'000;
+
+std::vector<std::string> Keys() {
+  std::vector<std::string> keys;
+  keys.reserve(kNumKeys);
+  for (std::size_t idx = 0; idx < kNumKeys; ++idx) {
+    keys.push_back("key_" + std::to_string(idx));
+  }
+  return keys;
+}
+
+std::vector<ShardNode> Nodes(std::size_t count) {
+  std::vector<ShardNode> nodes;
+  for (std::size_t idx = 0; idx < count; ++idx) {
+    nodes.push_back({.name = "node_" + std::to_string(idx)});
+  }
+  return nodes;
+}
+
+template<typename Router>
+class ShardRouterTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  static std::vector<std::string> Route(const Router& router, const std::vector<std::string>& keys) {
+    std::vector<std::string> routes;
+    routes.reserve(keys.size());
+    for (const std::string& key : keys) {
+      routes.push_back(router.node(router.Route(key)).name);
+    }
+    return routes;
+  }
+};
+
+using ShardRouterTypes = ::testing::Types<ShardRouter<>, ShardRouter<Hasher<siphash::Algorithm>>>;
+TYPED_TEST_SUITE(ShardRouterTest, ShardRouterTypes);
+
+TEST(JumpConsistentHashTest, Basics) {
+  static_assert(JumpConsistentHash(42, 1) == 0);
+  EXPECT_EQ(JumpConsistentHash(42, 0), -1);
+  EXPECT_EQ(JumpConsistentHash(42, -3), -1);
+  std::vector<std::size_t> counts(10);
+  for (uint64_t key = 0; key < kNumKeys; ++key) {
+    const int32_t bucket = JumpConsistentHash(GetHash64(std::to_string(key)), 10);
+    ASSERT_GE(bucket, 0);
+    ASSERT_LT(bucket, 10);
+    ++counts[static_cast<std::size_t>(bucket)];
+  }
+  for (const std::size_t count : counts) {
+    EXPECT_THAT(static_cast<double>(count), DoubleNear(kNumKeys / 10.0, kNumKeys / 100.0));
+  }
+}
+
+// Growing from n to n + 1 buckets moves about 1 / (n + 1) of the keys, all into the new bucket.
+TEST(JumpConsistentHashTest, Movement) {
+  for (const int32_t buckets : {1, 9, 99}) {
+    std::size_t moved = 0;
+    for (uint64_t key = 0; key < kNumKeys; ++key) {
+      const uint64_t key_hash = GetHash64(std::to_string(key));
+      const int32_t before = JumpConsistentHash(key_hash, buckets);
+      const int32_t after = JumpConsistentHash(key_hash, buckets + 1);
+      if (before != after) {
+        EXPECT_EQ(after, buckets);
+        ++moved;
+      }
+    }
+    EXPECT_THAT(static_cast<double>(moved) / kNumKeys, DoubleNear(1.0 / (buckets + 1), 0.01)) << buckets;
+  }
+}
+
+TEST(RendezvousTest, WeightedSelect) {
+  const std::vector<uint64_t> seeds = {GetHash64("a"), GetHash64("b"), GetHash64("c")};
+  const std::vector<double> weights = {1.0, 2.0, 1.0};
+  std::vector<std::size_t> counts(3);
+  for (uint64_t key = 0; key < kNumKeys; ++key) {
+    ++counts[WeightedRendezvousSelect(GetHash64(std::to_string(key)), seeds, weights)];
+  }
+  EXPECT_THAT(static_cast<double>(counts[0]) / kNumKeys, DoubleNear(0.25, 0.01));
+  EXPECT_THAT(static_cast<double>(counts[1]) / kNumKeys, DoubleNear(0.50, 0.01));
+  EXPECT_THAT(static_cast<double>(counts[2]) / kNumKeys, DoubleNear(0.25, 0.01));
+  EXPECT_EQ(RendezvousSelect(42, {}), 0);
+}
+
+TYPED_TEST(ShardRouterTest, Distribution) {
+  const TypeParam router(Nodes(10));
+  std::vector<std::size_t> counts(router.size());
+  for (const std::string& key : Keys()) {
+    ++counts[router.Route(key)];
+  }
+  for (const std::size_t count : counts) {
+    EXPECT_THAT(static_cast<double>(count), DoubleNear(kNumKeys / 10.0, kNumKeys / 100.0));
+  }
+}
+
+TYPED_TEST(ShardRouterTest, Weights) {
+  std::vector<ShardNode> nodes = Nodes(4);
+  nodes[0].weight = 3.0;
+  const TypeParam router(nodes);
+  std::size_t heavy = 0;
+  for (const std::string& key : Keys()) {
+    heavy += router.Route(key) == 0 ? 1 : 0;
+  }
+  EXPECT_THAT(static_cast<double>(heavy) / kNumKeys, DoubleNear(0.5, 0.01));
+}
+
+// The routes depend on the nodes, not on their order.
+TYPED_TEST(ShardRouterTest, NodeOrder) {
+  std::vector<ShardNode> nodes = Nodes(8);
+  nodes[3].weight = 2.5;
+  const TypeParam router(nodes);
+  std::ranges::reverse(nodes);
+  const TypeParam reversed(nodes);
+  const std::vector<std::string> keys = Keys();
+  EXPECT_EQ(TestFixture::Route(router, keys), TestFixture::Route(reversed, keys));
+}
+
+// Adding a node only moves keys to it, about 1 / nodes of them; removing it moves exactly those keys back.
+TYPED_TEST(ShardRouterTest, Movement) {
+  const std::vector<std::string> keys = Keys();
+  for (const std::size_t lookup_table_size : {0, 65'536}) {
+    for (const double weight : {1.0, 2.0}) {
+      std::vector<ShardNode> nodes = Nodes(20);
+      const TypeParam before(nodes, {.lookup_table_size = lookup_table_size});
+      nodes.push_back({.name = "new", .weight = weight});
+      const TypeParam after(nodes, {.lookup_table_size = lookup_table_size});
+      const std::vector<std::string> routes_before = TestFixture::Route(before, keys);
+      const std::vector<std::string> routes_after = TestFixture::Route(after, keys);
+      std::size_t moved = 0;
+      for (std::size_t idx = 0; idx < keys.size(); ++idx) {
+        if (routes_before[idx] != routes_after[idx]) {
+          EXPECT_EQ(routes_after[idx], "new");
+          ++moved;
+        }
+      }
+      const double expected = weight / (20.0 + weight);
+      EXPECT_THAT(static_cast<double>(moved) / kNumKeys, DoubleNear(expected, 0.01))
+          << "Table: " << lookup_table_size << ", weight: " << weight;
+    }
+  }
+}
+
+TYPED_TEST(ShardRouterTest, RouteMany) {
+  std::vector<ShardNode> nodes = Nodes(37);
+  const std::vector<std::string> keys = Keys();
+  const std::vector<std::string_view> views(keys.begin(), keys.end());
+  for (const double weight : {1.0, 0.5}) {
+    nodes[0].weight = weight;
+    const TypeParam router(nodes);
+    std::vector<std::size_t> routes(keys.size());
+    router.RouteMany(views, routes);
+    for (std::size_t idx = 0; idx < keys.size(); ++idx) {
+      ASSERT_EQ(routes[idx], router.Route(keys[idx])) << "Key: " << keys[idx];
+    }
+  }
+}
+
+TYPED_TEST(ShardRouterTest, LookupTable) {
+  const TypeParam router(Nodes(100), {.lookup_table_size = 6'400});
+  EXPECT_TRUE(router.has_lookup_table());
+  const std::vector<std::string> keys = Keys();
+  const std::vector<std::string_view> views(keys.begin(), keys.end());
+  std::vector<std::size_t> routes(keys.size());
+  router.RouteMany(views, routes);
+  std::vector<std::size_t> counts(router.size());
+  for (std::size_t idx = 0; idx < keys.size(); ++idx) {
+    ASSERT_EQ(routes[idx], router.Route(keys[idx]));
+    ++counts[routes[idx]];
+  }
+  for (const std::size_t count : counts) {
+    // 64 slots per node on average, so the per node share varies by about 1 / 8.
+    EXPECT_THAT(static_cast<double>(count), DoubleNear(kNumKeys / 100.0, kNumKeys / 200.0));
+  }
+}
+
+TYPED_TEST(ShardRouterTest, SingleNode) {
+  const TypeParam router({{.name = "only"}});
+  EXPECT_EQ(router.Route("key"), 0);
+  const TypeParam table({{.name = "only"}}, {.lookup_table_size = 1});
+  EXPECT_EQ(table.Route("key"), 0);
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::hash
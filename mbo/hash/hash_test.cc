@@ -15,6 +15,7 @@
 
 #include "mbo/hash/hash.h"
 
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <concepts>
@@ -23,10 +24,12 @@
 #include <functional>
 #include <random>
 #include <set>
+#include <span>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -298,6 +301,55 @@ TYPED_TEST(HashTest, StreamingMatchesOneShot) {
   }
 }
 
+// Batch: `Hasher::HashMany` must equal the per-key `GetHash64` for every
+// algorithm, across batch sizes from empty to all keys and key lengths (in a
+// shuffled order) that cover every length tier.
+TYPED_TEST(HashTest, BatchMatchesPerKey) {
+  // NOLINTNEXTLINE(cert-msc51-cpp,cert-msc32-c,bugprone-random-generator-seed): reproducible
+  std::mt19937_64 rng(0xBA7C4U);
+  std::vector<std::string> keys;
+  for (std::size_t length = 0; length <= 300; ++length) {
+    keys.push_back(algo::RandomString(rng, length));
+  }
+  std::shuffle(keys.begin(), keys.end(), rng);
+  const std::vector<std::string_view> views(keys.begin(), keys.end());
+  static constexpr auto kBatchSizes = std::to_array<std::size_t>({0, 1, 3, 4, 5, 8, 13, 301});
+  for (const std::size_t batch : kBatchSizes) {
+    std::vector<uint64_t> hashes(batch);
+    Hasher<TypeParam>::HashMany(std::span(views).first(batch), hashes, kSeed);
+    for (std::size_t i = 0; i < batch; ++i) {
+      ASSERT_THAT(hashes.at(i), Eq(TypeParam::GetHash64(views.at(i), kSeed)))
+          << TypeParam::Name() << " batch=" << batch << " key=" << i << " len=" << views.at(i).size();
+    }
+  }
+  // A short output span bounds the batch; nothing past it is written.
+  std::vector<uint64_t> short_out(3, 0);
+  GetHash64Batch<TypeParam>(std::span(views).first(5), std::span(short_out).first(2), kSeed);
+  EXPECT_THAT(short_out.at(1), Eq(TypeParam::GetHash64(views.at(1), kSeed)));
+  EXPECT_THAT(short_out.at(2), Eq(0U));
+}
+
+static_assert(HasGetHash64Batch<mumbo::Algorithm> && HasGetHash64Batch<jumbo::Algorithm>);
+static_assert(!HasGetHash64Batch<xxh64::Algorithm> && !HasGetHash64Batch<murmur3::Algorithm>);
+
+TEST_F(HasherTest, BatchIsConstexpr) {
+  static constexpr auto kKeys = std::to_array<std::string_view>({
+      "",
+      "a",
+      "batch",
+      "a key just over sixteen bytes",
+      "another",
+  });
+  constexpr std::array<uint64_t, kKeys.size()> kHashes = [] {
+    std::array<uint64_t, kKeys.size()> hashes{};
+    GetHash64Batch(kKeys, hashes, kSeed);
+    return hashes;
+  }();
+  for (std::size_t i = 0; i < kKeys.size(); ++i) {
+    EXPECT_THAT(kHashes.at(i), Eq(GetHash64(kKeys.at(i), kSeed))) << kKeys.at(i);
+  }
+}
+
 // Streaming support is intentional per algorithm: canonical forms exist for
 // xxh64 and siphash, mh defines its own; rapidhash has no canonical streaming.
 static_assert(std::same_as<DefaultHashAlgorithm, mumbo::Algorithm>);
@@ -30,7 +30,7 @@
 #include <string_view>
 
 #include "absl/strings/str_format.h"
-#include "mbo/container/limited_map.h"
+#include "mbo/container/perfect_hash_map.h"
 #include "mbo/hash/hash.h"
 
 namespace {
@@ -39,7 +39,7 @@ using HashFn = uint64_t (*)(std::string_view);
 
 // Plain `GetHash64` per algorithm, each with its own canonical default seed
 // (dumbo 0, fnv1a offset basis, ...). Captureless lambdas decay to `HashFn`.
-constexpr auto kAlgorithms = mbo::container::ToLimitedMap<std::string_view, HashFn>({
+constexpr auto kAlgorithms = mbo::container::ToPerfectHashMap<std::string_view, HashFn>({
     {"dumbo", [](std::string_view data) { return mbo::hash::dumbo::Algorithm::GetHash64(data); }},
     {"fambo", [](std::string_view data) { return mbo::hash::fambo::Algorithm::GetHash64(data); }},
     {"fnv1a", [](std::string_view data) { return mbo::hash::fnv1a::Algorithm::GetHash64(data); }},
@@ -63,7 +63,7 @@ import tempfile
 
 # README tables read their sizes from the data itself (see _throughput_table),
 # so there is no size list here to drift. The curated README set = kReadmeSizes
-# in hash_benchmark.cc (the FAST mode); the tables are rendered from a fast-mode
+# in hash_benchmark_lengths.h (the FAST mode); the tables are rendered from a fast-mode
 # dataset, the ns-vs-length chart from the dense FULL dataset.
 
 # Ordering uses the benchmark's algorithm keys (data keys); _LABEL_128 only
@@ -71,6 +71,12 @@ import tempfile
 _ORDER_TEMBO = ["tembo_3_4", "tembo_4_4", "tembo_5_4", "tembo_6_4", "tembo_7_4", "tembo_8_4", "tembo_8_8", "tembo_12_4", "tembo_12_8", "tembo_16_4", "tembo_16_8"]
 _ORDER_64 = ["mumbo", "fambo", "rapidhash", "xxh3", "xxh64", "murmur3", "siphash24", "fnv1a", "dumbo"] + _ORDER_TEMBO
 _ORDER_128 = ["mumbo", "xxh3", "murmur3"]
+_ORDER_DIGEST = [
+    "sha256", "sha256-portable", "sha224", "sha1", "sha1-portable", "md5", "sha512", "sha384", "sha512-256",
+    "sha3-256", "sha3-512", "shake128", "shake256", "blake2b", "blake2b-256", "blake3", "blake3-lanes",
+]
+# `DigestMany` next to its one-`Digest`-per-message baseline ("<algo>-loop").
+_ORDER_MANY = ["sha256", "sha256-loop", "blake2b", "blake2b-loop", "blake2b-256", "blake2b-256-loop"]
 _LABEL_128 = {"mumbo": "jumbo"}  # BmHash128<mumbo> is the jumbo (128-bit) face
 
 # Exact-length LATENCY: BmHash64/BmHash128<algo>/<len> - cost of hashing one exact
@@ -79,7 +85,15 @@ _LATENCY_RE = re.compile(r"^BmHash(64|128)<([-_A-Za-z0-9]+)>/(\d+)$")
 # Bounded-range THROUGHPUT: BmHash{64,128}Throughput<algo>/<Dist>:<bound> - bytes/s
 # over a length distribution truncated to each upper bound (Dist in {Short, Web}).
 _THROUGHPUT_RE = re.compile(r"^BmHash(64|128)Throughput<([-_A-Za-z0-9]+)>/([A-Za-z][-_A-Za-z0-9]*):(\d+)$")
-_BENCHMARK_TARGET = "//mbo/hash:hash_benchmark"
+# //mbo/digest:digest_benchmark shares the length sets and distributions (see
+# mbo/hash/hash_benchmark_lengths.h) and emits the same two shapes: exact-length
+# ns for one-shot `Digest` (BmDigest) and `Hmac` (BmHmac), bytes/s for the
+# bounded-range mixes (BmDigestThroughput), for `Streamer` by chunk size
+# (BmDigestStreamer<algo>/Chunk:<size>) and for `DigestMany` batches by message
+# length (BmDigestMany<algo>/Length:<length>).
+_DIGEST_LATENCY_RE = re.compile(r"^Bm(Digest|Hmac)<([-_A-Za-z0-9]+)>/(\d+)$")
+_DIGEST_THROUGHPUT_RE = re.compile(r"^BmDigest(Throughput|Streamer|Many)<([-_A-Za-z0-9]+)>/([A-Za-z][-_A-Za-z0-9]*):(\d+)$")
+_BENCHMARK_TARGETS = {"hash": "//mbo/hash:hash_benchmark", "digest": "//mbo/digest:digest_benchmark"}
 _TEMBO_4 = [f"tembo_{lanes}_4" for lanes in [3, 4, 5, 6, 7, 8, 12, 16]]
 _TEMBO_8 = [f"tembo_{lanes}_8" for lanes in [8, 12, 16]]
 _TEMBO_ALL = _TEMBO_4 + _TEMBO_8
@@ -204,9 +218,12 @@ def _expand_list_arg(prefix, args):
     return [f"{prefix}={arg}" for arg in args] if args else []
 
 
-def _run_benchmark(mode, reps, min_time, warmup, config=None, copt=None, host_copt=None):
+def _run_benchmark(mode, reps, min_time, warmup, config=None, copt=None, host_copt=None, benchmark="hash"):
     """Runs the bazel benchmark with the measurement precautions; returns parsed JSON.
 
+    `benchmark` selects the binary from `_BENCHMARK_TARGETS`; both honor
+    MBO_HASH_BENCHMARK_FULL.
+
     `config` selects a bazel `--config` (e.g. 'clang' / 'gcc'), so the toolchain -
     and therefore the compiler the benchmark records into the dataset - is the one
     you want to measure."""
@@ -222,7 +239,7 @@ def _run_benchmark(mode, reps, min_time, warmup, config=None, copt=None, host_co
         *_expand_list_arg("--config", config),
         *_expand_list_arg("--copt", copt),
         *_expand_list_arg("--host_copt", host_copt),
-        _BENCHMARK_TARGET,
+        _BENCHMARK_TARGETS[benchmark],
         "--",
         "--benchmark_out_format=json",
         "--benchmark_out=/tmp/results.json",
@@ -251,18 +268,25 @@ def _distill_buckets(raw):
     lat_section = {"64": "latency64", "128": "latency128"}
     tput = {"throughput64": {}, "throughput128": {}}
     tput_section = {"64": "throughput64", "128": "throughput128"}
+    lat_section["Digest"] = "digest_latency"
+    lat_section["Hmac"] = "hmac_latency"
+    tput_section["Throughput"] = "digest_throughput"
+    tput_section["Streamer"] = "digest_streamer"
+    tput_section["Many"] = "digest_many"
     for bench in raw.get("benchmarks", []):
         if bench.get("run_type") != "iteration":
             continue
-        match = _LATENCY_RE.match(bench["name"])
+        match = _LATENCY_RE.match(bench["name"]) or _DIGEST_LATENCY_RE.match(bench["name"])
         if match:
             width, algo, length = match.groups()
-            lat[lat_section[width]].setdefault(algo, {}).setdefault(length, []).append(float(bench["real_time"]))
+            lat.setdefault(lat_section[width], {}).setdefault(algo, {}).setdefault(length, []).append(
+                float(bench["real_time"])
+            )
             continue
-        match = _THROUGHPUT_RE.match(bench["name"])
+        match = _THROUGHPUT_RE.match(bench["name"]) or _DIGEST_THROUGHPUT_RE.match(bench["name"])
         if match:
             width, algo, dist, bound = match.groups()
-            tput[tput_section[width]].setdefault(algo, {}).setdefault(f"{dist}:{bound}", []).append(
+            tput.setdefault(tput_section[width], {}).setdefault(algo, {}).setdefault(f"{dist}:{bound}", []).append(
                 float(bench["bytes_per_second"])
             )
 
@@ -605,14 +629,14 @@ def _dists(data):
     return _order(seen, ["Short", "Web"])
 
 
-def _throughput_table(data, dist, preferred, relabel):
+def _throughput_table(data, dist, preferred, relabel, bound_header="max len"):
     # THROUGHPUT table for one distribution: upper-bound-per-row, algorithm-per-
     # column, GiB/s; bold marks the fastest (highest) at each bound. Keys are
     # "<Dist>:<bound>"; rows are that distribution's bounds ascending.
     algos = _order(list(data), preferred)
     prefix = f"{dist}:"
     bounds = sorted({int(k[len(prefix):]) for a in algos for k in data.get(a, {}) if k.startswith(prefix)})
-    headers = ["max len"] + [relabel.get(a, a) for a in algos]
+    headers = [bound_header] + [relabel.get(a, a) for a in algos]
     aligns = ["r"] + ["r"] * len(algos)
     rows = []
     for bound in bounds:
@@ -637,8 +661,8 @@ def _agg_label(ctx):
     return f"mean of the {meas.get('best_k', '?')} best of {meas.get('reps', '?')} reps"
 
 
-def _readme_sizes(ctx):
-    raw = ctx.get("readme_sizes")  # curated subset emitted by the benchmark (kReadmeSizes)
+def _readme_sizes(ctx, key="readme_sizes"):
+    raw = ctx.get(key)  # curated subset emitted by the benchmark (kReadmeSizes)
     return [int(x) for x in str(raw).split(",") if x.strip().isdigit()] if raw else None
 
 
@@ -689,6 +713,42 @@ def _sections(results):
         out.append(latency("latency128", 128, _ORDER_128, _LABEL_128, extra="native-128 only; "))
     for dist in _dists(results.get("throughput128", {})):
         out.append(throughput("throughput128", dist, 128, _ORDER_128, _LABEL_128))
+
+    # Digest datasets: the table rows are the benchmark's `table_sizes` (0 B,
+    # kReadmeSizes, and the bulk lengths up to 64 MiB).
+    digest_sizes = _readme_sizes(ctx, "table_sizes") or sizes
+    digest = {"order": _ORDER_DIGEST, "relabel": {}, "library": "mbo/digest"}
+    for tag, what in (("digest_latency", "Digest"), ("hmac_latency", "Hmac")):
+        if results.get(tag):
+            out.append({
+                "tag": tag, "title": f"{what} latency", "kind": "latency", "x_label": "message length",
+                "heading": f"`{what}` latency (ns/message at exact length, {agg}; lower is better)",
+                "table": _length_table(results[tag], _ORDER_DIGEST, {}, digest_sizes),
+                "chart": results[tag], **digest,
+            })
+    for dist in _dists(results.get("digest_throughput", {})):
+        out.append({
+            "tag": f"digest_throughput_{dist}", "title": f"Digest throughput ({dist})", "kind": "throughput",
+            "heading": f"`Digest` throughput, {dist} lengths (GiB/s over lengths <= max, {agg}; higher is better)",
+            "table": _throughput_table(results["digest_throughput"], dist, _ORDER_DIGEST, {}),
+            "chart": _dist_chart_data(results["digest_throughput"], dist), **digest,
+        })
+    if results.get("digest_streamer"):
+        out.append({
+            "tag": "digest_streamer", "title": "Streamer throughput by chunk size", "kind": "throughput",
+            "x_label": "chunk size",
+            "heading": f"`Streamer` throughput, 1 MiB message by `Update` chunk size (GiB/s, {agg}; higher is better)",
+            "table": _throughput_table(results["digest_streamer"], "Chunk", _ORDER_DIGEST, {}, bound_header="chunk"),
+            "chart": _dist_chart_data(results["digest_streamer"], "Chunk"), **digest,
+        })
+    if results.get("digest_many"):
+        out.append({
+            "tag": "digest_many", "title": "DigestMany throughput by message length", "kind": "throughput",
+            "x_label": "message length",
+            "heading": f"`DigestMany` throughput, batches of 64 messages by length (GiB/s, {agg}; higher is better)",
+            "table": _throughput_table(results["digest_many"], "Length", _ORDER_MANY, {}, bound_header="length"),
+            "chart": _dist_chart_data(results["digest_many"], "Length"), **digest, "order": _ORDER_MANY,
+        })
     return out
 
 
@@ -765,6 +825,8 @@ def render_compare(base, new):
     for key, order, relabel, title in (
         ("latency64", _ORDER_64, {}, "64-bit latency"),
         ("latency128", _ORDER_128, _LABEL_128, "128-bit latency"),
+        ("digest_latency", _ORDER_DIGEST, {}, "Digest latency"),
+        ("hmac_latency", _ORDER_DIGEST, {}, "Hmac latency"),
     ):
         table = _compare_bucket(base.get(key) or {}, new.get(key) or {}, order, relabel)
         if table:
@@ -772,6 +834,9 @@ def render_compare(base, new):
     for key, order, relabel, width in (
         ("throughput64", _ORDER_64, {}, "64-bit"),
         ("throughput128", _ORDER_128, _LABEL_128, "128-bit"),
+        ("digest_throughput", _ORDER_DIGEST, {}, "Digest"),
+        ("digest_streamer", _ORDER_DIGEST, {}, "Streamer"),
+        ("digest_many", _ORDER_MANY, {}, "DigestMany"),
     ):
         for dist in _dists(base.get(key) or {}):
             table = _compare_bucket(
@@ -810,7 +875,8 @@ def _svg_plot(*, data, algos, title, path, label_map=None, subtitle=None, linear
     drawn under the title so a chart is self-labeling.
     """
     label_map = label_map or {}
-    sizes = sorted({int(s) for a in data.values() for s in a})
+    # The x-axis is log: a 0-byte case (digest datasets) has no position on it.
+    sizes = sorted({int(s) for a in data.values() for s in a if int(s) > 0})
     if not sizes or not algos:
         return
     pad_l, pad_r, pad_t, pad_b = 66, 132, 62, 52
@@ -1113,14 +1179,15 @@ def _render_charts(full, stem, charts_dir, subtitle):
             continue
         name = f"{stem}_{section['tag']}.svg"
         y_label, x_label = ("GiB / s", "max length") if section["kind"] == "throughput" else ("ns / op", "key length")
+        x_label = section.get("x_label", x_label)
 
         # Append directionality to the machine label subtitle
         better = "lower is better" if section["kind"] == "latency" else "higher is better"
         full_subtitle = f"{subtitle} · {better}" if subtitle else better
 
         _svg_plot(
-            data=data, algos=_order(list(data), section["order"]), title=f"mbo/hash - {section['title']}",
-            path=os.path.join(charts_dir, name), label_map=section["relabel"], subtitle=full_subtitle, y_label=y_label, x_label=x_label,
+            data=data, algos=_order(list(data), section["order"]),
+            title=f"{section.get('library', 'mbo/hash')} - {section['title']}", path=os.path.join(charts_dir, name), label_map=section["relabel"], subtitle=full_subtitle, y_label=y_label, x_label=x_label,
         )
         written.append((section["tag"], name))
     return written
@@ -1141,7 +1208,9 @@ def _add_dataset_arg(parser):
 
 
 def dispatch_run(args, stamp):
-    raw = _run_benchmark(args.mode, args.reps, args.min_time, args.warmup, args.config, args.copt, args.host_copt)
+    raw = _run_benchmark(
+        args.mode, args.reps, args.min_time, args.warmup, args.config, args.copt, args.host_copt, args.benchmark
+    )
     if args.raw:
         raw_path = _timestamped(args.raw, stamp)
         opener = gzip.open if raw_path.endswith(".gz") else open
@@ -1191,13 +1260,14 @@ def dispatch_plot(args, stamp):
         if not data or (args.kind != "all" and section["kind"] != args.kind):
             continue
         y_label, x_label = ("GiB / s", "max length") if section["kind"] == "throughput" else ("ns / op", "key length")
+        x_label = section.get("x_label", x_label)
 
         # Determine direction suffix
         better = "lower is better" if section["kind"] == "latency" else "higher is better"
 
         _svg_plot(
-            data=data, algos=_order(list(data), section["order"]), title=f"mbo/hash - {section['title']}",
-            path=f"{base}_{section['tag']}{ext}", label_map=section["relabel"], subtitle=better, linear_y=linear_y, y_label=y_label, x_label=x_label,
+            data=data, algos=_order(list(data), section["order"]),
+            title=f"{section.get('library', 'mbo/hash')} - {section['title']}", path=f"{base}_{section['tag']}{ext}", label_map=section["relabel"], subtitle=better, linear_y=linear_y, y_label=y_label, x_label=x_label,
         )
     return 0
 
@@ -1611,6 +1681,12 @@ def add_command_help(sub):
 def add_command_run(sub):
     parser = sub.add_parser("run", help="run the benchmark, then store and/or render")
     parser.add_argument("--mode", choices=["fast", "full"], default="full")
+    parser.add_argument(
+        "--benchmark",
+        choices=sorted(_BENCHMARK_TARGETS),
+        default="hash",
+        help="which benchmark binary to run: 'hash' (//mbo/hash:hash_benchmark, default) or 'digest' (//mbo/digest:digest_benchmark)",
+    )
     # 9 reps is google/benchmark's recommended minimum for its compare.py U-test,
     # so two stored datasets can be compared for statistical significance.
     parser.add_argument("--reps", type=int, default=9)
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_JSON_INTERNAL_JSON_ARENA_H_
+#define MBO_JSON_INTERNAL_JSON_ARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mbo::json::json_internal {
+
+// A bump allocator: allocations are carved from large blocks and only released all together when the `Arena` is
+// destroyed. Objects are never destructed, so only trivially destructible types can be allocated.
+class Arena final {
+ public:
+  static constexpr std::size_t kMinBlockSize = 4'096;
+  static constexpr std::size_t kMaxBlockSize = std::size_t{1} << 20;
+
+  // The first block has `initial_block_size` bytes (at least `kMinBlockSize`), each further one twice the previous
+  // (up to `kMaxBlockSize` unless an allocation needs more).
+  explicit Arena(std::size_t initial_block_size = kMinBlockSize) noexcept
+      : next_block_size_(std::max(initial_block_size, kMinBlockSize)) {}
+
+  ~Arena() noexcept = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  Arena(Arena&& other) noexcept
+      : blocks_(std::move(other.blocks_)),
+        ptr_(std::exchange(other.ptr_, nullptr)),
+        end_(std::exchange(other.end_, nullptr)),
+        next_block_size_(std::exchange(other.next_block_size_, kMinBlockSize)),
+        bytes_reserved_(std::exchange(other.bytes_reserved_, 0)) {}
+
+  Arena& operator=(Arena&& other) noexcept {
+    if (this != &other) {
+      blocks_ = std::move(other.blocks_);
+      ptr_ = std::exchange(other.ptr_, nullptr);
+      end_ = std::exchange(other.end_, nullptr);
+      next_block_size_ = std::exchange(other.next_block_size_, kMinBlockSize);
+      bytes_reserved_ = std::exchange(other.bytes_reserved_, 0);
+    }
+    return *this;
+  }
+
+  // Returns `count` default constructed objects of type `T`.
+  template<typename T>
+  requires(std::is_trivially_destructible_v<T> && std::is_nothrow_default_constructible_v<T>)
+  std::span<T> AllocateArray(std::size_t count) {
+    if (count == 0) {
+      return {};
+    }
+    T* const array = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    std::uninitialized_default_construct_n(array, count);
+    return {array, count};
+  }
+
+  // Returns a copy of `values`.
+  template<typename T>
+  requires(std::is_trivially_destructible_v<T> && std::is_trivially_copyable_v<T>)
+  std::span<const T> CopyArray(std::span<const T> values) {
+    if (values.empty()) {
+      return {};
+    }
+    T* const copy = static_cast<T*>(Allocate(values.size_bytes(), alignof(T)));
+    std::memcpy(copy, values.data(), values.size_bytes());
+    return {copy, values.size()};
+  }
+
+  // Returns a copy of `str`.
+  std::string_view CopyString(std::string_view str) {
+    if (str.empty()) {
+      return {};
+    }
+    char* const copy = static_cast<char*>(Allocate(str.size(), 1));
+    std::memcpy(copy, str.data(), str.size());
+    return {copy, str.size()};
+  }
+
+  // The bytes of all blocks.
+  std::size_t BytesReserved() const noexcept { return bytes_reserved_; }
+
+  // The number of blocks (heap allocations).
+  std::size_t NumBlocks() const noexcept { return blocks_.size(); }
+
+ private:
+  void* Allocate(std::size_t size, std::size_t align) {
+    void* ptr = ptr_;
+    auto space = static_cast<std::size_t>(end_ - ptr_);
+    if (std::align(align, size, ptr, space) == nullptr) {
+      return AllocateBlock(size, align);
+    }
+    ptr_ = static_cast<std::byte*>(ptr) + size;  // NOLINT(*-pointer-arithmetic)
+    return ptr;
+  }
+
+  void* AllocateBlock(std::size_t size, std::size_t align) {
+    // Blocks come from `new[]`, so they are aligned for all fundamental types.
+    const std::size_t block_size = std::max(next_block_size_, size + align);
+    next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+    blocks_.push_back(std::make_unique_for_overwrite<std::byte[]>(block_size));  // NOLINT(*-avoid-c-arrays)
+    bytes_reserved_ += block_size;
+    ptr_ = blocks_.back().get();
+    end_ = ptr_ + block_size;  // NOLINT(*-pointer-arithmetic)
+    return Allocate(size, align);
+  }
+
+  std::vector<std::unique_ptr<std::byte[]>> blocks_;  // NOLINT(*-avoid-c-arrays)
+  std::byte* ptr_ = nullptr;                          // Next free byte of the last block.
+  std::byte* end_ = nullptr;                          // End of the last block.
+  std::size_t next_block_size_;
+  std::size_t bytes_reserved_ = 0;
+};
+
+}  // namespace mbo::json::json_internal
+
+#endif  // MBO_JSON_INTERNAL_JSON_ARENA_H_
@@ -0,0 +1,450 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/internal/json_parser.h"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace mbo::json::json_internal {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index)
+
+// The powers of ten that are exact doubles, for Clinger's fast path.
+constexpr std::array<double, 23> kPow10 = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+constexpr bool IsDigit(char chr) noexcept {
+  return static_cast<unsigned char>(chr - '0') < 10;
+}
+
+// Whether an atom (number or literal) may end before `chr`.
+constexpr bool IsAtomEnd(char chr) noexcept {
+  switch (chr) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case ',':
+    case ':':
+    case '[':
+    case ']':
+    case '{':
+    case '}': return true;
+    default: return false;
+  }
+}
+
+constexpr int HexDigit(char chr) noexcept {
+  if (IsDigit(chr)) {
+    return chr - '0';
+  }
+  const char lower = static_cast<char>(chr | 0x20);
+  return lower >= 'a' && lower <= 'f' ? lower - 'a' + 10 : -1;
+}
+
+// Returns the length of the UTF-8 sequence at `ptr` (RFC 3629: no overlong forms, no surrogates, at most U+10FFFF)
+// or 0 if it is invalid.
+std::size_t Utf8SequenceLength(const unsigned char* ptr, const unsigned char* end) noexcept {
+  const unsigned char lead = ptr[0];
+  std::size_t length = 0;
+  unsigned char min_second = 0x80;
+  unsigned char max_second = 0xBF;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    length = 2;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    length = 3;
+    min_second = lead == 0xE0 ? 0xA0 : 0x80;
+    max_second = lead == 0xED ? 0x9F : 0xBF;
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    length = 4;
+    min_second = lead == 0xF0 ? 0x90 : 0x80;
+    max_second = lead == 0xF4 ? 0x8F : 0xBF;
+  } else {
+    return 0;
+  }
+  if (static_cast<std::size_t>(end - ptr) < length || ptr[1] < min_second || ptr[1] > max_second) {
+    return 0;
+  }
+  for (std::size_t idx = 2; idx < length; ++idx) {
+    if ((ptr[idx] & 0xC0) != 0x80) {
+      return 0;
+    }
+  }
+  return length;
+}
+
+void AppendUtf8(std::string& out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+// Bit 7 of each byte of the result is set for the first byte of `word` that is a quote, a backslash, a control
+// character or not ASCII (bytes above that one may be set falsely).
+constexpr uint64_t StringSpecialBytes(uint64_t word) noexcept {
+  constexpr uint64_t kOnes = 0x0101'0101'0101'0101ULL;
+  constexpr uint64_t kHighs = kOnes * 0x80;
+  const auto has_zero = [](uint64_t bytes) { return (bytes - kOnes) & ~bytes & kHighs; };
+  return has_zero(word ^ (kOnes * '"')) | has_zero(word ^ (kOnes * '\\')) | ((word - (kOnes * 0x20)) & ~word & kHighs)
+         | (word & kHighs);
+}
+
+}  // namespace
+
+bool ScalarParser::ParseLiteral(std::size_t offset, std::string_view literal) {
+  if (text_.substr(offset, literal.size()) != literal
+      || (offset + literal.size() < text_.size() && !IsAtomEnd(text_[offset + literal.size()]))) {
+    return Fail(offset, "Invalid literal.");
+  }
+  return true;
+}
+
+bool ScalarParser::ParseString(std::size_t offset, std::string_view& value) {
+  const char* const begin = text_.data() + offset + 1;
+  const char* const end = text_.data() + text_.size();
+  const char* ptr = begin;
+  const char* segment = begin;  // Start of the content not yet copied into `scratch_`.
+  bool escaped = false;
+  while (true) {
+    if constexpr (std::endian::native == std::endian::little) {
+      while (end - ptr >= 8) {
+        uint64_t word = 0;
+        std::memcpy(&word, ptr, sizeof(word));
+        const uint64_t special = StringSpecialBytes(word);
+        if (special != 0) {
+          ptr += std::countr_zero(special) / 8;
+          break;
+        }
+        ptr += 8;
+      }
+    }
+    if (ptr == end) {
+      // Stage 1 guarantees the closing quote, this only guards against misuse.
+      return Fail(offset, "Unterminated string.");
+    }
+    const auto chr = static_cast<unsigned char>(*ptr);
+    if (chr == '"') {
+      break;
+    }
+    if (chr == '\\') {
+      if (!escaped) {
+        scratch_.clear();
+        escaped = true;
+      }
+      scratch_.append(segment, ptr);
+      if (!ParseEscape(ptr)) {
+        return false;
+      }
+      segment = ptr;
+    } else if (chr < 0x20) {
+      return Fail(static_cast<std::size_t>(ptr - text_.data()), "Control character in string.");
+    } else if (chr >= 0x80) {
+      const std::size_t length = Utf8SequenceLength(
+          reinterpret_cast<const unsigned char*>(ptr),  // NOLINT(*-reinterpret-cast)
+          reinterpret_cast<const unsigned char*>(end));  // NOLINT(*-reinterpret-cast)
+      if (length == 0) {
+        return Fail(static_cast<std::size_t>(ptr - text_.data()), "Invalid UTF-8 in string.");
+      }
+      ptr += length;
+    } else {
+      ++ptr;
+    }
+  }
+  if (escaped) {
+    scratch_.append(segment, ptr);
+    value = scratch_;
+  } else {
+    value = std::string_view(begin, static_cast<std::size_t>(ptr - begin));
+  }
+  return true;
+}
+
+// Appends the escape sequence at `ptr` to `scratch_` and moves `ptr` past it.
+bool ScalarParser::ParseEscape(const char*& ptr) {
+  const auto error_offset = static_cast<std::size_t>(ptr - text_.data());
+  const char* const end = text_.data() + text_.size();
+  const auto read_hex4 = [&](const char* hex) -> int32_t {
+    if (end - hex < 4) {
+      return -1;
+    }
+    int32_t value = 0;
+    for (std::size_t idx = 0; idx < 4; ++idx) {
+      const int digit = HexDigit(hex[idx]);
+      if (digit < 0) {
+        return -1;
+      }
+      value = (value << 4) | digit;
+    }
+    return value;
+  };
+  switch (ptr + 1 < end ? ptr[1] : '\0') {
+    case '"': scratch_.push_back('"'); break;
+    case '\\': scratch_.push_back('\\'); break;
+    case '/': scratch_.push_back('/'); break;
+    case 'b': scratch_.push_back('\b'); break;
+    case 'f': scratch_.push_back('\f'); break;
+    case 'n': scratch_.push_back('\n'); break;
+    case 'r': scratch_.push_back('\r'); break;
+    case 't': scratch_.push_back('\t'); break;
+    case 'u': {
+      const int32_t unit = read_hex4(ptr + 2);
+      if (unit < 0) {
+        return Fail(error_offset, "Invalid unicode escape.");
+      }
+      auto code_point = static_cast<uint32_t>(unit);
+      if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+        return Fail(error_offset, "Unpaired surrogate in unicode escape.");
+      }
+      if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+        const int32_t low = end - ptr >= 8 && ptr[6] == '\\' && ptr[7] == 'u' ? read_hex4(ptr + 8) : -1;
+        if (low < 0xDC00 || low > 0xDFFF) {
+          return Fail(error_offset, "Unpaired surrogate in unicode escape.");
+        }
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (static_cast<uint32_t>(low) - 0xDC00);
+        ptr += 6;
+      }
+      AppendUtf8(scratch_, code_point);
+      ptr += 6;
+      return true;
+    }
+    default: return Fail(error_offset, "Invalid escape sequence.");
+  }
+  ptr += 2;
+  return true;
+}
+
+bool ScalarParser::ParseNumber(std::size_t offset, Number& number) {  // NOLINT(*-function-cognitive-complexity)
+  const char* const begin = text_.data() + offset;
+  const char* const end = text_.data() + text_.size();
+  const char* ptr = begin;
+  const bool negative = *ptr == '-';
+  ptr += negative ? 1 : 0;
+  const char* const digits = ptr;
+  if (ptr == end || !IsDigit(*ptr)) {
+    return Fail(offset, "Invalid number.");
+  }
+  uint64_t mantissa = 0;  // Only valid for up to 19 digits.
+  if (*ptr == '0') {
+    ++ptr;
+  } else {
+    while (ptr != end && IsDigit(*ptr)) {
+      mantissa = (mantissa * 10) + static_cast<uint64_t>(*ptr - '0');
+      ++ptr;
+    }
+  }
+  std::size_t num_digits = static_cast<std::size_t>(ptr - digits);
+  bool is_float = false;
+  int64_t exponent = 0;
+  if (ptr != end && *ptr == '.') {
+    is_float = true;
+    const char* const fraction = ++ptr;
+    while (ptr != end && IsDigit(*ptr)) {
+      mantissa = (mantissa * 10) + static_cast<uint64_t>(*ptr - '0');
+      ++ptr;
+    }
+    if (ptr == fraction) {
+      return Fail(offset, "Invalid number.");
+    }
+    num_digits += static_cast<std::size_t>(ptr - fraction);
+    exponent = -(ptr - fraction);
+  }
+  if (ptr != end && (*ptr | 0x20) == 'e') {
+    is_float = true;
+    ++ptr;
+    const bool negative_exponent = ptr != end && *ptr == '-';
+    ptr += ptr != end && (*ptr == '-' || *ptr == '+') ? 1 : 0;
+    if (ptr == end || !IsDigit(*ptr)) {
+      return Fail(offset, "Invalid number.");
+    }
+    int64_t value = 0;
+    while (ptr != end && IsDigit(*ptr)) {
+      value = value < 1'000'000 ? (value * 10) + (*ptr - '0') : value;  // Saturates far outside of double's range.
+      ++ptr;
+    }
+    exponent += negative_exponent ? -value : value;
+  }
+  if (ptr != end && !IsAtomEnd(*ptr)) {
+    return Fail(offset, "Invalid number.");
+  }
+  if (!is_float) {
+    if (num_digits > 19) {
+      const auto [_, error] = std::from_chars(digits, ptr, mantissa);
+      if (error != std::errc{}) {
+        is_float = true;  // Beyond 64 bits.
+      }
+    }
+    if (!is_float) {
+      if (!negative) {
+        if (mantissa <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+          number.emplace<int64_t>(static_cast<int64_t>(mantissa));
+        } else {
+          number.emplace<uint64_t>(mantissa);
+        }
+        return true;
+      }
+      if (mantissa <= uint64_t{1} << 63) {
+        number.emplace<int64_t>(static_cast<int64_t>(0 - mantissa));
+        return true;
+      }
+    }
+  }
+  // Clinger: an exactly representable mantissa scaled by an exact power of ten is correctly rounded.
+  if (num_digits <= 19 && mantissa <= (uint64_t{1} << 53) && exponent >= -22 && exponent <= 22) {
+    double value = static_cast<double>(mantissa);
+    value = exponent < 0 ? value / kPow10[static_cast<std::size_t>(-exponent)]
+                         : value * kPow10[static_cast<std::size_t>(exponent)];
+    number.emplace<double>(negative ? -value : value);
+    return true;
+  }
+  double value = 0;
+  const auto [_, error] = std::from_chars(begin, ptr, value);
+  if (error == std::errc::result_out_of_range) {
+    if (exponent + static_cast<int64_t>(num_digits) > 0) {
+      return Fail(offset, "Number out of range.");
+    }
+    value = negative ? -0.0 : 0.0;  // Underflow.
+  } else if (error != std::errc{}) {
+    return Fail(offset, "Invalid number.");  // LCOV_EXCL_LINE: the grammar was checked above.
+  }
+  number.emplace<double>(value);
+  return true;
+}
+
+absl::Status IndexStructure(  // NOLINT(*-function-cognitive-complexity)
+    std::string_view text,
+    std::span<const uint32_t> structurals,
+    std::vector<uint32_t>& ends) {
+  ends.resize(structurals.size());
+  std::vector<uint32_t> open;  // The indices of the open containers.
+  uint32_t next = 0;  // Fits as `structurals` are offsets into at most `kMaxJsonSize` bytes.
+  // The structural character at `index` or '\0' at the end.
+  const auto at = [&](std::size_t index) noexcept {
+    return index < structurals.size() ? text[structurals[index]] : '\0';
+  };
+  const auto error = [&](std::size_t index, std::string_view message) {
+    return JsonError(text, index < structurals.size() ? structurals[index] : text.size(), message);
+  };
+  // The same state machine as `ParseStructure`, minus the scalars.
+  // NOLINTBEGIN(*-avoid-goto)
+value:
+  switch (at(next)) {
+    case '{':
+    case '[':
+      if (at(next + 1) == (text[structurals[next]] == '{' ? '}' : ']')) {
+        ends[next] = next + 1;
+        next += 2;
+        goto after_value;
+      }
+      if (open.size() == kMaxDepth) {
+        return error(next, "Nesting too deep.");
+      }
+      open.push_back(next);
+      if (text[structurals[next++]] == '{') {
+        goto object_key;
+      }
+      goto value;
+    case '"':
+    case 't':
+    case 'f':
+    case 'n':
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+      ends[next] = next;
+      ++next;
+      break;
+    default:
+      if (next == structurals.size()) {
+        return error(next, "Unexpected end of input.");
+      }
+      return error(next, "Unexpected character.");
+  }
+after_value:
+  if (open.empty()) {
+    if (next < structurals.size()) {
+      return error(next, "Unexpected content after the JSON value.");
+    }
+    return absl::OkStatus();
+  }
+  if (text[structurals[open.back()]] == '{') {
+    if (at(next) == ',') {
+      ++next;
+      goto object_key;
+    }
+    if (at(next) != '}') {
+      return error(next, "Expected ',' or '}'.");
+    }
+  } else {
+    if (at(next) == ',') {
+      ++next;
+      goto value;
+    }
+    if (at(next) != ']') {
+      return error(next, "Expected ',' or ']'.");
+    }
+  }
+  ends[open.back()] = next++;
+  open.pop_back();
+  goto after_value;
+object_key:
+  if (at(next) != '"') {
+    return error(next, "Expected a string key.");
+  }
+  ends[next] = next;
+  if (at(next + 1) != ':') {
+    return error(next + 1, "Expected ':'.");
+  }
+  next += 2;
+  goto value;
+  // NOLINTEND(*-avoid-goto)
+}
+
+// NOLINTEND(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index)
+
+}  // namespace mbo::json::json_internal
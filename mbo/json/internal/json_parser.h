@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_JSON_INTERNAL_JSON_PARSER_H_
+#define MBO_JSON_INTERNAL_JSON_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mbo/json/internal/json_structural.h"
+
+namespace mbo::json::json_internal {
+
+// Deeper documents are rejected, which also bounds the recursion of `~Json`.
+inline constexpr std::size_t kMaxDepth = 1'024;
+
+// A parsed number: `int64_t` if it is an integer that fits (negative or up to its max), `uint64_t` if it only fits
+// that, and `double` otherwise.
+using Number = std::variant<int64_t, uint64_t, double>;
+
+// Parses the scalars (strings, numbers and literals) of one JSON `text` at offsets found by `FindStructurals`. The
+// `Parse*` functions return false on malformed input and leave the error in `status`.
+class ScalarParser final {
+ public:
+  explicit ScalarParser(std::string_view text) noexcept : text_(text) {}
+
+  std::string_view text() const noexcept { return text_; }
+
+  const absl::Status& status() const noexcept { return status_; }
+
+  absl::Status Error(std::size_t offset, std::string_view message) const { return JsonError(text_, offset, message); }
+
+  bool Fail(std::size_t offset, std::string_view message) {
+    status_ = Error(offset, message);
+    return false;
+  }
+
+  // Parses the string whose opening quote is at `offset`. The `value` views `text` unless the string has escapes,
+  // in which case it views an internal buffer that is only valid until the next call.
+  bool ParseString(std::size_t offset, std::string_view& value);
+
+  // Checks that `literal` (`true`, `false` or `null`) is at `offset`.
+  bool ParseLiteral(std::size_t offset, std::string_view literal);
+
+  bool ParseNumber(std::size_t offset, Number& number);
+
+ private:
+  bool ParseEscape(const char*& ptr);
+
+  const std::string_view text_;
+  std::string scratch_;  // Unescaped string contents.
+  absl::Status status_;
+};
+
+// Stage 2 of the parser: visits the `structurals` of `text` in order, checks the grammar and reports the values to
+// `builder`, which decides how to store them. The `builder` receives:
+//
+//  * `Null()`, `Bool(bool)`, `String(std::string_view)` and `Number(int64_t|uint64_t|double)` for scalars,
+//  * `EmptyArray()` and `EmptyObject()` for `[]` and `{}`,
+//  * `BeginArray()`, then `NextElement()` before every further element, then `EndArray()`,
+//  * `BeginObject()`, then `Key(std::string_view)` before every member's value, then `EndObject()`.
+//
+// A `BeginArray()` is always followed by the first element. Strings passed to `String` and `Key` may only be valid
+// for the duration of the call.
+template<typename Builder>
+absl::Status ParseStructure(std::string_view text, std::span<const uint32_t> structurals, Builder& builder);
+
+// Checks the grammar of the `structurals` of `text` like `ParseStructure`, but leaves the scalars unchecked. For every
+// value (by index into `structurals`) `ends` receives the index of its last structural character: that of the closing
+// bracket for containers and the value's own index for scalars. So whatever follows the value at `idx` starts at
+// `ends[idx] + 1`. The `ends` of the other structural characters are unspecified.
+absl::Status IndexStructure(std::string_view text, std::span<const uint32_t> structurals, std::vector<uint32_t>& ends);
+
+// Implementation details follow.
+
+template<typename Builder>
+absl::Status ParseStructure(  // NOLINT(*-function-cognitive-complexity)
+    std::string_view text,
+    std::span<const uint32_t> structurals,
+    Builder& builder) {
+  ScalarParser scalars(text);
+  std::size_t next = 0;
+  // Returns the offset of the next structural character, or `text.size()` once all are consumed.
+  const auto next_offset = [&]() noexcept { return next < structurals.size() ? structurals[next++] : text.size(); };
+  // Skips the next structural character if it is `chr`.
+  const auto consume = [&](char chr) noexcept {
+    if (next < structurals.size() && text[structurals[next]] == chr) {
+      ++next;
+      return true;
+    }
+    return false;
+  };
+  // The character at `offset` or '\0' at the end.
+  const auto at = [&](std::size_t offset) noexcept { return offset < text.size() ? text[offset] : '\0'; };
+  std::vector<bool> in_object;  // One per open container.
+  std::size_t offset = 0;
+  std::string_view string;
+  Number number;
+  // A `goto` based state machine (value, key, after value) keeps the hot loop free of dispatch on an explicit state.
+  // NOLINTBEGIN(*-avoid-goto)
+value:
+  offset = next_offset();
+  switch (at(offset)) {
+    case '{':
+      if (consume('}')) {
+        builder.EmptyObject();
+        goto after_value;
+      }
+      if (in_object.size() == kMaxDepth) {
+        return scalars.Error(offset, "Nesting too deep.");
+      }
+      in_object.push_back(true);
+      builder.BeginObject();
+      goto object_key;
+    case '[':
+      if (consume(']')) {
+        builder.EmptyArray();
+        goto after_value;
+      }
+      if (in_object.size() == kMaxDepth) {
+        return scalars.Error(offset, "Nesting too deep.");
+      }
+      in_object.push_back(false);
+      builder.BeginArray();
+      goto value;
+    case '"':
+      if (!scalars.ParseString(offset, string)) {
+        return scalars.status();
+      }
+      builder.String(string);
+      break;
+    case 't':
+      if (!scalars.ParseLiteral(offset, "true")) {
+        return scalars.status();
+      }
+      builder.Bool(true);
+      break;
+    case 'f':
+      if (!scalars.ParseLiteral(offset, "false")) {
+        return scalars.status();
+      }
+      builder.Bool(false);
+      break;
+    case 'n':
+      if (!scalars.ParseLiteral(offset, "null")) {
+        return scalars.status();
+      }
+      builder.Null();
+      break;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+      if (!scalars.ParseNumber(offset, number)) {
+        return scalars.status();
+      }
+      std::visit([&builder](auto value) { builder.Number(value); }, number);
+      break;
+    default:
+      if (offset == text.size()) {
+        return scalars.Error(offset, "Unexpected end of input.");
+      }
+      return scalars.Error(offset, "Unexpected character.");
+  }
+after_value:
+  if (in_object.empty()) {
+    if (next < structurals.size()) {
+      return scalars.Error(structurals[next], "Unexpected content after the JSON value.");
+    }
+    return absl::OkStatus();
+  }
+  offset = next_offset();
+  if (in_object.back()) {
+    if (at(offset) == ',') {
+      goto object_key;
+    }
+    if (at(offset) != '}') {
+      return scalars.Error(offset, "Expected ',' or '}'.");
+    }
+    builder.EndObject();
+  } else {
+    if (at(offset) == ',') {
+      builder.NextElement();
+      goto value;
+    }
+    if (at(offset) != ']') {
+      return scalars.Error(offset, "Expected ',' or ']'.");
+    }
+    builder.EndArray();
+  }
+  in_object.pop_back();
+  goto after_value;
+object_key:
+  offset = next_offset();
+  if (at(offset) != '"') {
+    return scalars.Error(offset, "Expected a string key.");
+  }
+  if (!scalars.ParseString(offset, string)) {
+    return scalars.status();
+  }
+  offset = next_offset();
+  if (at(offset) != ':') {
+    return scalars.Error(offset, "Expected ':'.");
+  }
+  builder.Key(string);
+  goto value;
+  // NOLINTEND(*-avoid-goto)
+}
+
+}  // namespace mbo::json::json_internal
+
+#endif  // MBO_JSON_INTERNAL_JSON_PARSER_H_
@@ -0,0 +1,450 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/internal/json_structural.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# define MBO_JSON_STRUCTURAL_X86 1
+# include <immintrin.h>
+#else
+# define MBO_JSON_STRUCTURAL_X86 0
+#endif
+
+// The block logic must inline into each target clone to be compiled for it.
+#if defined(__GNUC__) || defined(__clang__)
+# define MBO_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+# define MBO_FORCE_INLINE __forceinline
+#else
+# define MBO_FORCE_INLINE inline
+#endif
+
+namespace mbo::json::json_internal {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-reinterpret-cast)
+
+constexpr std::size_t kBlockSize = 64;
+
+// One bit per byte of a block.
+struct BlockMasks {
+  uint64_t quote = 0;
+  uint64_t backslash = 0;
+  uint64_t op = 0;     // `{}[]:,`
+  uint64_t space = 0;  // JSON whitespace: space, tab, line feed and carriage return.
+};
+
+// What a block needs to know about its predecessors.
+struct ScanState {
+  uint64_t next_is_escaped = 0;  // Bit 0: the first byte is escaped by a trailing backslash.
+  uint64_t in_string = 0;        // All ones if the block starts inside a string.
+  uint64_t prev_scalar = 0;      // Bit 0: the previous block ended in a non quote scalar byte.
+};
+
+enum ByteClass : uint8_t {
+  kQuote = 1,
+  kBackslash = 2,
+  kOp = 4,
+  kSpace = 8,
+};
+
+constexpr std::array<uint8_t, 256> kByteClasses = [] {
+  std::array<uint8_t, 256> classes{};
+  classes['"'] = kQuote;
+  classes['\\'] = kBackslash;
+  for (const unsigned char chr : std::string_view("{}[]:,")) {
+    classes[chr] = kOp;
+  }
+  for (const unsigned char chr : std::string_view(" \t\n\r")) {
+    classes[chr] = kSpace;
+  }
+  return classes;
+}();
+
+MBO_FORCE_INLINE BlockMasks ClassifyPortable(const char* block) noexcept {
+  BlockMasks masks;
+  for (std::size_t idx = 0; idx < kBlockSize; ++idx) {
+    const uint64_t byte_class = kByteClasses[static_cast<unsigned char>(block[idx])];
+    masks.quote |= (byte_class & kQuote) << idx;
+    masks.backslash |= ((byte_class & kBackslash) >> 1) << idx;
+    masks.op |= ((byte_class & kOp) >> 2) << idx;
+    masks.space |= ((byte_class & kSpace) >> 3) << idx;
+  }
+  return masks;
+}
+
+// Bit `i` of the result is the parity of the bits `0..i` of `bits`.
+MBO_FORCE_INLINE uint64_t PrefixXorPortable(uint64_t bits) noexcept {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+// Escapes follow simdjson: a run of backslashes escapes the byte after it if the run has odd length, which one
+// subtraction finds for all runs of the block at once. Returns the quotes that are not escaped.
+MBO_FORCE_INLINE uint64_t UnescapedQuotes(const BlockMasks& masks, ScanState& state) noexcept {
+  constexpr uint64_t kOddBits = 0xAAAA'AAAA'AAAA'AAAAULL;
+  const uint64_t potential_escape = masks.backslash & ~state.next_is_escaped;
+  const uint64_t escape_and_terminal_code = (((potential_escape << 1) | kOddBits) - potential_escape) ^ kOddBits;
+  const uint64_t escaped = escape_and_terminal_code ^ (masks.backslash | state.next_is_escaped);
+  state.next_is_escaped = (escape_and_terminal_code & masks.backslash) >> 63;
+  return masks.quote & ~escaped;
+}
+
+// The structural bits of one block (see header), given the unescaped quotes and their prefix xor.
+MBO_FORCE_INLINE uint64_t Structurals(
+    const BlockMasks& masks,
+    uint64_t quote,
+    uint64_t quote_prefix_xor,
+    ScanState& state) noexcept {
+  const uint64_t in_string = quote_prefix_xor ^ state.in_string;
+  state.in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+  const uint64_t scalar = ~(masks.op | masks.space);
+  const uint64_t nonquote_scalar = scalar & ~quote;
+  const uint64_t follows_scalar = (nonquote_scalar << 1) | state.prev_scalar;
+  state.prev_scalar = nonquote_scalar >> 63;
+  const uint64_t string_tail = in_string ^ quote;  // Inside a string or its closing quote.
+  return (masks.op | (scalar & ~follows_scalar)) & ~string_tail;
+}
+
+MBO_FORCE_INLINE uint64_t StructuralsPortable(const BlockMasks& masks, ScanState& state) noexcept {
+  const uint64_t quote = UnescapedQuotes(masks, state);
+  return Structurals(masks, quote, PrefixXorPortable(quote), state);
+}
+
+// Writes the offsets of the set `bits` at `out[count]`. Writes are unconditional in groups of four, so `out` needs
+// room for `count + kBlockSize` entries.
+MBO_FORCE_INLINE void Flatten(uint64_t bits, uint32_t base, uint32_t* out, std::size_t& count) noexcept {
+  const auto num = static_cast<std::size_t>(std::popcount(bits));
+  uint32_t* dst = out + count;
+  for (std::size_t idx = 0; idx < num; idx += 4) {
+    dst[idx] = base + static_cast<uint32_t>(std::countr_zero(bits));
+    bits &= bits - 1;
+    dst[idx + 1] = base + static_cast<uint32_t>(std::countr_zero(bits));
+    bits &= bits - 1;
+    dst[idx + 2] = base + static_cast<uint32_t>(std::countr_zero(bits));
+    bits &= bits - 1;
+    dst[idx + 3] = base + static_cast<uint32_t>(std::countr_zero(bits));
+    bits &= bits - 1;
+  }
+  count += num;
+}
+
+// Keeps room for one more block of output.
+MBO_FORCE_INLINE void Reserve(std::vector<uint32_t>& out, std::size_t count) {
+  if (out.size() < count + kBlockSize) [[unlikely]] {
+    out.resize(std::max(out.size() * 2, count + kBlockSize));
+  }
+}
+
+// Each kernel scans all full blocks and returns the offset of the remaining tail.
+using ScanFunction = std::size_t (*)(std::string_view, std::vector<uint32_t>&, std::size_t&, ScanState&);
+
+std::size_t ScanPortable(
+    std::string_view text,
+    std::vector<uint32_t>& out,
+    std::size_t& count,
+    ScanState& state) noexcept {
+  std::size_t pos = 0;
+  for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+    Reserve(out, count);
+    const uint64_t bits = StructuralsPortable(ClassifyPortable(text.data() + pos), state);
+    Flatten(bits, static_cast<uint32_t>(pos), out.data(), count);
+  }
+  return pos;
+}
+
+MBO_FORCE_INLINE uint64_t NewlinesPortable(const char* block) noexcept {
+  uint64_t bits = 0;
+  for (std::size_t idx = 0; idx < kBlockSize; ++idx) {
+    bits |= uint64_t{block[idx] == '\n'} << idx;
+  }
+  return bits;
+}
+
+std::size_t ScanNewlinesPortable(std::string_view text, std::vector<uint32_t>& out, std::size_t& count) noexcept {
+  std::size_t pos = 0;
+  for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+    Reserve(out, count);
+    Flatten(NewlinesPortable(text.data() + pos), static_cast<uint32_t>(pos), out.data(), count);
+  }
+  return pos;
+}
+
+#if MBO_JSON_STRUCTURAL_X86
+MBO_FORCE_INLINE BlockMasks ClassifySse2(const char* block) noexcept {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i case_bit = _mm_set1_epi8(0x20);  // Maps `[` and `]` onto `{` and `}`.
+  BlockMasks masks;
+  for (std::size_t part = 0; part < kBlockSize; part += 16) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + part));
+    const __m128i lower = _mm_or_si128(chars, case_bit);
+    const __m128i op = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+        _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(',')), _mm_cmpeq_epi8(chars, _mm_set1_epi8(':'))));
+    const __m128i space = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\t'))),
+        _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\r'))));
+    masks.quote |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, quote)))} << part;
+    masks.backslash |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, backslash)))} << part;
+    masks.op |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(op))} << part;
+    masks.space |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(space))} << part;
+  }
+  return masks;
+}
+
+std::size_t ScanSse2(std::string_view text, std::vector<uint32_t>& out, std::size_t& count, ScanState& state) noexcept {
+  std::size_t pos = 0;
+  for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+    Reserve(out, count);
+    const uint64_t bits = StructuralsPortable(ClassifySse2(text.data() + pos), state);
+    Flatten(bits, static_cast<uint32_t>(pos), out.data(), count);
+  }
+  return pos;
+}
+
+std::size_t ScanNewlinesSse2(std::string_view text, std::vector<uint32_t>& out, std::size_t& count) noexcept {
+  const __m128i newline = _mm_set1_epi8('\n');
+  std::size_t pos = 0;
+  for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+    Reserve(out, count);
+    uint64_t bits = 0;
+    for (std::size_t part = 0; part < kBlockSize; part += 16) {
+      const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos + part));
+      bits |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, newline)))} << part;
+    }
+    Flatten(bits, static_cast<uint32_t>(pos), out.data(), count);
+  }
+  return pos;
+}
+
+__attribute__((target("pclmul"))) MBO_FORCE_INLINE uint64_t PrefixXorClmul(uint64_t bits) noexcept {
+  return static_cast<uint64_t>(_mm_cvtsi128_si64(
+      _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(bits)), _mm_set1_epi8(-1), 0)));
+}
+
+__attribute__((target("avx2,pclmul"))) std::size_t ScanAvx2(
+    std::string_view text,
+    std::vector<uint32_t>& out,
+    std::size_t& count,
+    ScanState& state) noexcept {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i case_bit = _mm256_set1_epi8(0x20);
+  std::size_t pos = 0;
+  for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+    Reserve(out, count);
+    BlockMasks masks;
+    for (std::size_t part = 0; part < kBlockSize; part += 32) {
+      const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + pos + part));
+      const __m256i lower = _mm256_or_si256(chars, case_bit);
+      const __m256i op = _mm256_or_si256(
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(',')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(':'))));
+      const __m256i space = _mm256_or_si256(
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\t'))),
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\r'))));
+      masks.quote |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, quote)))} << part;
+      masks.backslash |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, backslash)))}
+                         << part;
+      masks.op |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(op))} << part;
+      masks.space |= uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(space))} << part;
+    }
+    const uint64_t quotes = UnescapedQuotes(masks, state);
+    const uint64_t bits = Structurals(masks, quotes, PrefixXorClmul(quotes), state);
+    Flatten(bits, static_cast<uint32_t>(pos), out.data(), count);
+  }
+  return pos;
+}
+
+__attribute__((target("avx512f,avx512bw,pclmul"))) std::size_t ScanAvx512(
+    std::string_view text,
+    std::vector<uint32_t>& out,
+    std::size_t& count,
+    ScanState& state) noexcept {
+  const __m512i quote = _mm512_set1_epi8('"');
+  const __m512i backslash = _mm512_set1_epi8('\\');
+  const __m512i case_bit = _mm512_set1_epi8(0x20);
+  std::size_t pos = 0;
+  for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+    Reserve(out, count);
+    const __m512i chars = _mm512_loadu_si512(text.data() + pos);
+    const __m512i lower = _mm512_or_si512(chars, case_bit);
+    const BlockMasks masks{
+        .quote = _mm512_cmpeq_epi8_mask(chars, quote),
+        .backslash = _mm512_cmpeq_epi8_mask(chars, backslash),
+        .op = _mm512_cmpeq_epi8_mask(lower, _mm512_set1_epi8('{'))
+              | _mm512_cmpeq_epi8_mask(lower, _mm512_set1_epi8('}'))
+              | _mm512_cmpeq_epi8_mask(chars, _mm512_set1_epi8(','))
+              | _mm512_cmpeq_epi8_mask(chars, _mm512_set1_epi8(':')),
+        .space = _mm512_cmpeq_epi8_mask(chars, _mm512_set1_epi8(' '))
+                 | _mm512_cmpeq_epi8_mask(chars, _mm512_set1_epi8('\t'))
+                 | _mm512_cmpeq_epi8_mask(chars, _mm512_set1_epi8('\n'))
+                 | _mm512_cmpeq_epi8_mask(chars, _mm512_set1_epi8('\r')),
+    };
+    const uint64_t quotes = UnescapedQuotes(masks, state);
+    const uint64_t bits = Structurals(masks, quotes, PrefixXorClmul(quotes), state);
+    Flatten(bits, static_cast<uint32_t>(pos), out.data(), count);
+  }
+  return pos;
+}
+__attribute__((target("avx2"))) std::size_t ScanNewlinesAvx2(
+    std::string_view text,
+    std::vector<uint32_t>& out,
+    std::size_t& count) noexcept {
+  const __m256i newline = _mm256_set1_epi8('\n');
+  std::size_t pos = 0;
+  for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+    Reserve(out, count);
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + pos));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + pos + 32));
+    const uint64_t bits = uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, newline)))}
+                          | uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, newline)))} << 32;
+    Flatten(bits, static_cast<uint32_t>(pos), out.data(), count);
+  }
+  return pos;
+}
+
+__attribute__((target("avx512f,avx512bw"))) std::size_t ScanNewlinesAvx512(
+    std::string_view text,
+    std::vector<uint32_t>& out,
+    std::size_t& count) noexcept {
+  const __m512i newline = _mm512_set1_epi8('\n');
+  std::size_t pos = 0;
+  for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+    Reserve(out, count);
+    const uint64_t bits = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(text.data() + pos), newline);
+    Flatten(bits, static_cast<uint32_t>(pos), out.data(), count);
+  }
+  return pos;
+}
+#endif  // MBO_JSON_STRUCTURAL_X86
+
+ScanFunction SelectScan() noexcept {
+#if MBO_JSON_STRUCTURAL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("pclmul")) {
+    return &ScanAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("pclmul")) {
+    return &ScanAvx2;
+  }
+  return &ScanSse2;
+#else   // MBO_JSON_STRUCTURAL_X86
+  return &ScanPortable;
+#endif  // MBO_JSON_STRUCTURAL_X86
+}
+
+using NewlineFunction = std::size_t (*)(std::string_view, std::vector<uint32_t>&, std::size_t&);
+
+NewlineFunction SelectNewlineScan() noexcept {
+#if MBO_JSON_STRUCTURAL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512bw")) {
+    return &ScanNewlinesAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return &ScanNewlinesAvx2;
+  }
+  return &ScanNewlinesSse2;
+#else   // MBO_JSON_STRUCTURAL_X86
+  return &ScanNewlinesPortable;
+#endif  // MBO_JSON_STRUCTURAL_X86
+}
+
+// NOLINTEND(*-magic-numbers,*-pointer-arithmetic,*-constant-array-index,*-reinterpret-cast)
+
+}  // namespace
+
+absl::Status FindStructurals(std::string_view text, std::vector<uint32_t>& structurals, ScanKernel kernel) {
+  if (text.size() > kMaxJsonSize) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("JSON text of %d bytes exceeds the maximum of %d bytes.", text.size(), kMaxJsonSize));
+  }
+  static const ScanFunction kScan = SelectScan();
+  ScanState state;
+  std::size_t count = 0;
+  structurals.resize(text.size() / 8 + kBlockSize);  // Typical documents have a structural every 5 to 10 bytes.
+  const std::size_t tail = (kernel == ScanKernel::kPortable ? &ScanPortable : kScan)(text, structurals, count, state);
+  if (tail < text.size()) {
+    std::array<char, kBlockSize> block;
+    block.fill(' ');
+    std::memcpy(block.data(), text.data() + tail, text.size() - tail);
+    Reserve(structurals, count);
+    const uint64_t bits = StructuralsPortable(ClassifyPortable(block.data()), state);
+    Flatten(bits, static_cast<uint32_t>(tail), structurals.data(), count);
+  }
+  structurals.resize(count);
+  if (state.in_string != 0) {
+    // Nothing after an unterminated string's opening quote is structural.
+    return JsonError(text, count == 0 ? 0 : structurals.back(), "Unterminated string.");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status FindNewlines(std::string_view text, std::vector<uint32_t>& newlines, ScanKernel kernel) {
+  if (text.size() > kMaxJsonSize) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("JSON text of %d bytes exceeds the maximum of %d bytes.", text.size(), kMaxJsonSize));
+  }
+  static const NewlineFunction kScan = SelectNewlineScan();
+  std::size_t count = 0;
+  newlines.resize(text.size() / 256 + kBlockSize);  // JSON Lines records are rarely shorter than that.
+  const std::size_t tail = (kernel == ScanKernel::kPortable ? &ScanNewlinesPortable : kScan)(text, newlines, count);
+  if (tail < text.size()) {
+    std::array<char, kBlockSize> block{};
+    std::memcpy(block.data(), text.data() + tail, text.size() - tail);
+    Reserve(newlines, count);
+    Flatten(NewlinesPortable(block.data()), static_cast<uint32_t>(tail), newlines.data(), count);
+  }
+  newlines.resize(count);
+  return absl::OkStatus();
+}
+
+absl::Status JsonError(std::string_view text, std::size_t offset, std::string_view message) {
+  offset = std::min(offset, text.size());
+  const std::string_view before = text.substr(0, offset);
+  const std::size_t line = 1 + static_cast<std::size_t>(std::ranges::count(before, '\n'));
+  const std::size_t line_start = before.rfind('\n');
+  const std::size_t column = offset - (line_start == std::string_view::npos ? 0 : line_start + 1) + 1;
+  return absl::InvalidArgumentError(
+      absl::StrFormat("JSON error at line %d, column %d (offset %d): %s", line, column, offset, message));
+}
+
+}  // namespace mbo::json::json_internal
+
+#undef MBO_FORCE_INLINE
+#undef MBO_JSON_STRUCTURAL_X86
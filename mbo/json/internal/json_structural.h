@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_JSON_INTERNAL_JSON_STRUCTURAL_H_
+#define MBO_JSON_INTERNAL_JSON_STRUCTURAL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+
+namespace mbo::json::json_internal {
+
+// Stage 1 of the parser: a branch free pass over 64 byte blocks that finds every structural character of a JSON
+// text. Those are the operators `{}[]:,` and the first character of every atom (the opening quote of a string and
+// the first character of a number or literal), all outside of strings. Whitespace never is structural, nor is
+// anything inside a string. Stage 2 (the tree builder) then only visits these positions.
+
+enum class ScanKernel {
+  kAuto,      // The widest vector instructions the CPU supports.
+  kPortable,  // Plain 64 bit integer code (also the reference for the vector kernels).
+};
+
+// Offsets are 32 bit, which limits texts to 4 GiB.
+inline constexpr std::size_t kMaxJsonSize = std::numeric_limits<uint32_t>::max();
+
+// Replaces `structurals` with the structural offsets of `text` in increasing order.
+//
+// Returns:
+//  * absl::OkStatus:              The index is complete.
+//  * absl::InvalidArgumentError:  A string is not terminated or `text` exceeds `kMaxJsonSize`.
+absl::Status FindStructurals(
+    std::string_view text,
+    std::vector<uint32_t>& structurals,
+    ScanKernel kernel = ScanKernel::kAuto);
+
+// Replaces `newlines` with the offsets of all line feeds of `text` in increasing order, using the same kernels. Used to
+// split JSON Lines (which cannot have raw line feeds inside of records) without looking at the records.
+//
+// Returns:
+//  * absl::OkStatus:              The offsets are complete.
+//  * absl::InvalidArgumentError:  The `text` exceeds `kMaxJsonSize`.
+absl::Status FindNewlines(
+    std::string_view text,
+    std::vector<uint32_t>& newlines,
+    ScanKernel kernel = ScanKernel::kAuto);
+
+// Creates the error for a malformed `text` at `offset` with its line and column (both 1-based).
+absl::Status JsonError(std::string_view text, std::size_t offset, std::string_view message);
+
+}  // namespace mbo::json::json_internal
+
+#endif  // MBO_JSON_INTERNAL_JSON_STRUCTURAL_H_
@@ -18,20 +18,26 @@
 #ifndef MBO_JSON_JSON_H_
 #define MBO_JSON_JSON_H_
 
+#include <algorithm>
 #include <compare>
 #include <concepts>  // IWYU pragma: keep
 #include <cstdint>
+#include <filesystem>
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <ranges>
-#include <sstream>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
 #include "mbo/config/require.h"
 #include "mbo/log/demangle.h"
 #include "mbo/types/cases.h"
@@ -387,28 +393,53 @@ class Json {
     return Kind::kNull;
   }
 
+  // Parses the JSON `text` (RFC 8259) in two stages: a vectorized scan finds all structural characters, then the
+  // tree is built from them. Numbers become `SignedInt` if they are integers that fit (negative or up to its max),
+  // `UnsignedInt` if they only fit that, and `Float` otherwise. For duplicate object keys the last value wins.
+  //
+  // Returns:
+  //  * Json:                          The parsed value (any kind, not just an Object).
+  //  * absl::InvalidArgumentError:    Malformed `text`, the message has the offset, line and column of the error.
+  static absl::StatusOr<Json> Parse(std::string_view text);
+
+  // Parses the contents of the file `path` (see `Parse`), which is memory-mapped if possible.
+  //
+  // Returns:
+  //  * Json:                          The parsed value.
+  //  * absl::InvalidArgumentError:    Malformed content, the message starts with the `path`.
+  //  * Any error of `mbo::file::GetMappedContents`.
+  static absl::StatusOr<Json> ParseFile(const std::filesystem::path& path);
+
+  class Document;  // Arena backed and read-only, see `json_document.h`.
+
+  class View;  // Lazy and zero-copy, see `json_view.h`.
+
   std::ostream& Stream(
       std::ostream& os,
       SerializeMode mode = SerializeMode::kCompact,
       const types::StringifyRootOptions& root_options = types::StringifyRootOptions{}) const {
-    const ::mbo::types::Stringify stringify{static_cast<types::Stringify::OutputMode>(mode), root_options};
-    if (IsNull()) {
-      struct Null {};
-
-      stringify.Stream(os, Null{});
-    } else {
-      MBO_CONFIG_REQUIRE(IsObject(), "Only Objects can be serialized.");
-      stringify.Stream(os, std::get<Object>(data_));
-    }
+    SerializeWith(mode, root_options, [&os](const types::Stringify& stringify, const auto& value) {
+      stringify.Stream(os, value);
+    });
     return os;
   }
 
   std::string Serialize(
       SerializeMode mode = SerializeMode::kCompact,
       const types::StringifyRootOptions& root_options = types::StringifyRootOptions{}) const {
-    std::stringstream os;
-    Stream(os, mode, root_options);
-    return os.str();
+    std::string out;
+    AppendSerialized(out, mode, root_options);
+    return out;
+  }
+
+  // Appends the serialization to `out` (see `Serialize`), which allows to reuse buffers.
+  void AppendSerialized(
+      std::string& out,
+      SerializeMode mode = SerializeMode::kCompact,
+      const types::StringifyRootOptions& root_options = types::StringifyRootOptions{}) const {
+    SerializeWith(mode, root_options, [&out](const types::Stringify& stringify, const auto& value) {
+      stringify.AppendTo(out, value);
+    });
   }
 
   // Change value to a `Null` value.
@@ -734,6 +765,25 @@ class Json {
   }
 
  private:
+  class Parser;  // Implemented in `json_parse.cc`.
+
+  // Calls `func(stringify, value)` with the `Stringify` for `mode` and the value to serialize.
+  template<typename Func>
+  void SerializeWith(SerializeMode mode, const types::StringifyRootOptions& root_options, Func func) const {
+    const ::mbo::types::Stringify stringify{static_cast<types::Stringify::OutputMode>(mode), root_options};
+    if (IsNull()) {
+      struct Null {};
+
+      func(stringify, Null{});
+    } else {
+      MBO_CONFIG_REQUIRE(IsObject(), "Only Objects can be serialized.");
+      func(stringify, std::get<Object>(data_));
+    }
+  }
+
+  // Stage 2 of `Parse` on the `structurals` of a single value in `text`.
+  static absl::StatusOr<Json> ParseStructurals(std::string_view text, std::span<const uint32_t> structurals);
+
   template<typename T>
   bool IsType() const noexcept {
     return std::holds_alternative<T>(data_);
@@ -821,13 +871,26 @@ constexpr auto kJsonComparator = mbo::types::Overloaded{
     },
     [](const Json::Array& lhs, const Json::Array& rhs) { return types::WeakToStrong(*lhs <=> *rhs); },
     [](const Json::Object& lhs, const Json::Object& rhs) -> std::strong_ordering {
-      auto lhs_it = lhs.begin();
-      auto rhs_it = rhs.begin();
-      while (lhs_it != lhs.end() && rhs_it != rhs.end()) {
-        if (auto comp = types::WeakToStrong(lhs_it->first <=> rhs_it->first); comp != std::strong_ordering::equal) {
+      // The iteration order of a hash map depends on its history, so compare in the order of the property names.
+      const auto sorted = [](const Json::Object& object) {
+        std::vector<const Json::Object::value_type*> properties;
+        properties.reserve(object.size());
+        for (const auto& property : object) {
+          properties.push_back(&property);
+        }
+        std::ranges::sort(properties, {}, [](const auto* property) -> const std::string& { return property->first; });
+        return properties;
+      };
+      const auto lhs_sorted = sorted(lhs);
+      const auto rhs_sorted = sorted(rhs);
+      auto lhs_it = lhs_sorted.begin();
+      auto rhs_it = rhs_sorted.begin();
+      while (lhs_it != lhs_sorted.end() && rhs_it != rhs_sorted.end()) {
+        if (auto comp = types::WeakToStrong((*lhs_it)->first <=> (*rhs_it)->first);
+            comp != std::strong_ordering::equal) {
           return comp;
         }
-        if (auto comp = lhs_it->second <=> rhs_it->second; comp != std::strong_ordering::equal) {
+        if (auto comp = (*lhs_it)->second <=> (*rhs_it)->second; comp != std::strong_ordering::equal) {
           return comp;
         }
         ++lhs_it;
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/json_benchmark_corpus.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "mbo/file/file.h"
+
+namespace mbo::json {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+// About 180 KB of search results like twitter.json.
+std::string TwitterLike() {
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+  std::mt19937_64 rng(1);
+  std::string text = R"({"statuses":[)";
+  for (std::size_t idx = 0; idx < 100; ++idx) {
+    const uint64_t id = 505874924095815681ULL + rng() % 1'000'000;
+    absl::StrAppend(
+        &text, idx == 0 ? "" : ",", R"({"metadata":{"result_type":"recent","iso_language_code":"ja"},)",
+        R"("created_at":"Sun Aug 31 00:29:15 +0000 2014","id":)", id, R"(,"id_str":")", id, R"(",)",
+        R"("text":"@aym0566x \n\n名前:前田あゆみ\n第一印象:なんか怖っ！\n今の印象:とりあえずキモい。噛み合わない\n)",
+        R"(好きなところ:ぶすでキモいとこ😋✨✨\n思い出:んーーー、ありすぎ😊❤️\nLINE交換できる？:あぁ……ごめん✋\n)",
+        R"(トプ画をみて:照れますがな😘✨\n一言:お前は一生もんのダチ💖",)",
+        R"("source":"<a href=\"http://twitter.com/download/iphone\" rel=\"nofollow\">Twitter for )",
+        R"(iPhone</a>","truncated":false,"in_reply_to_status_id":null,"in_reply_to_user_id":866260188,)",
+        R"("user":{"id":)", rng() % 10'000'000'000ULL, R"(,"name":"AYUMI","screen_name":"ayuu0123",)",
+        R"("location":"","description":"元野球部マネージャー❤︎…最高の夏をありがとう…❤︎",)",
+        R"("url":null,"entities":{"description":{"urls":[]}},"protected":false,"followers_count":)", rng() % 10'000,
+        R"(,"friends_count":)", rng() % 10'000, R"(,"listed_count":0,"created_at":"Tue Feb 25 08:06:57 +0000 2014",)",
+        R"("favourites_count":235,"utc_offset":null,"time_zone":null,"geo_enabled":false,"verified":false,)",
+        R"("statuses_count":1769,"lang":"en","contributors_enabled":false,"is_translator":false,)",
+        R"("profile_background_color":"C0DEED","profile_background_tile":false,)",
+        R"("profile_image_url":"http://pbs.twimg.com/profile_images/497760886795153410/LDjAwR_y_normal.jpeg",)",
+        R"("profile_link_color":"0084B4","default_profile":true,"following":false,"notifications":false},)",
+        R"("geo":null,"coordinates":null,"place":null,"contributors":null,"retweet_count":)", rng() % 100,
+        R"(,"favorite_count":)", rng() % 100, R"(,"entities":{"hashtags":[],"symbols":[],"urls":[],)",
+        R"("user_mentions":[{"screen_name":"aym0566x","name":"前田あゆみ","id":866260188,"id_str":"866260188",)",
+        R"("indices":[0,9]}]},"favorited":false,"retweeted":false,"lang":"ja"})");
+  }
+  absl::StrAppend(
+      &text, R"(],"search_metadata":{"completed_in":0.087,"max_id":505874924095815681,"query":"%E4%B8%80",)",
+      R"("refresh_url":"?since_id=505874924095815681&q=%E4%B8%80&include_entities=1","count":100}})");
+  return text;
+}
+
+// About 1.3 MB of an indented catalog like citm_catalog.json.
+std::string CitmLike() {
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+  std::mt19937_64 rng(2);
+  std::string text = "{\n    \"areaNames\": {\n";
+  for (std::size_t idx = 0; idx < 17; ++idx) {
+    absl::StrAppend(&text, idx == 0 ? "" : ",\n", "        \"", 205705993 + idx, "\": \"Arrière-scène central\"");
+  }
+  absl::StrAppend(&text, "\n    },\n    \"events\": {\n");
+  for (std::size_t idx = 0; idx < 184; ++idx) {
+    const uint64_t id = 138586341 + (idx * 17);
+    absl::StrAppend(
+        &text, idx == 0 ? "" : ",\n", "        \"", id, "\": {\n            \"description\": null,\n",
+        "            \"id\": ", id, ",\n            \"logo\": \"/images/UE0AAAAACEKo6QAAAAZDSVRN\",\n",
+        "            \"name\": \"30th Anniversary Tour\",\n            \"subTopicIds\": [\n                ",
+        337184269 + rng() % 100, ",\n                337184283\n            ],\n",
+        "            \"subjectCode\": null,\n            \"subtitle\": null,\n",
+        "            \"topicIds\": [\n                324846099,\n                107888604\n            ]\n        }");
+  }
+  absl::StrAppend(&text, "\n    },\n    \"performances\": [\n");
+  for (std::size_t idx = 0; idx < 243; ++idx) {
+    absl::StrAppend(
+        &text, idx == 0 ? "" : ",\n", "        {\n            \"eventId\": ", 138586341 + (rng() % 184) * 17,
+        ",\n            \"id\": ", 339887544 + idx, ",\n            \"logo\": null,\n            \"name\": null,\n",
+        "            \"prices\": [\n");
+    for (std::size_t price = 0; price < 4; ++price) {
+      absl::StrAppend(
+          &text, price == 0 ? "" : ",\n", "                {\n                    \"amount\": ",
+          9'025 * (1 + rng() % 20), ",\n                    \"audienceSubCategoryId\": 337100890,\n",
+          "                    \"seatCategoryId\": ", 338937295 + price, "\n                }");
+    }
+    absl::StrAppend(&text, "\n            ],\n            \"seatCategories\": [\n");
+    for (std::size_t category = 0; category < 4; ++category) {
+      absl::StrAppend(&text, category == 0 ? "" : ",\n", "                {\n                    \"areas\": [\n");
+      for (std::size_t area = 0; area < 6; ++area) {
+        absl::StrAppend(
+            &text, area == 0 ? "" : ",\n", "                        {\n                            \"areaId\": ",
+            205705993 + rng() % 17, ",\n                            \"blockIds\": []\n                        }");
+      }
+      absl::StrAppend(
+          &text, "\n                    ],\n                    \"seatCategoryId\": ", 338937295 + category,
+          "\n                }");
+    }
+    absl::StrAppend(
+        &text, "\n            ],\n            \"seatMapImage\": null,\n            \"start\": ",
+        1372701600000 + (idx * 86'400'000), ",\n            \"venueCode\": \"PLEYEL_PLEYEL\"\n        }");
+  }
+  absl::StrAppend(&text, "\n    ],\n    \"venueNames\": {\n        \"PLEYEL_PLEYEL\": \"Salle Pleyel\"\n    }\n}");
+  return text;
+}
+
+// About 2.2 MB of polygon coordinates like canada.json.
+std::string CanadaLike() {
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Benchmarks must be repeatable.
+  std::mt19937_64 rng(3);
+  std::uniform_real_distribution<double> longitude(-141.0, -52.0);
+  std::uniform_real_distribution<double> latitude(41.0, 83.0);
+  std::string text =
+      R"({"type":"FeatureCollection","features":[{"type":"Feature","properties":{"name":"Canada"},)"
+      R"("geometry":{"type":"Polygon","coordinates":[)";
+  for (std::size_t ring = 0; ring < 480; ++ring) {
+    absl::StrAppend(&text, ring == 0 ? "[" : "],[");
+    for (std::size_t point = 0; point < 116; ++point) {
+      absl::StrAppend(
+          &text, point == 0 ? "" : ",", absl::StrFormat("[%.17g,%.17g]", longitude(rng), latitude(rng)));
+    }
+  }
+  absl::StrAppend(&text, "]]}}]}");
+  return text;
+}
+
+struct Source {
+  const char* name;
+  std::string (*generate)();
+};
+
+constexpr std::array<Source, 3> kSources = {{
+    {.name = "twitter", .generate = &TwitterLike},
+    {.name = "citm_catalog", .generate = &CitmLike},
+    {.name = "canada", .generate = &CanadaLike},
+}};
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+
+const std::vector<Corpus>& Corpora() {
+  static const auto* const kCorpora = [] {
+    auto* corpora = new std::vector<Corpus>();  // NOLINT(cppcoreguidelines-owning-memory)
+    const char* const dir = std::getenv("MBO_JSON_BENCHMARK_CORPUS");  // NOLINT(concurrency-mt-unsafe): startup only
+    for (const auto& [name, generate] : kSources) {
+      if (dir != nullptr) {
+        absl::StatusOr<std::string> text = file::GetContents(std::filesystem::path(dir) / absl::StrCat(name, ".json"));
+        if (text.ok()) {
+          corpora->push_back({.name = std::string(name), .text = *std::move(text)});
+          continue;
+        }
+      }
+      corpora->push_back({.name = absl::StrCat(name, "_like"), .text = generate()});
+    }
+    return corpora;
+  }();
+  return *kCorpora;
+}
+
+}  // namespace mbo::json
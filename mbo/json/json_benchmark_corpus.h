@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_JSON_JSON_BENCHMARK_CORPUS_H_
+#define MBO_JSON_JSON_BENCHMARK_CORPUS_H_
+
+#include <string>
+#include <vector>
+
+namespace mbo::json {
+
+struct Corpus {
+  std::string name;
+  std::string text;
+};
+
+// The canonical JSON benchmark corpora twitter.json, citm_catalog.json and canada.json, read from the directory in
+// `MBO_JSON_BENCHMARK_CORPUS` (e.g. simdjson's `jsonexamples`). Without it (or for missing files) generated documents
+// of the same shape and size stand in, named with a "_like" suffix: tweets with nested users and non-ASCII text, an
+// indented catalog of integer ids and a polygon of 17 digit coordinates.
+const std::vector<Corpus>& Corpora();
+
+}  // namespace mbo::json
+
+#endif  // MBO_JSON_JSON_BENCHMARK_CORPUS_H_
@@ -0,0 +1,311 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/json_document.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "mbo/config/require.h"
+#include "mbo/file/file.h"
+#include "mbo/json/internal/json_arena.h"
+#include "mbo/json/internal/json_parser.h"
+#include "mbo/json/internal/json_structural.h"
+#include "mbo/json/json.h"
+
+namespace mbo::json {
+namespace {
+
+// Below this many members insertion sort beats `std::stable_sort`, which also allocates.
+constexpr std::size_t kInsertionSortLimit = 16;
+
+// Sorts `members` by name, keeps only the last of each run of equal names and returns how many are left.
+std::size_t SortMembers(std::span<Json::Document::Member> members) {
+  const auto less = [](const Json::Document::Member& lhs, const Json::Document::Member& rhs) noexcept {
+    return lhs.name < rhs.name;
+  };
+  if (members.size() <= kInsertionSortLimit) {
+    for (auto it = members.begin(); it != members.end(); ++it) {
+      std::rotate(std::upper_bound(members.begin(), it, *it, less), it, it + 1);
+    }
+  } else {
+    std::stable_sort(members.begin(), members.end(), less);
+  }
+  std::size_t size = 0;
+  for (std::size_t idx = 0; idx < members.size(); ++idx) {
+    // NOLINTNEXTLINE(*-avoid-unchecked-container-access): `idx + 1` and `size` are both at most `idx`.
+    if (idx + 1 == members.size() || members[idx].name != members[idx + 1].name) {
+      members[size++] = members[idx];  // NOLINT(*-avoid-unchecked-container-access)
+    }
+  }
+  return size;
+}
+
+}  // namespace
+
+// Builds the values for `json_internal::ParseStructure` and from a `Json`. The elements and members of open
+// containers are collected on two shared stacks and copied into the arena once their container closes, when their
+// number is known.
+class Json::Document::Builder final {
+ public:
+  explicit Builder(Document& document) noexcept : document_(document) {}
+
+  void Null() noexcept {}
+
+  void Bool(bool value) noexcept { Slot().type_ = value ? Value::Type::kTrue : Value::Type::kFalse; }
+
+  void Number(SignedInt value) noexcept {
+    Value& slot = Slot();
+    slot.type_ = Value::Type::kSignedInt;
+    slot.signed_int_ = value;
+  }
+
+  void Number(UnsignedInt value) noexcept {
+    Value& slot = Slot();
+    slot.type_ = Value::Type::kUnsignedInt;
+    slot.unsigned_int_ = value;
+  }
+
+  void Number(Float value) noexcept {
+    Value& slot = Slot();
+    slot.type_ = Value::Type::kFloat;
+    slot.float_ = value;
+  }
+
+  void String(std::string_view value) {
+    const std::string_view copy = document_.arena_.CopyString(value);
+    Value& slot = Slot();
+    slot.type_ = Value::Type::kString;
+    slot.size_ = Size(copy.size());
+    slot.string_ = copy.data();
+  }
+
+  void EmptyArray() { SetArray(Slot(), {}); }
+
+  void EmptyObject() { SetObject(Slot(), {}); }
+
+  void BeginArray() {
+    stack_.push_back({.first = elements_.size(), .is_object = false});
+    elements_.emplace_back();
+  }
+
+  void NextElement() { elements_.emplace_back(); }
+
+  void EndArray() {
+    const std::size_t first = stack_.back().first;
+    const std::span<const Value> elements =
+        document_.arena_.CopyArray(std::span<const Value>(elements_).subspan(first));
+    elements_.resize(first);
+    stack_.pop_back();
+    SetArray(Slot(), elements);
+  }
+
+  void BeginObject() { stack_.push_back({.first = members_.size(), .is_object = true}); }
+
+  void Key(std::string_view key) { members_.push_back({.name = document_.arena_.CopyString(key)}); }
+
+  void EndObject() {
+    const std::size_t first = stack_.back().first;
+    const std::span<Member> members = std::span<Member>(members_).subspan(first);
+    const std::span<const Member> copy = document_.arena_.CopyArray(
+        std::span<const Member>(members.first(SortMembers(members))));
+    members_.resize(first);
+    stack_.pop_back();
+    SetObject(Slot(), copy);
+  }
+
+  // Converts `json` directly into the arena, depth first.
+  Value FromJson(const Json& json) {  // NOLINT(misc-no-recursion)
+    Value value;
+    std::visit(
+        types::Overloaded{
+            [](std::nullopt_t /*unused*/) {},
+            [&](bool flag) { value.type_ = flag ? Value::Type::kTrue : Value::Type::kFalse; },
+            [&](SignedInt number) {
+              value.type_ = Value::Type::kSignedInt;
+              value.signed_int_ = number;
+            },
+            [&](UnsignedInt number) {
+              value.type_ = Value::Type::kUnsignedInt;
+              value.unsigned_int_ = number;
+            },
+            [&](Float number) {
+              value.type_ = Value::Type::kFloat;
+              value.float_ = number;
+            },
+            [&](const std::string& str) {
+              const std::string_view copy = document_.arena_.CopyString(str);
+              value.type_ = Value::Type::kString;
+              value.size_ = Size(copy.size());
+              value.string_ = copy.data();
+            },
+            [&](const Array& array) {  // NOLINT(misc-no-recursion)
+              const std::span<Value> elements = document_.arena_.AllocateArray<Value>(array->size());
+              for (std::size_t idx = 0; idx < elements.size(); ++idx) {
+                elements[idx] = FromJson((*array)[idx]);  // NOLINT(*-avoid-unchecked-container-access)
+              }
+              SetArray(value, elements);
+            },
+            [&](const Object& object) {  // NOLINT(misc-no-recursion)
+              const std::span<Member> members = document_.arena_.AllocateArray<Member>(object.size());
+              auto member = members.begin();
+              for (const auto& [name, json_value] : object) {
+                *member++ = {.name = document_.arena_.CopyString(name), .value = FromJson(*json_value)};
+              }
+              SetObject(value, members.first(SortMembers(members)));
+            },
+        },
+        json.data_);
+    return value;
+  }
+
+ private:
+  struct Frame {
+    std::size_t first = 0;  // Of the container's elements in `elements_` or members in `members_`.
+    bool is_object = false;
+  };
+
+  static uint32_t Size(std::size_t size) {
+    MBO_CONFIG_REQUIRE(size <= std::numeric_limits<uint32_t>::max(), "Too large for a Json::Document: ") << size;
+    return static_cast<uint32_t>(size);
+  }
+
+  static void SetArray(Value& value, std::span<const Value> elements) {
+    value.type_ = Value::Type::kArray;
+    value.size_ = Size(elements.size());
+    value.elements_ = elements.data();
+  }
+
+  static void SetObject(Value& value, std::span<const Member> members) {
+    value.type_ = Value::Type::kObject;
+    value.size_ = Size(members.size());
+    value.members_ = members.data();
+  }
+
+  // The current value: the last element or member of the innermost open container or the root.
+  Value& Slot() noexcept {
+    if (stack_.empty()) {
+      return document_.root_;
+    }
+    return stack_.back().is_object ? members_.back().value : elements_.back();
+  }
+
+  Document& document_;
+  std::vector<Frame> stack_;
+  std::vector<Value> elements_;
+  std::vector<Member> members_;
+};
+
+Json::Document::Document(const Json& json) {
+  root_ = Builder(*this).FromJson(json);
+}
+
+absl::StatusOr<Json::Document> Json::Document::Parse(std::string_view text) {
+  std::vector<uint32_t> structurals;
+  if (absl::Status status = json_internal::FindStructurals(text, structurals); !status.ok()) {
+    return status;
+  }
+  // An upper bound: every structural character adds at most one value (16 bytes, a member's key and value come from
+  // two), plus the strings. So a single block holds the whole document.
+  Document document;
+  document.arena_ = json_internal::Arena(text.size() + (structurals.size() * sizeof(Value)));
+  Builder builder(document);
+  if (absl::Status status = json_internal::ParseStructure(text, structurals, builder); !status.ok()) {
+    return status;
+  }
+  return document;
+}
+
+absl::StatusOr<Json::Document> Json::Document::ParseFile(const std::filesystem::path& path) {
+  absl::StatusOr<file::MappedContents> contents = file::GetMappedContents(path);
+  if (!contents.ok()) {
+    return contents.status();
+  }
+  absl::StatusOr<Document> document = Parse(contents->View());
+  if (!document.ok()) {
+    return absl::Status(document.status().code(), absl::StrCat(path.string(), ": ", document.status().message()));
+  }
+  return document;
+}
+
+Json::Kind Json::Document::Value::GetKind() const noexcept {
+  switch (type_) {
+    case Type::kNull: return Kind::kNull;
+    case Type::kFalse:
+    case Type::kTrue: return Kind::kBool;
+    case Type::kSignedInt:
+    case Type::kUnsignedInt:
+    case Type::kFloat: return Kind::kNumber;
+    case Type::kString: return Kind::kString;
+    case Type::kArray: return Kind::kArray;
+    case Type::kObject: return Kind::kObject;
+  }
+  return Kind::kNull;  // LCOV_EXCL_LINE
+}
+
+const Json::Document::Value* Json::Document::Value::Find(std::string_view property) const noexcept {
+  if (!IsObject()) {
+    return nullptr;
+  }
+  const std::span<const Member> members(members_, size_);
+  const auto it = std::ranges::lower_bound(members, property, std::less<>{}, &Member::name);
+  return it != members.end() && it->name == property ? &it->value : nullptr;
+}
+
+Json Json::Document::Value::ToJson() const {  // NOLINT(misc-no-recursion)
+  Json json;
+  switch (type_) {
+    case Type::kNull: break;
+    case Type::kFalse: json.data_.emplace<bool>(false); break;
+    case Type::kTrue: json.data_.emplace<bool>(true); break;
+    case Type::kSignedInt: json.data_.emplace<SignedInt>(signed_int_); break;
+    case Type::kUnsignedInt: json.data_.emplace<UnsignedInt>(unsigned_int_); break;
+    case Type::kFloat: json.data_.emplace<Float>(float_); break;
+    case Type::kString: json.data_.emplace<std::string>(string_, size_); break;
+    case Type::kArray: {
+      auto& array = *json.data_.emplace<Array>(std::make_unique<Array::element_type>());
+      array.reserve(size_);
+      for (const Value& element : array_values()) {
+        array.push_back(element.ToJson());
+      }
+      break;
+    }
+    case Type::kObject: {
+      Object& object = json.data_.emplace<Object>();  // NOLINT(*-auto)
+      object.reserve(size_);
+      for (const Member& member : property_pairs()) {
+        object.try_emplace(std::string(member.name), std::make_unique<Json>(member.value.ToJson()));
+      }
+      break;
+    }
+  }
+  return json;
+}
+
+}  // namespace mbo::json
@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_JSON_JSON_DOCUMENT_H_
+#define MBO_JSON_JSON_DOCUMENT_H_
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "absl/status/statusor.h"
+#include "mbo/config/require.h"
+#include "mbo/json/internal/json_arena.h"
+#include "mbo/json/json.h"
+
+namespace mbo::json {
+
+// A read-only JSON document whose values, arrays, objects, keys and strings all live in an arena: building it takes a
+// few large allocations instead of one or more per value, and destroying it releases them at once without visiting
+// the values. The values offer the const API of `Json` (`Is*`, `GetKind`, `size`, `contains`, `operator[]`, `at`,
+// iteration, comparison and serialization) plus typed getters and `ToJson` to get a modifiable `Json`.
+//
+// Objects are sorted by key (for duplicate keys the last value wins) and looked up by binary search.
+//
+// Example:
+//
+// ```
+// MBO_ASSIGN_OR_RETURN(const Json::Document doc, Json::Document::Parse(R"({"a": [1, 2, 3]})"));
+// for (const Json::Document::Value& value : doc.root()["a"]) {
+//   total += value.GetSignedInt();
+// }
+// ```
+class Json::Document final {
+ public:
+  struct Member;
+
+  // A value of the document. References into the document, which must outlive it.
+  class Value final {
+   public:
+    using const_iterator = const Value*;
+    using iterator = const_iterator;
+
+    Value() noexcept = default;
+
+    bool IsNull() const noexcept { return type_ == Type::kNull; }
+
+    bool IsBool() const noexcept { return type_ == Type::kFalse || type_ == Type::kTrue; }
+
+    bool IsFalse() const noexcept { return type_ == Type::kFalse; }
+
+    bool IsTrue() const noexcept { return type_ == Type::kTrue; }
+
+    bool IsSignedInt() const noexcept { return type_ == Type::kSignedInt; }
+
+    bool IsUnsignedInt() const noexcept { return type_ == Type::kUnsignedInt; }
+
+    bool IsInteger() const noexcept { return IsSignedInt() || IsUnsignedInt(); }
+
+    bool IsFloat() const noexcept { return type_ == Type::kFloat; }
+
+    bool IsNumber() const noexcept { return IsInteger() || IsFloat(); }
+
+    bool IsString() const noexcept { return type_ == Type::kString; }
+
+    bool IsArray() const noexcept { return type_ == Type::kArray; }
+
+    bool IsObject() const noexcept { return type_ == Type::kObject; }
+
+    explicit operator bool() const noexcept { return !IsNull(); }
+
+    Kind GetKind() const noexcept;
+
+    bool GetBool() const {
+      MBO_CONFIG_REQUIRE(IsBool(), "Is not a Bool.");
+      return IsTrue();
+    }
+
+    SignedInt GetSignedInt() const {
+      MBO_CONFIG_REQUIRE(IsSignedInt(), "Is not a SignedInt.");
+      return signed_int_;
+    }
+
+    UnsignedInt GetUnsignedInt() const {
+      MBO_CONFIG_REQUIRE(IsUnsignedInt(), "Is not an UnsignedInt.");
+      return unsigned_int_;
+    }
+
+    Float GetFloat() const {
+      MBO_CONFIG_REQUIRE(IsFloat(), "Is not a Float.");
+      return float_;
+    }
+
+    std::string_view GetString() const {
+      MBO_CONFIG_REQUIRE(IsString(), "Is not a String.");
+      return {string_, size_};
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    // The number of elements or members (0 for all other kinds).
+    std::size_t size() const noexcept { return IsArray() || IsObject() ? size_ : 0; }
+
+    bool contains(std::string_view property) const noexcept { return Find(property) != nullptr; }
+
+    // Returns the value of `property` or nullptr if this is not an Object or `property` is not present.
+    const Value* Find(std::string_view property) const noexcept;
+
+    // NOLINTBEGIN(*-avoid-unchecked-container-access): Checked accessors, as for `Json`.
+    const Value& operator[](std::size_t index) const {
+      MBO_CONFIG_REQUIRE(IsArray(), "Is not an Array.");
+      MBO_CONFIG_REQUIRE(index < size_, "Out of range.");
+      return elements_[index];  // NOLINT(*-pointer-arithmetic)
+    }
+
+    const Value& operator[](std::string_view property) const {
+      MBO_CONFIG_REQUIRE(IsObject(), "Is not an Object.");
+      const Value* value = Find(property);
+      MBO_CONFIG_REQUIRE(value != nullptr, "Property not present:") << "'" << property << "'.";
+      return *value;
+    }
+
+    // NOLINTEND(*-avoid-unchecked-container-access)
+
+    const Value& at(std::size_t index) const { return (*this)[index]; }
+
+    const Value& at(std::string_view property) const { return (*this)[property]; }
+
+    const_iterator begin() const { return array_values().data(); }
+
+    const_iterator end() const {
+      const std::span<const Value> values = array_values();
+      return values.data() + values.size();  // NOLINT(*-pointer-arithmetic)
+    }
+
+    std::span<const Value> array_values() const {
+      MBO_CONFIG_REQUIRE(IsArray(), "Is not an Array.");
+      return {elements_, size_};
+    }
+
+    // The members in the order of their names.
+    std::span<const Member> property_pairs() const {
+      MBO_CONFIG_REQUIRE(IsObject(), "Is not an Object.");
+      return {members_, size_};
+    }
+
+    auto property_names() const {
+      return std::views::transform(property_pairs(), [](const Member& member) { return member.name; });
+    }
+
+    auto property_values() const {
+      return std::views::transform(
+          property_pairs(), [](const Member& member) -> const Value& { return member.value; });
+    }
+
+    // Returns a (deep) copy as a `Json`.
+    Json ToJson() const;
+
+    // Comparison and serialization work on `ToJson()`, so they are meant for tests and diagnostics.
+
+    std::strong_ordering operator<=>(const Json& other) const { return ToJson() <=> other; }
+
+    bool operator==(const Json& other) const { return ToJson() == other; }
+
+    template<ConvertibleToJson Other>
+    std::strong_ordering operator<=>(const Other& other) const {
+      return ToJson() <=> other;
+    }
+
+    template<ConvertibleToJson Other>
+    bool operator==(const Other& other) const {
+      return ToJson() == other;
+    }
+
+    std::ostream& Stream(
+        std::ostream& os,
+        SerializeMode mode = SerializeMode::kCompact,
+        const types::StringifyRootOptions& root_options = types::StringifyRootOptions{}) const {
+      return ToJson().Stream(os, mode, root_options);
+    }
+
+    std::string Serialize(
+        SerializeMode mode = SerializeMode::kCompact,
+        const types::StringifyRootOptions& root_options = types::StringifyRootOptions{}) const {
+      return ToJson().Serialize(mode, root_options);
+    }
+
+   private:
+    friend class Document;
+
+    enum class Type : uint8_t {
+      kNull,
+      kFalse,
+      kTrue,
+      kSignedInt,
+      kUnsignedInt,
+      kFloat,
+      kString,
+      kArray,
+      kObject,
+    };
+
+    Type type_ = Type::kNull;
+    uint32_t size_ = 0;  // Of the string, array or object.
+
+    union {
+      SignedInt signed_int_ = 0;
+      UnsignedInt unsigned_int_;
+      Float float_;
+      const char* string_;
+      const Value* elements_;
+      const Member* members_;
+    };
+  };
+
+  struct Member {
+    std::string_view name;
+    Value value;
+  };
+
+  ~Document() noexcept = default;
+
+  // A document holding a Null value.
+  Document() noexcept = default;
+
+  // Copies `json` into a new document.
+  explicit Document(const Json& json);
+
+  Document(const Document&) = delete;
+  Document& operator=(const Document&) = delete;
+  Document(Document&&) noexcept = default;
+  Document& operator=(Document&&) noexcept = default;
+
+  // Parses the JSON `text` just like `Json::Parse`, but into a document.
+  static absl::StatusOr<Document> Parse(std::string_view text);
+
+  // Parses the contents of the file `path` just like `Json::ParseFile`, but into a document.
+  static absl::StatusOr<Document> ParseFile(const std::filesystem::path& path);
+
+  const Value& root() const noexcept { return root_; }
+
+  Json ToJson() const { return root_.ToJson(); }
+
+  // The bytes held by the arena. Parsing reserves an upper bound of its needs at once, most of which is often never
+  // touched and hence never backed by physical memory.
+  std::size_t BytesReserved() const noexcept { return arena_.BytesReserved(); }
+
+ private:
+  class Builder;  // Implemented in `json_document.cc`.
+
+  json_internal::Arena arena_;
+  Value root_;
+};
+
+static_assert(sizeof(Json::Document::Value) == 16);
+static_assert(std::is_trivially_copyable_v<Json::Document::Value>);
+static_assert(std::is_trivially_destructible_v<Json::Document::Member>);
+
+}  // namespace mbo::json
+
+#endif  // MBO_JSON_JSON_DOCUMENT_H_
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Building and destroying `Json` vs the arena backed `Json::Document` on the corpora of `json_benchmark_corpus.h`:
+// parsing, copying a `Json` (into a `Json` or a `Json::Document`) and destruction. The counter `allocs` is the number
+// of heap allocations per built document.
+// Run with: MBO_JSON_BENCHMARK_CORPUS=/path/to/jsonexamples bazel run -c opt //mbo/json:json_document_benchmark
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "mbo/json/json.h"
+#include "mbo/json/json_benchmark_corpus.h"
+#include "mbo/json/json_document.h"
+
+namespace {
+
+std::atomic<int64_t> num_allocations{0};  // NOLINT(*-avoid-non-const-global-variables)
+
+}  // namespace
+
+// Counts all allocations of the benchmark (the array and `nothrow` forms end up here as well).
+void* operator new(std::size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {  // NOLINT(*-no-malloc,*-owning-memory)
+    return ptr;
+  }
+#if __cpp_exceptions
+  throw std::bad_alloc();
+#else   // __cpp_exceptions
+  std::abort();
+#endif  // __cpp_exceptions
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);  // NOLINT(*-no-malloc,*-owning-memory)
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);  // NOLINT(*-no-malloc,*-owning-memory)
+}
+
+namespace mbo::json {
+namespace {
+
+template<typename T>
+struct Repr;
+
+template<>
+struct Repr<Json> {
+  static constexpr const char* kName = "Json";
+
+  static absl::StatusOr<Json> Parse(std::string_view text) { return Json::Parse(text); }
+
+  static Json Copy(const Json& json) { return json; }
+};
+
+template<>
+struct Repr<Json::Document> {
+  static constexpr const char* kName = "Document";
+
+  static absl::StatusOr<Json::Document> Parse(std::string_view text) { return Json::Document::Parse(text); }
+
+  static Json::Document Copy(const Json& json) { return Json::Document(json); }
+};
+
+void SetCounters(benchmark::State& state, const Corpus& corpus, int64_t allocations) {
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(corpus.text.size()));
+  state.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+template<typename T>
+void BmParse(benchmark::State& state, const Corpus& corpus) {
+  if (!Repr<T>::Parse(corpus.text).ok()) {
+    state.SkipWithError("The corpus is not valid JSON.");
+    return;
+  }
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    const int64_t before = num_allocations.load(std::memory_order_relaxed);
+    std::optional<absl::StatusOr<T>> value(Repr<T>::Parse(corpus.text));
+    allocations += num_allocations.load(std::memory_order_relaxed) - before;
+    benchmark::DoNotOptimize(value);
+    state.PauseTiming();
+    value.reset();
+    state.ResumeTiming();
+  }
+  SetCounters(state, corpus, allocations);
+}
+
+template<typename T>
+void BmCopy(benchmark::State& state, const Corpus& corpus) {
+  const absl::StatusOr<Json> json = Json::Parse(corpus.text);
+  if (!json.ok()) {
+    state.SkipWithError("The corpus is not valid JSON.");
+    return;
+  }
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    const int64_t before = num_allocations.load(std::memory_order_relaxed);
+    std::optional<T> value(Repr<T>::Copy(*json));
+    allocations += num_allocations.load(std::memory_order_relaxed) - before;
+    benchmark::DoNotOptimize(value);
+    state.PauseTiming();
+    value.reset();
+    state.ResumeTiming();
+  }
+  SetCounters(state, corpus, allocations);
+}
+
+template<typename T>
+void BmDestroy(benchmark::State& state, const Corpus& corpus) {
+  if (!Repr<T>::Parse(corpus.text).ok()) {
+    state.SkipWithError("The corpus is not valid JSON.");
+    return;
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::optional<absl::StatusOr<T>> value(Repr<T>::Parse(corpus.text));
+    benchmark::DoNotOptimize(value);
+    state.ResumeTiming();
+    value.reset();
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(corpus.text.size()));
+}
+
+// Destruction only takes a fraction of the untimed parse, so its iterations are fixed instead of timed.
+constexpr benchmark::IterationCount kDestroyIterations = 50;
+
+template<typename T>
+benchmark::internal::Benchmark* Register(
+    const char* name,
+    void (*run)(benchmark::State&, const Corpus&),
+    const Corpus& corpus) {
+  return benchmark::RegisterBenchmark(
+      absl::StrCat(name, "<", Repr<T>::kName, ">/", corpus.name),
+      [run, &corpus](benchmark::State& state) { run(state, corpus); });
+}
+
+void RegisterAll() {
+  for (const Corpus& corpus : Corpora()) {
+    Register<Json>("BmParse", &BmParse<Json>, corpus);
+    Register<Json::Document>("BmParse", &BmParse<Json::Document>, corpus);
+    Register<Json>("BmCopy", &BmCopy<Json>, corpus);
+    Register<Json::Document>("BmCopy", &BmCopy<Json::Document>, corpus);
+    Register<Json>("BmDestroy", &BmDestroy<Json>, corpus)->Iterations(kDestroyIterations);
+    Register<Json::Document>("BmDestroy", &BmDestroy<Json::Document>, corpus)->Iterations(kDestroyIterations);
+  }
+}
+
+}  // namespace
+}  // namespace mbo::json
+
+int main(int argc, char** argv) {
+  mbo::json::RegisterAll();
+  benchmark::Initialize(&argc, argv);
+  for (const mbo::json::Corpus& corpus : mbo::json::Corpora()) {
+    benchmark::AddCustomContext(corpus.name, absl::StrCat(corpus.text.size(), " bytes"));
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,221 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/json_document.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/file/file.h"
+#include "mbo/json/internal/json_arena.h"
+#include "mbo/json/json.h"
+#include "mbo/testing/status.h"
+
+namespace mbo::json {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::mbo::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+struct JsonDocumentTest : ::testing::Test {
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  using Document = Json::Document;
+  using Value = Json::Document::Value;
+};
+
+TEST_F(JsonDocumentTest, Arena) {
+  json_internal::Arena arena;
+  EXPECT_EQ(arena.NumBlocks(), 0);
+  EXPECT_THAT(arena.CopyString(""), IsEmpty());
+  EXPECT_EQ(arena.NumBlocks(), 0);
+  const std::string_view str = arena.CopyString("abc");
+  EXPECT_EQ(str, "abc");
+  const std::span<uint64_t> numbers = arena.AllocateArray<uint64_t>(3);
+  EXPECT_THAT(numbers, ElementsAre(0, 0, 0));
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(numbers.data()) % alignof(uint64_t), 0);  // NOLINT(*-reinterpret-cast)
+  EXPECT_EQ(arena.NumBlocks(), 1);
+  EXPECT_EQ(arena.BytesReserved(), json_internal::Arena::kMinBlockSize);
+  // Too large for the rest of the block.
+  const std::string large(json_internal::Arena::kMinBlockSize * 3, 'x');
+  EXPECT_EQ(arena.CopyString(large), large);
+  EXPECT_EQ(arena.NumBlocks(), 2);
+  json_internal::Arena moved = std::move(arena);
+  EXPECT_EQ(moved.NumBlocks(), 2);
+  EXPECT_EQ(str, "abc");
+}
+
+TEST_F(JsonDocumentTest, Scalars) {
+  MBO_ASSERT_OK_AND_ASSIGN(const Document null, Document::Parse(" null "));
+  EXPECT_TRUE(null.root().IsNull());
+  EXPECT_EQ(null.root().GetKind(), Json::Kind::kNull);
+  MBO_ASSERT_OK_AND_ASSIGN(const Document yes, Document::Parse("true"));
+  EXPECT_TRUE(yes.root().IsTrue());
+  EXPECT_TRUE(yes.root().GetBool());
+  MBO_ASSERT_OK_AND_ASSIGN(const Document no, Document::Parse("false"));
+  EXPECT_TRUE(no.root().IsFalse());
+  EXPECT_EQ(no.root().GetKind(), Json::Kind::kBool);
+  MBO_ASSERT_OK_AND_ASSIGN(const Document str, Document::Parse(R"("a\"b\nä")"));
+  EXPECT_EQ(str.root().GetString(), "a\"b\n\xC3\xA4");
+  EXPECT_EQ(str.root(), "a\"b\n\xC3\xA4");
+  MBO_ASSERT_OK_AND_ASSIGN(const Document signed_int, Document::Parse("-42"));
+  EXPECT_EQ(signed_int.root().GetSignedInt(), -42);
+  EXPECT_EQ(signed_int.root(), -42);
+  MBO_ASSERT_OK_AND_ASSIGN(const Document unsigned_int, Document::Parse("18446744073709551615"));
+  EXPECT_EQ(unsigned_int.root().GetUnsignedInt(), std::numeric_limits<uint64_t>::max());
+  MBO_ASSERT_OK_AND_ASSIGN(const Document number, Document::Parse("2.5e-1"));
+  EXPECT_EQ(number.root().GetFloat(), 0.25);
+  EXPECT_EQ(number.root().GetKind(), Json::Kind::kNumber);
+}
+
+TEST_F(JsonDocumentTest, Containers) {
+  MBO_ASSERT_OK_AND_ASSIGN(
+      const Document doc, Document::Parse(R"({"d": "e", "a": [1, 2, {"b": []}], "c": {}, "a2": [[[]]], "f": -1.5})"));
+  const Value& root = doc.root();
+  ASSERT_TRUE(root.IsObject());
+  EXPECT_EQ(root.size(), 5);
+  const auto names = root.property_names();
+  EXPECT_THAT(std::vector<std::string_view>(names.begin(), names.end()), ElementsAre("a", "a2", "c", "d", "f"));
+  ASSERT_TRUE(root["a"].IsArray());
+  EXPECT_EQ(root["a"].size(), 3);
+  EXPECT_EQ(root["a"][0], 1);
+  EXPECT_EQ(root["a"][1], 2);
+  EXPECT_TRUE(root["a"][2]["b"].IsArray());
+  EXPECT_TRUE(root["a"][2]["b"].empty());
+  EXPECT_TRUE(root["c"].IsObject());
+  EXPECT_TRUE(root["c"].empty());
+  EXPECT_EQ(root.at("d"), "e");
+  EXPECT_EQ(root["a2"][0][0].size(), 0);
+  EXPECT_EQ(root["f"], -1.5);
+  EXPECT_TRUE(root.contains("f"));
+  EXPECT_FALSE(root.contains("g"));
+  EXPECT_EQ(root.Find("g"), nullptr);
+  EXPECT_EQ(root["a"].Find("a"), nullptr);
+  std::vector<int64_t> values;
+  for (const Value& value : root["a"]) {
+    if (value.IsSignedInt()) {
+      values.push_back(value.GetSignedInt());
+    }
+  }
+  EXPECT_THAT(values, ElementsAre(1, 2));
+  MBO_ASSERT_OK_AND_ASSIGN(const Document duplicate, Document::Parse(R"({"a": [1], "b": 0, "a": 2, "a": 3})"));
+  EXPECT_EQ(duplicate.root().size(), 2);
+  EXPECT_EQ(duplicate.root()["a"], 3);
+}
+
+TEST_F(JsonDocumentTest, LargeObject) {
+  // Beyond insertion sort, reversed and with a duplicate of every key.
+  std::string text = "{";
+  for (int idx = 99; idx >= 0; --idx) {
+    text += "\"" + std::to_string(1000 + idx) + "\": " + std::to_string(idx) + ", ";
+  }
+  for (int idx = 0; idx < 100; ++idx) {
+    text += "\"" + std::to_string(1000 + idx) + "\": " + std::to_string(-idx) + (idx < 99 ? ", " : "}");
+  }
+  MBO_ASSERT_OK_AND_ASSIGN(const Document doc, Document::Parse(text));
+  ASSERT_EQ(doc.root().size(), 100);
+  for (int idx = 0; idx < 100; ++idx) {
+    EXPECT_EQ(doc.root()[std::to_string(1000 + idx)], -idx);
+  }
+}
+
+TEST_F(JsonDocumentTest, JsonRoundTrip) {
+  Json json;
+  json["null"];
+  json["bool"] = true;
+  json["int"] = -17;
+  json["uint"] = std::numeric_limits<uint64_t>::max();
+  json["float"] = 0.25;
+  json["string"] = "with \"quotes\"";
+  json["array"].push_back(1);
+  json["array"].push_back("two");
+  json["object"]["nested"] = false;
+  const Document doc(json);
+  EXPECT_EQ(doc.root(), json);
+  EXPECT_EQ(doc.ToJson(), json);
+  EXPECT_EQ(doc.root()["array"][1], "two");
+  EXPECT_TRUE(doc.root()["null"].IsNull());
+  EXPECT_EQ(doc.root()["uint"].GetUnsignedInt(), std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(doc.root().Serialize(Json::SerializeMode::kPretty), json.Serialize(Json::SerializeMode::kPretty));
+  MBO_ASSERT_OK_AND_ASSIGN(const Document parsed, Document::Parse(json.Serialize()));
+  EXPECT_EQ(parsed.root(), json);
+}
+
+TEST_F(JsonDocumentTest, SameAsJsonParse) {
+  constexpr std::string_view kText =
+      R"({"statuses": [{"id": 1, "text": "aä😀", "tags": [], "user": {"name": "x", "id": 2.5}},)"
+      R"( {"id": 18446744073709551615, "text": "", "tags": [true, false, null], "user": {}}], "count": -3})";
+  MBO_ASSERT_OK_AND_ASSIGN(const Document doc, Document::Parse(kText));
+  MBO_ASSERT_OK_AND_ASSIGN(const Json json, Json::Parse(kText));
+  EXPECT_EQ(doc.ToJson(), json);
+}
+
+TEST_F(JsonDocumentTest, SingleAllocation) {
+  std::string text = "[";
+  for (std::size_t idx = 0; idx < 100'000; ++idx) {
+    text += idx == 0 ? "" : ",";
+    text += R"({"id": )" + std::to_string(idx) + R"(, "name": "node"})";
+  }
+  text += "]";
+  MBO_ASSERT_OK_AND_ASSIGN(Document doc, Document::Parse(text));
+  // A single arena block, that stays valid as the document moves.
+  EXPECT_GE(doc.BytesReserved(), text.size());
+  const Value* const first = &doc.root()[0];
+  const Document moved = std::move(doc);
+  EXPECT_EQ(&moved.root()[0], first);
+  EXPECT_EQ(moved.root().size(), 100'000);
+  EXPECT_EQ(moved.root()[99'999]["id"], 99'999);
+  EXPECT_EQ(moved.root()[99'999]["name"], "node");
+}
+
+TEST_F(JsonDocumentTest, Errors) {
+  EXPECT_THAT(Document::Parse(""), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("end of input")));
+  EXPECT_THAT(Document::Parse("[1 2]"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Expected ',' or ']'")));
+  EXPECT_THAT(Document::Parse(R"({"a": 1,})"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("string key")));
+  EXPECT_THAT(Document::Parse(R"(["a)"), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      Document::Parse(std::string(2'000, '[')), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("too deep")));
+}
+
+TEST_F(JsonDocumentTest, ParseFile) {
+  const std::filesystem::path path = std::filesystem::path(::testing::TempDir()) / "json_document_test.json";
+  ASSERT_OK(file::SetContents(path, R"({"a": [1, 2]})"));
+  MBO_ASSERT_OK_AND_ASSIGN(const Document doc, Document::ParseFile(path));
+  EXPECT_EQ(doc.root()["a"][1], 2);
+  ASSERT_OK(file::SetContents(path, "[1,"));
+  EXPECT_THAT(
+      Document::ParseFile(path),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("json_document_test.json: JSON error")));
+  EXPECT_THAT(Document::ParseFile(path.string() + ".missing"), StatusIs(absl::StatusCode::kNotFound));
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::json
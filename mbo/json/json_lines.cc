@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/json_lines.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "mbo/config/require.h"
+#include "mbo/file/file.h"
+#include "mbo/json/internal/json_structural.h"
+#include "mbo/json/json.h"
+#include "mbo/types/stringify.h"
+
+namespace mbo::json {
+namespace {
+
+JsonLinesReaderOptions WithBatchBytes(JsonLinesReaderOptions options) noexcept {
+  if (options.batch_bytes == 0) {
+    constexpr std::size_t kBatchBytesPerThread = std::size_t{64} << 10;
+    options.batch_bytes = kBatchBytesPerThread * (options.executor == nullptr ? 1 : options.executor->Concurrency());
+  }
+  return options;
+}
+
+}  // namespace
+
+JsonLinesReader::JsonLinesReader(std::string_view text, Options options) noexcept
+    : options_(WithBatchBytes(options)), text_(text) {}
+
+JsonLinesReader::JsonLinesReader(std::istream& input, Options options) noexcept
+    : options_(WithBatchBytes(options)), input_(&input) {}
+
+absl::StatusOr<JsonLinesReader> JsonLinesReader::Open(const std::filesystem::path& path, Options options) {
+  absl::StatusOr<file::MappedContents> contents = file::GetMappedContents(path);
+  if (!contents.ok()) {
+    return contents.status();
+  }
+  JsonLinesReader reader(contents->View(), options);
+  reader.contents_ = *std::move(contents);  // Moving keeps the contents in place.
+  return reader;
+}
+
+absl::StatusOr<std::string_view> JsonLinesReader::NextChunk() {
+  std::size_t size = options_.batch_bytes;
+  if (input_ == nullptr) {
+    size = std::min(size, text_.size());
+    // Double the window until it has a line feed (or is all of the rest).
+    while (size < text_.size()) {
+      if (const std::size_t last = text_.rfind('\n', size - 1); last != std::string_view::npos) {
+        size = last + 1;
+        break;
+      }
+      size = std::min(size * 2, text_.size());
+    }
+    const std::string_view chunk = text_.substr(0, size);
+    text_.remove_prefix(size);
+    return chunk;
+  }
+  buffer_.erase(0, consumed_);
+  bool at_end = !input_->good();
+  while (true) {
+    if (!at_end && buffer_.size() < size) {
+      const std::size_t have = buffer_.size();
+      buffer_.resize(size);
+      input_->read(buffer_.data() + have, static_cast<std::streamsize>(size - have));  // NOLINT(*-pointer-arithmetic)
+      buffer_.resize(have + static_cast<std::size_t>(input_->gcount()));
+      if (input_->bad()) {
+        return absl::DataLossError("Unable to read the JSON Lines input.");
+      }
+      at_end = !input_->good();
+    }
+    if (const std::size_t last = std::string_view(buffer_).rfind('\n'); last != std::string_view::npos) {
+      consumed_ = last + 1;
+      break;
+    }
+    if (at_end) {
+      consumed_ = buffer_.size();
+      break;
+    }
+    size *= 2;
+  }
+  return std::string_view(buffer_).substr(0, consumed_);
+}
+
+absl::Status JsonLinesReader::ParseBatch() {
+  batch_.clear();
+  parsed_.clear();
+  next_ = 0;
+  while (batch_.empty()) {
+    const absl::StatusOr<std::string_view> chunk = NextChunk();
+    if (!chunk.ok()) {
+      return chunk.status();
+    }
+    if (chunk->empty()) {
+      return absl::OkStatus();
+    }
+    if (absl::Status status = json_internal::FindNewlines(*chunk, newlines_); !status.ok()) {
+      return status;
+    }
+    std::size_t begin = 0;
+    const auto add_line = [&](std::size_t end) {
+      const std::string_view line = chunk->substr(begin, end - begin);
+      ++lines_;
+      if (line.find_first_not_of(" \t\r") != std::string_view::npos) {
+        batch_.push_back({.text = line, .number = lines_});
+      }
+      begin = end + 1;
+    };
+    for (const uint32_t newline : newlines_) {
+      add_line(newline);
+    }
+    if (begin < chunk->size()) {
+      add_line(chunk->size());  // The last line has no line feed.
+    }
+  }
+  parsed_.resize(batch_.size());
+  const auto parse = [this](std::size_t begin, std::size_t end) {
+    // NOLINTBEGIN(*-avoid-unchecked-container-access): Both have the same size.
+    for (std::size_t idx = begin; idx < end; ++idx) {
+      parsed_[idx] = Json::Parse(batch_[idx].text);
+    }
+    // NOLINTEND(*-avoid-unchecked-container-access)
+  };
+  const std::size_t size = batch_.size();
+  if (options_.executor == nullptr || size == 1) {
+    parse(0, size);
+  } else {
+    // Contiguous ranges (a few per worker to even out record sizes) keep the tasks cache friendly.
+    const std::size_t tasks = std::min(size, options_.executor->Concurrency() * 4);
+    options_.executor->ParallelFor(tasks, [&](std::size_t task) {
+      parse(size * task / tasks, size * (task + 1) / tasks);
+    });
+  }
+  return absl::OkStatus();
+}
+
+absl::Status JsonLinesReader::ReadBatch(std::vector<Json>& records) {
+  records.clear();
+  if (next_ == parsed_.size()) {
+    if (absl::Status status = ParseBatch(); !status.ok()) {
+      return status;
+    }
+  }
+  records.reserve(parsed_.size() - next_);
+  // NOLINTBEGIN(*-avoid-unchecked-container-access): Both have the same size.
+  for (; next_ < parsed_.size(); ++next_) {
+    absl::StatusOr<Json>& record = parsed_[next_];
+    if (!record.ok()) {
+      const std::size_t number = batch_[next_++].number;
+      return absl::Status(record.status().code(), absl::StrCat("Line ", number, ": ", record.status().message()));
+    }
+    records.push_back(*std::move(record));
+  }
+  // NOLINTEND(*-avoid-unchecked-container-access)
+  return absl::OkStatus();
+}
+
+JsonLinesWriter::JsonLinesWriter(std::ostream& output, Options options) : options_(options), output_(output) {
+  MBO_CONFIG_REQUIRE(options.mode != Json::SerializeMode::kPretty, "JSON Lines records must be single lines.");
+  buffer_.reserve(options.buffer_bytes);
+}
+
+JsonLinesWriter::~JsonLinesWriter() noexcept {
+  if (Drain()) {
+    output_.flush();
+  }
+}
+
+bool JsonLinesWriter::Drain() {
+  if (!buffer_.empty()) {
+    output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+  }
+  return output_.good();
+}
+
+absl::Status JsonLinesWriter::Error() const {
+  return absl::DataLossError(absl::StrCat("Unable to write the JSON Lines output after ", records_, " records."));
+}
+
+absl::Status JsonLinesWriter::Write(const Json& record) {
+  // Unlike `Json::AppendSerialized` this serializes every kind of value (and Null as `null`).
+  const types::Stringify stringify{static_cast<types::Stringify::OutputMode>(options_.mode)};
+  stringify.AppendTo(buffer_, record);  // Ends in a line feed.
+  if (buffer_.size() >= options_.buffer_bytes ? !Drain() : !output_.good()) {
+    return Error();
+  }
+  ++records_;
+  return absl::OkStatus();
+}
+
+absl::Status JsonLinesWriter::Flush() {
+  return Drain() && output_.flush().good() ? absl::OkStatus() : Error();
+}
+
+}  // namespace mbo::json
@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_JSON_JSON_LINES_H_
+#define MBO_JSON_JSON_LINES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mbo/file/file.h"
+#include "mbo/json/json.h"
+#include "mbo/thread/executor.h"
+
+namespace mbo::json {
+
+struct JsonLinesReaderOptions {
+  // The number of bytes per batch. A batch ends after the last full line that fits, or after the first line if that is
+  // longer. The default of 0 means 64 KiB per thread of the `executor`: the records of smaller batches are still in
+  // the caches when they are returned, which makes up for the overhead of more batches.
+  std::size_t batch_bytes = 0;
+
+  // Parses the records of each batch, if set. Otherwise the calling thread parses them.
+  thread::Executor* executor = nullptr;
+};
+
+// Reads JSON Lines (https://jsonlines.org): one JSON value per line. The input is read in batches of whole lines. The
+// lines of a batch are found with a vectorized scan for line feeds (records cannot contain raw line feeds), and then
+// parsed in parallel on the `Options::executor`. Records are returned in the order of the input. Blank lines (empty or
+// only whitespace) are skipped, but still counted for the line numbers of errors.
+//
+// Example:
+//
+// ```
+// mbo::thread::ThreadPool pool;
+// MBO_ASSIGN_OR_RETURN(JsonLinesReader reader, JsonLinesReader::Open(path, {.executor = &pool}));
+// std::vector<Json> records;
+// do {
+//   MBO_RETURN_IF_ERROR(reader.ReadBatch(records));
+//   for (const Json& record : records) { ... }
+// } while (!records.empty());
+// ```
+class JsonLinesReader final {
+ public:
+  using Options = JsonLinesReaderOptions;
+
+  ~JsonLinesReader() noexcept = default;
+
+  JsonLinesReader(const JsonLinesReader&) = delete;
+  JsonLinesReader& operator=(const JsonLinesReader&) = delete;
+  JsonLinesReader(JsonLinesReader&&) noexcept = default;
+  JsonLinesReader& operator=(JsonLinesReader&&) noexcept = default;
+
+  // Reads the records of `text`, which must outlive the reader.
+  explicit JsonLinesReader(std::string_view text, Options options = {}) noexcept;
+
+  // Reads the records of `input`, which must outlive the reader, in chunks of about `Options::batch_bytes`.
+  explicit JsonLinesReader(std::istream& input, Options options = {}) noexcept;
+
+  // Maps the file `path` (if possible) and reads its records. The reader owns the contents.
+  //
+  // Returns:
+  //  * JsonLinesReader:    The reader, positioned at the first record.
+  //  * Any error of `mbo::file::GetMappedContents`.
+  static absl::StatusOr<JsonLinesReader> Open(const std::filesystem::path& path, Options options = {});
+
+  // Replaces `records` with the next records. An empty `records` with an OK status means the input is exhausted.
+  //
+  // Returns:
+  //  * absl::OkStatus:              All `records` are valid.
+  //  * absl::InvalidArgumentError:  A record is malformed, the message starts with "Line <number>: ". The `records`
+  //                                 hold the valid records before it, and the next call continues after it.
+  //  * absl::DataLossError:         Reading the `std::istream` failed.
+  absl::Status ReadBatch(std::vector<Json>& records);
+
+  // The number of lines read so far, including blank and malformed ones.
+  std::size_t lines() const noexcept { return lines_; }
+
+ private:
+  struct Line {
+    std::string_view text;
+    std::size_t number = 0;  // 1-based.
+  };
+
+  // Finds the next chunk of whole lines, which is empty at the end of the input.
+  absl::StatusOr<std::string_view> NextChunk();
+
+  // Splits and parses the lines of the next non empty chunk into `parsed_`.
+  absl::Status ParseBatch();
+
+  Options options_;
+  std::string_view text_;  // Not yet chunked, unless reading from `input_`.
+  std::istream* input_ = nullptr;
+  std::string buffer_;             // For `input_`: the current chunk followed by the start of the next.
+  std::size_t consumed_ = 0;       // The size of the current chunk in `buffer_`.
+  file::MappedContents contents_;  // For `Open`.
+  std::size_t lines_ = 0;
+  std::vector<uint32_t> newlines_;
+  std::vector<Line> batch_;
+  std::vector<absl::StatusOr<Json>> parsed_;
+  std::size_t next_ = 0;  // The next record of `parsed_` to return.
+};
+
+struct JsonLinesWriterOptions {
+  // The size of the buffer: it is written to the output once a record makes it reach this size.
+  std::size_t buffer_bytes = std::size_t{1} << 20;
+
+  // Either `kCompact` or `kLine`.
+  Json::SerializeMode mode = Json::SerializeMode::kCompact;
+};
+
+// Writes JSON Lines: every record is serialized on a single line, followed by a line feed. Records can be of any
+// kind, e.g. a Null record is written as `null`. They are serialized straight into a buffer (see
+// `types::Stringify::AppendTo`), which is written to the output when it is full, on `Flush` and on destruction.
+class JsonLinesWriter final {
+ public:
+  using Options = JsonLinesWriterOptions;
+
+  // Writes to `output`, which must outlive the writer.
+  explicit JsonLinesWriter(std::ostream& output, Options options = {});
+
+  // Flushes the buffer, ignoring errors.
+  ~JsonLinesWriter() noexcept;
+
+  JsonLinesWriter(const JsonLinesWriter&) = delete;
+  JsonLinesWriter& operator=(const JsonLinesWriter&) = delete;
+  JsonLinesWriter(JsonLinesWriter&&) = delete;
+  JsonLinesWriter& operator=(JsonLinesWriter&&) = delete;
+
+  // Appends `record` followed by a line feed.
+  //
+  // Returns:
+  //  * absl::OkStatus:              The record is buffered or written.
+  //  * absl::DataLossError:         Writing to the output failed (now or in an earlier call).
+  absl::Status Write(const Json& record);
+
+  // Writes the buffer to the output and flushes that.
+  absl::Status Flush();
+
+  // The number of records written so far.
+  std::size_t records() const noexcept { return records_; }
+
+ private:
+  // Writes the buffered bytes to the output.
+  bool Drain();
+
+  absl::Status Error() const;
+
+  const Options options_;
+  std::ostream& output_;
+  std::string buffer_;
+  std::size_t records_ = 0;
+};
+
+}  // namespace mbo::json
+
+#endif  // MBO_JSON_JSON_LINES_H_
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput of reading and writing JSON Lines of log-like records: `JsonLinesReader` on the calling thread and on
+// thread pools vs `std::getline` with `Json::Parse`, and `JsonLinesWriter` vs `Json::Serialize` per record.
+// Run with: bazel run -c opt //mbo/json:json_lines_benchmark
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "mbo/json/json.h"
+#include "mbo/json/json_lines.h"
+#include "mbo/thread/executor.h"
+
+namespace mbo::json {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+constexpr std::size_t kNumRecords = 1 << 16;
+
+const std::string& Text() {
+  static const auto* const kText = [] {
+    auto* text = new std::string();  // NOLINT(cppcoreguidelines-owning-memory)
+    for (std::size_t idx = 0; idx < kNumRecords; ++idx) {
+      absl::StrAppend(
+          text, R"({"ts": "2026-01-01T12:00:)", idx % 60, R"(.123Z", "level": ")", idx % 7 == 0 ? "WARN" : "INFO",
+          R"(", "msg": "request served in handler )", idx % 97, R"(", "attrs": {"user_id": )", idx * 7919,
+          R"(, "latency_ms": )", static_cast<double>(idx % 1000) / 8, R"(, "path": "/api/v1/items/)", idx,
+          R"(", "tags": ["a", "b", "c"], "ok": true}})", "\n");
+    }
+    return text;
+  }();
+  return *kText;
+}
+
+const std::vector<Json>& Records() {
+  static const auto* const kRecords = [] {
+    auto* records = new std::vector<Json>();  // NOLINT(cppcoreguidelines-owning-memory)
+    JsonLinesReader reader(Text());
+    std::vector<Json> batch;
+    do {
+      if (!reader.ReadBatch(batch).ok()) {
+        break;
+      }
+      for (Json& record : batch) {
+        records->push_back(std::move(record));
+      }
+    } while (!batch.empty());
+    return records;
+  }();
+  return *kRecords;
+}
+
+// Discards all output.
+class NullBuffer final : public std::streambuf {
+ protected:
+  std::streamsize xsputn(const char* /*data*/, std::streamsize size) override { return size; }
+
+  int_type overflow(int_type chr) override { return traits_type::not_eof(chr); }
+};
+
+// The argument is the number of threads, 0 for the calling thread only.
+void BmReadJsonLines(benchmark::State& state) {
+  const std::string& text = Text();
+  std::unique_ptr<thread::ThreadPool> pool;
+  if (state.range(0) > 0) {
+    pool = std::make_unique<thread::ThreadPool>(static_cast<std::size_t>(state.range(0)));
+  }
+  std::vector<Json> records;
+  for (auto _ : state) {
+    JsonLinesReader reader(text, {.executor = pool.get()});
+    std::size_t count = 0;
+    do {
+      if (!reader.ReadBatch(records).ok()) {
+        state.SkipWithError("Bad record.");
+        return;
+      }
+      count += records.size();
+    } while (!records.empty());
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kNumRecords));
+}
+
+void BmReadGetline(benchmark::State& state) {
+  const std::string& text = Text();
+  for (auto _ : state) {
+    std::istringstream input(text);
+    std::string line;
+    std::size_t count = 0;
+    while (std::getline(input, line)) {
+      absl::StatusOr<Json> record = Json::Parse(line);
+      if (!record.ok()) {
+        state.SkipWithError("Bad record.");
+        return;
+      }
+      benchmark::DoNotOptimize(record);
+      ++count;
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kNumRecords));
+}
+
+void BmWriteJsonLines(benchmark::State& state) {
+  const std::vector<Json>& records = Records();
+  NullBuffer null;
+  std::ostream output(&null);
+  for (auto _ : state) {
+    JsonLinesWriter writer(output);
+    for (const Json& record : records) {
+      if (!writer.Write(record).ok()) {
+        state.SkipWithError("Write failed.");
+        return;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records.size()));
+}
+
+void BmWriteSerialize(benchmark::State& state) {
+  const std::vector<Json>& records = Records();
+  NullBuffer null;
+  std::ostream output(&null);
+  for (auto _ : state) {
+    for (const Json& record : records) {
+      output << record.Serialize();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records.size()));
+}
+
+BENCHMARK(BmReadJsonLines)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK(BmReadGetline)->UseRealTime();
+BENCHMARK(BmWriteJsonLines);
+BENCHMARK(BmWriteSerialize);
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::json
+
+BENCHMARK_MAIN();  // NOLINT
@@ -0,0 +1,285 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/json_lines.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ios>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/file/file.h"
+#include "mbo/json/internal/json_structural.h"
+#include "mbo/json/json.h"
+#include "mbo/testing/status.h"
+#include "mbo/thread/executor.h"
+
+namespace mbo::json {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::mbo::json::json_internal::FindNewlines;
+using ::mbo::json::json_internal::ScanKernel;
+using ::mbo::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+struct JsonLinesTest : ::testing::Test {
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  // Reads all records as compact JSON (without the line feed), with the errors in place of their records.
+  static std::vector<std::string> ReadAll(JsonLinesReader& reader) {
+    std::vector<std::string> result;
+    std::vector<Json> records;
+    while (true) {
+      const absl::Status status = reader.ReadBatch(records);
+      for (const Json& record : records) {
+        result.emplace_back(absl::StripTrailingAsciiWhitespace(record.Serialize()));
+      }
+      if (!status.ok()) {
+        result.emplace_back(status.message());
+      } else if (records.empty()) {
+        return result;
+      }
+    }
+  }
+
+  // Many records of varying sizes, each with a single property for a stable serialization.
+  static std::string Records(std::size_t count) {
+    std::string text;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      absl::StrAppend(&text, R"({"record": [)", idx, R"(, ")", std::string(idx % 37, 'x'), "\"]}\n");
+    }
+    return text;
+  }
+};
+
+TEST_F(JsonLinesTest, FindNewlines) {
+  std::string text;
+  for (std::size_t idx = 0; idx < 1000; ++idx) {
+    text += std::string(idx % 131, 'a') + '\n';
+  }
+  std::vector<uint32_t> expected;
+  for (std::size_t pos = text.find('\n'); pos != std::string::npos; pos = text.find('\n', pos + 1)) {
+    expected.push_back(static_cast<uint32_t>(pos));
+  }
+  // All alignments and lengths of the tail.
+  for (std::size_t skip = 0; skip < 70; ++skip) {
+    const std::string_view part = std::string_view(text).substr(skip, text.size() - 2 * skip);
+    std::vector<uint32_t> want;
+    for (const uint32_t pos : expected) {
+      if (pos >= skip && pos < skip + part.size()) {
+        want.push_back(pos - static_cast<uint32_t>(skip));
+      }
+    }
+    for (const ScanKernel kernel : {ScanKernel::kAuto, ScanKernel::kPortable}) {
+      std::vector<uint32_t> newlines;
+      ASSERT_OK(FindNewlines(part, newlines, kernel));
+      ASSERT_EQ(newlines, want) << "Skip: " << skip << ", Kernel: " << static_cast<int>(kernel);
+    }
+  }
+  std::vector<uint32_t> newlines{1, 2, 3};
+  ASSERT_OK(FindNewlines("", newlines));
+  EXPECT_THAT(newlines, IsEmpty());
+}
+
+TEST_F(JsonLinesTest, Read) {
+  JsonLinesReader reader("{\"a\": 1}\n\n  \r\n{}\r\n{\"b\": {\"c\": null}}");
+  EXPECT_THAT(ReadAll(reader), ElementsAre(R"({"a":1})", "{}", R"({"b":{"c":null}})"));
+  EXPECT_EQ(reader.lines(), 5);
+  JsonLinesReader empty("");
+  EXPECT_THAT(ReadAll(empty), IsEmpty());
+  JsonLinesReader blank("\n \n\t\n");
+  EXPECT_THAT(ReadAll(blank), IsEmpty());
+  EXPECT_EQ(blank.lines(), 3);
+}
+
+TEST_F(JsonLinesTest, Kinds) {
+  JsonLinesReader reader("[1, 2]\n\"str\"\n42\nnull\n");
+  std::vector<Json> records;
+  ASSERT_OK(reader.ReadBatch(records));
+  ASSERT_EQ(records.size(), 4);
+  EXPECT_TRUE(records[0].IsArray());
+  EXPECT_TRUE(records[1].IsString());
+  EXPECT_TRUE(records[2].IsNumber());
+  EXPECT_TRUE(records[3].IsNull());
+  ASSERT_OK(reader.ReadBatch(records));
+  EXPECT_THAT(records, IsEmpty());
+}
+
+TEST_F(JsonLinesTest, Errors) {
+  JsonLinesReader reader("{\"a\": 1}\n{\"b\":\n\n{\"c\": 3}\n[1,]\n{\"d\": 4}");
+  std::vector<Json> records;
+  EXPECT_THAT(reader.ReadBatch(records), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Line 2: ")));
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].Serialize(), "{\"a\":1}\n");
+  EXPECT_THAT(reader.ReadBatch(records), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Line 5: ")));
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].Serialize(), "{\"c\":3}\n");
+  ASSERT_OK(reader.ReadBatch(records));
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].Serialize(), "{\"d\":4}\n");
+  ASSERT_OK(reader.ReadBatch(records));
+  EXPECT_THAT(records, IsEmpty());
+}
+
+TEST_F(JsonLinesTest, Batches) {
+  const std::string text = Records(2000);
+  std::vector<std::string> expected;
+  for (std::size_t idx = 0; idx < 2000; ++idx) {
+    expected.push_back(absl::StrCat(R"({"record":[)", idx, R"(,")", std::string(idx % 37, 'x'), "\"]}"));
+  }
+  thread::ThreadPool pool(4);
+  // The default batches, batches smaller than a line, of a few lines and of everything.
+  for (const std::size_t batch_bytes : std::vector<std::size_t>{0, 1, 10, 1000, 1 << 20}) {
+    for (thread::Executor* executor : std::vector<thread::Executor*>{nullptr, &pool}) {
+      const JsonLinesReader::Options options{.batch_bytes = batch_bytes, .executor = executor};
+      JsonLinesReader reader(text, options);
+      EXPECT_EQ(ReadAll(reader), expected) << "Batch bytes: " << batch_bytes;
+      EXPECT_EQ(reader.lines(), 2000);
+      std::istringstream input(text);
+      JsonLinesReader stream(input, options);
+      EXPECT_EQ(ReadAll(stream), expected) << "Batch bytes: " << batch_bytes;
+      EXPECT_EQ(stream.lines(), 2000);
+    }
+  }
+}
+
+TEST_F(JsonLinesTest, Stream) {
+  std::istringstream input("{\"a\": 1}\n\n[1,\n{\"b\": 2}");
+  JsonLinesReader reader(input, {.batch_bytes = 3});
+  EXPECT_THAT(ReadAll(reader), ElementsAre(R"({"a":1})", HasSubstr("Line 3: "), R"({"b":2})"));
+  EXPECT_EQ(reader.lines(), 4);
+}
+
+TEST_F(JsonLinesTest, Open) {
+  const std::filesystem::path path = std::filesystem::path(::testing::TempDir()) / "json_lines_test.jsonl";
+  ASSERT_OK(file::SetContents(path, Records(100)));
+  MBO_ASSERT_OK_AND_ASSIGN(JsonLinesReader reader, JsonLinesReader::Open(path, {.batch_bytes = 100}));
+  std::vector<Json> records;
+  ASSERT_OK(reader.ReadBatch(records));
+  JsonLinesReader moved = std::move(reader);
+  const std::vector<std::string> rest = ReadAll(moved);
+  ASSERT_EQ(records.size() + rest.size(), 100);
+  EXPECT_EQ(rest.back(), R"({"record":[99,"xxxxxxxxxxxxxxxxxxxxxxxxx"]})");
+  EXPECT_THAT(JsonLinesReader::Open(path.string() + ".missing"), StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(JsonLinesTest, Write) {
+  std::ostringstream output;
+  {
+    JsonLinesWriter writer(output, {.buffer_bytes = 16});
+    Json record;
+    record["a"] = "two";
+    ASSERT_OK(writer.Write(record));
+    ASSERT_OK(writer.Write(Json()));
+    ASSERT_OK(writer.Write(Json(42)));
+    record["a"].Reset().MakeArray();
+    record["a"].emplace_back(1);
+    ASSERT_OK(writer.Write(record));
+    ASSERT_OK(writer.Write(record["a"]));
+    EXPECT_EQ(writer.records(), 5);
+  }
+  EXPECT_EQ(output.str(), "{\"a\":\"two\"}\nnull\n42\n{\"a\":[1]}\n[1]\n");
+}
+
+TEST_F(JsonLinesTest, WriteLineMode) {
+  std::ostringstream output;
+  JsonLinesWriter writer(output, {.mode = Json::SerializeMode::kLine});
+  Json record;
+  record["a"]["b"] = 1;
+  ASSERT_OK(writer.Write(record));
+  EXPECT_THAT(output.str(), IsEmpty()) << "Still buffered.";
+  ASSERT_OK(writer.Flush());
+  EXPECT_EQ(output.str(), "{\"a\": {\"b\": 1}}\n");
+}
+
+TEST_F(JsonLinesTest, WriteError) {
+  std::ostringstream output;
+  output.setstate(std::ios::badbit);
+  JsonLinesWriter writer(output, {.buffer_bytes = 4});
+  Json record;
+  record["a"] = "long enough to fill the buffer";
+  EXPECT_THAT(writer.Write(record), StatusIs(absl::StatusCode::kDataLoss));
+  EXPECT_THAT(writer.Flush(), StatusIs(absl::StatusCode::kDataLoss));
+  EXPECT_EQ(writer.records(), 0);
+}
+
+TEST_F(JsonLinesTest, RoundTrip) {
+  const std::string text = Records(500);
+  std::ostringstream output;
+  {
+    JsonLinesWriter writer(output, {.buffer_bytes = 100});
+    JsonLinesReader reader(text, {.batch_bytes = 1000});
+    std::vector<Json> records;
+    do {
+      ASSERT_OK(reader.ReadBatch(records));
+      for (const Json& record : records) {
+        ASSERT_OK(writer.Write(record));
+      }
+    } while (!records.empty());
+    ASSERT_OK(writer.Flush());
+    EXPECT_EQ(writer.records(), 500);
+  }
+  const std::string written = output.str();
+  JsonLinesReader original_reader(text);
+  JsonLinesReader written_reader(written);
+  const std::vector<std::string> original_records = ReadAll(original_reader);
+  EXPECT_EQ(original_records.size(), 500);
+  EXPECT_EQ(ReadAll(written_reader), original_records);
+}
+
+TEST_F(JsonLinesTest, RoundTripKinds) {
+  const std::string text =
+      "{\"a\": 1}\n[1, \"x\\ny\", null, {\"b\": true}, []]\n\"str\"\n42\n-1.5\ntrue\nnull\n{}\n[]\n";
+  for (const Json::SerializeMode mode : {Json::SerializeMode::kCompact, Json::SerializeMode::kLine}) {
+    std::ostringstream output;
+    JsonLinesWriter writer(output, {.mode = mode});
+    JsonLinesReader reader(text);
+    std::vector<Json> records;
+    ASSERT_OK(reader.ReadBatch(records));
+    ASSERT_EQ(records.size(), 9);
+    for (const Json& record : records) {
+      ASSERT_OK(writer.Write(record));
+    }
+    ASSERT_OK(writer.Flush());
+    const std::string text_written = output.str();
+    if (mode == Json::SerializeMode::kCompact) {
+      EXPECT_EQ(text_written, "{\"a\":1}\n[1,\"x\\ny\",null,{\"b\":true},[]]\n\"str\"\n42\n-1.5\ntrue\nnull\n{}\n[]\n");
+    }
+    JsonLinesReader written_reader(text_written);
+    std::vector<Json> written;
+    ASSERT_OK(written_reader.ReadBatch(written)) << text_written;
+    EXPECT_EQ(written, records) << text_written;
+  }
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::json
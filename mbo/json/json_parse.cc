@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "mbo/file/file.h"
+#include "mbo/json/internal/json_parser.h"
+#include "mbo/json/internal/json_structural.h"
+#include "mbo/json/json.h"
+
+namespace mbo::json {
+
+// Builds the tree for `json_internal::ParseStructure`. Array elements are collected on one shared stack and moved into
+// an exactly sized vector when their array closes, which saves the vector's growth. Values on that stack move when it
+// grows, so they are tracked by index, while the root and object members (held by `std::unique_ptr`) stay put and are
+// tracked by pointer.
+class Json::Parser final {
+ public:
+  explicit Parser(Json& root) noexcept : location_{.json = &root} {}
+
+  void Null() noexcept {}
+
+  void Bool(bool value) { Get(location_).data_.emplace<bool>(value); }
+
+  void Number(json_internal::SignedInt value) { Get(location_).data_.emplace<SignedInt>(value); }
+
+  void Number(json_internal::UnsignedInt value) { Get(location_).data_.emplace<UnsignedInt>(value); }
+
+  void Number(json_internal::Float value) { Get(location_).data_.emplace<Float>(value); }
+
+  void String(std::string_view value) { Get(location_).data_.emplace<std::string>(value); }
+
+  void EmptyArray() { Get(location_).data_.emplace<Array>(std::make_unique<Array::element_type>()); }
+
+  void EmptyObject() { Get(location_).data_.emplace<Object>(); }
+
+  void BeginArray() {
+    stack_.push_back({.container = location_, .first_element = elements_.size()});
+    NextElement();
+  }
+
+  void NextElement() {
+    elements_.emplace_back();
+    location_ = {.index = elements_.size() - 1};
+  }
+
+  void EndArray() {
+    const auto first = elements_.begin() + static_cast<std::ptrdiff_t>(stack_.back().first_element);
+    Get(stack_.back().container)
+        .data_.emplace<Array>(std::make_unique<Array::element_type>(
+            std::make_move_iterator(first), std::make_move_iterator(elements_.end())));
+    elements_.erase(first, elements_.end());
+    stack_.pop_back();
+  }
+
+  void BeginObject() {
+    EmptyObject();
+    stack_.push_back({.container = location_});
+  }
+
+  void Key(std::string_view key) {
+    auto [it, inserted] = std::get<Object>(Get(stack_.back().container).data_).try_emplace(std::string(key));
+    if (inserted) {
+      it->second = std::make_unique<Json>();
+    } else {
+      it->second->Reset();  // The last duplicate wins.
+    }
+    location_ = {.json = it->second.get()};
+  }
+
+  void EndObject() noexcept { stack_.pop_back(); }
+
+ private:
+  static constexpr std::size_t kNoIndex = std::numeric_limits<std::size_t>::max();
+
+  // Where a value lives: at `json` or, if that is null, at `elements_[index]`.
+  struct Location {
+    Json* json = nullptr;
+    std::size_t index = kNoIndex;
+  };
+
+  struct Frame {
+    Location container;
+    std::size_t first_element = 0;  // Arrays: start of their elements in `elements_`.
+  };
+
+  Json& Get(const Location& location) noexcept {
+    return location.json != nullptr ? *location.json : elements_[location.index];  // NOLINT(*-unchecked-*)
+  }
+
+  Location location_;           // Of the current value.
+  std::vector<Frame> stack_;    // The open containers.
+  std::vector<Json> elements_;  // The elements of all open arrays.
+};
+
+absl::StatusOr<Json> Json::Parse(std::string_view text) {
+  std::vector<uint32_t> structurals;
+  if (absl::Status status = json_internal::FindStructurals(text, structurals); !status.ok()) {
+    return status;
+  }
+  return ParseStructurals(text, structurals);
+}
+
+absl::StatusOr<Json> Json::ParseStructurals(std::string_view text, std::span<const uint32_t> structurals) {
+  Json root;
+  Parser parser(root);
+  if (absl::Status status = json_internal::ParseStructure(text, structurals, parser); !status.ok()) {
+    return status;
+  }
+  return root;
+}
+
+absl::StatusOr<Json> Json::ParseFile(const std::filesystem::path& path) {
+  absl::StatusOr<file::MappedContents> contents = file::GetMappedContents(path);
+  if (!contents.ok()) {
+    return contents.status();
+  }
+  absl::StatusOr<Json> json = Parse(contents->View());
+  if (!json.ok()) {
+    return absl::Status(json.status().code(), absl::StrCat(path.string(), ": ", json.status().message()));
+  }
+  return json;
+}
+
+}  // namespace mbo::json
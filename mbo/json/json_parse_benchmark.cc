@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput (bytes/s) of `Json::Parse` and its structural scan on the corpora of `json_benchmark_corpus.h`.
+// Run with: MBO_JSON_BENCHMARK_CORPUS=/path/to/jsonexamples bazel run -c opt //mbo/json:json_parse_benchmark
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "mbo/json/internal/json_structural.h"
+#include "mbo/json/json.h"
+#include "mbo/json/json_benchmark_corpus.h"
+
+namespace mbo::json {
+namespace {
+
+void BmFindStructurals(benchmark::State& state, const Corpus& corpus, json_internal::ScanKernel kernel) {
+  std::vector<uint32_t> structurals;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(json_internal::FindStructurals(corpus.text, structurals, kernel));
+    benchmark::DoNotOptimize(structurals.data());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(corpus.text.size()));
+}
+
+void BmParse(benchmark::State& state, const Corpus& corpus) {
+  if (!Json::Parse(corpus.text).ok()) {
+    state.SkipWithError("The corpus is not valid JSON.");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Json::Parse(corpus.text));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(corpus.text.size()));
+}
+
+void RegisterAll() {
+  for (const Corpus& corpus : Corpora()) {
+    benchmark::RegisterBenchmark(absl::StrCat("BmFindStructurals<auto>/", corpus.name), [&](benchmark::State& state) {
+      BmFindStructurals(state, corpus, json_internal::ScanKernel::kAuto);
+    });
+    benchmark::RegisterBenchmark(
+        absl::StrCat("BmFindStructurals<portable>/", corpus.name), [&](benchmark::State& state) {
+          BmFindStructurals(state, corpus, json_internal::ScanKernel::kPortable);
+        });
+    benchmark::RegisterBenchmark(absl::StrCat("BmParse/", corpus.name), [&](benchmark::State& state) {
+      BmParse(state, corpus);
+    });
+  }
+}
+
+}  // namespace
+}  // namespace mbo::json
+
+int main(int argc, char** argv) {
+  mbo::json::RegisterAll();
+  benchmark::Initialize(&argc, argv);
+  for (const mbo::json::Corpus& corpus : mbo::json::Corpora()) {
+    benchmark::AddCustomContext(corpus.name, absl::StrCat(corpus.text.size(), " bytes"));
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
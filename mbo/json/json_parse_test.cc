@@ -0,0 +1,271 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/file/file.h"
+#include "mbo/json/internal/json_structural.h"
+#include "mbo/json/json.h"
+#include "mbo/testing/status.h"
+
+namespace mbo::json {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::mbo::json::json_internal::FindStructurals;
+using ::mbo::json::json_internal::ScanKernel;
+using ::mbo::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+struct JsonParseTest : ::testing::Test {
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  // Byte by byte reference for stage 1. Like the vector scan it lets a backslash escape the next byte even outside
+  // of strings (that is invalid JSON and rejected by stage 2 either way).
+  static std::vector<uint32_t> ReferenceStructurals(std::string_view text) {
+    std::vector<uint32_t> structurals;
+    bool in_string = false;
+    bool escaped = false;
+    bool prev_scalar = false;
+    for (std::size_t pos = 0; pos < text.size(); ++pos) {
+      const char chr = text[pos];
+      const bool is_escaped = std::exchange(escaped, !escaped && chr == '\\');
+      if (in_string) {
+        in_string = is_escaped || chr != '"';
+        continue;
+      }
+      if (std::string_view("{}[]:,").find(chr) != std::string_view::npos) {
+        structurals.push_back(pos);
+        prev_scalar = false;
+      } else if (std::string_view(" \t\n\r").find(chr) != std::string_view::npos) {
+        prev_scalar = false;
+      } else if (chr == '"' && !is_escaped) {
+        if (!prev_scalar) {
+          structurals.push_back(pos);
+        }
+        in_string = true;
+        prev_scalar = false;
+      } else {
+        if (!prev_scalar) {
+          structurals.push_back(pos);
+        }
+        prev_scalar = true;
+      }
+    }
+    return structurals;
+  }
+};
+
+TEST_F(JsonParseTest, Structurals) {
+  std::vector<uint32_t> structurals;
+  ASSERT_OK(FindStructurals(R"({"a\"b": [1, -2.5e3, true], "c" : null})", structurals));
+  EXPECT_THAT(structurals, ElementsAre(0, 1, 7, 9, 10, 11, 13, 19, 21, 25, 26, 28, 32, 34, 38));
+  ASSERT_OK(FindStructurals(" \n\t ", structurals));
+  EXPECT_THAT(structurals, IsEmpty());
+  EXPECT_THAT(FindStructurals(R"(["abc\"])", structurals), StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(JsonParseTest, StructuralKernelsAgree) {
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Tests must be repeatable.
+  std::mt19937_64 rng(42);
+  constexpr std::string_view kAlphabet = "{}[]:,\"\\ a1\n\x0c\x80";
+  for (std::size_t run = 0; run < 10'000; ++run) {
+    std::string text(rng() % 500, ' ');
+    for (char& chr : text) {
+      chr = kAlphabet[rng() % kAlphabet.size()];
+    }
+    const std::vector<uint32_t> expected = ReferenceStructurals(text);
+    for (const ScanKernel kernel : {ScanKernel::kAuto, ScanKernel::kPortable}) {
+      std::vector<uint32_t> structurals;
+      if (FindStructurals(text, structurals, kernel).ok()) {
+        ASSERT_EQ(structurals, expected) << "Text: '" << text << "'";
+      }
+    }
+    std::vector<uint32_t> automatic;
+    std::vector<uint32_t> portable;
+    ASSERT_EQ(FindStructurals(text, automatic).ok(), FindStructurals(text, portable, ScanKernel::kPortable).ok());
+  }
+}
+
+TEST_F(JsonParseTest, Scalars) {
+  MBO_ASSERT_OK_AND_ASSIGN(const Json null, Json::Parse(" null "));
+  EXPECT_TRUE(null.IsNull());
+  MBO_ASSERT_OK_AND_ASSIGN(const Json yes, Json::Parse("true"));
+  EXPECT_TRUE(yes.IsTrue());
+  MBO_ASSERT_OK_AND_ASSIGN(const Json no, Json::Parse("false"));
+  EXPECT_TRUE(no.IsFalse());
+  MBO_ASSERT_OK_AND_ASSIGN(const Json str, Json::Parse(R"("a\"b\\c\/\nä😀")"));
+  EXPECT_EQ(str, "a\"b\\c/\n\xC3\xA4\xF0\x9F\x98\x80");
+  MBO_ASSERT_OK_AND_ASSIGN(const Json utf8, Json::Parse("\"\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80 is valid UTF-8\""));
+  EXPECT_EQ(utf8, "\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80 is valid UTF-8");
+}
+
+TEST_F(JsonParseTest, Integers) {
+  const auto parse = [](std::string_view text) { return Json::Parse(text).value(); };
+  EXPECT_TRUE(parse("0").IsSignedInt());
+  EXPECT_EQ(parse("0"), 0);
+  EXPECT_EQ(parse("-0"), 0);
+  EXPECT_EQ(parse("42"), 42);
+  EXPECT_EQ(parse("-42"), -42);
+  EXPECT_TRUE(parse("9223372036854775807").IsSignedInt());
+  EXPECT_EQ(parse("9223372036854775807"), std::numeric_limits<int64_t>::max());
+  EXPECT_TRUE(parse("-9223372036854775808").IsSignedInt());
+  EXPECT_EQ(parse("-9223372036854775808"), std::numeric_limits<int64_t>::min());
+  EXPECT_TRUE(parse("9223372036854775808").IsUnsignedInt());
+  EXPECT_EQ(parse("9223372036854775808"), uint64_t{1} << 63);
+  EXPECT_TRUE(parse("18446744073709551615").IsUnsignedInt());
+  EXPECT_EQ(parse("18446744073709551615"), std::numeric_limits<uint64_t>::max());
+  EXPECT_TRUE(parse("18446744073709551616").IsFloat());
+  EXPECT_EQ(parse("18446744073709551616"), 18446744073709551616.0);
+  EXPECT_TRUE(parse("-9223372036854775809").IsFloat());
+  EXPECT_EQ(parse("-9223372036854775809"), -9223372036854775809.0);
+}
+
+TEST_F(JsonParseTest, Floats) {
+  const auto parse = [](std::string_view text) { return Json::Parse(text).value(); };
+  EXPECT_TRUE(parse("1.0").IsFloat());
+  EXPECT_EQ(parse("1.0"), 1.0);
+  EXPECT_EQ(parse("-2.5"), -2.5);
+  EXPECT_EQ(parse("1e3"), 1000.0);
+  EXPECT_EQ(parse("1E+3"), 1000.0);
+  EXPECT_EQ(parse("25e-1"), 2.5);
+  EXPECT_EQ(parse("0.1"), 0.1);
+  EXPECT_EQ(parse("3.141592653589793"), 3.141592653589793);
+  EXPECT_EQ(parse("-65.613616999999977"), -65.613616999999977);  // Beyond the fast path.
+  EXPECT_EQ(parse("2.2250738585072014e-308"), 2.2250738585072014e-308);
+  EXPECT_EQ(parse("1.7976931348623157e308"), 1.7976931348623157e308);
+  EXPECT_EQ(parse("123456789012345678901234567890"), 123456789012345678901234567890.0);
+  EXPECT_EQ(parse("1e-400"), 0.0);
+  EXPECT_THAT(Json::Parse("1e400"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("out of range")));
+  // Round trip of random doubles through their shortest representation.
+  // NOLINTNEXTLINE(cert-msc32-c,cert-msc51-cpp): Tests must be repeatable.
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+  for (std::size_t run = 0; run < 10'000; ++run) {
+    const double value = dist(rng);
+    std::array<char, 64> buffer{};
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    const std::string_view text(buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data()));
+    ASSERT_EQ(parse(text), value) << text;
+  }
+}
+
+TEST_F(JsonParseTest, Containers) {
+  MBO_ASSERT_OK_AND_ASSIGN(
+      const Json json, Json::Parse(R"({"a": [1, 2, {"b": []}], "c": {}, "d": "e", "a2": [[[]]], "f": -1.5})"));
+  ASSERT_TRUE(json.IsObject());
+  EXPECT_EQ(json.size(), 5);
+  ASSERT_TRUE(json["a"].IsArray());
+  EXPECT_EQ(json["a"].size(), 3);
+  EXPECT_EQ(json["a"][0], 1);
+  EXPECT_EQ(json["a"][1], 2);
+  EXPECT_TRUE(json["a"][2]["b"].IsArray());
+  EXPECT_TRUE(json["a"][2]["b"].empty());
+  EXPECT_TRUE(json["c"].IsObject());
+  EXPECT_TRUE(json["c"].empty());
+  EXPECT_EQ(json["d"], "e");
+  EXPECT_EQ(json["a2"][0][0].size(), 0);
+  EXPECT_EQ(json["f"], -1.5);
+  MBO_ASSERT_OK_AND_ASSIGN(const Json array, Json::Parse("[]"));
+  EXPECT_TRUE(array.IsArray());
+  MBO_ASSERT_OK_AND_ASSIGN(const Json duplicate, Json::Parse(R"({"a": [1], "a": 2})"));
+  EXPECT_EQ(duplicate.size(), 1);
+  EXPECT_EQ(duplicate["a"], 2);
+}
+
+TEST_F(JsonParseTest, RoundTrip) {
+  Json json;
+  json["null"];
+  json["bool"] = true;
+  json["int"] = -17;
+  json["uint"] = std::numeric_limits<uint64_t>::max();
+  json["float"] = 0.25;
+  json["string"] = "with \"quotes\", a \\ and a\nnewline";
+  json["array"].push_back(1);
+  json["array"].push_back("two");
+  json["object"]["nested"] = false;
+  for (const Json::SerializeMode mode :
+       {Json::SerializeMode::kCompact, Json::SerializeMode::kLine, Json::SerializeMode::kPretty}) {
+    const std::string text = json.Serialize(mode);
+    MBO_ASSERT_OK_AND_ASSIGN(const Json parsed, Json::Parse(text));
+    // Only the pretty form orders the properties.
+    EXPECT_EQ(parsed.Serialize(Json::SerializeMode::kPretty), json.Serialize(Json::SerializeMode::kPretty));
+  }
+}
+
+TEST_F(JsonParseTest, Errors) {
+  const auto error = [](std::string_view text) { return Json::Parse(text).status(); };
+  EXPECT_THAT(error(""), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("end of input")));
+  EXPECT_THAT(error("  "), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("end of input")));
+  EXPECT_THAT(error("[1, 2"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("offset 5")));
+  EXPECT_THAT(error("[1 2]"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Expected ',' or ']'")));
+  EXPECT_THAT(error(R"({"a" 1})"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Expected ':'")));
+  EXPECT_THAT(error("{1: 2}"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("string key")));
+  EXPECT_THAT(error(R"({"a": 1,})"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("string key")));
+  EXPECT_THAT(error("[1,]"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Unexpected character")));
+  EXPECT_THAT(error("{} {}"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("after the JSON value")));
+  EXPECT_THAT(error("tru"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Invalid literal")));
+  EXPECT_THAT(error("nullx"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Invalid literal")));
+  for (const std::string_view number : {"01", "-", "1.", ".5", "1e", "1e+", "+1", "1.5x", "0x10", "- 1"}) {
+    EXPECT_THAT(error(number), StatusIs(absl::StatusCode::kInvalidArgument)) << number;
+  }
+  EXPECT_THAT(error(R"("a\x")"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("escape sequence")));
+  EXPECT_THAT(error(R"("\u12")"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("unicode escape")));
+  EXPECT_THAT(error(R"("\ud83d")"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("surrogate")));
+  EXPECT_THAT(error(R"("\ude00")"), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("surrogate")));
+  EXPECT_THAT(error("\"a\tb\""), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Control character")));
+  for (const std::string_view utf8 : {"\xC0\xAF", "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xC3"}) {
+    EXPECT_THAT(
+        error("\"" + std::string(utf8) + "\""), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("UTF-8")));
+  }
+  EXPECT_THAT(error(std::string(2'000, '[')), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("too deep")));
+  EXPECT_THAT(
+      error("{\n  \"a\": [\n    1,\n    x\n  ]\n}"),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("line 4, column 5 (offset 22)")));
+}
+
+TEST_F(JsonParseTest, ParseFile) {
+  const std::filesystem::path path = std::filesystem::path(::testing::TempDir()) / "json_parse_test.json";
+  ASSERT_OK(file::SetContents(path, R"({"a": [1, 2]})"));
+  MBO_ASSERT_OK_AND_ASSIGN(const Json json, Json::ParseFile(path));
+  EXPECT_EQ(json["a"][1], 2);
+  ASSERT_OK(file::SetContents(path, "[1,"));
+  EXPECT_THAT(
+      Json::ParseFile(path),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("json_parse_test.json: JSON error")));
+  EXPECT_THAT(Json::ParseFile(path.string() + ".missing"), StatusIs(absl::StatusCode::kNotFound));
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::json
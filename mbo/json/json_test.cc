@@ -132,6 +132,20 @@ TEST_F(JsonTest, JsonComparisonsCoverEveryStoredKind) {
   EXPECT_THAT(object_lhs, Lt(Json{"value"}));
 }
 
+TEST_F(JsonTest, ObjectComparisonIgnoresInsertionOrder) {
+  // Enough properties that the hash maps iterate them in different orders.
+  Json forward;
+  Json backward;
+  for (int idx = 0; idx < 100; ++idx) {  // NOLINT(*-magic-numbers)
+    forward[std::to_string(idx)] = idx;
+    backward[std::to_string(99 - idx)] = 99 - idx;  // NOLINT(*-magic-numbers)
+  }
+  EXPECT_THAT(forward, backward);
+  EXPECT_THAT(forward <=> backward, std::strong_ordering::equal);
+  backward["50"] = 0;
+  EXPECT_THAT(backward, Lt(forward));
+}
+
 TEST_F(JsonTest, CopyOperationsDeepCopyArraysAndObjects) {
   Json original;
   original["array"].emplace_back(1);
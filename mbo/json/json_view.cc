@@ -0,0 +1,260 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/json_view.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "mbo/file/file.h"
+#include "mbo/json/internal/json_parser.h"
+#include "mbo/json/internal/json_structural.h"
+#include "mbo/json/json.h"
+
+namespace mbo::json {
+
+// NOLINTBEGIN(*-avoid-unchecked-container-access): The positions of values are valid by construction.
+
+absl::StatusOr<Json::View> Json::View::Parse(std::string_view text) {
+  auto index = std::make_unique<Index>();
+  index->text = text;
+  if (absl::Status status = json_internal::FindStructurals(text, index->structurals); !status.ok()) {
+    return status;
+  }
+  if (absl::Status status = json_internal::IndexStructure(text, index->structurals, index->ends); !status.ok()) {
+    return status;
+  }
+  return View(std::move(index));
+}
+
+absl::StatusOr<Json::View> Json::View::ParseFile(const std::filesystem::path& path) {
+  absl::StatusOr<file::MappedContents> contents = file::GetMappedContents(path);
+  if (!contents.ok()) {
+    return contents.status();
+  }
+  absl::StatusOr<View> view = Parse(contents->View());
+  if (!view.ok()) {
+    return absl::Status(view.status().code(), absl::StrCat(path.string(), ": ", view.status().message()));
+  }
+  view->index_->contents = *std::move(contents);  // Moving keeps the contents in place.
+  return view;
+}
+
+Json::Kind Json::View::Value::GetKind() const noexcept {
+  switch (First()) {
+    case 'n': return Kind::kNull;
+    case 't':
+    case 'f': return Kind::kBool;
+    case '"': return Kind::kString;
+    case '[': return Kind::kArray;
+    case '{': return Kind::kObject;
+    default: return Kind::kNumber;
+  }
+}
+
+absl::StatusOr<bool> Json::View::Value::GetBool() const {
+  json_internal::ScalarParser parser(index_->text);
+  const uint32_t offset = index_->structurals[pos_];
+  if (!IsBool()) {
+    return parser.Error(offset, "Is not a Bool.");
+  }
+  const bool value = First() == 't';
+  if (!parser.ParseLiteral(offset, value ? "true" : "false")) {
+    return parser.status();
+  }
+  return value;
+}
+
+absl::StatusOr<Json::SignedInt> Json::View::Value::GetSignedInt() const {
+  json_internal::ScalarParser parser(index_->text);
+  const uint32_t offset = index_->structurals[pos_];
+  json_internal::Number number;
+  if (!IsNumber() || !parser.ParseNumber(offset, number)) {
+    return IsNumber() ? parser.status() : parser.Error(offset, "Is not a SignedInt.");
+  }
+  if (const auto* value = std::get_if<int64_t>(&number)) {
+    return *value;
+  }
+  return parser.Error(offset, "Is not a SignedInt.");
+}
+
+absl::StatusOr<Json::UnsignedInt> Json::View::Value::GetUnsignedInt() const {
+  json_internal::ScalarParser parser(index_->text);
+  const uint32_t offset = index_->structurals[pos_];
+  json_internal::Number number;
+  if (!IsNumber() || !parser.ParseNumber(offset, number)) {
+    return IsNumber() ? parser.status() : parser.Error(offset, "Is not an UnsignedInt.");
+  }
+  if (const auto* value = std::get_if<uint64_t>(&number)) {
+    return *value;
+  }
+  if (const auto* value = std::get_if<int64_t>(&number); value != nullptr && *value >= 0) {
+    return static_cast<uint64_t>(*value);
+  }
+  return parser.Error(offset, "Is not an UnsignedInt.");
+}
+
+absl::StatusOr<Json::Float> Json::View::Value::GetFloat() const {
+  json_internal::ScalarParser parser(index_->text);
+  const uint32_t offset = index_->structurals[pos_];
+  json_internal::Number number;
+  if (!IsNumber() || !parser.ParseNumber(offset, number)) {
+    return IsNumber() ? parser.status() : parser.Error(offset, "Is not a Float.");
+  }
+  return std::visit([](auto value) { return static_cast<Float>(value); }, number);
+}
+
+absl::StatusOr<std::string_view> Json::View::Value::GetString() const {
+  json_internal::ScalarParser parser(index_->text);
+  const uint32_t offset = index_->structurals[pos_];
+  if (!IsString()) {
+    return parser.Error(offset, "Is not a String.");
+  }
+  std::string_view value;
+  if (!parser.ParseString(offset, value)) {
+    return parser.status();
+  }
+  const char* const text = index_->text.data();
+  const char* const text_end = text + index_->text.size();  // NOLINT(*-pointer-arithmetic)
+  if (value.empty() || (!std::less<>{}(value.data(), text) && std::less<>{}(value.data(), text_end))) {
+    return value;  // Without escapes: a view of the text.
+  }
+  return index_->strings.CopyString(value);
+}
+
+std::string_view Json::View::Value::text() const noexcept {
+  const std::string_view text = index_->text;
+  const std::span<const uint32_t> structurals = index_->structurals;
+  const std::size_t begin = structurals[pos_];
+  if (End() != pos_) {
+    return text.substr(begin, structurals[End()] + 1 - begin);
+  }
+  // A scalar extends up to the next structural character, less whitespace.
+  const std::size_t next = pos_ + 1 < structurals.size() ? structurals[pos_ + 1] : text.size();
+  const std::size_t end = text.find_last_not_of(" \t\n\r", next - 1);
+  return text.substr(begin, end + 1 - begin);
+}
+
+absl::StatusOr<Json> Json::View::Value::ToJson() const {
+  const std::span<const uint32_t> structurals = index_->structurals;
+  return Json::ParseStructurals(index_->text, structurals.subspan(pos_, End() + 1 - pos_));
+}
+
+std::size_t Json::View::Value::size() const noexcept {
+  if (IsArray()) {
+    return static_cast<std::size_t>(std::ranges::distance(array_values()));
+  }
+  if (IsObject()) {
+    return static_cast<std::size_t>(std::ranges::distance(property_pairs()));
+  }
+  return 0;
+}
+
+bool Json::View::Value::KeyEquals(uint32_t key, std::string_view property) const {
+  const std::string_view text = index_->text;
+  const std::size_t begin = index_->structurals[key] + 1;
+  // The text from after the opening quote to the colon, so it includes the closing quote.
+  const std::string_view raw = text.substr(begin, index_->structurals[key + 1] - begin);
+  if (raw.size() > property.size() && raw[property.size()] == '"' && raw.starts_with(property)
+      && property.find_first_of("\"\\") == std::string_view::npos) {
+    return true;
+  }
+  if (raw.find('\\') == std::string_view::npos) {
+    return false;  // Without escapes the key is `raw` up to its quote, which did not match.
+  }
+  json_internal::ScalarParser parser(text);
+  std::string_view name;
+  return parser.ParseString(begin - 1, name) && name == property;
+}
+
+std::optional<Json::View::Value> Json::View::Value::FindProperty(std::string_view property) const {
+  std::optional<Value> result;
+  for (const auto& [name, value] : property_pairs()) {
+    if (KeyEquals(name.pos_, property)) {
+      result = value;
+    }
+  }
+  return result;
+}
+
+std::optional<Json::View::Value> Json::View::Value::FindElement(std::size_t index) const {
+  for (const Value& value : array_values()) {
+    if (index-- == 0) {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+absl::StatusOr<Json::View::Value> Json::View::Value::Find(std::string_view path) const {
+  Value value = *this;
+  std::size_t pos = 0;
+  const auto invalid = [&] {
+    return absl::InvalidArgumentError(absl::StrCat("Invalid JSON path '", path, "' at position ", pos, "."));
+  };
+  while (pos < path.size()) {
+    std::optional<Value> next;
+    if (path[pos] == '[') {
+      const std::size_t close = path.find(']', pos);
+      if (close == std::string_view::npos) {
+        return invalid();
+      }
+      std::size_t index = 0;
+      const char* const last = path.data() + close;  // NOLINT(*-pointer-arithmetic)
+      const auto [ptr, error] = std::from_chars(path.data() + pos + 1, last, index);  // NOLINT(*-pointer-arithmetic)
+      if (error != std::errc() || ptr != last || close == pos + 1) {
+        return invalid();
+      }
+      next = value.FindElement(index);
+      pos = close + 1;
+    } else {
+      if (pos > 0) {
+        if (path[pos] != '.') {
+          return invalid();
+        }
+        ++pos;
+      }
+      const std::size_t end = std::min(path.find_first_of(".[", pos), path.size());
+      if (end == pos) {
+        return invalid();
+      }
+      next = value.FindProperty(path.substr(pos, end - pos));
+      pos = end;
+    }
+    if (!next.has_value()) {
+      return absl::NotFoundError(absl::StrCat("JSON path '", path, "' not found at '", path.substr(0, pos), "'."));
+    }
+    value = *next;
+  }
+  return value;
+}
+
+// NOLINTEND(*-avoid-unchecked-container-access)
+
+}  // namespace mbo::json
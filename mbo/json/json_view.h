@@ -0,0 +1,264 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_JSON_JSON_VIEW_H_
+#define MBO_JSON_JSON_VIEW_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "mbo/file/file.h"
+#include "mbo/json/internal/json_arena.h"
+#include "mbo/json/json.h"
+
+namespace mbo::json {
+
+// A lazy, zero-copy view of a JSON text, for reading a few values out of large documents. `Parse` only indexes the
+// text: it finds the structural characters (see `Json::Parse`), checks the grammar of the brackets, commas and colons
+// and records where every container ends. Nothing is built. Scalars are parsed, and validated, only when a getter is
+// called, and lookups jump over the values they pass, however large those are.
+//
+// The values are views into the text, which must outlive the `View` (unless it came from `ParseFile`). Strings are
+// returned as views into the text unless they have escapes, in which case they are unescaped into the `View`. So a
+// `View` and its values must not be used by several threads at a time.
+//
+// Example:
+//
+// ```
+// MBO_ASSIGN_OR_RETURN(const Json::View view, Json::View::Parse(text));
+// MBO_ASSIGN_OR_RETURN(const Json::View::Value name, view.root().Find("statuses[3].user.name"));
+// MBO_ASSIGN_OR_RETURN(const std::string_view str, name.GetString());
+// ```
+class Json::View final {
+ private:
+  struct Index;
+
+ public:
+  class Value;
+
+  struct Member;
+
+  // A value of the `View`, which must outlive it.
+  class Value final {
+   public:
+    template<bool kMembers>
+    class Iterator;
+
+    using ElementIterator = Iterator<false>;
+    using MemberIterator = Iterator<true>;
+
+    Kind GetKind() const noexcept;
+
+    bool IsNull() const noexcept { return First() == 'n'; }
+
+    bool IsBool() const noexcept { return First() == 't' || First() == 'f'; }
+
+    bool IsNumber() const noexcept { return GetKind() == Kind::kNumber; }
+
+    bool IsString() const noexcept { return First() == '"'; }
+
+    bool IsArray() const noexcept { return First() == '['; }
+
+    bool IsObject() const noexcept { return First() == '{'; }
+
+    // The getters parse the value. They fail with `absl::InvalidArgumentError` (with the line and column of the value)
+    // if it has another kind or is malformed.
+
+    absl::StatusOr<bool> GetBool() const;
+
+    absl::StatusOr<SignedInt> GetSignedInt() const;
+
+    // Also accepts non-negative `SignedInt` values.
+    absl::StatusOr<UnsignedInt> GetUnsignedInt() const;
+
+    // Accepts all numbers.
+    absl::StatusOr<Float> GetFloat() const;
+
+    absl::StatusOr<std::string_view> GetString() const;
+
+    // The JSON text of the value, without surrounding whitespace.
+    std::string_view text() const noexcept;
+
+    // Parses the value into a `Json`.
+    absl::StatusOr<Json> ToJson() const;
+
+    bool empty() const noexcept { return !IsContainer() || End() == pos_ + 1; }
+
+    // The number of elements or members (0 for all other kinds). Counts them, skipping their values.
+    std::size_t size() const noexcept;
+
+    bool contains(std::string_view property) const { return FindProperty(property).has_value(); }
+
+    // Returns the value of `property` if this is an Object that has it. For duplicate keys the last value wins, as for
+    // `Json::Parse`, so this visits all keys, but skips all values.
+    std::optional<Value> FindProperty(std::string_view property) const;
+
+    // Returns the element at `index` if this is an Array that has it. Skips the elements before it.
+    std::optional<Value> FindElement(std::size_t index) const;
+
+    // Finds the value at `path`, a sequence of property names separated by '.' and of array indices in brackets:
+    // `a.b[3].c`, `[0][1]` or `name`. An empty `path` finds this value. Property names that contain '.' or '[' need
+    // `FindProperty`.
+    //
+    // Returns:
+    //  * Value:                        The value at `path`.
+    //  * absl::NotFoundError:          A property or element of the `path` does not exist.
+    //  * absl::InvalidArgumentError:   The `path` is malformed.
+    absl::StatusOr<Value> Find(std::string_view path) const;
+
+    // Forward ranges over the elements of an Array and the members of an Object (in the order of the text, including
+    // duplicate keys). Both are empty for other kinds.
+
+    auto array_values() const noexcept;  // A `std::ranges::subrange<ElementIterator>`.
+
+    auto property_pairs() const noexcept;  // A `std::ranges::subrange<MemberIterator>`.
+
+   private:
+    friend class View;
+
+    Value(const Index* index, uint32_t pos) noexcept : index_(index), pos_(pos) {}
+
+    // NOLINTBEGIN(*-avoid-unchecked-container-access): Values only exist for valid positions.
+
+    // The structural character of the value: its first.
+    char First() const noexcept { return index_->text[index_->structurals[pos_]]; }
+
+    // The index of the last structural character of the value.
+    uint32_t End() const noexcept { return index_->ends[pos_]; }
+
+    // NOLINTEND(*-avoid-unchecked-container-access)
+
+    bool IsContainer() const noexcept { return IsArray() || IsObject(); }
+
+    bool KeyEquals(uint32_t key, std::string_view property) const;
+
+    const Index* index_;
+    uint32_t pos_;  // Of the value's first structural character.
+  };
+
+  struct Member {
+    Value name;  // A String, see `Value::GetString`.
+    Value value;
+  };
+
+  ~View() noexcept = default;
+
+  View(const View&) = delete;
+  View& operator=(const View&) = delete;
+  View(View&&) noexcept = default;
+  View& operator=(View&&) noexcept = default;
+
+  // Indexes the JSON `text`, which must outlive the `View`.
+  //
+  // Returns:
+  //  * View:                          The index. Scalars are not validated yet.
+  //  * absl::InvalidArgumentError:    Malformed structure, the message has the offset, line and column of the error.
+  static absl::StatusOr<View> Parse(std::string_view text);
+
+  // Maps the file `path` (if possible) and indexes it (see `Parse`). The `View` owns the contents.
+  static absl::StatusOr<View> ParseFile(const std::filesystem::path& path);
+
+  Value root() const noexcept { return {index_.get(), 0}; }
+
+  std::string_view text() const noexcept { return index_->text; }
+
+ private:
+  struct Index {
+    std::string_view text;
+    std::vector<uint32_t> structurals;
+    std::vector<uint32_t> ends;  // See `json_internal::IndexStructure`.
+    file::MappedContents contents;  // For `ParseFile`.
+    mutable json_internal::Arena strings;  // The strings with escapes, once unescaped.
+  };
+
+  explicit View(std::unique_ptr<Index> index) noexcept : index_(std::move(index)) {}
+
+  std::unique_ptr<Index> index_;  // Held by pointer so values remain valid when the view moves.
+};
+
+// Iterates the elements or members of a container, skipping their values.
+template<bool kMembers>
+class Json::View::Value::Iterator final {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = std::conditional_t<kMembers, Member, Value>;
+  using reference = value_type;
+  using pointer = void;
+
+  Iterator() noexcept = default;
+
+  value_type operator*() const noexcept {
+    if constexpr (kMembers) {
+      return {.name = {index_, pos_}, .value = {index_, pos_ + 2}};
+    } else {
+      return {index_, pos_};
+    }
+  }
+
+  Iterator& operator++() noexcept {
+    // NOLINTBEGIN(*-avoid-unchecked-container-access): The structure was validated by `Parse`.
+    pos_ = index_->ends[kMembers ? pos_ + 2 : pos_] + 1;
+    if (index_->text[index_->structurals[pos_]] == ',') {
+      ++pos_;
+    }
+    // NOLINTEND(*-avoid-unchecked-container-access)
+    return *this;
+  }
+
+  Iterator operator++(int) noexcept {
+    Iterator result = *this;
+    ++*this;
+    return result;
+  }
+
+  friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.pos_ == rhs.pos_; }
+
+ private:
+  friend class Value;
+
+  Iterator(const Index* index, uint32_t pos) noexcept : index_(index), pos_(pos) {}
+
+  const Index* index_ = nullptr;
+  uint32_t pos_ = 0;  // Of the current element or key, or of the closing bracket at the end.
+};
+
+inline auto Json::View::Value::array_values() const noexcept {
+  using Range = std::ranges::subrange<ElementIterator>;
+  return IsArray() ? Range(ElementIterator(index_, pos_ + 1), ElementIterator(index_, End())) : Range();
+}
+
+inline auto Json::View::Value::property_pairs() const noexcept {
+  using Range = std::ranges::subrange<MemberIterator>;
+  return IsObject() ? Range(MemberIterator(index_, pos_ + 1), MemberIterator(index_, End())) : Range();
+}
+
+static_assert(std::is_trivially_copyable_v<Json::View::Value>);
+static_assert(std::forward_iterator<Json::View::Value::ElementIterator>);
+static_assert(std::forward_iterator<Json::View::Value::MemberIterator>);
+
+}  // namespace mbo::json
+
+#endif  // MBO_JSON_JSON_VIEW_H_
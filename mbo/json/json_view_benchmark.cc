@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Sparse access: reading a few values out of the corpora of `json_benchmark_corpus.h` with the lazy `Json::View` vs
+// building a `Json` or a `Json::Document` and looking the values up in it.
+// Run with: MBO_JSON_BENCHMARK_CORPUS=/path/to/jsonexamples bazel run -c opt //mbo/json:json_view_benchmark
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "benchmark/benchmark.h"
+#include "mbo/json/json.h"
+#include "mbo/json/json_benchmark_corpus.h"
+#include "mbo/json/json_document.h"
+#include "mbo/json/json_view.h"
+
+namespace mbo::json {
+namespace {
+
+// The paths read from each corpus: a handful of scalars spread over the document.
+std::vector<std::string_view> Paths(const Corpus& corpus) {
+  if (absl::StartsWith(corpus.name, "twitter")) {
+    return {"statuses[0].user.screen_name", "statuses[50].id", "statuses[99].retweet_count", "search_metadata.count"};
+  }
+  if (absl::StartsWith(corpus.name, "citm_catalog")) {
+    return {
+        "areaNames.205705993", "performances[0].start", "performances[242].prices[3].amount",
+        "venueNames.PLEYEL_PLEYEL"};
+  }
+  return {
+      "type", "features[0].properties.name", "features[0].geometry.type",
+      "features[0].geometry.coordinates[400][0][1]"};
+}
+
+// Looks up `path` in a `Json` or `Json::Document::Value`.
+template<typename T>
+const T* Walk(const T& root, std::string_view path) {
+  const T* value = &root;
+  for (const std::string_view step : absl::StrSplit(path, absl::ByAnyChar(".["), absl::SkipEmpty())) {
+    if (step.ends_with(']')) {
+      std::size_t index = 0;
+      if (!absl::SimpleAtoi(step.substr(0, step.size() - 1), &index) || !value->IsArray() || index >= value->size()) {
+        return nullptr;
+      }
+      value = &(*value)[index];
+    } else {
+      if (!value->contains(step)) {
+        return nullptr;
+      }
+      value = &(*value)[step];
+    }
+  }
+  return value;
+}
+
+// Builds the tree (`Json` or `Json::Document`) and looks up all paths.
+template<typename T>
+bool ParseAndFind(const Corpus& corpus, const std::vector<std::string_view>& paths) {
+  const absl::StatusOr<T> parsed = T::Parse(corpus.text);
+  if (!parsed.ok()) {
+    return false;
+  }
+  for (const std::string_view path : paths) {
+    const auto* value = [&] {
+      if constexpr (std::is_same_v<T, Json>) {
+        return Walk(*parsed, path);
+      } else {
+        return Walk(parsed->root(), path);
+      }
+    }();
+    if (value == nullptr) {
+      return false;
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  return true;
+}
+
+// Indexes the text and parses only the values at `paths`.
+bool ViewAndFind(const Corpus& corpus, const std::vector<std::string_view>& paths) {
+  const absl::StatusOr<Json::View> view = Json::View::Parse(corpus.text);
+  if (!view.ok()) {
+    return false;
+  }
+  for (const std::string_view path : paths) {
+    const absl::StatusOr<Json::View::Value> value = view->root().Find(path);
+    if (!value.ok()) {
+      return false;
+    }
+    absl::StatusOr<Json> json = value->ToJson();
+    if (!json.ok()) {
+      return false;
+    }
+    benchmark::DoNotOptimize(json);
+  }
+  return true;
+}
+
+using FindFunc = bool (*)(const Corpus& corpus, const std::vector<std::string_view>& paths);
+
+void BmSparse(benchmark::State& state, const Corpus& corpus, FindFunc find) {
+  const std::vector<std::string_view> paths = Paths(corpus);
+  if (!find(corpus, paths)) {
+    state.SkipWithError("The corpus is not valid JSON or lacks a path.");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(find(corpus, paths));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(corpus.text.size()));
+}
+
+void RegisterAll() {
+  for (const Corpus& corpus : Corpora()) {
+    for (const auto& [name, find] : {
+             std::pair<const char*, FindFunc>{"Json", &ParseAndFind<Json>},
+             std::pair<const char*, FindFunc>{"Document", &ParseAndFind<Json::Document>},
+             std::pair<const char*, FindFunc>{"View", &ViewAndFind},
+         }) {
+      benchmark::RegisterBenchmark(
+          absl::StrCat("BmSparse<", name, ">/", corpus.name),
+          [&corpus, find](benchmark::State& state) { BmSparse(state, corpus, find); });
+    }
+  }
+}
+
+}  // namespace
+}  // namespace mbo::json
+
+int main(int argc, char** argv) {
+  mbo::json::RegisterAll();
+  benchmark::Initialize(&argc, argv);
+  for (const mbo::json::Corpus& corpus : mbo::json::Corpora()) {
+    benchmark::AddCustomContext(corpus.name, absl::StrCat(corpus.text.size(), " bytes"));
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
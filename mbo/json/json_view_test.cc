@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/json/json_view.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/initialize.h"
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mbo/file/file.h"
+#include "mbo/json/json.h"
+#include "mbo/testing/status.h"
+
+namespace mbo::json {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+using ::mbo::testing::IsOkAndHolds;
+using ::mbo::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Pair;
+
+struct JsonViewTest : ::testing::Test {
+  static void SetUpTestSuite() { absl::InitializeLog(); }
+
+  using View = Json::View;
+  using Value = Json::View::Value;
+};
+
+TEST_F(JsonViewTest, Scalars) {
+  constexpr std::string_view kText =
+      R"([null, true, false, -42, 18446744073709551615, 2.5e-1, 7, "abc", "a\"bä", ""])";
+  MBO_ASSERT_OK_AND_ASSIGN(const View view, View::Parse(kText));
+  const Value root = view.root();
+  ASSERT_TRUE(root.IsArray());
+  ASSERT_EQ(root.size(), 10);
+  EXPECT_TRUE(root.FindElement(0)->IsNull());
+  EXPECT_EQ(root.FindElement(0)->GetKind(), Json::Kind::kNull);
+  EXPECT_THAT(root.FindElement(1)->GetBool(), IsOkAndHolds(true));
+  EXPECT_THAT(root.FindElement(2)->GetBool(), IsOkAndHolds(false));
+  EXPECT_EQ(root.FindElement(2)->GetKind(), Json::Kind::kBool);
+  EXPECT_THAT(root.FindElement(3)->GetSignedInt(), IsOkAndHolds(-42));
+  EXPECT_THAT(root.FindElement(3)->GetFloat(), IsOkAndHolds(-42.0));
+  EXPECT_THAT(root.FindElement(4)->GetUnsignedInt(), IsOkAndHolds(std::numeric_limits<uint64_t>::max()));
+  EXPECT_THAT(root.FindElement(4)->GetSignedInt(), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(root.FindElement(5)->GetFloat(), IsOkAndHolds(0.25));
+  EXPECT_EQ(root.FindElement(5)->GetKind(), Json::Kind::kNumber);
+  EXPECT_THAT(root.FindElement(6)->GetUnsignedInt(), IsOkAndHolds(7));
+  EXPECT_THAT(root.FindElement(3)->GetUnsignedInt(), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(root.FindElement(7)->GetString(), IsOkAndHolds("abc"));
+  EXPECT_THAT(root.FindElement(8)->GetString(), IsOkAndHolds("a\"b\xC3\xA4"));
+  EXPECT_THAT(root.FindElement(9)->GetString(), IsOkAndHolds(""));
+  EXPECT_FALSE(root.FindElement(10).has_value());
+  EXPECT_THAT(
+      root.FindElement(7)->GetSignedInt(),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Is not a SignedInt.")));
+  EXPECT_THAT(root.FindElement(3)->GetString(), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("line 1")));
+  EXPECT_THAT(root.FindElement(0)->GetBool(), StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(JsonViewTest, StringsAreViewsUnlessEscaped) {
+  constexpr std::string_view kText = R"({"plain": "abc", "escaped": "a\nb"})";
+  MBO_ASSERT_OK_AND_ASSIGN(const View view, View::Parse(kText));
+  MBO_ASSERT_OK_AND_ASSIGN(const std::string_view plain, view.root().FindProperty("plain")->GetString());
+  EXPECT_EQ(plain.data(), kText.data() + kText.find("abc"));
+  MBO_ASSERT_OK_AND_ASSIGN(const std::string_view escaped, view.root().FindProperty("escaped")->GetString());
+  EXPECT_EQ(escaped, "a\nb");
+  MBO_ASSERT_OK_AND_ASSIGN(const std::string_view again, view.root().FindProperty("escaped")->GetString());
+  EXPECT_EQ(escaped, "a\nb");  // Still valid.
+  EXPECT_EQ(again, "a\nb");
+}
+
+TEST_F(JsonViewTest, Iteration) {
+  MBO_ASSERT_OK_AND_ASSIGN(
+      const View view, View::Parse(R"({"a": [1, [2, {"x": 3}], {}, []], "b": {"c": "d", "e": null}, "f": []})"));
+  const Value root = view.root();
+  std::vector<std::pair<std::string_view, std::string_view>> members;
+  for (const auto& [name, value] : root.property_pairs()) {
+    MBO_ASSERT_OK_AND_ASSIGN(const std::string_view key, name.GetString());
+    members.emplace_back(key, value.text());
+  }
+  EXPECT_THAT(
+      members,
+      ElementsAre(
+          Pair("a", R"([1, [2, {"x": 3}], {}, []])"), Pair("b", R"({"c": "d", "e": null})"), Pair("f", "[]")));
+  std::vector<std::string_view> elements;
+  for (const Value& value : root.FindProperty("a")->array_values()) {
+    elements.push_back(value.text());
+  }
+  EXPECT_THAT(elements, ElementsAre("1", R"([2, {"x": 3}])", "{}", "[]"));
+  EXPECT_EQ(root.size(), 3);
+  EXPECT_FALSE(root.empty());
+  EXPECT_EQ(root.FindProperty("a")->size(), 4);
+  EXPECT_TRUE(root.FindProperty("f")->empty());
+  EXPECT_EQ(root.FindProperty("f")->size(), 0);
+  EXPECT_TRUE(root.FindProperty("a")->FindElement(2)->empty());
+  EXPECT_TRUE(root.FindProperty("a")->FindElement(0)->empty());
+  EXPECT_TRUE(root.FindProperty("a")->array_values().begin() != root.FindProperty("a")->array_values().end());
+  EXPECT_TRUE(root.array_values().empty());
+  EXPECT_TRUE(root.FindProperty("a")->property_pairs().empty());
+}
+
+TEST_F(JsonViewTest, Find) {
+  MBO_ASSERT_OK_AND_ASSIGN(
+      const View view,
+      View::Parse(R"({"a": {"b": [0, 1, 2, {"c": "found"}]}, "x": [[1, 2], [3, 4]], "a.b": 5, "": 6})"));
+  const Value root = view.root();
+  MBO_ASSERT_OK_AND_ASSIGN(const Value found, root.Find("a.b[3].c"));
+  EXPECT_THAT(found.GetString(), IsOkAndHolds("found"));
+  EXPECT_EQ(root.Find("x[1][0]")->text(), "3");
+  MBO_ASSERT_OK_AND_ASSIGN(const Value x, root.Find("x"));
+  EXPECT_THAT(x.Find("[0][1]")->GetSignedInt(), IsOkAndHolds(2));
+  EXPECT_EQ(root.Find("")->text(), root.text());
+  EXPECT_THAT(root.FindProperty("a.b")->GetSignedInt(), IsOkAndHolds(5));
+  EXPECT_THAT(root.FindProperty("")->GetSignedInt(), IsOkAndHolds(6));
+  EXPECT_TRUE(root.contains("x"));
+  EXPECT_FALSE(root.contains("y"));
+  EXPECT_FALSE(x.contains("x"));
+  EXPECT_THAT(root.Find("a.b[4]"), StatusIs(absl::StatusCode::kNotFound, HasSubstr("not found at 'a.b[4]'")));
+  EXPECT_THAT(root.Find("a.c.d"), StatusIs(absl::StatusCode::kNotFound, HasSubstr("not found at 'a.c'")));
+  EXPECT_THAT(root.Find("a[0]"), StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(root.Find("x.a"), StatusIs(absl::StatusCode::kNotFound));
+  for (const std::string_view path : {".a", "a.", "a..b", "a[", "a[]", "a[-1]", "a[1x]", "a[+1]", "x[0]a", "a.[0]"}) {
+    EXPECT_THAT(root.Find(path), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("Invalid JSON path")))
+        << "Path: '" << path << "'";
+  }
+}
+
+TEST_F(JsonViewTest, Keys) {
+  MBO_ASSERT_OK_AND_ASSIGN(
+      const View view, View::Parse(R"({"a": 1, "ab": 2, "ab": 3, "q\"": 4, "b\\": 5, "a": 6, "abc": 7})"));
+  const Value root = view.root();
+  EXPECT_THAT(root.FindProperty("a")->GetSignedInt(), IsOkAndHolds(6));  // Last wins.
+  EXPECT_THAT(root.FindProperty("ab")->GetSignedInt(), IsOkAndHolds(3));
+  EXPECT_THAT(root.FindProperty("q\"")->GetSignedInt(), IsOkAndHolds(4));
+  EXPECT_THAT(root.FindProperty("b\\")->GetSignedInt(), IsOkAndHolds(5));
+  EXPECT_THAT(root.FindProperty("abc")->GetSignedInt(), IsOkAndHolds(7));
+  EXPECT_FALSE(root.FindProperty("b").has_value());
+  EXPECT_FALSE(root.FindProperty("q").has_value());
+  EXPECT_EQ(root.size(), 7);
+}
+
+TEST_F(JsonViewTest, ToJson) {
+  constexpr std::string_view kText =
+      R"({"statuses": [{"id": 1, "text": "aä", "tags": [], "user": {"name": "x", "id": 2.5}}], "count": -3})";
+  MBO_ASSERT_OK_AND_ASSIGN(const View view, View::Parse(kText));
+  MBO_ASSERT_OK_AND_ASSIGN(const Json json, Json::Parse(kText));
+  EXPECT_THAT(view.root().ToJson(), IsOkAndHolds(json));
+  MBO_ASSERT_OK_AND_ASSIGN(const Value user, view.root().Find("statuses[0].user"));
+  EXPECT_THAT(user.ToJson(), IsOkAndHolds(json["statuses"][0]["user"]));
+  MBO_ASSERT_OK_AND_ASSIGN(const Value count, view.root().Find("count"));
+  EXPECT_THAT(count.ToJson(), IsOkAndHolds(Json(-3)));
+}
+
+TEST_F(JsonViewTest, ScalarsAreValidatedLazily) {
+  MBO_ASSERT_OK_AND_ASSIGN(const View view, View::Parse(R"({"bad": [tru, 01, "\x"], "good": 1})"));
+  EXPECT_THAT(view.root().Find("good")->GetSignedInt(), IsOkAndHolds(1));
+  EXPECT_THAT(view.root().Find("bad[0]")->GetBool(), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(view.root().Find("bad[1]")->GetSignedInt(), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(view.root().Find("bad[2]")->GetString(), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(view.root().Find("bad")->ToJson(), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(view.root().ToJson(), StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(JsonViewTest, StructureErrors) {
+  for (const std::string_view text : {"", "[1 2]", R"({"a": 1,})", R"({"a" 1})", R"({1: 2})", "[1,]", "[1]]", "]",
+                                      R"({"a": 1])", "[", R"(["a)"}) {
+    const absl::StatusOr<View> view = View::Parse(text);
+    const absl::StatusOr<Json> json = Json::Parse(text);
+    ASSERT_THAT(view, StatusIs(absl::StatusCode::kInvalidArgument)) << "Text: '" << text << "'";
+    EXPECT_EQ(view.status(), json.status()) << "Text: '" << text << "'";
+  }
+  EXPECT_THAT(
+      View::Parse(std::string(2'000, '[')), StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("too deep")));
+  MBO_ASSERT_OK_AND_ASSIGN(const View scalar, View::Parse(" 42 "));
+  EXPECT_THAT(scalar.root().GetSignedInt(), IsOkAndHolds(42));
+  EXPECT_EQ(scalar.root().text(), "42");
+}
+
+TEST_F(JsonViewTest, ParseFile) {
+  const std::filesystem::path path = std::filesystem::path(::testing::TempDir()) / "json_view_test.json";
+  ASSERT_OK(file::SetContents(path, R"({"a": [1, "two"]})"));
+  MBO_ASSERT_OK_AND_ASSIGN(View view, View::ParseFile(path));
+  const Value value = *view.root().Find("a[1]");
+  const View moved = std::move(view);
+  EXPECT_THAT(value.GetString(), IsOkAndHolds("two"));
+  EXPECT_EQ(moved.text(), R"({"a": [1, "two"]})");
+  ASSERT_OK(file::SetContents(path, "[1,"));
+  EXPECT_THAT(
+      View::ParseFile(path),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("json_view_test.json: JSON error")));
+  EXPECT_THAT(View::ParseFile(path.string() + ".missing"), StatusIs(absl::StatusCode::kNotFound));
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::json
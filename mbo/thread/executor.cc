@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/thread/executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+
+namespace mbo::thread {
+namespace {
+
+// The pool whose task the current thread is running (if any): nested
+// `ParallelFor` calls into the same pool run inline instead of deadlocking.
+thread_local const ThreadPool* t_current_pool = nullptr;  // NOLINT(*-avoid-non-const-global-variables)
+
+class ScopedCurrentPool final {
+ public:
+  explicit ScopedCurrentPool(const ThreadPool* pool) noexcept : previous_(t_current_pool) { t_current_pool = pool; }
+
+  ~ScopedCurrentPool() noexcept { t_current_pool = previous_; }
+
+  ScopedCurrentPool(const ScopedCurrentPool&) = delete;
+  ScopedCurrentPool& operator=(const ScopedCurrentPool&) = delete;
+  ScopedCurrentPool(ScopedCurrentPool&&) = delete;
+  ScopedCurrentPool& operator=(ScopedCurrentPool&&) = delete;
+
+ private:
+  const ThreadPool* const previous_;
+};
+
+void RunInline(std::size_t count, absl::FunctionRef<void(std::size_t)> task) {
+  for (std::size_t index = 0; index < count; ++index) {
+    task(index);
+  }
+}
+
+}  // namespace
+
+void InlineExecutor::ParallelFor(std::size_t count, absl::FunctionRef<void(std::size_t)> task) {
+  RunInline(count, task);
+}
+
+ThreadPool::ThreadPool(std::size_t concurrency) {
+  if (concurrency == 0) {
+    concurrency = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  }
+  workers_.reserve(concurrency - 1);
+  for (std::size_t i = 1; i < concurrency; ++i) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+  {
+    const absl::MutexLock lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.SignalAll();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Work(Job& job) {
+  while (true) {
+    const std::size_t index = job.next.fetch_add(1, std::memory_order_relaxed);
+    if (index >= job.count) {
+      return;
+    }
+    job.task(index);
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+  const ScopedCurrentPool current(this);
+  uint64_t seen = 0;
+  while (true) {
+    Job* job = nullptr;
+    {
+      const absl::MutexLock lock(mutex_);
+      while (!stop_ && generation_ == seen) {
+        work_cv_.Wait(&mutex_);
+      }
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      job = job_;
+    }
+    Work(*job);
+    const absl::MutexLock lock(mutex_);
+    if (--active_ == 0) {
+      done_cv_.Signal();
+    }
+  }
+}
+
+void ThreadPool::ParallelFor(std::size_t count, absl::FunctionRef<void(std::size_t)> task) {
+  if (workers_.empty() || count <= 1 || t_current_pool == this) {
+    RunInline(count, task);
+    return;
+  }
+  if (!run_mutex_.TryLock()) {
+    // Another thread owns the workers; this caller still makes progress.
+    RunInline(count, task);
+    return;
+  }
+  Job job{.task = task, .count = count};
+  {
+    const absl::MutexLock lock(mutex_);
+    job_ = &job;
+    ++generation_;
+    active_ = workers_.size();
+  }
+  work_cv_.SignalAll();
+  {
+    const ScopedCurrentPool current(this);
+    Work(job);
+  }
+  const absl::MutexLock lock(mutex_);
+  while (active_ != 0) {
+    done_cv_.Wait(&mutex_);
+  }
+  job_ = nullptr;
+  run_mutex_.Unlock();
+}
+
+}  // namespace mbo::thread
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_THREAD_EXECUTOR_H_
+#define MBO_THREAD_EXECUTOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+
+namespace mbo::thread {
+
+// Fork-join execution of index-addressed work. `ParallelFor(count, task)` calls
+// `task(i)` exactly once for every `i` in `[0, count)` and returns only after
+// all calls have completed; the order and the threads used are unspecified, so
+// tasks must only touch state owned by their index (results are usually written
+// to slot `i` of a pre-sized vector and consumed in order by the caller).
+// Tasks must not throw.
+class Executor {
+ public:
+  Executor() noexcept = default;
+  virtual ~Executor() noexcept = default;
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+  Executor(Executor&&) = delete;
+  Executor& operator=(Executor&&) = delete;
+
+  // The number of tasks that may run at the same time (at least 1). Callers use
+  // this to size their work split.
+  virtual std::size_t Concurrency() const noexcept = 0;
+
+  virtual void ParallelFor(std::size_t count, absl::FunctionRef<void(std::size_t)> task) = 0;
+};
+
+// Runs every task on the calling thread, in index order.
+class InlineExecutor final : public Executor {
+ public:
+  std::size_t Concurrency() const noexcept override { return 1; }
+
+  void ParallelFor(std::size_t count, absl::FunctionRef<void(std::size_t)> task) override;
+};
+
+// A fixed-size pool: `ThreadPool(n)` has a concurrency of `n` (0 selects
+// `std::thread::hardware_concurrency()`), made up of `n - 1` worker threads
+// plus the calling thread, which participates in every `ParallelFor`.
+//
+// Indices are handed out through one atomic counter, so uneven task costs
+// balance themselves. The workers serve one `ParallelFor` at a time: a call
+// made while another thread's call is running (or nested inside a task) runs
+// inline on its own thread instead of waiting, so it cannot deadlock and one
+// pool can be shared by independent callers (e.g. per-file hashing running on
+// a second pool).
+class ThreadPool final : public Executor {
+ public:
+  explicit ThreadPool(std::size_t concurrency = 0);
+  ~ThreadPool() noexcept override;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  std::size_t Concurrency() const noexcept override { return workers_.size() + 1; }
+
+  void ParallelFor(std::size_t count, absl::FunctionRef<void(std::size_t)> task) override;
+
+ private:
+  struct Job {
+    absl::FunctionRef<void(std::size_t)> task;
+    std::size_t count = 0;
+    std::atomic<std::size_t> next{0};
+  };
+
+  static void Work(Job& job);
+
+  void WorkerLoop();
+
+  absl::Mutex run_mutex_;  // Held by the `ParallelFor` caller that owns the workers.
+  absl::Mutex mutex_;
+  absl::CondVar work_cv_;  // A new generation (or `stop_`) was published.
+  absl::CondVar done_cv_;  // `active_` dropped to 0.
+  Job* job_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  uint64_t generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::size_t active_ ABSL_GUARDED_BY(mutex_) = 0;  // Workers still on the current generation.
+  bool stop_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace mbo::thread
+
+#endif  // MBO_THREAD_EXECUTOR_H_
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/thread/executor.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace mbo::thread {
+namespace {
+
+using ::testing::Each;
+using ::testing::ElementsAre;
+
+TEST(InlineExecutorTest, RunsInOrder) {
+  InlineExecutor executor;
+  EXPECT_THAT(executor.Concurrency(), 1);
+  std::vector<std::size_t> order;
+  executor.ParallelFor(4, [&order](std::size_t index) { order.push_back(index); });
+  EXPECT_THAT(order, ElementsAre(0, 1, 2, 3));
+}
+
+TEST(ThreadPoolTest, Concurrency) {
+  EXPECT_THAT(ThreadPool(1).Concurrency(), 1);
+  EXPECT_THAT(ThreadPool(4).Concurrency(), 4);
+  EXPECT_THAT(ThreadPool(0).Concurrency(), ::testing::Ge(1));
+}
+
+TEST(ThreadPoolTest, RunsEveryIndexOnce) {
+  ThreadPool pool(4);
+  constexpr auto kCounts = std::to_array<std::size_t>({0, 1, 2, 3, 17, 1'000});
+  for (const std::size_t count : kCounts) {
+    std::vector<std::atomic<int>> calls(count);
+    pool.ParallelFor(count, [&calls](std::size_t index) { calls.at(index).fetch_add(1); });
+    std::vector<int> seen;
+    seen.reserve(count);
+    for (const std::atomic<int>& call : calls) {
+      seen.push_back(call.load());
+    }
+    EXPECT_THAT(seen, Each(1)) << "count " << count;
+  }
+}
+
+TEST(ThreadPoolTest, ReusableAcrossManyRounds) {
+  ThreadPool pool(3);
+  std::atomic<std::size_t> sum = 0;
+  constexpr std::size_t kRounds = 200;
+  constexpr std::size_t kCount = 10;
+  for (std::size_t round = 0; round < kRounds; ++round) {
+    pool.ParallelFor(kCount, [&sum](std::size_t index) { sum.fetch_add(index); });
+  }
+  EXPECT_THAT(sum.load(), kRounds * (kCount * (kCount - 1) / 2));
+}
+
+TEST(ThreadPoolTest, NestedCallsRunInline) {
+  ThreadPool pool(2);
+  std::atomic<std::size_t> calls = 0;
+  pool.ParallelFor(4, [&](std::size_t /*index*/) {
+    pool.ParallelFor(3, [&calls](std::size_t /*index*/) { calls.fetch_add(1); });
+  });
+  EXPECT_THAT(calls.load(), 12);
+}
+
+TEST(ThreadPoolTest, ConcurrentCallersAllComplete) {
+  ThreadPool pool(3);
+  constexpr std::size_t kCallers = 4;
+  constexpr std::size_t kCount = 500;
+  std::atomic<std::size_t> calls = 0;
+  std::vector<std::thread> callers;
+  callers.reserve(kCallers);
+  for (std::size_t caller = 0; caller < kCallers; ++caller) {
+    callers.emplace_back([&] { pool.ParallelFor(kCount, [&calls](std::size_t /*index*/) { calls.fetch_add(1); }); });
+  }
+  for (std::thread& caller : callers) {
+    caller.join();
+  }
+  EXPECT_THAT(calls.load(), kCallers * kCount);
+}
+
+}  // namespace
+}  // namespace mbo::thread
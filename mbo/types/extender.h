@@ -43,6 +43,7 @@
 //
 //   * Provides: `friend void AbslStringify(Sink&, const Type& t)`
 //   * Provides: protected `void OStreamFields(std::ostream& os, const StringifyOptions&) const`
+//   * Provides: protected `void AppendFields(std::string& out, const StringifyOptions&) const`
 //   * Enables use of the struct with `absl::Format` library.
 //   * Required by: `Printable`, `Streamable`.
 //
@@ -64,7 +65,7 @@
 // IWYU pragma: private, include "mbo/types/extend.h"
 
 #include <concepts>  // IWYU pragma: keep
-#include <sstream>
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -145,12 +146,17 @@ struct AbslStringify_ : ExtenderBase {  // NOLINT(readability-identifier-naming)
 
   template<typename Sink>
   friend void AbslStringify(Sink& sink, const Type& value) {
-    std::ostringstream os;
-    value.OStreamFields(os);
-    sink.Append(os.str());
+    std::string out;
+    value.AppendFields(out);
+    sink.Append(out);
   }
 
  protected:
+  // Append the type to `out` with control via `field_options`.
+  void AppendFields(std::string& out, const StringifyOptions& default_options = Stringify::OptionsDefault()) const {
+    Stringify(default_options).AppendTo(out, static_cast<const Type&>(*this));
+  }
+
   // Stream the type to `os` with control via `field_options`.
   void OStreamFields(std::ostream& os, const StringifyOptions& default_options = Stringify::OptionsDefault()) const {
     OStreamFieldsStatic(os, static_cast<const Type&>(*this), default_options);
@@ -240,9 +246,9 @@ struct Printable_ : ExtenderBase {  // NOLINT(readability-identifier-naming)
   // something that can produce those. It defaults to `MboTypesStringifyOptions`
   // if available and otherwise the default `StringifyOptions` will be used.
   std::string ToString(const StringifyOptions& default_options = Stringify::OptionsDefault()) const {
-    std::ostringstream os;
-    this->OStreamFields(os, default_options);
-    return os.str();
+    std::string out;
+    this->AppendFields(out, default_options);
+    return out;
   }
 
   std::string ToJsonString() const { return ToString(Stringify::OptionsJson()); }
@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/types/internal/escape.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "absl/strings/ascii.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# define MBO_TYPES_ESCAPE_X86 1
+# include <immintrin.h>
+#else
+# define MBO_TYPES_ESCAPE_X86 0
+#endif
+
+namespace mbo::types::types_internal {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic,*-reinterpret-cast)
+
+constexpr bool IsUnescaped(char chr) noexcept {
+  const auto byte = static_cast<unsigned char>(chr);
+  return byte >= 0x20 && byte < 0x7F && chr != '"' && chr != '\'' && chr != '\\';
+}
+
+std::size_t UnescapedPrefixPortable(std::string_view text) noexcept {
+  std::size_t pos = 0;
+  while (pos < text.size() && IsUnescaped(text[pos])) {
+    ++pos;
+  }
+  return pos;
+}
+
+#if MBO_TYPES_ESCAPE_X86
+// Bytes below 0x20 and at or above 0x80 are both less than 0x20 as signed bytes.
+std::size_t UnescapedPrefixSse2(std::string_view text) noexcept {
+  const __m128i space = _mm_set1_epi8(0x20);
+  const __m128i del = _mm_set1_epi8(0x7F);
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i apostrophe = _mm_set1_epi8('\'');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  std::size_t pos = 0;
+  for (; pos + 16 <= text.size(); pos += 16) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+    const __m128i escape = _mm_or_si128(
+        _mm_or_si128(_mm_cmplt_epi8(chars, space), _mm_cmpeq_epi8(chars, del)),
+        _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chars, quote), _mm_cmpeq_epi8(chars, apostrophe)),
+            _mm_cmpeq_epi8(chars, backslash)));
+    if (const auto bits = static_cast<uint32_t>(_mm_movemask_epi8(escape)); bits != 0) {
+      return pos + static_cast<std::size_t>(std::countr_zero(bits));
+    }
+  }
+  return pos + UnescapedPrefixPortable(text.substr(pos));
+}
+
+__attribute__((target("avx2"))) std::size_t UnescapedPrefixAvx2(std::string_view text) noexcept {
+  const __m256i space = _mm256_set1_epi8(0x20);
+  const __m256i del = _mm256_set1_epi8(0x7F);
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i apostrophe = _mm256_set1_epi8('\'');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  std::size_t pos = 0;
+  for (; pos + 32 <= text.size(); pos += 32) {
+    const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + pos));
+    const __m256i escape = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpgt_epi8(space, chars), _mm256_cmpeq_epi8(chars, del)),
+        _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, quote), _mm256_cmpeq_epi8(chars, apostrophe)),
+            _mm256_cmpeq_epi8(chars, backslash)));
+    if (const auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(escape)); bits != 0) {
+      return pos + static_cast<std::size_t>(std::countr_zero(bits));
+    }
+  }
+  return pos + UnescapedPrefixSse2(text.substr(pos));
+}
+#endif  // MBO_TYPES_ESCAPE_X86
+
+using PrefixFunction = std::size_t (*)(std::string_view) noexcept;
+
+PrefixFunction SelectPrefix() noexcept {
+#if MBO_TYPES_ESCAPE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return &UnescapedPrefixAvx2;
+  }
+  return &UnescapedPrefixSse2;
+#else   // MBO_TYPES_ESCAPE_X86
+  return &UnescapedPrefixPortable;
+#endif  // MBO_TYPES_ESCAPE_X86
+}
+
+PrefixFunction GetPrefix(EscapeKernel kernel) noexcept {
+  static const PrefixFunction kPrefix = SelectPrefix();
+  return kernel == EscapeKernel::kPortable ? &UnescapedPrefixPortable : kPrefix;
+}
+
+// Calls `copy(pos, size)` for each run of unescaped bytes and `escape(chr, numeric)` for each other byte, where
+// `numeric` tells whether `chr` needs an octal or hex escape (all but the short escapes such as `\n`).
+template<typename Copy, typename Escape>
+void ForEachRun(std::string_view text, CEscapeStyle style, EscapeKernel kernel, Copy copy, Escape escape) {
+  const PrefixFunction prefix = GetPrefix(kernel);
+  std::size_t pos = 0;
+  while (pos < text.size()) {
+    const std::size_t run = prefix(text.substr(pos));
+    if (run > 0) {
+      copy(pos, run);
+      pos += run;
+      if (pos == text.size()) {
+        break;
+      }
+    }
+    const char chr = text[pos++];
+    switch (chr) {
+      case '\n':
+      case '\r':
+      case '\t':
+      case '"':
+      case '\'':
+      case '\\': escape(chr, false); continue;
+      default: break;
+    }
+    escape(chr, true);
+    if (style == CEscapeStyle::kHex) {
+      // A hex digit right after a hex escape would continue it, so it gets escaped as well.
+      while (pos < text.size() && absl::ascii_isxdigit(static_cast<unsigned char>(text[pos]))) {
+        escape(text[pos++], true);
+      }
+    }
+  }
+}
+
+// NOLINTEND(*-magic-numbers,*-pointer-arithmetic,*-reinterpret-cast)
+
+}  // namespace
+
+std::size_t UnescapedPrefix(std::string_view text, EscapeKernel kernel) noexcept {
+  return GetPrefix(kernel)(text);
+}
+
+std::size_t EscapedSize(std::string_view text, CEscapeStyle style, EscapeKernel kernel) noexcept {
+  std::size_t size = 0;
+  ForEachRun(
+      text, style, kernel, [&](std::size_t /*pos*/, std::size_t run) { size += run; },
+      [&](char /*chr*/, bool numeric) { size += numeric ? 4 : 2; });
+  return size;
+}
+
+void AppendEscaped(std::string& out, std::string_view text, CEscapeStyle style, EscapeKernel kernel) {
+  const std::size_t unescaped = GetPrefix(kernel)(text);
+  if (unescaped == text.size()) {
+    out.append(text);
+    return;
+  }
+  out.append(text.substr(0, unescaped));
+  text.remove_prefix(unescaped);
+  const std::size_t size = out.size();
+  out.resize(size + EscapedSize(text, style, kernel));
+  char* dst = out.data() + size;  // NOLINT(*-pointer-arithmetic)
+  // NOLINTBEGIN(*-magic-numbers,*-pointer-arithmetic)
+  ForEachRun(
+      text, style, kernel,
+      [&](std::size_t pos, std::size_t run) {
+        text.copy(dst, run, pos);
+        dst += run;
+      },
+      [&](char chr, bool numeric) {
+        *dst++ = '\\';
+        if (!numeric) {
+          switch (chr) {
+            case '\n': *dst++ = 'n'; return;
+            case '\r': *dst++ = 'r'; return;
+            case '\t': *dst++ = 't'; return;
+            default: *dst++ = chr; return;
+          }
+        }
+        const auto byte = static_cast<unsigned char>(chr);
+        if (style == CEscapeStyle::kHex) {
+          constexpr std::string_view kHexDigits = "0123456789abcdef";
+          *dst++ = 'x';
+          *dst++ = kHexDigits[byte >> 4];
+          *dst++ = kHexDigits[byte & 0xF];
+        } else {
+          *dst++ = static_cast<char>('0' + (byte >> 6));
+          *dst++ = static_cast<char>('0' + ((byte >> 3) & 7));
+          *dst++ = static_cast<char>('0' + (byte & 7));
+        }
+      });
+  // NOLINTEND(*-magic-numbers,*-pointer-arithmetic)
+}
+
+}  // namespace mbo::types::types_internal
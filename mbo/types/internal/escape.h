@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MBO_TYPES_INTERNAL_ESCAPE_H_
+#define MBO_TYPES_INTERNAL_ESCAPE_H_
+
+// IWYU pragma: private, include "mbo/types/stringify.h"
+// IWYU pragma: friend "mbo/types/.*"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace mbo::types::types_internal {
+
+// C-escaping without temporaries: the output is byte for byte that of `absl::CEscape` (`kOctal`) or
+// `absl::CHexEscape` (`kHex`), but it is appended to an existing string. Runs of bytes that need no escaping are
+// found with a vectorized scan, so the common case of text without any special character costs a single pass.
+
+enum class CEscapeStyle {
+  kOctal,  // Like `absl::CEscape`: non printable bytes become `\ooo`.
+  kHex,    // Like `absl::CHexEscape`: non printable bytes become `\xhh`.
+};
+
+enum class EscapeKernel {
+  kAuto,      // The widest vector instructions the CPU supports.
+  kPortable,  // Plain byte by byte code (also the reference for the vector kernels).
+};
+
+// Returns the number of leading bytes of `text` that are kept as they are: printable ASCII other than `"`, `'` and
+// `\`. The bytes after a hex escape are not considered.
+std::size_t UnescapedPrefix(std::string_view text, EscapeKernel kernel = EscapeKernel::kAuto) noexcept;
+
+// Returns the size of `text` once it is escaped.
+std::size_t EscapedSize(std::string_view text, CEscapeStyle style, EscapeKernel kernel = EscapeKernel::kAuto) noexcept;
+
+// Appends the escaped `text` to `out`. The `out` grows only once, by exactly the escaped size.
+void AppendEscaped(
+    std::string& out,
+    std::string_view text,
+    CEscapeStyle style,
+    EscapeKernel kernel = EscapeKernel::kAuto);
+
+}  // namespace mbo::types::types_internal
+
+#endif  // MBO_TYPES_INTERNAL_ESCAPE_H_
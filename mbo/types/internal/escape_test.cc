@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mbo/types/internal/escape.h"
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "absl/strings/escaping.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace mbo::types::types_internal {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+struct EscapeInternalTest : ::testing::Test {
+  static std::string Absl(std::string_view text, CEscapeStyle style) {
+    return style == CEscapeStyle::kHex ? absl::CHexEscape(text) : absl::CEscape(text);
+  }
+
+  static std::string Escape(std::string_view text, CEscapeStyle style, EscapeKernel kernel) {
+    std::string out = "prefix";
+    AppendEscaped(out, text, style, kernel);
+    return out.substr(6);
+  }
+};
+
+TEST_F(EscapeInternalTest, Basics) {
+  constexpr std::string_view kText = "a\n\r\t\"'\\\x01\x7F\x80\xFF\x1b""5f";
+  EXPECT_EQ(Escape(kText, CEscapeStyle::kOctal, EscapeKernel::kAuto), R"(a\n\r\t\"\'\\\001\177\200\377\0335f)");
+  EXPECT_EQ(Escape(kText, CEscapeStyle::kHex, EscapeKernel::kAuto), R"(a\n\r\t\"\'\\\x01\x7f\x80\xff\x1b\x35\x66)");
+  EXPECT_EQ(Escape("", CEscapeStyle::kOctal, EscapeKernel::kAuto), "");
+  EXPECT_EQ(Escape("plain text", CEscapeStyle::kHex, EscapeKernel::kAuto), "plain text");
+  EXPECT_EQ(Escape("\x01g1", CEscapeStyle::kHex, EscapeKernel::kAuto), R"(\x01g1)");
+}
+
+TEST_F(EscapeInternalTest, UnescapedPrefix) {
+  const std::string text(100, 'a');
+  for (std::size_t pos = 0; pos < text.size(); ++pos) {
+    for (const char special : {'"', '\'', '\\', '\n', '\x1F', '\x7F', '\x80'}) {
+      std::string copy = text;
+      copy[pos] = special;
+      EXPECT_EQ(UnescapedPrefix(copy), pos) << "Pos: " << pos << ", Char: " << int{special};
+      EXPECT_EQ(UnescapedPrefix(copy, EscapeKernel::kPortable), pos);
+    }
+  }
+  EXPECT_EQ(UnescapedPrefix(text), text.size());
+  EXPECT_EQ(UnescapedPrefix(" ~"), 2);
+}
+
+TEST_F(EscapeInternalTest, MatchesAbsl) {
+  std::mt19937 rng(42);  // NOLINT(*-msc51-cpp)
+  // Mostly plain text, so that the runs between escapes cover all lengths and alignments of the vector kernels.
+  constexpr std::string_view kChars = "abcdefABCDEF0123456789 xyz{}:,\"'\\\n\r\t\x01\x1F\x7F\x80\xC3\xA4\xFF";
+  std::uniform_int_distribution<std::size_t> pick(0, kChars.size() - 1);
+  std::uniform_int_distribution<int> plain(0, 15);
+  for (std::size_t size = 0; size < 300; ++size) {
+    std::string text;
+    for (std::size_t idx = 0; idx < size; ++idx) {
+      text += plain(rng) == 0 ? kChars[pick(rng)] : 'm';
+    }
+    for (const CEscapeStyle style : {CEscapeStyle::kOctal, CEscapeStyle::kHex}) {
+      const std::string expected = Absl(text, style);
+      EXPECT_EQ(EscapedSize(text, style), expected.size());
+      for (const EscapeKernel kernel : {EscapeKernel::kAuto, EscapeKernel::kPortable}) {
+        ASSERT_EQ(Escape(text, style, kernel), expected)
+            << "Size: " << size << ", Style: " << static_cast<int>(style) << ", Kernel: " << static_cast<int>(kernel);
+      }
+    }
+  }
+}
+
+TEST_F(EscapeInternalTest, AllBytes) {
+  std::string text;
+  for (int chr = 0; chr < 256; ++chr) {
+    text += static_cast<char>(chr);
+    text += static_cast<char>(chr);
+  }
+  for (const CEscapeStyle style : {CEscapeStyle::kOctal, CEscapeStyle::kHex}) {
+    EXPECT_EQ(Escape(text, style, EscapeKernel::kAuto), Absl(text, style));
+  }
+}
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::types::types_internal
@@ -20,13 +20,15 @@
 
 // IWYU pragma: private, include "mbo/types/extend.h"
 
+#include <array>
+#include <charconv>
 #include <concepts>  // IWYU pragma: keep
+#include <cstddef>
 #include <functional>
 #include <iostream>
 #include <limits>
 #include <optional>
 #include <ostream>
-#include <sstream>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -36,9 +38,9 @@
 #include "absl/container/btree_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
-#include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
 #include "mbo/config/require.h"
+#include "mbo/types/internal/escape.h"
 #include "mbo/types/internal/extender.h"      // IWYU pragma: keep
 #include "mbo/types/internal/struct_names.h"  // IWYU pragma: keep
 #include "mbo/types/optional_data_or_ref.h"
@@ -757,23 +759,31 @@ class Stringify {
       : Stringify(OptionsAs(output_mode), root_options) {}
 
   template<typename T>
-  requires(IsAggregate<T> || IsEmptyType<T> || IsStringKeyedContainer<T>)
+  requires(IsAggregate<T> || IsEmptyType<T> || IsStringKeyedContainer<T> || HasMboTypesStringifyValueAccess<T>)
   std::string ToString(const T& value, OptionalRef<const StringifyRootOptions> opt_root_options = {}) const {
-    std::ostringstream os;
-    Stream<T>(os, value, opt_root_options);
-    return os.str();
+    std::string out;
+    AppendTo<T>(out, value, opt_root_options);
+    return out;
   }
 
+  // Appends the output for `value` to `out`, which allows to reuse buffers.
   template<typename T>
-  requires(IsAggregate<T> || IsEmptyType<T> || IsStringKeyedContainer<T>)
+  requires(IsAggregate<T> || IsEmptyType<T> || IsStringKeyedContainer<T> || HasMboTypesStringifyValueAccess<T>)
+  void AppendTo(std::string& out, const T& value, OptionalRef<const StringifyRootOptions> opt_root_options = {}) const {
+    const StringifyRootOptions& root_options = opt_root_options ? *opt_root_options : default_root_options_;
+    OStream os(EnableIndent(), out, root_options);
+    StreamRoot(os, value, root_options);
+  }
+
+  // Writes the output for `value` to `out`. The output is collected in a buffer that is written to `out` in chunks.
+  template<typename T>
+  requires(IsAggregate<T> || IsEmptyType<T> || IsStringKeyedContainer<T> || HasMboTypesStringifyValueAccess<T>)
   void Stream(std::ostream& out, const T& value, OptionalRef<const StringifyRootOptions> opt_root_options = {}) const {
     const StringifyRootOptions& root_options = opt_root_options ? *opt_root_options : default_root_options_;
-    OStream os(!default_field_options_.outer.format.get({}).field_indent.empty(), out, root_options);
-    os << root_options.root_prefix;
-    os << default_field_options_.outer.format.get({}).message_prefix;
-    StreamImpl(os, default_field_options_, value);
-    os << default_field_options_.outer.format.get({}).message_suffix;
-    os << root_options.root_suffix;
+    std::string buffer;
+    OStream os(EnableIndent(), buffer, root_options, &out);
+    StreamRoot(os, value, root_options);
+    os.Flush();
   }
 
   const StringifyRootOptions& DebugDefaultRootOptions() const noexcept { return default_root_options_; }
@@ -784,8 +794,12 @@ class Stringify {
   using SO = StringifyOptions;
   using SFO = StringifyFieldOptions;
 
+  // Appends the output to a string. With a `flush` stream the string is a buffer that gets written to that whenever it
+  // grows beyond `kFlushBytes`.
   class OStream {
    public:
+    static constexpr std::size_t kFlushBytes = std::size_t{64} << 10;
+
     ~OStream() noexcept = default;
     OStream() = delete;
     OStream(const OStream&) = delete;
@@ -793,19 +807,65 @@ class Stringify {
     OStream(OStream&&) = delete;
     OStream& operator=(OStream&&) = delete;
 
-    OStream(bool enable_indent, std::ostream& os, const StringifyRootOptions& root_options)
-        : enable_indent_(enable_indent), os_(os) {
+    OStream(
+        bool enable_indent,
+        std::string& out,
+        const StringifyRootOptions& root_options,
+        std::ostream* flush = nullptr)
+        : enable_indent_(enable_indent), out_(out), flush_(flush) {
       RootIndent(root_options);
     }
 
-    template<typename T>
-    OStream& operator<<(const T& v) {
-      os_ << v;
+    OStream& operator<<(std::string_view v) {
+      Append(v);
       return *this;
     }
 
+    // Formats numbers as `absl::StrFormat("%v", v)` would, but without its overhead.
+    template<typename T>
+    requires(std::is_arithmetic_v<T>)
+    void AppendNumber(T v) {
+      if constexpr (std::same_as<T, bool>) {
+        Append(v ? "true" : "false");
+      } else if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(int64_t)) {
+        using Int = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+        std::array<char, std::numeric_limits<Int>::digits10 + 3> buf;  // Digits, sign and the extra digit.
+        // NOLINTNEXTLINE(*-pointer-arithmetic)
+        const std::to_chars_result result = std::to_chars(buf.data(), buf.data() + buf.size(), static_cast<Int>(v));
+        Append(std::string_view(buf.data(), static_cast<std::size_t>(result.ptr - buf.data())));
+      } else if constexpr (std::same_as<T, float> || std::same_as<T, double>) {
+        constexpr int kPrecision = 6;  // Same as `%g` (and hence `%v`).
+        std::array<char, 32> buf;      // NOLINT(*-magic-numbers): Longest is "-1.23457e-308".
+        const std::to_chars_result result =  // NOLINTNEXTLINE(*-pointer-arithmetic)
+            std::to_chars(buf.data(), buf.data() + buf.size(), v, std::chars_format::general, kPrecision);
+        Append(std::string_view(buf.data(), static_cast<std::size_t>(result.ptr - buf.data())));
+      } else {
+        AppendFormat(v);
+      }
+    }
+
+    // Appends `absl::StrFormat("%v", v)`.
+    template<typename T>
+    void AppendFormat(const T& v) {
+      absl::Format(this, "%v", v);
+    }
+
+    // Escapes `v` straight into the output, which grows by exactly the escaped size.
+    void AppendEscaped(std::string_view v, types_internal::CEscapeStyle style) {
+      types_internal::AppendEscaped(out_, v, style);
+      MaybeFlush();
+    }
+
+    // Writes the buffered output to the `flush` stream (if any).
+    void Flush() {
+      if (flush_ != nullptr && !out_.empty()) {
+        flush_->write(out_.data(), static_cast<std::streamsize>(out_.size()));
+        out_.clear();
+      }
+    }
+
     void IncContainer(const StringifyOptions::Format& format) {
-      os_ << format.container_prefix;
+      Append(format.container_prefix);
       level_.push_back(format.field_indent);
       enable_indent_ = !format.field_indent.empty();
     }
@@ -813,12 +873,12 @@ class Stringify {
     void DecContainer(const StringifyOptions::Format& format) {
       level_.pop_back();
       StreamIndent();
-      os_ << format.container_suffix;
+      Append(format.container_suffix);
       enable_indent_ = level_.empty() || !level_.back().empty();
     }
 
     void IncStruct(const StringifyOptions::Format& format) {
-      os_ << format.structure_prefix;
+      Append(format.structure_prefix);
       level_.push_back(format.field_indent);
       enable_indent_ = !format.field_indent.empty();
     }
@@ -826,7 +886,7 @@ class Stringify {
     void DecStruct(const StringifyOptions::Format& format) {
       level_.pop_back();
       StreamIndent();
-      os_ << format.structure_suffix;
+      Append(format.structure_suffix);
       enable_indent_ = level_.empty() || !level_.back().empty();
     }
 
@@ -834,13 +894,27 @@ class Stringify {
       if (!enable_indent_) {
         return;
       }
-      os_ << "\n";
+      Append("\n");
       for (const std::string_view level : level_) {
-        os_ << level;
+        Append(level);
       }
     }
 
    private:
+    // Makes `OStream` an absl format sink.
+    friend void AbslFormatFlush(OStream* os, std::string_view v) { os->Append(v); }
+
+    void Append(std::string_view v) {
+      out_.append(v);
+      MaybeFlush();
+    }
+
+    void MaybeFlush() {
+      if (flush_ != nullptr && out_.size() >= kFlushBytes) {
+        Flush();
+      }
+    }
+
     void RootIndent(const StringifyRootOptions& root_options) {
       if (!root_options.root_indent.empty()) {
         level_.push_back(root_options.root_indent);
@@ -848,10 +922,22 @@ class Stringify {
     }
 
     bool enable_indent_ = true;
-    std::ostream& os_;
+    std::string& out_;
+    std::ostream* flush_;
     std::vector<std::string_view> level_;
   };
 
+  bool EnableIndent() const { return !default_field_options_.outer.format.get({}).field_indent.empty(); }
+
+  template<typename T>
+  void StreamRoot(OStream& os, const T& value, const StringifyRootOptions& root_options) const {
+    os << root_options.root_prefix;
+    os << default_field_options_.outer.format.get({}).message_prefix;
+    StreamImpl(os, default_field_options_, value);
+    os << default_field_options_.outer.format.get({}).message_suffix;
+    os << root_options.root_suffix;
+  }
+
   template<IsAggregate T>
   requires(!IsEmptyType<T>)
   void StreamImpl(OStream& os, const StringifyFieldOptions& options, const T& value) const {
@@ -870,6 +956,13 @@ class Stringify {
     StreamValue(os, options, value, true);
   }
 
+  // A value holder at the root streams whatever it holds, e.g. a scalar or array (see `MboTypesStringifyValueAccess`).
+  template<HasMboTypesStringifyValueAccess T>
+  requires(!IsAggregate<T> && !IsEmptyType<T> && !IsStringKeyedContainer<T>)
+  void StreamImpl(OStream& os, const StringifyFieldOptions& options, const T& value) const {
+    StreamValue(os, options, value, false);
+  }
+
   template<typename T>
   requires(HasMboTypesStringifyDisable<T>)
   void StreamFieldsImpl(
@@ -1156,7 +1249,9 @@ class Stringify {
     if (!field_name.empty()) {
       os << key_control.key_prefix << field_name << key_control.key_suffix << format.key_value_separator;
     } else if (key_control.key_mode == StringifyOptions::KeyMode::kNumericFallback) {
-      os << key_control.key_prefix << field.idx << key_control.key_suffix << format.key_value_separator;
+      os << key_control.key_prefix;
+      os.AppendNumber(field.idx);
+      os << key_control.key_suffix << format.key_value_separator;
     }
   }
 
@@ -1297,7 +1392,7 @@ class Stringify {
       StreamValuePair(os, options, v, allow_field_names);
     } else if constexpr (std::is_same_v<RawV, char> || std::is_same_v<RawV, unsigned char>) {
       if (options.outer.format->char_delim.empty()) {
-        os << absl::StreamFormat("%v", int(v));
+        os.AppendNumber(int(v));
       } else {
         os << options.outer.format->char_delim;
         if (v == '\'') {
@@ -1310,7 +1405,7 @@ class Stringify {
       }
     } else if constexpr (std::is_arithmetic_v<RawV>) {
       if (options.outer.value_overrides->replacement_other.empty()) {
-        os << absl::StreamFormat("%v", v);
+        os.AppendNumber(v);
       } else {
         os << options.outer.value_overrides->replacement_other;
       }
@@ -1388,7 +1483,7 @@ class Stringify {
   static void StreamValueFallback(OStream& os, const StringifyOptions& options, const V& v) {
     if (options.value_control->other_types_direct) {
       if (options.value_overrides->replacement_other.empty()) {
-        os << absl::StreamFormat("%v", v);
+        os.AppendFormat(v);
       } else {
         os << options.value_overrides->replacement_other;
       }
@@ -1409,8 +1504,8 @@ class Stringify {
     }
     switch (options.value_control->escape_mode) {
       case StringifyOptions::EscapeMode::kNone: os << vvv; break;
-      case StringifyOptions::EscapeMode::kCEscape: os << absl::CEscape(vvv); break;
-      case StringifyOptions::EscapeMode::kCHexEscape: os << absl::CHexEscape(vvv); break;
+      case StringifyOptions::EscapeMode::kCEscape: os.AppendEscaped(vvv, types_internal::CEscapeStyle::kOctal); break;
+      case StringifyOptions::EscapeMode::kCHexEscape: os.AppendEscaped(vvv, types_internal::CEscapeStyle::kHex); break;
     }
     if (vvv.length() < v.length()) {
       os << options.value_control->str_cutoff_suffix;
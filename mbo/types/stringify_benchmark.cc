@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: Copyright (c) The helly25 authors (helly25.com)
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput of `Stringify` for a document of log-like records: `ToString`, `AppendTo` a reused buffer and `Stream`
+// to a `std::ostream`. The argument selects text without (0) or with (1) characters that need escaping.
+// Run with: bazel run -c opt //mbo/types:stringify_benchmark
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "mbo/types/extend.h"
+#include "mbo/types/stringify.h"
+
+namespace mbo::types {
+namespace {
+
+// NOLINTBEGIN(*-magic-numbers)
+
+struct Record : Extend<Record> {
+  std::string message;
+  int64_t id = 0;
+  double latency = 0;
+  bool ok = false;
+  std::vector<std::string> tags;
+};
+
+struct Document : Extend<Document> {
+  std::vector<Record> records;
+};
+
+const Document& GetDocument(bool escapes) {
+  static const auto* const kDocuments = [] {
+    auto* documents = new std::vector<Document>(2);  // NOLINT(cppcoreguidelines-owning-memory)
+    for (std::size_t idx = 0; idx < 2000; ++idx) {
+      for (Document& document : *documents) {
+        const bool with_escapes = &document != documents->data();
+        document.records.push_back({
+            .message = absl::StrCat(
+                "request ", idx, with_escapes ? " served by \"handler\"\n\tin C:\\srv" : " served by handler in /srv"),
+            .id = static_cast<int64_t>(idx * 7919),
+            .latency = static_cast<double>(idx % 1000) / 8,
+            .ok = idx % 7 != 0,
+            .tags = {"api", "v1", absl::StrCat("item-", idx)},
+        });
+      }
+    }
+    return documents;
+  }();
+  return (*kDocuments)[escapes ? 1 : 0];
+}
+
+// Discards all output.
+class NullBuffer final : public std::streambuf {
+ protected:
+  std::streamsize xsputn(const char* /*data*/, std::streamsize size) override { return size; }
+
+  int_type overflow(int_type chr) override { return traits_type::not_eof(chr); }
+};
+
+void BmToString(benchmark::State& state) {
+  const Document& document = GetDocument(state.range(0) != 0);
+  const Stringify stringify(Stringify::OptionsJson());
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    const std::string text = stringify.ToString(document);
+    bytes += text.size();
+    benchmark::DoNotOptimize(text);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+void BmAppendTo(benchmark::State& state) {
+  const Document& document = GetDocument(state.range(0) != 0);
+  const Stringify stringify(Stringify::OptionsJson());
+  std::string buffer;
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    buffer.clear();
+    stringify.AppendTo(buffer, document);
+    bytes += buffer.size();
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+void BmStream(benchmark::State& state) {
+  const Document& document = GetDocument(state.range(0) != 0);
+  const Stringify stringify(Stringify::OptionsJson());
+  NullBuffer null;
+  std::ostream output(&null);
+  const std::size_t size = stringify.ToString(document).size();
+  for (auto _ : state) {
+    stringify.Stream(output, document);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+
+BENCHMARK(BmToString)->Arg(0)->Arg(1);
+BENCHMARK(BmAppendTo)->Arg(0)->Arg(1);
+BENCHMARK(BmStream)->Arg(0)->Arg(1);
+
+// NOLINTEND(*-magic-numbers)
+
+}  // namespace
+}  // namespace mbo::types
+
+BENCHMARK_MAIN();  // NOLINT
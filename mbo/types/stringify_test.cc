@@ -17,8 +17,11 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -28,6 +31,7 @@
 #include "absl/container/btree_map.h"
 #include "absl/log/absl_check.h"  // IWYU pragma: keep
 #include "absl/log/absl_log.h"    // IWYU pragma: keep
+#include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "gmock/gmock.h"
@@ -73,6 +77,7 @@ using ::mbo::types::types_internal::kStructNameSupport;
 using ::mbo::types::types_internal::SupportsFieldNames;
 using ::mbo::types::types_internal::SupportsFieldNamesConstexpr;
 using ::testing::ElementsAre;
+using ::testing::Gt;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 
@@ -1086,6 +1091,72 @@ TEST_F(StringifyTest, MboTypesStringifyConvert) {
   EXPECT_THAT(Stringify::AsCpp().ToString(data), R"({"value@0:42", "value@1:33", {"two", "2"}})");
 }
 
+struct TestStructEscaping {
+  using MboTypesStringifyDoNotPrintFieldNames = void;
+
+  std::string plain = "plain";
+  std::string special = "a\"b'c\\d\n\r\te";
+  std::string binary = "\x01\x7F\x80\xFF\x1b" "5f";
+  char quote = '\'';
+  char tab = '\t';
+};
+
+TEST_F(StringifyTest, Escaping) {
+  const TestStructEscaping data;
+  for (const auto mode : {StringifyOptions::EscapeMode::kCEscape, StringifyOptions::EscapeMode::kCHexEscape}) {
+    StringifyOptions options = Stringify::OptionsCpp();
+    options.value_control.as_data().escape_mode = mode;
+    const auto escape = [mode](std::string_view text) {
+      return mode == StringifyOptions::EscapeMode::kCEscape ? absl::CEscape(text) : absl::CHexEscape(text);
+    };
+    EXPECT_THAT(
+        Stringify(options).ToString(data),
+        absl::StrCat(
+            R"({"plain", ")", escape(data.special), R"(", ")", escape(data.binary), R"(", ')", escape("\\'"), "', '",
+            escape("\t"), "'}"));
+  }
+}
+
+struct TestStructNumbers {
+  using MboTypesStringifyDoNotPrintFieldNames = void;
+
+  int64_t min = std::numeric_limits<int64_t>::min();
+  uint64_t max = std::numeric_limits<uint64_t>::max();
+  double big = 123456789.0;
+  double tiny = -1.5e-300;
+  float half = 0.5F;
+  bool yes = true;
+  char chr = 'A';
+};
+
+TEST_F(StringifyTest, Numbers) {
+  StringifyOptions options = Stringify::OptionsCpp();
+  options.format.as_data().char_delim = "";
+  EXPECT_THAT(
+      Stringify(options).ToString(TestStructNumbers{}),
+      "{-9223372036854775808, 18446744073709551615, 1.23457e+08, -1.5e-300, 0.5, true, 65}");
+}
+
+struct TestStructLarge {
+  std::vector<std::string> lines;
+};
+
+TEST_F(StringifyTest, AppendToAndStream) {
+  TestStructLarge data;
+  for (std::size_t idx = 0; idx < 10'000; ++idx) {
+    data.lines.push_back(absl::StrCat("line \"", idx, "\"\n"));
+  }
+  const Stringify stringify = Stringify::AsJsonPretty();
+  const std::string text = stringify.ToString(data);
+  ASSERT_THAT(text.size(), Gt(std::size_t{1} << 17)) << "Must be streamed in multiple chunks.";
+  std::ostringstream os;
+  stringify.Stream(os, data);
+  EXPECT_EQ(os.str(), text);
+  std::string out = "prefix";
+  stringify.AppendTo(out, data);
+  EXPECT_EQ(out, "prefix" + text);
+}
+
 // NOLINTEND(*-magic-numbers,*-named-parameter)
 
 }  // namespace